@@ -0,0 +1,5 @@
+#include <netpacket/packet.h>
+
+int main() {
+	return 0;
+}
@@ -0,0 +1,5 @@
+#include <sys/types.h>
+
+int main() {
+	return 0;
+}
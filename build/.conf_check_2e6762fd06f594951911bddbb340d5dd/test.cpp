@@ -0,0 +1,11 @@
+
+#include <stdint.h>
+int main ()
+{
+   uint32_t a = 0;
+   uint64_t b = 0;
+   __sync_bool_compare_and_swap (&a, 0, 1);
+   __sync_fetch_and_add (&b, 1);
+   __sync_synchronize ();
+   return a + b;
+}
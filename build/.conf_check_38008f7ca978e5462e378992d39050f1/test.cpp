@@ -0,0 +1,5 @@
+#include <dirent.h>
+
+int main() {
+	return 0;
+}
@@ -0,0 +1,5 @@
+#include <signal.h>
+
+int main() {
+	return 0;
+}
@@ -0,0 +1,6 @@
+
+static __thread int x;
+int main ()
+{
+   return x;
+}
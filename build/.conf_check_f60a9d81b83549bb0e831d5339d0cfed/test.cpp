@@ -0,0 +1,5 @@
+#include <sys/mman.h>
+
+int main() {
+	return 0;
+}
@@ -0,0 +1,295 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef END_POINT_INDEX_H
+#define END_POINT_INDEX_H
+
+#include "ns3/assert.h"
+#include "ns3/sgi-hashmap.h"
+#include <stdint.h>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ * \brief hash indexes of the end points of an end point demux
+ *
+ * The end points (Ipv4EndPoint or Ipv6EndPoint, with A the matching
+ * address type and H its hash function) are indexed by their local port
+ * and by their full four-tuple, where the wildcard addresses and the zero
+ * peer port are ordinary values of the key: a demux looks up a partially
+ * specified four-tuple by asking for the key in which the unspecified
+ * fields are set to their wildcard.
+ *
+ * Each end point is given a sequence number when it is inserted and the
+ * end points of a bucket are ordered on it, so that the buckets list
+ * their end points in the order in which they were allocated, which is
+ * the order in which the demuxes used to scan their list.
+ *
+ * The index only references the end points: the demux owns them and
+ * must call Update whenever the address or the ports of one of them
+ * change, and Remove before deleting it.
+ */
+template <typename T, typename A, typename H>
+class EndPointIndex
+{
+public:
+  /**
+   * The end points of a bucket, keyed on their sequence number.
+   */
+  typedef std::map<uint64_t, T *> Bucket;
+
+  EndPointIndex ();
+
+  /**
+   * \param endPoint the end point to index under its current four-tuple.
+   */
+  void Insert (T *endPoint);
+  /**
+   * \param endPoint the end point to index again under its current
+   *        four-tuple, without changing its rank in the buckets.
+   */
+  void Update (T *endPoint);
+  /**
+   * \param endPoint the end point to remove from the index.
+   * \returns false if the end point was not indexed.
+   */
+  bool Remove (T *endPoint);
+  /**
+   * \returns all the end points, in their order of insertion.
+   */
+  const Bucket &GetAll (void) const;
+  /**
+   * \param port a local port
+   * \returns the end points whose local port is port, or zero if there
+   *          is none.
+   */
+  const Bucket *GetPort (uint16_t port) const;
+  /**
+   * \param localAddress a local address
+   * \param localPort a local port
+   * \param peerAddress a peer address
+   * \param peerPort a peer port
+   * \returns the end points whose four-tuple is exactly the one
+   *          specified, or zero if there is none.
+   */
+  const Bucket *Get (A localAddress, uint16_t localPort,
+                     A peerAddress, uint16_t peerPort) const;
+
+private:
+  struct Key
+  {
+    A localAddress;
+    uint16_t localPort;
+    A peerAddress;
+    uint16_t peerPort;
+  };
+  struct KeyHash
+  {
+    size_t operator() (const Key &key) const;
+  };
+  struct KeyEqual
+  {
+    bool operator() (const Key &a, const Key &b) const;
+  };
+  struct PointerHash
+  {
+    size_t operator() (const T *endPoint) const;
+  };
+  struct Entry
+  {
+    uint64_t sequence;
+    Key key;
+  };
+  typedef sgi::hash_map<uint16_t, Bucket> Ports;
+  typedef sgi::hash_map<Key, Bucket, KeyHash, KeyEqual> Tuples;
+  typedef sgi::hash_map<const T *, Entry, PointerHash> Entries;
+
+  static Key GetKey (T *endPoint);
+  void Link (const Entry &entry, T *endPoint);
+  void Unlink (const Entry &entry);
+
+  Bucket m_all;
+  Ports m_ports;
+  Tuples m_tuples;
+  Entries m_entries;
+  uint64_t m_sequence;
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+template <typename T, typename A, typename H>
+size_t
+EndPointIndex<T,A,H>::KeyHash::operator() (const Key &key) const
+{
+  H hash;
+  size_t h = hash (key.localAddress);
+  h = h * 31 + hash (key.peerAddress);
+  h = h * 31 + key.localPort;
+  return h * 31 + key.peerPort;
+}
+
+template <typename T, typename A, typename H>
+bool
+EndPointIndex<T,A,H>::KeyEqual::operator() (const Key &a, const Key &b) const
+{
+  return a.localPort == b.localPort && a.peerPort == b.peerPort
+         && a.localAddress == b.localAddress && a.peerAddress == b.peerAddress;
+}
+
+template <typename T, typename A, typename H>
+size_t
+EndPointIndex<T,A,H>::PointerHash::operator() (const T *endPoint) const
+{
+  return reinterpret_cast<size_t> (endPoint) >> 4;
+}
+
+template <typename T, typename A, typename H>
+EndPointIndex<T,A,H>::EndPointIndex ()
+  : m_sequence (0)
+{
+}
+
+template <typename T, typename A, typename H>
+typename EndPointIndex<T,A,H>::Key
+EndPointIndex<T,A,H>::GetKey (T *endPoint)
+{
+  Key key;
+  key.localAddress = endPoint->GetLocalAddress ();
+  key.localPort = endPoint->GetLocalPort ();
+  key.peerAddress = endPoint->GetPeerAddress ();
+  key.peerPort = endPoint->GetPeerPort ();
+  return key;
+}
+
+template <typename T, typename A, typename H>
+void
+EndPointIndex<T,A,H>::Link (const Entry &entry, T *endPoint)
+{
+  m_ports[entry.key.localPort][entry.sequence] = endPoint;
+  m_tuples[entry.key][entry.sequence] = endPoint;
+}
+
+template <typename T, typename A, typename H>
+void
+EndPointIndex<T,A,H>::Unlink (const Entry &entry)
+{
+  typename Ports::iterator port = m_ports.find (entry.key.localPort);
+  NS_ASSERT (port != m_ports.end ());
+  port->second.erase (entry.sequence);
+  if (port->second.empty ())
+    {
+      m_ports.erase (port);
+    }
+  typename Tuples::iterator tuple = m_tuples.find (entry.key);
+  NS_ASSERT (tuple != m_tuples.end ());
+  tuple->second.erase (entry.sequence);
+  if (tuple->second.empty ())
+    {
+      m_tuples.erase (tuple);
+    }
+}
+
+template <typename T, typename A, typename H>
+void
+EndPointIndex<T,A,H>::Insert (T *endPoint)
+{
+  NS_ASSERT (m_entries.find (endPoint) == m_entries.end ());
+  Entry entry;
+  entry.sequence = m_sequence++;
+  entry.key = GetKey (endPoint);
+  m_entries[endPoint] = entry;
+  m_all[entry.sequence] = endPoint;
+  Link (entry, endPoint);
+}
+
+template <typename T, typename A, typename H>
+void
+EndPointIndex<T,A,H>::Update (T *endPoint)
+{
+  typename Entries::iterator i = m_entries.find (endPoint);
+  if (i == m_entries.end ())
+    {
+      return;
+    }
+  Key key = GetKey (endPoint);
+  if (KeyEqual () (key, i->second.key))
+    {
+      return;
+    }
+  Unlink (i->second);
+  i->second.key = key;
+  Link (i->second, endPoint);
+}
+
+template <typename T, typename A, typename H>
+bool
+EndPointIndex<T,A,H>::Remove (T *endPoint)
+{
+  typename Entries::iterator i = m_entries.find (endPoint);
+  if (i == m_entries.end ())
+    {
+      return false;
+    }
+  Unlink (i->second);
+  m_all.erase (i->second.sequence);
+  m_entries.erase (i);
+  return true;
+}
+
+template <typename T, typename A, typename H>
+const typename EndPointIndex<T,A,H>::Bucket &
+EndPointIndex<T,A,H>::GetAll (void) const
+{
+  return m_all;
+}
+
+template <typename T, typename A, typename H>
+const typename EndPointIndex<T,A,H>::Bucket *
+EndPointIndex<T,A,H>::GetPort (uint16_t port) const
+{
+  typename Ports::const_iterator i = m_ports.find (port);
+  if (i == m_ports.end ())
+    {
+      return 0;
+    }
+  return &i->second;
+}
+
+template <typename T, typename A, typename H>
+const typename EndPointIndex<T,A,H>::Bucket *
+EndPointIndex<T,A,H>::Get (A localAddress, uint16_t localPort,
+                           A peerAddress, uint16_t peerPort) const
+{
+  Key key;
+  key.localAddress = localAddress;
+  key.localPort = localPort;
+  key.peerAddress = peerAddress;
+  key.peerPort = peerPort;
+  typename Tuples::const_iterator i = m_tuples.find (key);
+  if (i == m_tuples.end ())
+    {
+      return 0;
+    }
+  return &i->second;
+}
+
+} // namespace ns3
+
+#endif /* END_POINT_INDEX_H */
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef FLOW_MONITOR_EXPORT_H
+#define FLOW_MONITOR_EXPORT_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+
+#include "ns3/nstime.h"
+#include "ns3/flow-classifier.h"
+#include "ns3/ipv4-flow-classifier.h"
+
+namespace ns3 {
+
+/// \brief A record of the streaming export of FlowMonitor
+///
+/// The export is a sequence of records:
+///  - a FLOW record gives the five-tuple of a flow, before its first
+///    DELTA record, and again if the flow shows up after its eviction;
+///  - a DELTA record gives the changes of the counters of a flow since its
+///    previous DELTA record, so that the sum of the DELTA records of a flow
+///    gives its statistics at the time of the last record;
+///  - an EVICTION record tells that the flow was idle and that the monitor
+///    forgot it.
+///
+/// In the binary format, the file starts with the 8 bytes "NS3FLOWS" and
+/// a 32-bit version number, and each record starts with its type ('F',
+/// 'D' or 'E'), its time in nanoseconds (64 bits) and its flow identifier
+/// (32 bits). A FLOW record follows with the source and destination
+/// addresses (32 bits each), the protocol (8 bits) and the source and
+/// destination ports (16 bits each); a DELTA record with the fields
+/// txBytes to jitterSum below, the times in nanoseconds. All the integers
+/// are little-endian.
+///
+/// In the CSV format, the first line names the columns: record, time,
+/// flowId, the five-tuple, then the fields txBytes to jitterSum; each
+/// record fills the columns which apply to its type.
+struct FlowMonitorExportRecord
+{
+  enum Type
+  {
+    FLOW = 'F',
+    DELTA = 'D',
+    EVICTION = 'E'
+  };
+
+  FlowMonitorExportRecord ();
+
+  enum Type type;
+  Time time;
+  FlowId flowId;
+  /// The five-tuple of the flow, in FLOW records
+  Ipv4FlowClassifier::FiveTuple tuple;
+  /// The changes of the FlowMonitor::FlowStats counters, in DELTA records
+  uint64_t txBytes;
+  uint64_t rxBytes;
+  uint32_t txPackets;
+  uint32_t rxPackets;
+  uint32_t lostPackets;
+  uint32_t timesForwarded;
+  Time delaySum;
+  Time jitterSum;
+};
+
+/// \brief Writes the records of the streaming export of FlowMonitor
+class FlowMonitorExportWriter
+{
+public:
+  enum Format
+  {
+    BINARY,
+    CSV
+  };
+
+  FlowMonitorExportWriter ();
+
+  /// Create the file, or fail with a fatal error
+  void Open (std::string fileName, enum Format format);
+  bool IsOpen (void) const;
+  void Write (const FlowMonitorExportRecord &record);
+  /// Push the records written so far to the file, for the readers of a
+  /// simulation in progress
+  void Flush (void);
+  void Close (void);
+
+private:
+  FlowMonitorExportWriter (const FlowMonitorExportWriter &);
+  FlowMonitorExportWriter& operator= (const FlowMonitorExportWriter &);
+
+  std::ofstream m_stream;
+  enum Format m_format;
+};
+
+/// \brief Reads the records of the streaming export of FlowMonitor
+///
+/// The format of the file is detected when it is opened. A file which is
+/// still being written can be read as it grows: Read returns false at the
+/// end of the file or at a record which is not complete yet, and it can be
+/// called again later.
+class FlowMonitorExportReader
+{
+public:
+  FlowMonitorExportReader ();
+
+  /// \returns false if the file cannot be opened or is not an export
+  bool Open (std::string fileName);
+  /// \returns true if a whole record was read
+  bool Read (FlowMonitorExportRecord &record);
+  void Close (void);
+
+private:
+  FlowMonitorExportReader (const FlowMonitorExportReader &);
+  FlowMonitorExportReader& operator= (const FlowMonitorExportReader &);
+
+  bool ReadBinary (FlowMonitorExportRecord &record);
+  bool ReadCsv (FlowMonitorExportRecord &record);
+
+  std::ifstream m_stream;
+  enum FlowMonitorExportWriter::Format m_format;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_MONITOR_EXPORT_H */
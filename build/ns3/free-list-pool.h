@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FREE_LIST_POOL_H
+#define FREE_LIST_POOL_H
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief per-thread free lists of small blocks, sorted by size class
+ *
+ * The objects which are allocated and released at a very high rate, such
+ * as the simulation events, can recycle their storage through a pool
+ * instead of the general-purpose allocator. A pool is meant to be a
+ * static object, used by the class-specific operator new and operator
+ * delete of these objects, which must not be allocated before the
+ * constructor of the pool has run.
+ *
+ * Each thread has its own free lists, so that no lock is needed, and
+ * keeps a bounded number of free blocks of each size class: a block may
+ * be released by another thread than the one which allocated it. The
+ * free blocks of a thread are returned to the system when the thread
+ * exits, if POSIX threads are available, and those of the main thread
+ * when the program exits. Without thread-local storage, the blocks are
+ * not pooled.
+ */
+class FreeListPool
+{
+public:
+  /**
+   * \param granularity the size classes are multiples of this number of
+   *        bytes, at least the size of a pointer
+   * \param nClasses the number of size classes, at most 16: larger
+   *        blocks go to the general-purpose allocator
+   * \param maxFree the maximum number of free blocks a thread keeps for
+   *        each size class
+   */
+  FreeListPool (size_t granularity, uint32_t nClasses, uint32_t maxFree);
+
+  /**
+   * \param size the number of bytes to allocate
+   * \returns a block of at least size bytes
+   */
+  void *Allocate (size_t size);
+  /**
+   * \param buffer a block returned by Allocate, or zero
+   * \param size the size given to Allocate
+   */
+  void Deallocate (void *buffer, size_t size);
+
+private:
+  uint32_t m_index;
+  size_t m_granularity;
+  uint32_t m_nClasses;
+  uint32_t m_maxFree;
+};
+
+} // namespace ns3
+
+#endif /* FREE_LIST_POOL_H */
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTE_CACHE_H
+#define IPV4_ROUTE_CACHE_H
+
+#include <stdint.h>
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/net-device.h"
+#include "ns3/ptr.h"
+#include "ns3/sgi-hashmap.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief cache of the unicast routes found by a routing protocol
+ *
+ * Routing protocols whose routes only depend on the content of their
+ * routing table can keep the results of their lookups in this cache,
+ * keyed on the destination address and the requested output device, so
+ * that the packets sent to the same destination share a single Ipv4Route
+ * instead of searching the table and allocating a new route each time.
+ * The absence of a route is cached too.
+ *
+ * The routes handed out by the cache are shared and must not be modified.
+ * The owner of the cache must flush it whenever its routing table, or the
+ * state or the addresses of its interfaces, change. When the cache is
+ * full, it is flushed before a new route is added.
+ */
+class Ipv4RouteCache
+{
+public:
+  Ipv4RouteCache ();
+
+  /**
+   * \param maxSize the maximum number of cached lookups, zero to disable
+   *        the cache.
+   */
+  void SetMaxSize (uint32_t maxSize);
+  /**
+   * \returns the maximum number of cached lookups.
+   */
+  uint32_t GetMaxSize (void) const;
+
+  /**
+   * \param dest the destination address
+   * \param oif the requested output device, or zero
+   * \param route set to the cached route, which is zero if the lookup
+   *        found no route.
+   * \returns true if the result of this lookup is cached.
+   */
+  bool Lookup (Ipv4Address dest, Ptr<const NetDevice> oif, Ptr<Ipv4Route> &route);
+  /**
+   * \param dest the destination address
+   * \param oif the requested output device, or zero
+   * \param route the route found by the lookup, or zero.
+   */
+  void Add (Ipv4Address dest, Ptr<const NetDevice> oif, Ptr<Ipv4Route> route);
+  /**
+   * Forget all the cached lookups.
+   */
+  void Flush (void);
+
+  /**
+   * \returns the number of lookups found in the cache.
+   */
+  uint64_t GetHits (void) const;
+  /**
+   * \returns the number of lookups not found in the cache.
+   */
+  uint64_t GetMisses (void) const;
+
+private:
+  struct Key
+  {
+    Ipv4Address dest;
+    const NetDevice *oif;
+  };
+  struct KeyHash
+  {
+    size_t operator() (const Key &key) const;
+  };
+  struct KeyEqual
+  {
+    bool operator() (const Key &a, const Key &b) const;
+  };
+  typedef sgi::hash_map<Key, Ptr<Ipv4Route>, KeyHash, KeyEqual> Cache;
+
+  Cache m_cache;
+  uint32_t m_maxSize;
+  uint64_t m_hits;
+  uint64_t m_misses;
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTE_CACHE_H */
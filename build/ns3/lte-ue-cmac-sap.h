@@ -0,0 +1,79 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Nicola Baldo <nbaldo@cttc.es>
+ */
+
+#ifndef LTE_UE_CMAC_SAP_H
+#define LTE_UE_CMAC_SAP_H
+
+#include <ns3/packet.h>
+#include <ns3/ff-mac-common.h>
+#include <ns3/eps-bearer.h>
+#include <ns3/lte-common.h>
+
+namespace ns3 {
+
+
+
+class LteMacSapUser;
+
+/**
+ * Service Access Point (SAP) offered by the UE MAC to the UE RRC
+ *
+ * This is the MAC SAP Provider, i.e., the part of the SAP that contains the MAC methods called by the RRC
+ */
+class LteUeCmacSapProvider
+{
+public:
+  virtual ~LteUeCmacSapProvider ();
+  /**
+   * called by the RRC after going to RRC connected
+   *
+   * \param rnti
+   */
+  virtual void ConfigureUe (uint16_t rnti) = 0;
+
+  virtual void AddLc (uint8_t lcId, LteMacSapUser* msu) = 0;
+
+  virtual void RemoveLc (uint8_t lcId) = 0;
+  
+  virtual void RrcUpdateConfigurationReq (LteUeConfig_t params) = 0;
+
+};
+
+
+
+/**
+ * Service Access Point (SAP) offered by the UE MAC to the UE RRC
+ *
+ * This is the MAC SAP User, i.e., the part of the SAP that contains the RRC methods called by the MAC
+ */
+class LteUeCmacSapUser
+{
+public:
+  virtual ~LteUeCmacSapUser ();
+  virtual void LcConfigCompleted () = 0;
+};
+
+
+
+
+} // namespace ns3
+
+
+#endif // LTE_UE_CMAC_SAP_H
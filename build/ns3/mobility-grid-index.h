@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_GRID_INDEX_H
+#define MOBILITY_GRID_INDEX_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Uniform grid over the x/y plane used to find the mobility
+ * models which are possibly within a given range of a position.
+ *
+ * Every mobility model added to the index is identified by the
+ * small integer returned by Add. Items are bucketed by the position
+ * they had the last time they were refreshed; refreshes happen lazily
+ * upon the next query after a CourseChange notification of the
+ * underlying MobilityModel.
+ *
+ * Because most mobility models only notify a course change when their
+ * velocity changes, items which were moving at their last refresh can
+ * drift away from their cell. The index keeps track of the largest
+ * speed of such items and widens the query range by the distance
+ * they may have covered since they were bucketed; once this slack
+ * exceeds half a cell, all moving items are re-bucketed. This assumes
+ * that the velocity of a model does not change without a course
+ * change notification (which is not true of, for example,
+ * ns3::ConstantAccelerationMobilityModel).
+ *
+ * The candidate set returned by GetCandidates is a superset of the
+ * items within range: callers must still check the exact distance.
+ * Only the x and y coordinates are used so the candidate set is also
+ * a superset of the items within the three-dimensional range.
+ */
+class MobilityGridIndex : public SimpleRefCount<MobilityGridIndex>
+{
+public:
+  MobilityGridIndex ();
+  ~MobilityGridIndex ();
+
+  /**
+   * \param cellSize the length of the side of a grid cell, in meters.
+   *
+   * Changing the cell size re-buckets all the items already added.
+   */
+  void SetCellSize (double cellSize);
+  /**
+   * \returns the length of the side of a grid cell, in meters.
+   */
+  double GetCellSize (void) const;
+
+  /**
+   * \param mobility the mobility model to track.
+   * \returns the identifier of the new item, which is equal to the
+   *          number of items added before it.
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+  /**
+   * \returns the number of items added to this index.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * Remove all items and disconnect from their CourseChange trace sources.
+   */
+  void Clear (void);
+
+  /**
+   * \param position the center of the query.
+   * \param range the query radius, in meters.
+   * \param candidates filled with the identifiers, in increasing order,
+   *        of all the items which may be within range of position.
+   */
+  void GetCandidates (const Vector &position, double range,
+                      std::vector<uint32_t> &candidates);
+
+private:
+  MobilityGridIndex (const MobilityGridIndex &o);
+  MobilityGridIndex &operator = (const MobilityGridIndex &o);
+
+  typedef std::pair<int64_t, int64_t> Cell;
+  typedef std::map<Cell, std::vector<uint32_t> > Cells;
+
+  struct Item
+  {
+    Ptr<MobilityModel> mobility;
+    Cell cell;
+    double speed;
+    bool dirty;
+    bool bucketed;
+  };
+
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+  void Refresh (void);
+  void Bucket (uint32_t id);
+  void Unbucket (uint32_t id);
+  int64_t GetCellCoordinate (double v) const;
+
+  double m_cellSize;
+  std::vector<Item> m_items;
+  Cells m_cells;
+  std::vector<uint32_t> m_dirty;
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_mobilityItems;
+  std::vector<uint32_t> m_moving;
+  double m_maxSpeed;
+  Time m_lastMovingRefresh;
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_GRID_INDEX_H */
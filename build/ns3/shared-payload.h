@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SHARED_PAYLOAD_H
+#define SHARED_PAYLOAD_H
+
+#include <stdint.h>
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief an immutable byte array which can back the payload of many packets
+ *
+ * Applications which send the same payload over and over again can
+ * store it once in a SharedPayload and create their packets with
+ * Packet::Packet (Ptr<const SharedPayload>): the payload bytes of these
+ * packets are then not copied into each packet but referenced from
+ * the shared instance, in the same way the zero-filled payload of
+ * Packet::Packet (uint32_t) is not allocated. The bytes are copied
+ * into the packet only when they must be made contiguous with the
+ * headers, that is, when Packet::PeekData is called or when two
+ * payloads which are not adjacent in the same SharedPayload are
+ * concatenated.
+ */
+class SharedPayload : public SimpleRefCount<SharedPayload>
+{
+public:
+  /**
+   * \param buffer the bytes of the payload, which are copied.
+   * \param size the number of bytes of the payload.
+   */
+  SharedPayload (uint8_t const *buffer, uint32_t size);
+  /**
+   * \param fill the value of each byte of the payload.
+   * \param size the number of bytes of the payload.
+   */
+  SharedPayload (uint8_t fill, uint32_t size);
+  ~SharedPayload ();
+
+  /**
+   * \returns the bytes of the payload.
+   */
+  inline uint8_t const *PeekData (void) const;
+  /**
+   * \returns the number of bytes of the payload.
+   */
+  inline uint32_t GetSize (void) const;
+
+private:
+  SharedPayload (const SharedPayload &o);
+  SharedPayload &operator = (const SharedPayload &o);
+
+  uint8_t *m_data;
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+uint8_t const *
+SharedPayload::PeekData (void) const
+{
+  return m_data;
+}
+
+uint32_t
+SharedPayload::GetSize (void) const
+{
+  return m_size;
+}
+
+} // namespace ns3
+
+#endif /* SHARED_PAYLOAD_H */
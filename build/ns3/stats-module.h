@@ -0,0 +1,18 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_STATS
+    
+
+// Module headers:
+#include "basic-data-calculators.h"
+#include "data-calculator.h"
+#include "data-collector.h"
+#include "data-output-interface.h"
+#include "omnet-data-output.h"
+#include "packet-data-calculators.h"
+#include "sqlite-data-output.h"
+#include "time-data-calculators.h"
+#endif
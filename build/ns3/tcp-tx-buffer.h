@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 Adrian Sai-wah Tam
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Adrian Sai-wah Tam <adrian.sw.tam@gmail.com>
+ */
+
+#ifndef TCP_TX_BUFFER_H
+#define TCP_TX_BUFFER_H
+
+#include <list>
+#include <map>
+#include "ns3/traced-value.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/object.h"
+#include "ns3/sequence-number.h"
+#include "ns3/ptr.h"
+#include "tcp-byte-ring.h"
+
+namespace ns3 {
+class Packet;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief class for keeping the data sent by the application to the TCP socket, i.e.
+ *        the sending buffer.
+ */
+class TcpTxBuffer : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  TcpTxBuffer (uint32_t n = 0);
+  virtual ~TcpTxBuffer (void);
+
+  // Accessors
+
+  /**
+   * Returns the first byte's sequence number
+   */
+  SequenceNumber32 HeadSequence (void) const;
+
+  /**
+   * Returns the last byte's sequence number + 1
+   */
+  SequenceNumber32 TailSequence (void) const;
+
+  /**
+   * Returns total number of bytes in this Tx buffer
+   */
+  uint32_t Size (void) const;
+
+  /**
+   * Returns the Tx window size
+   */
+  uint32_t MaxBufferSize (void) const;
+
+  /**
+   * Set the Tx window size
+   */
+  void SetMaxBufferSize (uint32_t n);
+
+  /**
+   * Returns the available capacity in this Tx window
+   */
+  uint32_t Available (void) const;
+
+  /**
+   * Append a data packet to the end of the buffer
+   *
+   * \param p The packet to be appended to the Tx buffer
+   * \return Boolean to indicate success
+   */
+  bool Add (Ptr<Packet> p);
+
+  /**
+   * Returns the number of bytes from the buffer in the range [seq, tailSequence)
+   */
+  uint32_t SizeFromSequence (const SequenceNumber32& seq) const;
+
+  /**
+   * Copy data of size numBytes into a packet, data from the range [seq, seq+numBytes)
+   */
+  Ptr<Packet> CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq);
+
+  /**
+   * Set the m_firstByteSeq to seq. Supposed to be called only when the
+   * connection is just set up and we did not send any data out yet.
+   */
+  void SetHeadSequence (const SequenceNumber32& seq);
+
+  /**
+   * Discard data up to but not including this sequence number.
+   *
+   * \param seq The sequence number of the head byte
+   */
+  void DiscardUpTo (const SequenceNumber32& seq);
+
+  /**
+   * Choose how the data is stored: as the list of the packets added, or
+   * in a TcpByteRing, which copies the bytes but makes CopyFromSequence
+   * and DiscardUpTo independent of the number of packets added. The ring
+   * does not keep the tags of the packets added. Supposed to be called
+   * only when the buffer is empty.
+   *
+   * \param ring true to store the data in a ring
+   */
+  void SetRingStorage (bool ring);
+
+  /**
+   * \returns true if the data is stored in a ring
+   */
+  bool GetRingStorage (void) const;
+
+  /*
+   * The scoreboard: the ranges of data above the head of the buffer which
+   * the receiver reported in SACK options (RFC 2018), kept as disjoint
+   * ranges keyed on their first byte. The ranges below the head are
+   * discarded with the data.
+   */
+
+  /**
+   * Mark the data in [begin, end) as received by the peer, merging it with
+   * the ranges that it overlaps or touches. The part of the range outside
+   * of [HeadSequence (), TailSequence ()) is ignored.
+   *
+   * \returns the number of bytes which were not marked yet.
+   */
+  uint32_t Sack (const SequenceNumber32& begin, const SequenceNumber32& end);
+
+  /**
+   * Forget all the SACK information, e.g. if the receiver reneged.
+   */
+  void ResetScoreboard (void);
+
+  /**
+   * \returns true if the byte seq was reported by the peer in a SACK option
+   */
+  bool IsSacked (const SequenceNumber32& seq) const;
+
+  /**
+   * \returns the total number of bytes marked by SACK options
+   */
+  uint32_t SackedBytes (void) const;
+
+  /**
+   * \returns the byte following the highest byte marked by a SACK option,
+   *          or HeadSequence () if there is none
+   */
+  SequenceNumber32 HighestSacked (void) const;
+
+  /**
+   * \param seq a sequence number
+   * \param size set to the number of bytes from the result to the next
+   *        range marked by a SACK option, or to the end of the buffer
+   * \returns the first byte at or after seq which is not marked by a SACK
+   *          option
+   */
+  SequenceNumber32 NextUnsacked (const SequenceNumber32& seq, uint32_t &size) const;
+
+  /**
+   * The IsLost function of RFC 6675: a byte is deemed lost if at least
+   * dupThresh discontiguous ranges, or more than (dupThresh - 1) *
+   * segmentSize bytes, above it were marked by SACK options.
+   *
+   * \returns the first byte which is not deemed lost, so that the unmarked
+   *          bytes below it are lost. It is HeadSequence () if none is.
+   */
+  SequenceNumber32 LostBoundary (uint32_t dupThresh, uint32_t segmentSize) const;
+
+  /**
+   * \returns the number of bytes in [seq, HighestSacked ()) which were
+   *          marked by SACK options
+   */
+  uint32_t SackedBytesFrom (const SequenceNumber32& seq) const;
+
+private:
+  typedef std::list<Ptr<Packet> >::iterator BufIterator;
+
+  TracedValue<SequenceNumber32> m_firstByteSeq; //< Sequence number of the first byte in data (SND.UNA)
+  uint32_t m_size;                              //< Number of data bytes
+  uint32_t m_maxBuffer;                         //< Max number of data bytes in buffer (SND.WND)
+  std::list<Ptr<Packet> > m_data;               //< Corresponding data (may be null)
+  bool m_ringStorage;                           //< Whether the data is in m_ring rather than m_data
+  TcpByteRing m_ring;                           //< Corresponding data in ring storage mode
+  typedef std::map<SequenceNumber32, SequenceNumber32> Scoreboard;
+  Scoreboard m_sacked;                          //< SACKed ranges, first byte to byte after the last
+  uint32_t m_sackedBytes;                       //< Number of SACKed bytes
+};
+
+} // namepsace ns3
+
+#endif /* TCP_TX_BUFFER_H */
@@ -0,0 +1,154 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Giuseppe Piro  <g.piro@poliba.it>
+ *         Marco Miozzo <mmiozzo@cttc.es>
+ */
+
+
+#ifndef TRACE_FADING_LOSS_MODEL_H
+#define TRACE_FADING_LOSS_MODEL_H
+
+
+#include <ns3/object.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <map>
+#include <string>
+#include "ns3/random-variable-stream.h"
+#include <ns3/nstime.h>
+
+namespace ns3 {
+
+
+class MobilityModel;
+
+
+/**
+ * \ingroup lte
+ *
+ * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace is read either from the text format written by
+ * fading_trace_generator.m, or from a binary format made of a header,
+ * which gives the number of RBs, the number of samples, the sampling
+ * period and the window size of the trace, followed by the samples as
+ * 32-bit floats in host byte order, RB by RB. A binary trace is mapped in
+ * memory rather than read; ConvertTrace writes the binary version of a
+ * text trace.
+ *
+ * The instances of this model which load the same trace share a single
+ * read-only copy of it.
+ */
+class TraceFadingLossModel : public SpectrumPropagationLossModel
+{
+public:
+  TraceFadingLossModel ();
+  virtual ~TraceFadingLossModel ();
+
+  static TypeId GetTypeId ();
+  
+  virtual void DoStart (void);
+
+  /**
+   * \brief The couple of mobility mnode that form a fading channel realization
+   */
+  typedef std::pair<Ptr<const MobilityModel>, Ptr<const MobilityModel> > ChannelRealizationId_t;
+
+ /**
+  * Assign a fixed random variable stream number to the random variables
+  * used by this model.  Return the number of streams (possibly zero) that
+  * have been assigned.
+  *
+  * \param stream first stream index to use
+  * \return the number of stream indices assigned by this model
+  */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \brief Write the binary version of a fading trace in the text format
+   *
+   * \param textFileName the name of the trace in the text format
+   * \param binaryFileName the name of the trace to write in the binary format
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples of each RB
+   * \param traceLength the duration of the trace
+   * \param windowSize the size of the window for the fading trace
+   */
+  static void ConvertTrace (std::string textFileName, std::string binaryFileName,
+                            uint32_t rbNum, uint32_t samplesNum,
+                            Time traceLength, Time windowSize);
+
+  
+private:
+  class SharedTrace;
+
+  /**
+   * @param txPower set of values vs frequency representing the
+   * transmission power. See SpectrumChannel for details.
+   *
+   * @param a sender mobility
+   * @param b receiver mobility
+   *
+   * @return set of values vs frequency representing the received
+   * power in the same units used for the txPower parameter.
+   */
+  Ptr<SpectrumValue> DoCalcRxPowerSpectralDensity (Ptr<const SpectrumValue> txPsd,
+                                                   Ptr<const MobilityModel> a,
+                                                   Ptr<const MobilityModel> b) const;
+                                                   
+  /**
+  * \brief Get the value for a particular sub channel and a given speed
+  * \param subChannel the sub channel for which a value is requested
+  * \param speed the relative speed of the two devices
+  * \return the loss for a particular sub channel
+  */
+  double GetValue (int subChannel, double speed);
+  
+  void SetTraceFileName (std::string fileName);
+  void SetTraceLength (Time t);
+  
+  void LoadTrace ();
+
+
+   
+  mutable std::map <ChannelRealizationId_t, int > m_windowOffsetsMap;
+  
+  mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
+  
+  std::string m_traceFile;
+  
+  /**
+   * The fading samples, per RB in the frequency domain and in the time
+   * domain for each RB
+   */
+  Ptr<const SharedTrace> m_fadingTrace;
+
+  
+  Time m_traceLength;
+  uint32_t m_samplesNum;
+  Time m_windowSize;
+  uint8_t m_rbNum;
+  mutable Time m_lastWindowUpdate;
+  uint8_t m_timeGranularity;
+  
+};
+
+
+
+} // namespace ns3
+
+#endif /* TRACE_FADING_LOSS_MODEL_H */
@@ -176,6 +176,7 @@ UdpEchoClient::SetDataSize (uint32_t dataSize)
   delete [] m_data;
   m_data = 0;
   m_dataSize = 0;
+  m_payload = 0;
   m_size = dataSize;
 }
 
@@ -190,6 +191,7 @@ void
 UdpEchoClient::SetFill (std::string fill)
 {
   NS_LOG_FUNCTION (this << fill);
+  m_payload = 0;
 
   uint32_t dataSize = fill.size () + 1;
 
@@ -212,6 +214,7 @@ void
 UdpEchoClient::SetFill (uint8_t fill, uint32_t dataSize)
 {
   NS_LOG_FUNCTION (this << fill << dataSize);
+  m_payload = 0;
   if (dataSize != m_dataSize)
     {
       delete [] m_data;
@@ -231,6 +234,7 @@ void
 UdpEchoClient::SetFill (uint8_t *fill, uint32_t fillSize, uint32_t dataSize)
 {
   NS_LOG_FUNCTION (this << fill << fillSize << dataSize);
+  m_payload = 0;
   if (dataSize != m_dataSize)
     {
       delete [] m_data;
@@ -291,7 +295,13 @@ UdpEchoClient::Send (void)
       //
       NS_ASSERT_MSG (m_dataSize == m_size, "UdpEchoClient::Send(): m_size and m_dataSize inconsistent");
       NS_ASSERT_MSG (m_data, "UdpEchoClient::Send(): m_dataSize but no m_data");
-      p = Create<Packet> (m_data, m_dataSize);
+      // the data buffer is shared by all the packets we send rather
+      // than copied into each of them.
+      if (m_payload == 0)
+        {
+          m_payload = Create<SharedPayload> (m_data, m_dataSize);
+        }
+      p = Create<Packet> (m_payload);
     }
   else
     {
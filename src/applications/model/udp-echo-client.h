@@ -24,6 +24,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/traced-callback.h"
+#include "ns3/shared-payload.h"
 
 namespace ns3 {
 
@@ -141,6 +142,7 @@ private:
 
   uint32_t m_dataSize;
   uint8_t *m_data;
+  Ptr<const SharedPayload> m_payload;
 
   uint32_t m_sent;
   Ptr<Socket> m_socket;
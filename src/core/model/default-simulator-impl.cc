@@ -38,6 +38,10 @@ NS_LOG_COMPONENT_DEFINE ("DefaultSimulatorImpl");
 
 namespace ns3 {
 
+// number of slots of the ring used to pass events scheduled from
+// other threads to the simulation thread.
+static const uint32_t EVENTS_WITH_CONTEXT_RING_SIZE = 1024;
+
 NS_OBJECT_ENSURE_REGISTERED (DefaultSimulatorImpl);
 
 TypeId
@@ -51,6 +55,9 @@ DefaultSimulatorImpl::GetTypeId (void)
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl ()
+#ifdef HAVE_SYNC_BUILTINS
+  : m_eventsWithContextRing (EVENTS_WITH_CONTEXT_RING_SIZE)
+#endif
 {
   NS_LOG_FUNCTION (this);
   m_stop = false;
@@ -65,6 +72,8 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
   m_eventsWithContextEmpty = true;
+  m_eventsWithContextInjected = 0;
+  m_eventsWithContextDrained = 0;
   m_main = SystemThread::Self();
 }
 
@@ -149,9 +158,40 @@ DefaultSimulatorImpl::IsFinished (void) const
   return m_events->IsEmpty () || m_stop;
 }
 
+void
+DefaultSimulatorImpl::InsertEventWithContext (const EventWithContext &event)
+{
+  Scheduler::Event ev;
+  ev.impl = event.event;
+  ev.key.m_ts = m_currentTs + event.timestamp;
+  ev.key.m_context = event.context;
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  m_eventsWithContextDrained++;
+}
+
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
+#ifdef HAVE_SYNC_BUILTINS
+  // drain at most one ring worth of events to make sure we get back
+  // to the simulation even if other threads keep scheduling events.
+  EventWithContext event;
+  for (uint32_t i = 0; i < EVENTS_WITH_CONTEXT_RING_SIZE
+       && m_eventsWithContextRing.Dequeue (event); i++)
+    {
+      InsertEventWithContext (event);
+    }
+  if (!m_eventsWithContextRing.IsEmpty ())
+    {
+      // events still in the ring were scheduled before those of the
+      // overflow list.
+      return;
+    }
+#endif
+
   if (m_eventsWithContextEmpty)
     {
       return;
@@ -166,16 +206,8 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
   }
   while (!eventsWithContext.empty ())
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
-       Scheduler::Event ev;
-       ev.impl = event.event;
-       ev.key.m_ts = m_currentTs + event.timestamp;
-       ev.key.m_context = event.context;
-       ev.key.m_uid = m_uid;
-       m_uid++;
-       m_unscheduledEvents++;
-       m_events->Insert (ev);
+      InsertEventWithContext (eventsWithContext.front ());
+      eventsWithContext.pop_front ();
     }
 }
 
@@ -259,10 +291,22 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
       ev.context = context;
       ev.timestamp = time.GetTimeStep ();
       ev.event = event;
+#ifdef HAVE_SYNC_BUILTINS
+      __sync_fetch_and_add (&m_eventsWithContextInjected, 1);
+      // once the ring has overflowed, keep using the list until it is
+      // drained to preserve the order of the events of each thread.
+      if (m_eventsWithContextEmpty && m_eventsWithContextRing.Enqueue (ev))
+        {
+          return;
+        }
+#endif
       {
         CriticalSection cs (m_eventsWithContextMutex);
         m_eventsWithContext.push_back(ev);
         m_eventsWithContextEmpty = false;
+#ifndef HAVE_SYNC_BUILTINS
+        m_eventsWithContextInjected++;
+#endif
       }
     }
 }
@@ -404,4 +448,16 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetInjectedEventCount (void) const
+{
+  return m_eventsWithContextInjected;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetDrainedEventCount (void) const
+{
+  return m_eventsWithContextDrained;
+}
+
 } // namespace ns3
@@ -25,7 +25,9 @@
 #include "scheduler.h"
 #include "event-impl.h"
 #include "system-thread.h"
+#include "mpsc-ring.h"
 #include "ns3/system-mutex.h"
+#include "ns3/core-config.h"
 
 #include "ptr.h"
 
@@ -60,6 +62,18 @@ public:
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
 
+  /**
+   * \returns the number of events scheduled with ScheduleWithContext
+   *          from another thread than the simulation thread.
+   */
+  uint64_t GetInjectedEventCount (void) const;
+  /**
+   * \returns the number of events scheduled from another thread than
+   *          the simulation thread which have been moved to the event
+   *          list.
+   */
+  uint64_t GetDrainedEventCount (void) const;
+
 private:
   virtual void DoDispose (void);
   void ProcessOneEvent (void);
@@ -70,10 +84,20 @@ private:
     uint64_t timestamp;
     EventImpl *event;
   };
+  void InsertEventWithContext (const EventWithContext &event);
+
+#ifdef HAVE_SYNC_BUILTINS
+  // events scheduled from other threads are pushed in this ring
+  // without locking and fall back to m_eventsWithContext when it
+  // is full.
+  MpscRing<struct EventWithContext> m_eventsWithContextRing;
+#endif
   typedef std::list<struct EventWithContext> EventsWithContext;
   EventsWithContext m_eventsWithContext;
   bool m_eventsWithContextEmpty;
   SystemMutex m_eventsWithContextMutex;
+  uint64_t m_eventsWithContextInjected;
+  uint64_t m_eventsWithContextDrained;
 
   typedef std::list<EventId> DestroyEvents;
   DestroyEvents m_destroyEvents;
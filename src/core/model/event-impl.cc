@@ -20,11 +20,29 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include "free-list-pool.h"
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
 namespace ns3 {
 
+// event objects are pooled by size classes of 16 bytes, up to 256 bytes,
+// and each thread keeps at most 4096 free blocks of each size class.
+// Larger objects go straight to the general-purpose allocator.
+static FreeListPool g_eventPool (16, 16, 4096);
+
+void *
+EventImpl::operator new (size_t size)
+{
+  return g_eventPool.Allocate (size);
+}
+
+void
+EventImpl::operator delete (void *buffer, size_t size)
+{
+  g_eventPool.Deallocate (buffer, size);
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
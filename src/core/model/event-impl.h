@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 namespace ns3 {
@@ -58,6 +59,23 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * \param size the size of the event object to allocate.
+   * \returns storage for an event object.
+   *
+   * Events are allocated and released at a very high rate so their
+   * storage is recycled through per-thread free lists sorted by size
+   * class rather than returned to the general-purpose allocator. Events
+   * may be released by another thread than the one which allocated
+   * them: each thread keeps a bounded number of free blocks of each size.
+   */
+  static void *operator new (size_t size);
+  /**
+   * \param buffer the storage of the event object to release.
+   * \param size the size of the event object.
+   */
+  static void operator delete (void *buffer, size_t size);
+
 protected:
   virtual void Notify (void) = 0;
 
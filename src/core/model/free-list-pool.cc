@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "free-list-pool.h"
+#include "thread-local.h"
+#include "assert.h"
+#include <new>
+
+#if defined (HAVE_TLS) && defined (HAVE_PTHREAD_H)
+#include <pthread.h>
+#define FREE_LIST_POOL_FLUSH_ON_THREAD_EXIT 1
+#endif
+
+namespace ns3 {
+
+#ifdef HAVE_TLS
+
+// the number of pools and of size classes of each pool
+static const uint32_t FREE_LIST_POOL_MAX_POOLS = 4;
+static const uint32_t FREE_LIST_POOL_MAX_CLASSES = 16;
+
+struct FreeListPoolBlock
+{
+  FreeListPoolBlock *next;
+};
+
+/* The free lists of a thread start as uninitialized (which is what the
+ * zero-initialized storage of the thread-local variable holds), become
+ * initialized upon first use, and destroyed once the static destructors
+ * of this compilation unit have run for the main thread, or when another
+ * thread exits: in this last state, blocks are not pooled anymore.
+ */
+enum FreeListPoolCacheState
+{
+  CACHE_UNINITIALIZED = 0,
+  CACHE_INITIALIZED,
+  CACHE_DESTROYED
+};
+
+struct FreeListPoolCache
+{
+  FreeListPoolBlock *freeList[FREE_LIST_POOL_MAX_POOLS][FREE_LIST_POOL_MAX_CLASSES];
+  uint32_t freeCount[FREE_LIST_POOL_MAX_POOLS][FREE_LIST_POOL_MAX_CLASSES];
+  uint32_t state;
+};
+
+static NS_THREAD_LOCAL struct FreeListPoolCache g_freeListPoolCache;
+static uint32_t g_freeListPoolCount = 0;
+
+static void
+FlushFreeListPoolCache (void *p)
+{
+  struct FreeListPoolCache *cache = static_cast<struct FreeListPoolCache *> (p);
+  for (uint32_t i = 0; i < FREE_LIST_POOL_MAX_POOLS; i++)
+    {
+      for (uint32_t j = 0; j < FREE_LIST_POOL_MAX_CLASSES; j++)
+        {
+          while (cache->freeList[i][j] != 0)
+            {
+              FreeListPoolBlock *block = cache->freeList[i][j];
+              cache->freeList[i][j] = block->next;
+              ::operator delete (block);
+            }
+          cache->freeCount[i][j] = 0;
+        }
+    }
+  cache->state = CACHE_DESTROYED;
+}
+
+static struct FreeListPoolLocalStaticDestructor
+{
+  ~FreeListPoolLocalStaticDestructor ()
+  {
+    FlushFreeListPoolCache (&g_freeListPoolCache);
+  }
+} g_freeListPoolLocalStaticDestructor;
+
+#ifdef FREE_LIST_POOL_FLUSH_ON_THREAD_EXIT
+static pthread_key_t g_freeListPoolKey;
+static pthread_once_t g_freeListPoolKeyOnce = PTHREAD_ONCE_INIT;
+
+static void
+CreateFreeListPoolKey (void)
+{
+  pthread_key_create (&g_freeListPoolKey, &FlushFreeListPoolCache);
+}
+#endif /* FREE_LIST_POOL_FLUSH_ON_THREAD_EXIT */
+
+static struct FreeListPoolCache *
+GetFreeListPoolCache (void)
+{
+  struct FreeListPoolCache *cache = &g_freeListPoolCache;
+  if (cache->state == CACHE_UNINITIALIZED)
+    {
+      cache->state = CACHE_INITIALIZED;
+#ifdef FREE_LIST_POOL_FLUSH_ON_THREAD_EXIT
+      // return the free blocks of other threads to the system when they exit.
+      pthread_once (&g_freeListPoolKeyOnce, &CreateFreeListPoolKey);
+      pthread_setspecific (g_freeListPoolKey, cache);
+#endif
+    }
+  return cache;
+}
+
+#endif /* HAVE_TLS */
+
+FreeListPool::FreeListPool (size_t granularity, uint32_t nClasses, uint32_t maxFree)
+  : m_index (0),
+    m_granularity (granularity),
+    m_nClasses (nClasses),
+    m_maxFree (maxFree)
+{
+  NS_ASSERT (granularity >= sizeof (void *));
+#ifdef HAVE_TLS
+  NS_ASSERT (nClasses <= FREE_LIST_POOL_MAX_CLASSES);
+  NS_ASSERT_MSG (g_freeListPoolCount < FREE_LIST_POOL_MAX_POOLS, "too many free list pools");
+  m_index = g_freeListPoolCount++;
+#endif /* HAVE_TLS */
+}
+
+void *
+FreeListPool::Allocate (size_t size)
+{
+#ifdef HAVE_TLS
+  NS_ASSERT_MSG (m_granularity != 0, "free list pool used before its construction");
+  if (size != 0)
+    {
+      size_t sizeClass = (size - 1) / m_granularity;
+      if (sizeClass < m_nClasses)
+        {
+          struct FreeListPoolCache *cache = GetFreeListPoolCache ();
+          FreeListPoolBlock *block = cache->freeList[m_index][sizeClass];
+          if (block != 0)
+            {
+              cache->freeList[m_index][sizeClass] = block->next;
+              cache->freeCount[m_index][sizeClass]--;
+              return block;
+            }
+          return ::operator new ((sizeClass + 1) * m_granularity);
+        }
+    }
+#endif /* HAVE_TLS */
+  return ::operator new (size);
+}
+
+void
+FreeListPool::Deallocate (void *buffer, size_t size)
+{
+  if (buffer == 0)
+    {
+      return;
+    }
+#ifdef HAVE_TLS
+  if (size != 0)
+    {
+      size_t sizeClass = (size - 1) / m_granularity;
+      struct FreeListPoolCache *cache = GetFreeListPoolCache ();
+      if (sizeClass < m_nClasses
+          && cache->state == CACHE_INITIALIZED
+          && cache->freeCount[m_index][sizeClass] < m_maxFree)
+        {
+          FreeListPoolBlock *block = static_cast<FreeListPoolBlock *> (buffer);
+          block->next = cache->freeList[m_index][sizeClass];
+          cache->freeList[m_index][sizeClass] = block;
+          cache->freeCount[m_index][sizeClass]++;
+          return;
+        }
+    }
+#endif /* HAVE_TLS */
+  ::operator delete (buffer);
+}
+
+} // namespace ns3
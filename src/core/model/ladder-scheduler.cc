@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+namespace ns3 {
+
+// maximum number of events which are sorted into the bottom tier at once.
+// Larger buckets are spread over a new rung.
+static const uint32_t LADDER_THRESHOLD = 50;
+// maximum number of rungs.
+static const uint32_t LADDER_MAX_RUNGS = 8;
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMin (std::numeric_limits<uint64_t>::max ()),
+    m_topMax (0),
+    m_nRungs (0),
+    m_bottomHead (0),
+    m_qSize (0)
+{
+  NS_LOG_FUNCTION (this);
+  // rungs are referenced while new ones are spawned so their storage
+  // must never be reallocated.
+  m_rungs.resize (LADDER_MAX_RUNGS);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::GetCurrentStart (const Rung &rung) const
+{
+  return rung.m_start + rung.m_current * rung.m_width;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  m_qSize++;
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      return;
+    }
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= GetCurrentStart (rung))
+        {
+          uint64_t bucket = (ts - rung.m_start) / rung.m_width;
+          NS_ASSERT (bucket < rung.m_buckets.size ());
+          rung.m_buckets[bucket].push_back (ev);
+          rung.m_count++;
+          return;
+        }
+    }
+  Bucket::iterator i = std::upper_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (), ev);
+  m_bottom.insert (i, ev);
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottomHead == m_bottom.size ())
+    {
+      // moving events down the ladder does not change the content of the queue.
+      const_cast<LadderScheduler *> (this)->Refill ();
+    }
+  return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottomHead == m_bottom.size ())
+    {
+      Refill ();
+    }
+  Scheduler::Event ev = m_bottom[m_bottomHead];
+  m_bottomHead++;
+  m_qSize--;
+  if (m_bottomHead == m_bottom.size ())
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+    }
+  else if (m_bottomHead >= LADDER_THRESHOLD && m_bottomHead * 2 >= m_bottom.size ())
+    {
+      // events keep being inserted in the bottom tier: reclaim the
+      // space of the events already dequeued.
+      m_bottom.erase (m_bottom.begin (), m_bottom.begin () + m_bottomHead);
+      m_bottomHead = 0;
+    }
+  NS_LOG_DEBUG ("remove " << ev.impl << " ts=" << ev.key.m_ts << " uid=" << ev.key.m_uid);
+  return ev;
+}
+
+bool
+LadderScheduler::RemoveFromBucket (Bucket &bucket, const Event &ev)
+{
+  for (Bucket::iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (i->impl == ev.impl);
+          // buckets are not sorted
+          *i = bucket.back ();
+          bucket.pop_back ();
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  m_qSize--;
+  if (ts >= m_topStart)
+    {
+      bool found = RemoveFromBucket (m_top, ev);
+      NS_ASSERT (found);
+      return;
+    }
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= GetCurrentStart (rung))
+        {
+          uint64_t bucket = (ts - rung.m_start) / rung.m_width;
+          bool found = RemoveFromBucket (rung.m_buckets[bucket], ev);
+          NS_ASSERT (found);
+          rung.m_count--;
+          return;
+        }
+    }
+  Bucket::iterator i = std::lower_bound (m_bottom.begin () + m_bottomHead, m_bottom.end (), ev);
+  NS_ASSERT (i != m_bottom.end () && i->key.m_uid == ev.key.m_uid);
+  m_bottom.erase (i);
+  if (m_bottomHead == m_bottom.size ())
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+    }
+}
+
+void
+LadderScheduler::SpawnRung (Bucket &events, uint64_t start, uint64_t width, uint32_t nBuckets)
+{
+  NS_LOG_FUNCTION (this << events.size () << start << width << nBuckets);
+  NS_ASSERT (m_nRungs < LADDER_MAX_RUNGS);
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  rung.m_start = start;
+  rung.m_width = width;
+  rung.m_current = 0;
+  rung.m_count = events.size ();
+  // buckets of previous rungs were all emptied before their rung
+  // was dropped so they can be reused as-is.
+  rung.m_buckets.resize (nBuckets);
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      uint64_t bucket = (i->key.m_ts - start) / width;
+      NS_ASSERT (bucket < nBuckets);
+      rung.m_buckets[bucket].push_back (*i);
+    }
+  events.clear ();
+}
+
+void
+LadderScheduler::TransferToBottom (Bucket &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  NS_ASSERT (m_bottom.empty ());
+  // hand the (empty) storage of the bottom tier over to the source.
+  m_bottom.swap (events);
+  m_bottomHead = 0;
+  std::sort (m_bottom.begin (), m_bottom.end ());
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_qSize > 0);
+  m_bottom.clear ();
+  m_bottomHead = 0;
+  while (true)
+    {
+      if (m_nRungs == 0)
+        {
+          // start a new epoch with the content of the top tier.
+          NS_ASSERT (!m_top.empty ());
+          uint64_t range = m_topMax - m_topMin;
+          uint64_t start = m_topMin;
+          m_topMin = std::numeric_limits<uint64_t>::max ();
+          if (m_top.size () <= LADDER_THRESHOLD || range == 0)
+            {
+              m_topStart = m_topMax + 1;
+              m_topMax = 0;
+              TransferToBottom (m_top);
+              return;
+            }
+          uint64_t width = range / m_top.size () + 1;
+          uint32_t nBuckets = range / width + 1;
+          m_topStart = start + nBuckets * width;
+          m_topMax = 0;
+          SpawnRung (m_top, start, width, nBuckets);
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.m_current < rung.m_buckets.size () && rung.m_buckets[rung.m_current].empty ())
+        {
+          rung.m_current++;
+        }
+      if (rung.m_current == rung.m_buckets.size ())
+        {
+          NS_ASSERT (rung.m_count == 0);
+          m_nRungs--;
+          continue;
+        }
+      uint64_t start = GetCurrentStart (rung);
+      Bucket &bucket = rung.m_buckets[rung.m_current];
+      rung.m_current++;
+      rung.m_count -= bucket.size ();
+      if (bucket.size () <= LADDER_THRESHOLD || rung.m_width == 1 || m_nRungs == LADDER_MAX_RUNGS)
+        {
+          TransferToBottom (bucket);
+          return;
+        }
+      // the bucket is too crowded: spread it over a finer rung.
+      uint32_t nBuckets = bucket.size ();
+      uint64_t width = (rung.m_width + nBuckets - 1) / nBuckets;
+      nBuckets = (rung.m_width + width - 1) / width;
+      SpawnRung (bucket, start, width, nBuckets);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale Discrete
+ * Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and Ian Li-Jin Thng
+ * (ACM TOMACS, 2005). Events are kept in three tiers:
+ *  - Top: an unsorted array which receives all the events scheduled after
+ *    the end of the current epoch.
+ *  - Ladder: a stack of rungs of buckets. When the bottom tier runs dry, the
+ *    top array is spread over a new rung whose bucket width is derived from
+ *    the range of timestamps it holds. Buckets which hold too many events are
+ *    spread over a finer rung instead of being sorted so that the bucket
+ *    width adapts automatically to the distribution of event timestamps.
+ *  - Bottom: a small sorted array from which events are dequeued.
+ *
+ * Unlike the calendar queue, sorting is deferred until events are about to
+ * be dequeued and only involves a handful of events at a time, and all tiers
+ * are stored in contiguous arrays whose storage is reused across epochs.
+ *
+ * Remove is supported but requires a linear search of the tier which holds
+ * the event.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LadderScheduler ();
+  virtual ~LadderScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  struct Rung
+  {
+    // timestamp of the start of the first bucket
+    uint64_t m_start;
+    // duration of a bucket
+    uint64_t m_width;
+    // index of the first bucket which has not been dequeued yet
+    uint32_t m_current;
+    // number of events in the buckets of this rung
+    uint32_t m_count;
+    std::vector<Bucket> m_buckets;
+  };
+
+  void Refill (void);
+  void SpawnRung (Bucket &events, uint64_t start, uint64_t width, uint32_t nBuckets);
+  void TransferToBottom (Bucket &events);
+  uint64_t GetCurrentStart (const Rung &rung) const;
+  static bool RemoveFromBucket (Bucket &bucket, const Event &ev);
+
+  // unsorted events scheduled at or after m_topStart
+  Bucket m_top;
+  uint64_t m_topStart;
+  uint64_t m_topMin;
+  uint64_t m_topMax;
+  // rungs in use, from the coarsest to the finest. Storage for rungs
+  // beyond m_nRungs is kept to be reused.
+  std::vector<Rung> m_rungs;
+  uint32_t m_nRungs;
+  // sorted events, the next event to dequeue is at index m_bottomHead.
+  Bucket m_bottom;
+  uint32_t m_bottomHead;
+  // number of events in queue
+  uint32_t m_qSize;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
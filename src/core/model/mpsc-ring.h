@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include "ns3/core-config.h"
+#include "assert.h"
+#include <stdint.h>
+
+#ifdef HAVE_SYNC_BUILTINS
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief a bounded lock-free queue with multiple producers and a single consumer
+ *
+ * Items can be enqueued concurrently from any number of threads but only
+ * one thread at a time may dequeue them. Each slot carries a sequence
+ * number which tells producers whether the slot is free and the consumer
+ * whether the item it holds has been completely written, so that neither
+ * side ever blocks: Enqueue fails when the ring is full and Dequeue fails
+ * when the next item has not been published yet.
+ *
+ * This class is only available when the compiler supports the GCC
+ * __sync atomic builtins (HAVE_SYNC_BUILTINS).
+ */
+template <typename T>
+class MpscRing
+{
+public:
+  /**
+   * \param size the number of slots of the ring, which must be a power of two.
+   */
+  MpscRing (uint32_t size);
+  ~MpscRing ();
+
+  /**
+   * \param item the item to enqueue.
+   * \returns false if the ring is full, true otherwise.
+   *
+   * May be called from any thread.
+   */
+  bool Enqueue (const T &item);
+  /**
+   * \param item filled with the dequeued item.
+   * \returns false if no item is ready to be dequeued, true otherwise.
+   *
+   * Must only be called from the consumer thread.
+   */
+  bool Dequeue (T &item);
+  /**
+   * \returns true if no item has been enqueued since the last dequeue. Items
+   *          which are being enqueued concurrently may or may not be seen.
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \returns the number of slots of the ring.
+   */
+  uint32_t GetSize (void) const;
+
+private:
+  MpscRing (const MpscRing &o);
+  MpscRing &operator = (const MpscRing &o);
+
+  struct Slot
+  {
+    volatile uint32_t sequence;
+    T item;
+  };
+
+  Slot *m_slots;
+  uint32_t m_mask;
+  // producers and consumer positions are kept apart to avoid
+  // false sharing.
+  char m_pad0[64];
+  volatile uint32_t m_enqueuePos;
+  char m_pad1[64];
+  uint32_t m_dequeuePos;
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+template <typename T>
+MpscRing<T>::MpscRing (uint32_t size)
+  : m_slots (new Slot[size]),
+    m_mask (size - 1),
+    m_enqueuePos (0),
+    m_dequeuePos (0)
+{
+  NS_ASSERT_MSG (size >= 2 && (size & (size - 1)) == 0, "size must be a power of two");
+  for (uint32_t i = 0; i < size; i++)
+    {
+      m_slots[i].sequence = i;
+    }
+  __sync_synchronize ();
+}
+
+template <typename T>
+MpscRing<T>::~MpscRing ()
+{
+  delete [] m_slots;
+}
+
+template <typename T>
+bool
+MpscRing<T>::Enqueue (const T &item)
+{
+  uint32_t pos = m_enqueuePos;
+  Slot *slot;
+  while (true)
+    {
+      slot = &m_slots[pos & m_mask];
+      uint32_t sequence = slot->sequence;
+      __sync_synchronize ();
+      int32_t diff = static_cast<int32_t> (sequence - pos);
+      if (diff == 0)
+        {
+          // the slot is free: try to claim it.
+          if (__sync_bool_compare_and_swap (&m_enqueuePos, pos, pos + 1))
+            {
+              break;
+            }
+          pos = m_enqueuePos;
+        }
+      else if (diff < 0)
+        {
+          // the slot still holds an item from the previous lap.
+          return false;
+        }
+      else
+        {
+          // another producer claimed the slot first.
+          pos = m_enqueuePos;
+        }
+    }
+  slot->item = item;
+  __sync_synchronize ();
+  slot->sequence = pos + 1;
+  return true;
+}
+
+template <typename T>
+bool
+MpscRing<T>::Dequeue (T &item)
+{
+  Slot *slot = &m_slots[m_dequeuePos & m_mask];
+  uint32_t sequence = slot->sequence;
+  __sync_synchronize ();
+  if (sequence != m_dequeuePos + 1)
+    {
+      return false;
+    }
+  item = slot->item;
+  __sync_synchronize ();
+  slot->sequence = m_dequeuePos + m_mask + 1;
+  m_dequeuePos++;
+  return true;
+}
+
+template <typename T>
+bool
+MpscRing<T>::IsEmpty (void) const
+{
+  return m_enqueuePos == m_dequeuePos;
+}
+
+template <typename T>
+uint32_t
+MpscRing<T>::GetSize (void) const
+{
+  return m_mask + 1;
+}
+
+} // namespace ns3
+
+#endif /* HAVE_SYNC_BUILTINS */
+
+#endif /* MPSC_RING_H */
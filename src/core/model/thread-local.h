@@ -0,0 +1,35 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NS3_THREAD_LOCAL_H
+#define NS3_THREAD_LOCAL_H
+
+#include "ns3/core-config.h"
+
+/**
+ * \ingroup core
+ *
+ * Give each thread its own copy of a static variable, when the compiler
+ * supports thread-local storage (HAVE_TLS). Otherwise, the variable is
+ * shared by all the threads, so code which cannot work with a shared
+ * copy must test HAVE_TLS itself.
+ */
+#ifdef HAVE_TLS
+#define NS_THREAD_LOCAL __thread
+#else
+#define NS_THREAD_LOCAL
+#endif
+
+#endif /* NS3_THREAD_LOCAL_H */
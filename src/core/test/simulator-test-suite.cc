@@ -23,6 +23,8 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/random-variable.h"
 
 using namespace ns3;
 
@@ -459,6 +461,99 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the dequeue order of a large number of events " + schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  // compare against the map scheduler with a mix of clustered and
+  // spread timestamps, ties, and removals.
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  UniformVariable uniform;
+  ExponentialVariable exponential (1000.0);
+  std::vector<Scheduler::Event> pending;
+  uint32_t uid = 0;
+  uint64_t now = 0;
+  for (uint32_t round = 0; round < 20000; round++)
+    {
+      uint32_t nInsert = uniform.GetInteger (0, 4);
+      for (uint32_t i = 0; i < nInsert; i++)
+        {
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          switch (uniform.GetInteger (0, 3))
+            {
+            case 0:
+              ev.key.m_ts = now;
+              break;
+            case 1:
+              ev.key.m_ts = now + uniform.GetInteger (0, 10);
+              break;
+            case 2:
+              ev.key.m_ts = now + static_cast<uint64_t> (exponential.GetValue ());
+              break;
+            default:
+              ev.key.m_ts = now + uniform.GetInteger (0, 1000000);
+              break;
+            }
+          scheduler->Insert (ev);
+          reference->Insert (ev);
+          pending.push_back (ev);
+        }
+      if (!pending.empty () && uniform.GetInteger (0, 9) == 0)
+        {
+          uint32_t index = uniform.GetInteger (0, pending.size () - 1);
+          Scheduler::Event ev = pending[index];
+          pending[index] = pending.back ();
+          pending.pop_back ();
+          scheduler->Remove (ev);
+          reference->Remove (ev);
+        }
+      uint32_t nRemove = uniform.GetInteger (0, 3);
+      for (uint32_t i = 0; i < nRemove && !reference->IsEmpty (); i++)
+        {
+          Scheduler::Event expected = reference->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, expected.key.m_uid, "wrong next event");
+          Scheduler::Event ev = scheduler->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.key.m_uid, "wrong event dequeued");
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_ts, expected.key.m_ts, "wrong event timestamp");
+          now = ev.key.m_ts;
+          for (std::vector<Scheduler::Event>::iterator j = pending.begin (); j != pending.end (); ++j)
+            {
+              if (j->key.m_uid == ev.key.m_uid)
+                {
+                  *j = pending.back ();
+                  pending.pop_back ();
+                  break;
+                }
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), reference->IsEmpty (), "wrong queue state");
+    }
+  while (!reference->IsEmpty ())
+    {
+      Scheduler::Event expected = reference->RemoveNext ();
+      Scheduler::Event ev = scheduler->RemoveNext ();
+      NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.key.m_uid, "wrong event dequeued");
+    }
+  NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), true, "queue not empty");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +570,8 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory));
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory));
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory));
+    AddTestCase (new SchedulerOrderTestCase (factory));
   }
 } g_simulatorTestSuite;
@@ -23,9 +23,11 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/system-thread.h"
+#include "ns3/default-simulator-impl.h"
 
 #include <ctime>
 #include <list>
@@ -225,6 +227,96 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+class ThreadedSimulatorInjectionTestCase : public TestCase
+{
+public:
+  ThreadedSimulatorInjectionTestCase ();
+  static void SchedulingThread (std::pair<ThreadedSimulatorInjectionTestCase *, unsigned int> context);
+  void Receive (unsigned int threadno, unsigned int sequence);
+  void Tick (void);
+
+private:
+  virtual void DoRun (void);
+
+  enum { THREADS = 4, EVENTS = 20000 };
+  unsigned int m_expected[THREADS];
+  unsigned int m_received;
+  std::string m_error;
+};
+
+ThreadedSimulatorInjectionTestCase::ThreadedSimulatorInjectionTestCase ()
+  : TestCase ("Check that the events scheduled from other threads are all delivered in order")
+{
+}
+
+void
+ThreadedSimulatorInjectionTestCase::SchedulingThread (std::pair<ThreadedSimulatorInjectionTestCase *, unsigned int> context)
+{
+  ThreadedSimulatorInjectionTestCase *me = context.first;
+  unsigned int threadno = context.second;
+  for (unsigned int i = 0; i < EVENTS; ++i)
+    {
+      Simulator::ScheduleWithContext (threadno, MicroSeconds (1),
+                                      &ThreadedSimulatorInjectionTestCase::Receive, me, threadno, i);
+    }
+}
+
+void
+ThreadedSimulatorInjectionTestCase::Receive (unsigned int threadno, unsigned int sequence)
+{
+  if (m_expected[threadno] != sequence)
+    {
+      m_error = "Events of a thread delivered out of order";
+    }
+  m_expected[threadno] = sequence + 1;
+  m_received++;
+}
+
+void
+ThreadedSimulatorInjectionTestCase::Tick (void)
+{
+  if (m_received < THREADS * EVENTS)
+    {
+      Simulator::Schedule (MicroSeconds (1), &ThreadedSimulatorInjectionTestCase::Tick, this);
+    }
+}
+
+void
+ThreadedSimulatorInjectionTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Ptr<DefaultSimulatorImpl> impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "unexpected simulator implementation");
+
+  m_received = 0;
+  std::list<Ptr<SystemThread> > threads;
+  for (unsigned int i = 0; i < THREADS; ++i)
+    {
+      m_expected[i] = 0;
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (
+                                                 &ThreadedSimulatorInjectionTestCase::SchedulingThread,
+                                                 std::pair<ThreadedSimulatorInjectionTestCase *, unsigned int> (this, i))));
+    }
+  Simulator::Schedule (MicroSeconds (1), &ThreadedSimulatorInjectionTestCase::Tick, this);
+  for (std::list<Ptr<SystemThread> >::iterator i = threads.begin (); i != threads.end (); ++i)
+    {
+      (*i)->Start ();
+    }
+  Simulator::Run ();
+  for (std::list<Ptr<SystemThread> >::iterator i = threads.begin (); i != threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  uint64_t injected = impl->GetInjectedEventCount ();
+  uint64_t drained = impl->GetDrainedEventCount ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_error.empty (), true, m_error);
+  NS_TEST_EXPECT_MSG_EQ (m_received, THREADS * EVENTS, "Events lost");
+  NS_TEST_EXPECT_MSG_EQ (injected, THREADS * EVENTS, "Bad injected event count");
+  NS_TEST_EXPECT_MSG_EQ (drained, THREADS * EVENTS, "Bad drained event count");
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -241,7 +333,8 @@ public:
       "ns3::ListScheduler",
       "ns3::HeapScheduler",
       "ns3::MapScheduler",
-      "ns3::CalendarScheduler"
+      "ns3::CalendarScheduler",
+      "ns3::LadderScheduler"
     };
     unsigned int threadcounts[] = {
       0,
@@ -262,5 +355,6 @@ public:
               }
           }
       }
+    AddTestCase (new ThreadedSimulatorInjectionTestCase ());
   }
 } g_threadedSimulatorTestSuite;
@@ -30,6 +30,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/segment-offload-tag.h"
 #include "csma-net-device.h"
 #include "csma-channel.h"
 
@@ -491,6 +492,18 @@ CsmaNetDevice::TransmitStart (void)
           m_phyTxBeginTrace (m_currentPkt);
 
           Time tEvent = Seconds (m_bps.CalculateTxTime (m_currentPkt->GetSize ()));
+          SegmentOffloadTag offload;
+          if (m_currentPkt->PeekPacketTag (offload) && offload.GetSegments () > 1)
+            {
+              //
+              // A super-segment occupies the channel as long as its segments
+              // would, each in its own frame and followed by an interframe gap.
+              //
+              uint32_t frameOverhead = EthernetHeader (false).GetSerializedSize () + EthernetTrailer ().GetSerializedSize ();
+              uint32_t size = m_currentPkt->GetSize () + offload.GetReplicatedSize (frameOverhead);
+              tEvent = Seconds (m_bps.CalculateTxTime (size))
+                + TimeStep (m_tInterframeGap.GetTimeStep () * (offload.GetSegments () - 1));
+            }
           NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << tEvent.GetSeconds () << "sec");
           Simulator::Schedule (tEvent, &CsmaNetDevice::TransmitCompleteEvent, this);
         }
@@ -1014,6 +1027,17 @@ CsmaNetDevice::SupportsSendFrom () const
   return true;
 }
 
+bool
+CsmaNetDevice::SupportsSegmentOffload () const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  //
+  // The length interpretation of the LLC/SNAP encapsulation cannot describe
+  // a frame larger than the MTU.
+  //
+  return m_encapMode == DIX;
+}
+
 int64_t
 CsmaNetDevice::AssignStreams (int64_t stream)
 {
@@ -321,6 +321,12 @@ public:
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
 
+  /**
+   * \return true in the DIX encapsulation mode, in which the super-segments
+   *         of a transport protocol may be sent without being segmented.
+   */
+  virtual bool SupportsSegmentOffload (void) const;
+
  /**
   * Assign a fixed random variable stream number to the random variables
   * used by this model.  Return the number of streams (possibly zero) that
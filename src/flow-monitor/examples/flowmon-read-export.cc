@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Print the statistics of each flow found in a file written by the
+// streaming export of FlowMonitor (see its ExportFileName attribute), in
+// binary or CSV format. The file can be read while the simulation which
+// writes it is still running.
+//
+//   ./waf --run "flowmon-read-export --file=flows.bin"
+
+#include <iostream>
+#include <map>
+#include "ns3/core-module.h"
+#include "ns3/flow-monitor-export.h"
+
+using namespace ns3;
+
+struct FlowTotals
+{
+  FlowTotals ()
+    : txBytes (0), rxBytes (0), txPackets (0), rxPackets (0), lostPackets (0), evicted (false)
+  {
+  }
+  Ipv4FlowClassifier::FiveTuple tuple;
+  uint64_t txBytes;
+  uint64_t rxBytes;
+  uint64_t txPackets;
+  uint64_t rxPackets;
+  uint64_t lostPackets;
+  Time delaySum;
+  bool evicted;
+};
+
+int
+main (int argc, char *argv[])
+{
+  std::string fileName;
+  CommandLine cmd;
+  cmd.AddValue ("file", "The file written by the FlowMonitor export", fileName);
+  cmd.Parse (argc, argv);
+
+  FlowMonitorExportReader reader;
+  if (!reader.Open (fileName))
+    {
+      std::cerr << "Cannot read the flow monitor export " << fileName << std::endl;
+      return 1;
+    }
+  std::map<FlowId, FlowTotals> flows;
+  FlowMonitorExportRecord record;
+  Time last;
+  uint64_t records = 0;
+  while (reader.Read (record))
+    {
+      records++;
+      last = record.time;
+      FlowTotals &totals = flows[record.flowId];
+      switch (record.type)
+        {
+        case FlowMonitorExportRecord::FLOW:
+          totals.tuple = record.tuple;
+          totals.evicted = false;
+          break;
+        case FlowMonitorExportRecord::DELTA:
+          totals.txBytes += record.txBytes;
+          totals.rxBytes += record.rxBytes;
+          totals.txPackets += record.txPackets;
+          totals.rxPackets += record.rxPackets;
+          totals.lostPackets += record.lostPackets;
+          totals.delaySum += record.delaySum;
+          break;
+        case FlowMonitorExportRecord::EVICTION:
+          totals.evicted = true;
+          break;
+        }
+    }
+
+  std::cout << records << " records, " << flows.size () << " flows, up to " << last.GetSeconds () << "s" << std::endl;
+  for (std::map<FlowId, FlowTotals>::const_iterator i = flows.begin (); i != flows.end (); i++)
+    {
+      const FlowTotals &totals = i->second;
+      std::cout << "Flow " << i->first << " (" << totals.tuple.sourceAddress << ":" << totals.tuple.sourcePort
+                << " -> " << totals.tuple.destinationAddress << ":" << totals.tuple.destinationPort
+                << " proto " << int (totals.tuple.protocol) << ")"
+                << (totals.evicted ? " evicted" : "") << std::endl;
+      std::cout << "  Tx: " << totals.txPackets << " packets, " << totals.txBytes << " bytes" << std::endl;
+      std::cout << "  Rx: " << totals.rxPackets << " packets, " << totals.rxBytes << " bytes" << std::endl;
+      std::cout << "  Lost: " << totals.lostPackets << " packets" << std::endl;
+      if (totals.rxPackets > 0)
+        {
+          std::cout << "  Mean delay: " << totals.delaySum.GetSeconds () / totals.rxPackets << "s" << std::endl;
+        }
+    }
+  return 0;
+}
@@ -0,0 +1,351 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "flow-monitor-export.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowMonitorExport");
+
+static const char g_magic[8] = { 'N', 'S', '3', 'F', 'L', 'O', 'W', 'S' };
+static const uint32_t g_version = 1;
+static const uint32_t g_prefixSize = 13;          // type, time, flowId
+static const uint32_t g_flowSize = 13;            // five-tuple
+static const uint32_t g_deltaSize = 48;           // counters
+static const char g_csvHeader[] = "record,time,flowId,sourceAddress,destinationAddress,protocol,sourcePort,destinationPort,"
+  "txBytes,rxBytes,txPackets,rxPackets,lostPackets,timesForwarded,delaySum,jitterSum";
+
+// Little-endian encoding of the integers of the binary format
+static uint8_t *
+Put (uint8_t *buffer, uint64_t value, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+    {
+      *buffer++ = (value >> (8 * i)) & 0xff;
+    }
+  return buffer;
+}
+
+static const uint8_t *
+Get (const uint8_t *buffer, uint64_t &value, uint32_t size)
+{
+  value = 0;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      value |= uint64_t (*buffer++) << (8 * i);
+    }
+  return buffer;
+}
+
+FlowMonitorExportRecord::FlowMonitorExportRecord ()
+  : type (DELTA),
+    flowId (0),
+    txBytes (0),
+    rxBytes (0),
+    txPackets (0),
+    rxPackets (0),
+    lostPackets (0),
+    timesForwarded (0)
+{
+  tuple.protocol = 0;
+  tuple.sourcePort = 0;
+  tuple.destinationPort = 0;
+}
+
+FlowMonitorExportWriter::FlowMonitorExportWriter ()
+  : m_format (BINARY)
+{
+}
+
+void
+FlowMonitorExportWriter::Open (std::string fileName, enum Format format)
+{
+  NS_LOG_FUNCTION (this << fileName << format);
+  m_format = format;
+  m_stream.open (fileName.c_str (), std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!m_stream.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not create the flow monitor export file " << fileName);
+    }
+  if (m_format == BINARY)
+    {
+      uint8_t version[4];
+      Put (version, g_version, 4);
+      m_stream.write (g_magic, sizeof (g_magic));
+      m_stream.write ((const char *)version, sizeof (version));
+    }
+  else
+    {
+      m_stream << g_csvHeader << "\n";
+    }
+}
+
+bool
+FlowMonitorExportWriter::IsOpen (void) const
+{
+  return m_stream.is_open ();
+}
+
+void
+FlowMonitorExportWriter::Write (const FlowMonitorExportRecord &record)
+{
+  NS_ASSERT (m_stream.is_open ());
+  if (m_format == BINARY)
+    {
+      uint8_t buffer[g_prefixSize + g_deltaSize];
+      uint8_t *p = buffer;
+      p = Put (p, record.type, 1);
+      p = Put (p, record.time.GetNanoSeconds (), 8);
+      p = Put (p, record.flowId, 4);
+      if (record.type == FlowMonitorExportRecord::FLOW)
+        {
+          p = Put (p, record.tuple.sourceAddress.Get (), 4);
+          p = Put (p, record.tuple.destinationAddress.Get (), 4);
+          p = Put (p, record.tuple.protocol, 1);
+          p = Put (p, record.tuple.sourcePort, 2);
+          p = Put (p, record.tuple.destinationPort, 2);
+        }
+      else if (record.type == FlowMonitorExportRecord::DELTA)
+        {
+          p = Put (p, record.txBytes, 8);
+          p = Put (p, record.rxBytes, 8);
+          p = Put (p, record.txPackets, 4);
+          p = Put (p, record.rxPackets, 4);
+          p = Put (p, record.lostPackets, 4);
+          p = Put (p, record.timesForwarded, 4);
+          p = Put (p, record.delaySum.GetNanoSeconds (), 8);
+          p = Put (p, record.jitterSum.GetNanoSeconds (), 8);
+        }
+      m_stream.write ((const char *)buffer, p - buffer);
+      return;
+    }
+  m_stream << char (record.type) << ',' << record.time.GetNanoSeconds () << ',' << record.flowId;
+  if (record.type == FlowMonitorExportRecord::FLOW)
+    {
+      m_stream << ',' << record.tuple.sourceAddress << ',' << record.tuple.destinationAddress
+               << ',' << int (record.tuple.protocol) << ',' << record.tuple.sourcePort
+               << ',' << record.tuple.destinationPort << ",,,,,,,,";
+    }
+  else if (record.type == FlowMonitorExportRecord::DELTA)
+    {
+      m_stream << ",,,,,," << record.txBytes << ',' << record.rxBytes
+               << ',' << record.txPackets << ',' << record.rxPackets
+               << ',' << record.lostPackets << ',' << record.timesForwarded
+               << ',' << record.delaySum.GetNanoSeconds () << ',' << record.jitterSum.GetNanoSeconds ();
+    }
+  else
+    {
+      m_stream << ",,,,,,,,,,,,,";
+    }
+  m_stream << "\n";
+}
+
+void
+FlowMonitorExportWriter::Flush (void)
+{
+  m_stream.flush ();
+}
+
+void
+FlowMonitorExportWriter::Close (void)
+{
+  m_stream.close ();
+}
+
+FlowMonitorExportReader::FlowMonitorExportReader ()
+  : m_format (FlowMonitorExportWriter::BINARY)
+{
+}
+
+bool
+FlowMonitorExportReader::Open (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  m_stream.open (fileName.c_str (), std::ios::in | std::ios::binary);
+  if (!m_stream.is_open ())
+    {
+      return false;
+    }
+  char magic[sizeof (g_magic) + 4];
+  m_stream.read (magic, sizeof (magic));
+  if (m_stream.gcount () == sizeof (magic) && std::memcmp (magic, g_magic, sizeof (g_magic)) == 0)
+    {
+      uint64_t version;
+      Get ((const uint8_t *)magic + sizeof (g_magic), version, 4);
+      m_format = FlowMonitorExportWriter::BINARY;
+      return version == g_version;
+    }
+  m_stream.clear ();
+  m_stream.seekg (0);
+  std::string header;
+  std::getline (m_stream, header);
+  m_format = FlowMonitorExportWriter::CSV;
+  return header == g_csvHeader;
+}
+
+bool
+FlowMonitorExportReader::Read (FlowMonitorExportRecord &record)
+{
+  if (!m_stream.is_open ())
+    {
+      return false;
+    }
+  std::streampos position = m_stream.tellg ();
+  bool complete = (m_format == FlowMonitorExportWriter::BINARY) ? ReadBinary (record) : ReadCsv (record);
+  if (!complete)
+    {
+      // Come back to the beginning of the record, which may be completed
+      // by a simulation in progress
+      m_stream.clear ();
+      m_stream.seekg (position);
+    }
+  return complete;
+}
+
+bool
+FlowMonitorExportReader::ReadBinary (FlowMonitorExportRecord &record)
+{
+  uint8_t buffer[g_prefixSize + g_deltaSize];
+  m_stream.read ((char *)buffer, g_prefixSize);
+  if (m_stream.gcount () != g_prefixSize)
+    {
+      return false;
+    }
+  uint64_t value;
+  const uint8_t *p = buffer;
+  p = Get (p, value, 1);
+  record.type = FlowMonitorExportRecord::Type (value);
+  p = Get (p, value, 8);
+  record.time = NanoSeconds (int64_t (value));
+  p = Get (p, value, 4);
+  record.flowId = value;
+  uint32_t size = 0;
+  switch (record.type)
+    {
+    case FlowMonitorExportRecord::FLOW:
+      size = g_flowSize;
+      break;
+    case FlowMonitorExportRecord::DELTA:
+      size = g_deltaSize;
+      break;
+    case FlowMonitorExportRecord::EVICTION:
+      return true;
+    default:
+      NS_LOG_WARN ("Unknown record type " << int (record.type));
+      return false;
+    }
+  m_stream.read ((char *)buffer, size);
+  if (m_stream.gcount () != size)
+    {
+      return false;
+    }
+  p = buffer;
+  if (record.type == FlowMonitorExportRecord::FLOW)
+    {
+      p = Get (p, value, 4);
+      record.tuple.sourceAddress = Ipv4Address (uint32_t (value));
+      p = Get (p, value, 4);
+      record.tuple.destinationAddress = Ipv4Address (uint32_t (value));
+      p = Get (p, value, 1);
+      record.tuple.protocol = value;
+      p = Get (p, value, 2);
+      record.tuple.sourcePort = value;
+      p = Get (p, value, 2);
+      record.tuple.destinationPort = value;
+      return true;
+    }
+  p = Get (p, record.txBytes, 8);
+  p = Get (p, record.rxBytes, 8);
+  p = Get (p, value, 4);
+  record.txPackets = value;
+  p = Get (p, value, 4);
+  record.rxPackets = value;
+  p = Get (p, value, 4);
+  record.lostPackets = value;
+  p = Get (p, value, 4);
+  record.timesForwarded = value;
+  p = Get (p, value, 8);
+  record.delaySum = NanoSeconds (int64_t (value));
+  p = Get (p, value, 8);
+  record.jitterSum = NanoSeconds (int64_t (value));
+  return true;
+}
+
+bool
+FlowMonitorExportReader::ReadCsv (FlowMonitorExportRecord &record)
+{
+  std::string line;
+  std::getline (m_stream, line);
+  if (m_stream.eof () || m_stream.fail ())
+    {
+      // No line, or a line without its end yet
+      return false;
+    }
+  std::vector<std::string> fields;
+  std::istringstream iss (line);
+  std::string field;
+  while (std::getline (iss, field, ','))
+    {
+      fields.push_back (field);
+    }
+  if (fields.size () < 3 || fields[0].size () != 1)
+    {
+      NS_LOG_WARN ("Skipping malformed record " << line);
+      return ReadCsv (record);
+    }
+  record.type = FlowMonitorExportRecord::Type (fields[0][0]);
+  record.time = NanoSeconds (std::strtoll (fields[1].c_str (), 0, 10));
+  record.flowId = std::strtoul (fields[2].c_str (), 0, 10);
+  if (record.type == FlowMonitorExportRecord::FLOW && fields.size () >= 8)
+    {
+      record.tuple.sourceAddress = Ipv4Address (fields[3].c_str ());
+      record.tuple.destinationAddress = Ipv4Address (fields[4].c_str ());
+      record.tuple.protocol = std::strtoul (fields[5].c_str (), 0, 10);
+      record.tuple.sourcePort = std::strtoul (fields[6].c_str (), 0, 10);
+      record.tuple.destinationPort = std::strtoul (fields[7].c_str (), 0, 10);
+    }
+  else if (record.type == FlowMonitorExportRecord::DELTA && fields.size () >= 16)
+    {
+      record.txBytes = std::strtoull (fields[8].c_str (), 0, 10);
+      record.rxBytes = std::strtoull (fields[9].c_str (), 0, 10);
+      record.txPackets = std::strtoul (fields[10].c_str (), 0, 10);
+      record.rxPackets = std::strtoul (fields[11].c_str (), 0, 10);
+      record.lostPackets = std::strtoul (fields[12].c_str (), 0, 10);
+      record.timesForwarded = std::strtoul (fields[13].c_str (), 0, 10);
+      record.delaySum = NanoSeconds (std::strtoll (fields[14].c_str (), 0, 10));
+      record.jitterSum = NanoSeconds (std::strtoll (fields[15].c_str (), 0, 10));
+    }
+  else if (record.type != FlowMonitorExportRecord::EVICTION)
+    {
+      NS_LOG_WARN ("Skipping malformed record " << line);
+      return ReadCsv (record);
+    }
+  return true;
+}
+
+void
+FlowMonitorExportReader::Close (void)
+{
+  m_stream.close ();
+}
+
+} // namespace ns3
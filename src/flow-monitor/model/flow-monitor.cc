@@ -22,6 +22,10 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -71,6 +75,34 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("SamplingInterval", ("Monitor about one packet in every SamplingInterval packets of each flow, "
+                                        "chosen by a hash of the flow and packet identifiers, so that all the "
+                                        "probes see the same packets.  All the statistics then describe the "
+                                        "monitored packets only.  1 monitors all the packets."),
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FlowMonitor::m_samplingInterval),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ExportFileName", ("The file to which the changes of the flow statistics are appended every "
+                                      "ExportInterval, while the simulation runs.  Empty to disable this export."),
+                   StringValue (""),
+                   MakeStringAccessor (&FlowMonitor::m_exportFileName),
+                   MakeStringChecker ())
+    .AddAttribute ("ExportFormat", ("The format of the export file."),
+                   EnumValue (FlowMonitorExportWriter::BINARY),
+                   MakeEnumAccessor (&FlowMonitor::m_exportFormat),
+                   MakeEnumChecker (FlowMonitorExportWriter::BINARY, "Binary",
+                                    FlowMonitorExportWriter::CSV, "Csv"))
+    .AddAttribute ("ExportInterval", ("The interval between two exports of the flow statistics."),
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&FlowMonitor::m_exportInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("ExportEvictionDelay", ("When the export is enabled, the flows which neither sent nor received "
+                                           "packets for this time are forgotten after their export, so that "
+                                           "GetFlowStats and the XML output only report the flows still active.  "
+                                           "Zero to keep all the flows."),
+                   TimeValue (Seconds (0.0)),
+                   MakeTimeAccessor (&FlowMonitor::m_exportEvictionDelay),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -82,16 +114,62 @@ FlowMonitor::GetInstanceTypeId (void) const
 }
 
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_enabled (false),
+    m_samplingInterval (1),
+    m_exportFormat (FlowMonitorExportWriter::BINARY)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
 
 
+size_t
+FlowMonitor::TrackedPacketKeyHash::operator() (const TrackedPacketKey &key) const
+{
+  return key.first * 0x9e3779b9U ^ key.second;
+}
+
+inline bool
+FlowMonitor::IsSampled (FlowId flowId, FlowPacketId packetId) const
+{
+  if (m_samplingInterval == 1)
+    {
+      return true;
+    }
+  // The packet identifiers may be shared by the flows of a node, so they
+  // are mixed with the flow identifier to avoid sampling some flows only
+  uint32_t h = (packetId ^ (flowId * 0x9e3779b9U)) * 0x85ebca6bU;
+  h ^= h >> 16;
+  return h % m_samplingInterval == 0;
+}
+
+void
+FlowMonitor::ScheduleExpiry (const TrackedPacketKey &key, Time lastSeenTime)
+{
+  ExpiryEntry entry;
+  entry.key = key;
+  entry.lastSeenTime = lastSeenTime;
+  m_expiryQueue.push_back (entry);
+  if (m_expiryQueue.size () > 2 * m_trackedPackets.size () + 1024)
+    {
+      // Most entries are for packets which were received or seen again
+      // since then: drop them so that the queue follows the tracked packets
+      std::deque<ExpiryEntry>::iterator out = m_expiryQueue.begin ();
+      for (std::deque<ExpiryEntry>::iterator in = m_expiryQueue.begin (); in != m_expiryQueue.end (); in++)
+        {
+          TrackedPacketMap::const_iterator tracked = m_trackedPackets.find (in->key);
+          if (tracked != m_trackedPackets.end () && tracked->second.lastSeenTime == in->lastSeenTime)
+            {
+              *out++ = *in;
+            }
+        }
+      m_expiryQueue.erase (out, m_expiryQueue.end ());
+    }
+}
+
 inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
-  std::map<FlowId, FlowStats>::iterator iter;
+  FlowStatsContainer::iterator iter;
   iter = m_flowStats.find (flowId);
   if (iter == m_flowStats.end ())
     {
@@ -121,15 +199,17 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
 void
 FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (flowId, packetId))
     {
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  TrackedPacketKey key (flowId, packetId);
+  TrackedPacket &tracked = m_trackedPackets[key];
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
+  ScheduleExpiry (key, now);
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
@@ -149,11 +229,11 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
 void
 FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (flowId, packetId))
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
+  TrackedPacketKey key (flowId, packetId);
   TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
   if (tracked == m_trackedPackets.end ())
     {
@@ -164,6 +244,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 
   tracked->second.timesForwarded++;
   tracked->second.lastSeenTime = Simulator::Now ();
+  ScheduleExpiry (key, tracked->second.lastSeenTime);
 
   Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
@@ -173,7 +254,7 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
 void
 FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (flowId, packetId))
     {
       return;
     }
@@ -237,7 +318,7 @@ void
 FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetId, uint32_t packetSize,
                          uint32_t reasonCode)
 {
-  if (!m_enabled)
+  if (!m_enabled || !IsSampled (flowId, packetId))
     {
       return;
     }
@@ -269,7 +350,7 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
 std::map<FlowId, FlowMonitor::FlowStats>
 FlowMonitor::GetFlowStats () const
 {
-  return m_flowStats;
+  return std::map<FlowId, FlowStats> (m_flowStats.begin (), m_flowStats.end ());
 }
 
 
@@ -278,24 +359,20 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  while (!m_expiryQueue.empty () && now - m_expiryQueue.front ().lastSeenTime >= maxDelay)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
+      const ExpiryEntry &entry = m_expiryQueue.front ();
+      TrackedPacketMap::iterator tracked = m_trackedPackets.find (entry.key);
+      if (tracked != m_trackedPackets.end () && tracked->second.lastSeenTime == entry.lastSeenTime)
         {
-          // packet is considered lost, add it to the loss statistics
-          std::map<FlowId, FlowStats>::iterator
-            flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+          // packet is considered lost, add it to the loss statistics (the
+          // flow may have been evicted after its export)
+          GetStatsForFlow (entry.key.first).lostPackets++;
 
           // we won't track it anymore
-          m_trackedPackets.erase (iter++);
-        }
-      else
-        {
-          iter++;
+          m_trackedPackets.erase (tracked);
         }
+      m_expiryQueue.pop_front ();
     }
 }
 
@@ -312,6 +389,114 @@ FlowMonitor::PeriodicCheckForLostPackets ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::PeriodicExport ()
+{
+  if (m_exportFileName.empty ())
+    {
+      return;
+    }
+  ExportNow ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
+void
+FlowMonitor::ExportFlow (FlowId flowId, const FlowStats &stats, Time now)
+{
+  sgi::hash_map<FlowId, ExportedStats>::iterator exported = m_exportedStats.find (flowId);
+  if (exported == m_exportedStats.end ())
+    {
+      FlowMonitorExportRecord record;
+      record.type = FlowMonitorExportRecord::FLOW;
+      record.time = now;
+      record.flowId = flowId;
+      Ipv4FlowClassifier *classifier = dynamic_cast<Ipv4FlowClassifier *> (PeekPointer (m_classifier));
+      if (classifier != 0)
+        {
+          record.tuple = classifier->FindFlow (flowId);
+        }
+      m_exportWriter.Write (record);
+      ExportedStats &zero = m_exportedStats[flowId];
+      zero.txBytes = 0;
+      zero.rxBytes = 0;
+      zero.txPackets = 0;
+      zero.rxPackets = 0;
+      zero.lostPackets = 0;
+      zero.timesForwarded = 0;
+      zero.delaySum = Seconds (0);
+      zero.jitterSum = Seconds (0);
+      exported = m_exportedStats.find (flowId);
+    }
+  ExportedStats &last = exported->second;
+  if (stats.txPackets == last.txPackets && stats.rxPackets == last.rxPackets
+      && stats.lostPackets == last.lostPackets)
+    {
+      return;
+    }
+  FlowMonitorExportRecord record;
+  record.type = FlowMonitorExportRecord::DELTA;
+  record.time = now;
+  record.flowId = flowId;
+  record.txBytes = stats.txBytes - last.txBytes;
+  record.rxBytes = stats.rxBytes - last.rxBytes;
+  record.txPackets = stats.txPackets - last.txPackets;
+  record.rxPackets = stats.rxPackets - last.rxPackets;
+  record.lostPackets = stats.lostPackets - last.lostPackets;
+  record.timesForwarded = stats.timesForwarded - last.timesForwarded;
+  record.delaySum = stats.delaySum - last.delaySum;
+  record.jitterSum = stats.jitterSum - last.jitterSum;
+  m_exportWriter.Write (record);
+  last.txBytes = stats.txBytes;
+  last.rxBytes = stats.rxBytes;
+  last.txPackets = stats.txPackets;
+  last.rxPackets = stats.rxPackets;
+  last.lostPackets = stats.lostPackets;
+  last.timesForwarded = stats.timesForwarded;
+  last.delaySum = stats.delaySum;
+  last.jitterSum = stats.jitterSum;
+}
+
+void
+FlowMonitor::ExportNow ()
+{
+  if (m_exportFileName.empty ())
+    {
+      return;
+    }
+  if (!m_exportWriter.IsOpen ())
+    {
+      m_exportWriter.Open (m_exportFileName, m_exportFormat);
+    }
+  Time now = Simulator::Now ();
+  // Export the flows in the order of their identifiers, so that the output
+  // does not depend on the hash tables
+  std::vector<FlowId> flowIds;
+  flowIds.reserve (m_flowStats.size ());
+  for (FlowStatsContainer::const_iterator flow = m_flowStats.begin (); flow != m_flowStats.end (); flow++)
+    {
+      flowIds.push_back (flow->first);
+    }
+  std::sort (flowIds.begin (), flowIds.end ());
+  for (std::vector<FlowId>::const_iterator i = flowIds.begin (); i != flowIds.end (); i++)
+    {
+      FlowStatsContainer::iterator flow = m_flowStats.find (*i);
+      ExportFlow (*i, flow->second, now);
+      if (m_exportEvictionDelay > Seconds (0)
+          && now - std::max (flow->second.timeLastTxPacket, flow->second.timeLastRxPacket) >= m_exportEvictionDelay)
+        {
+          NS_LOG_DEBUG ("Evicting idle flow " << *i);
+          FlowMonitorExportRecord record;
+          record.type = FlowMonitorExportRecord::EVICTION;
+          record.time = now;
+          record.flowId = *i;
+          m_exportWriter.Write (record);
+          m_exportedStats.erase (*i);
+          m_flowStats.erase (flow);
+        }
+    }
+  m_exportWriter.Flush ();
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
@@ -319,6 +504,19 @@ FlowMonitor::NotifyConstructionCompleted ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::DoDispose ()
+{
+  // The export is still running if the monitor was never stopped
+  if (m_exportEvent.IsRunning ())
+    {
+      m_exportEvent.Cancel ();
+      ExportNow ();
+    }
+  m_exportWriter.Close ();
+  Object::DoDispose ();
+}
+
 void
 FlowMonitor::AddProbe (Ptr<FlowProbe> probe)
 {
@@ -363,6 +561,11 @@ FlowMonitor::StartRightNow ()
       return;
     }
   m_enabled = true;
+  if (!m_exportFileName.empty () && !m_exportEvent.IsRunning ())
+    {
+      // The first export creates the file, before any flow is seen
+      PeriodicExport ();
+    }
 }
 
 
@@ -375,6 +578,11 @@ FlowMonitor::StopRightNow ()
     }
   m_enabled = false;
   CheckForLostPackets ();
+  if (m_exportEvent.IsRunning ())
+    {
+      m_exportEvent.Cancel ();
+      ExportNow ();
+    }
 }
 
 void
@@ -392,12 +600,17 @@ FlowMonitor::SerializeToXmlStream (std::ostream &os, int indent, bool enableHist
   indent += 2;
   INDENT (indent); os << "<FlowStats>\n";
   indent += 2;
-  for (std::map<FlowId, FlowStats>::const_iterator flowI = m_flowStats.begin ();
-       flowI != m_flowStats.end (); flowI++)
+  std::map<FlowId, const FlowStats *> sortedFlowStats;
+  for (FlowStatsContainer::const_iterator flow = m_flowStats.begin (); flow != m_flowStats.end (); flow++)
+    {
+      sortedFlowStats[flow->first] = &flow->second;
+    }
+  for (std::map<FlowId, const FlowStats *>::const_iterator flowI = sortedFlowStats.begin ();
+       flowI != sortedFlowStats.end (); flowI++)
     {
 
       INDENT (indent);
-#define ATTRIB(name) << " " # name "=\"" << flowI->second.name << "\""
+#define ATTRIB(name) << " " # name "=\"" << flowI->second->name << "\""
       os << "<Flow flowId=\"" << flowI->first << "\""
       ATTRIB (timeFirstTxPacket)
       ATTRIB (timeFirstRxPacket)
@@ -417,26 +630,26 @@ FlowMonitor::SerializeToXmlStream (std::ostream &os, int indent, bool enableHist
 
 
       indent += 2;
-      for (uint32_t reasonCode = 0; reasonCode < flowI->second.packetsDropped.size (); reasonCode++)
+      for (uint32_t reasonCode = 0; reasonCode < flowI->second->packetsDropped.size (); reasonCode++)
         {
           INDENT (indent);
           os << "<packetsDropped reasonCode=\"" << reasonCode << "\""
-          << " number=\"" << flowI->second.packetsDropped[reasonCode]
+          << " number=\"" << flowI->second->packetsDropped[reasonCode]
           << "\" />\n";
         }
-      for (uint32_t reasonCode = 0; reasonCode < flowI->second.bytesDropped.size (); reasonCode++)
+      for (uint32_t reasonCode = 0; reasonCode < flowI->second->bytesDropped.size (); reasonCode++)
         {
           INDENT (indent);
           os << "<bytesDropped reasonCode=\"" << reasonCode << "\""
-          << " bytes=\"" << flowI->second.bytesDropped[reasonCode]
+          << " bytes=\"" << flowI->second->bytesDropped[reasonCode]
           << "\" />\n";
         }
       if (enableHistograms)
         {
-          flowI->second.delayHistogram.SerializeToXmlStream (os, indent, "delayHistogram");
-          flowI->second.jitterHistogram.SerializeToXmlStream (os, indent, "jitterHistogram");
-          flowI->second.packetSizeHistogram.SerializeToXmlStream (os, indent, "packetSizeHistogram");
-          flowI->second.flowInterruptionsHistogram.SerializeToXmlStream (os, indent, "flowInterruptionsHistogram");
+          flowI->second->delayHistogram.SerializeToXmlStream (os, indent, "delayHistogram");
+          flowI->second->jitterHistogram.SerializeToXmlStream (os, indent, "jitterHistogram");
+          flowI->second->packetSizeHistogram.SerializeToXmlStream (os, indent, "packetSizeHistogram");
+          flowI->second->flowInterruptionsHistogram.SerializeToXmlStream (os, indent, "flowInterruptionsHistogram");
         }
       indent -= 2;
 
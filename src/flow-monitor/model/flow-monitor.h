@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <map>
+#include <deque>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -31,6 +32,8 @@
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/sgi-hashmap.h"
+#include "ns3/flow-monitor-export.h"
 
 namespace ns3 {
 
@@ -201,10 +204,19 @@ public:
   /// \param enableProbes if true, include also the per-probe/flow pair statistics in the output
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
+  /// Append to the file set by the ExportFileName attribute the changes
+  /// of the flow statistics since the last export, then evict the flows
+  /// idle for longer than ExportEvictionDelay.  This happens every
+  /// ExportInterval from the start of the monitor, and once more when it
+  /// stops or is disposed; call it to export the last changes of a
+  /// simulation that neither stops nor disposes the monitor.
+  void ExportNow ();
+
 
 protected:
 
   virtual void NotifyConstructionCompleted ();
+  virtual void DoDispose ();
 
 private:
 
@@ -216,11 +228,28 @@ private:
   };
 
   // FlowId --> FlowStats
-  std::map<FlowId, FlowStats> m_flowStats;
+  typedef sgi::hash_map<FlowId, FlowStats> FlowStatsContainer;
+  FlowStatsContainer m_flowStats;
 
   // (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  typedef std::pair<FlowId, FlowPacketId> TrackedPacketKey;
+  struct TrackedPacketKeyHash
+  {
+    size_t operator() (const TrackedPacketKey &key) const;
+  };
+  typedef sgi::hash_map<TrackedPacketKey, TrackedPacket, TrackedPacketKeyHash> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets;
+
+  // The tracked packets in the order of their last report, which is the
+  // order in which they may be considered lost. A packet gets a new entry
+  // each time that it is seen, and the entries which no longer match the
+  // last time that their packet was seen are skipped.
+  struct ExpiryEntry
+  {
+    TrackedPacketKey key;
+    Time lastSeenTime;
+  };
+  std::deque<ExpiryEntry> m_expiryQueue;
   Time m_maxPerHopDelay;
   std::vector< Ptr<FlowProbe> > m_flowProbes;
 
@@ -235,9 +264,34 @@ private:
   double m_packetSizeBinWidth;
   double m_flowInterruptionsBinWidth;
   Time m_flowInterruptionsMinTime;
+  uint32_t m_samplingInterval;
+
+  // The counters of each flow at its last export, to export their changes
+  struct ExportedStats
+  {
+    uint64_t txBytes;
+    uint64_t rxBytes;
+    uint32_t txPackets;
+    uint32_t rxPackets;
+    uint32_t lostPackets;
+    uint32_t timesForwarded;
+    Time delaySum;
+    Time jitterSum;
+  };
+  sgi::hash_map<FlowId, ExportedStats> m_exportedStats;
+  std::string m_exportFileName;
+  enum FlowMonitorExportWriter::Format m_exportFormat;
+  Time m_exportInterval;
+  Time m_exportEvictionDelay;
+  FlowMonitorExportWriter m_exportWriter;
+  EventId m_exportEvent;
 
   FlowStats& GetStatsForFlow (FlowId flowId);
+  bool IsSampled (FlowId flowId, FlowPacketId packetId) const;
+  void ScheduleExpiry (const TrackedPacketKey &key, Time lastSeenTime);
   void PeriodicCheckForLostPackets ();
+  void PeriodicExport ();
+  void ExportFlow (FlowId flowId, const FlowStats &stats, Time now);
 };
 
 
@@ -22,10 +22,11 @@
 #define IPV4_FLOW_CLASSIFIER_H
 
 #include <stdint.h>
-#include <map>
+#include <vector>
 
 #include "ns3/ipv4-header.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 
@@ -63,7 +64,16 @@ public:
 
 private:
 
-  std::map<FiveTuple, FlowId> m_flowMap;
+  struct FiveTupleHash
+  {
+    size_t operator() (const FiveTuple &tuple) const;
+  };
+
+  // FiveTuple --> FlowId
+  typedef sgi::hash_map<FiveTuple, FlowId, FiveTupleHash> FlowMap;
+  FlowMap m_flowMap;
+  // FlowId - 1 --> FiveTuple, the flow identifiers being allocated in sequence
+  std::vector<FiveTuple> m_flows;
 
 };
 
@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/flow-monitor-export.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/test.h"
+
+namespace ns3 {
+
+// The probes report the packets to the monitor directly
+class FlowMonitorTestProbe : public FlowProbe
+{
+public:
+  FlowMonitorTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+class FlowMonitorLossTestCase : public TestCase
+{
+public:
+  FlowMonitorLossTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowMonitorLossTestCase::FlowMonitorLossTestCase ()
+  : TestCase ("Check that the packets are considered lost after MaxPerHopDelay without report")
+{
+}
+
+void
+FlowMonitorLossTestCase::DoRun (void)
+{
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->StartRightNow ();
+  Ptr<FlowProbe> probe = Create<FlowMonitorTestProbe> (monitor);
+  FlowId flow = 1;
+
+  for (FlowPacketId id = 1; id <= 3; id++)
+    {
+      Simulator::Schedule (Seconds (0), &FlowMonitor::ReportFirstTx, monitor, probe, flow, id, 100);
+    }
+  Simulator::Schedule (Seconds (1), &FlowMonitor::ReportForwarding, monitor, probe, flow, 2, 100);
+  Simulator::Schedule (Seconds (2), &FlowMonitor::ReportLastRx, monitor, probe, flow, 3, 100);
+  Simulator::Schedule (Seconds (3), &FlowMonitor::ReportFirstTx, monitor, probe, flow, 4, 100);
+  // A packet identifier used again after the first packet was received
+  Simulator::Schedule (Seconds (0), &FlowMonitor::ReportFirstTx, monitor, probe, flow, 5, 100);
+  Simulator::Schedule (Seconds (0.5), &FlowMonitor::ReportLastRx, monitor, probe, flow, 5, 100);
+  Simulator::Schedule (Seconds (4), &FlowMonitor::ReportFirstTx, monitor, probe, flow, 5, 100);
+  Simulator::Stop (Seconds (10.5));
+  Simulator::Run ();
+
+  // The periodic check at 10s found the first packet only
+  FlowMonitor::FlowStats stats = monitor->GetFlowStats ()[flow];
+  NS_TEST_EXPECT_MSG_EQ (stats.txPackets, 6, "wrong number of packets sent");
+  NS_TEST_EXPECT_MSG_EQ (stats.rxPackets, 2, "wrong number of packets received");
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, 1, "only the first packet should be lost");
+
+  monitor->CheckForLostPackets (Seconds (8));
+  stats = monitor->GetFlowStats ()[flow];
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, 2, "the forwarded packet should be lost too");
+
+  monitor->CheckForLostPackets (Seconds (0));
+  stats = monitor->GetFlowStats ()[flow];
+  NS_TEST_EXPECT_MSG_EQ (stats.lostPackets, 4, "all the packets in flight should be lost");
+  NS_TEST_EXPECT_MSG_EQ (stats.timesForwarded, 0, "the forwarded packet was not received");
+  Simulator::Destroy ();
+}
+
+class FlowMonitorSamplingTestCase : public TestCase
+{
+public:
+  FlowMonitorSamplingTestCase ();
+  virtual void DoRun (void);
+};
+
+FlowMonitorSamplingTestCase::FlowMonitorSamplingTestCase ()
+  : TestCase ("Check that each flow is sampled at the SamplingInterval rate")
+{
+}
+
+void
+FlowMonitorSamplingTestCase::DoRun (void)
+{
+  const uint32_t flows = 10;
+  const uint32_t packets = 4000;
+  const uint32_t interval = 4;
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("SamplingInterval", UintegerValue (interval));
+  monitor->StartRightNow ();
+  Ptr<FlowProbe> probe = Create<FlowMonitorTestProbe> (monitor);
+
+  // The flows share the packet identifiers, as those of a node do
+  for (FlowPacketId id = 0; id < packets; id++)
+    {
+      FlowId flow = 1 + id % flows;
+      monitor->ReportFirstTx (probe, flow, id, 100);
+      monitor->ReportForwarding (probe, flow, id, 100);
+      monitor->ReportLastRx (probe, flow, id, 100);
+    }
+  std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.size (), flows, "every flow should be sampled");
+  for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin (); i != stats.end (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (i->second.txPackets, packets / flows / interval, 30, "wrong sampling of flow " << i->first);
+      NS_TEST_EXPECT_MSG_EQ (i->second.rxPackets, i->second.txPackets, "the sampled packets should all be received");
+      NS_TEST_EXPECT_MSG_EQ (i->second.timesForwarded, i->second.txPackets, "the sampled packets are forwarded once");
+    }
+  monitor->CheckForLostPackets (Seconds (0));
+  for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator i = stats.begin (); i != stats.end (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (monitor->GetFlowStats ()[i->first].lostPackets, 0, "no packet was lost");
+    }
+  Simulator::Destroy ();
+}
+
+class FlowMonitorExportTestCase : public TestCase
+{
+public:
+  FlowMonitorExportTestCase (enum FlowMonitorExportWriter::Format format);
+  virtual void DoRun (void);
+
+private:
+  void Send (Ptr<FlowMonitor> monitor, Ptr<FlowProbe> probe, FlowId flow, FlowPacketId id, bool received);
+
+  enum FlowMonitorExportWriter::Format m_format;
+};
+
+FlowMonitorExportTestCase::FlowMonitorExportTestCase (enum FlowMonitorExportWriter::Format format)
+  : TestCase (std::string ("Check that the ") + (format == FlowMonitorExportWriter::CSV ? "CSV" : "binary")
+              + " export adds up to the flow statistics"),
+    m_format (format)
+{
+}
+
+void
+FlowMonitorExportTestCase::Send (Ptr<FlowMonitor> monitor, Ptr<FlowProbe> probe, FlowId flow, FlowPacketId id, bool received)
+{
+  monitor->ReportFirstTx (probe, flow, id, 100);
+  if (received)
+    {
+      Simulator::Schedule (MilliSeconds (10), &FlowMonitor::ReportLastRx, monitor, probe, flow, id, 100);
+    }
+}
+
+void
+FlowMonitorExportTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flowmon-export");
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  monitor->SetAttribute ("ExportFormat", EnumValue (m_format));
+  monitor->SetAttribute ("ExportEvictionDelay", TimeValue (Seconds (2)));
+  monitor->SetAttribute ("ExportFileName", StringValue (fileName));
+  monitor->StartRightNow ();
+  Ptr<FlowProbe> probe = Create<FlowMonitorTestProbe> (monitor);
+
+  // Flow 1 ends early, flow 2 pauses for longer than the eviction delay,
+  // the packet of flow 3 is lost
+  for (FlowPacketId id = 1; id <= 5; id++)
+    {
+      Simulator::Schedule (Seconds (0.1 * id), &FlowMonitorExportTestCase::Send, this, monitor, probe, 1, id, true);
+    }
+  Simulator::Schedule (Seconds (0.2), &FlowMonitorExportTestCase::Send, this, monitor, probe, 2, 1, true);
+  Simulator::Schedule (Seconds (3.5), &FlowMonitorExportTestCase::Send, this, monitor, probe, 2, 2, true);
+  Simulator::Schedule (Seconds (0.3), &FlowMonitorExportTestCase::Send, this, monitor, probe, 3, 1, false);
+  Simulator::Stop (Seconds (5.2));
+  Simulator::Run ();
+  monitor->CheckForLostPackets (Seconds (0));
+  // Stopping the monitor does the last export
+  monitor->StopRightNow ();
+
+  // The idle flows were forgotten; flow 3 came back with its loss, which
+  // was exported before the flow was evicted again
+  std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats ();
+  NS_TEST_EXPECT_MSG_EQ (stats.size (), 1, "only flow 2 should be left");
+  NS_TEST_EXPECT_MSG_EQ (stats.count (2), 1, "only flow 2 should be left");
+
+  FlowMonitorExportReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (fileName), true, "cannot read the export");
+  std::map<FlowId, FlowMonitorExportRecord> totals;
+  std::map<FlowId, uint32_t> flowRecords;
+  std::map<FlowId, uint32_t> evictions;
+  FlowMonitorExportRecord record;
+  Time last;
+  while (reader.Read (record))
+    {
+      NS_TEST_EXPECT_MSG_EQ ((record.time >= last), true, "the records should be in time order");
+      last = record.time;
+      FlowMonitorExportRecord &total = totals[record.flowId];
+      switch (record.type)
+        {
+        case FlowMonitorExportRecord::FLOW:
+          flowRecords[record.flowId]++;
+          break;
+        case FlowMonitorExportRecord::DELTA:
+          total.txBytes += record.txBytes;
+          total.rxBytes += record.rxBytes;
+          total.txPackets += record.txPackets;
+          total.rxPackets += record.rxPackets;
+          total.lostPackets += record.lostPackets;
+          total.delaySum += record.delaySum;
+          break;
+        case FlowMonitorExportRecord::EVICTION:
+          evictions[record.flowId]++;
+          NS_TEST_EXPECT_MSG_EQ ((record.time == Seconds (3) || record.flowId == 3), true, "wrong eviction time");
+          break;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (last, Seconds (5.2), "the last export is missing");
+  NS_TEST_EXPECT_MSG_EQ (totals[1].txPackets, 5, "wrong flow 1");
+  NS_TEST_EXPECT_MSG_EQ (totals[1].rxBytes, 500, "wrong flow 1");
+  NS_TEST_EXPECT_MSG_EQ (totals[1].delaySum, MilliSeconds (50), "wrong flow 1");
+  NS_TEST_EXPECT_MSG_EQ (totals[2].txPackets, 2, "wrong flow 2");
+  NS_TEST_EXPECT_MSG_EQ (totals[2].rxPackets, 2, "wrong flow 2");
+  NS_TEST_EXPECT_MSG_EQ (totals[3].txPackets, 1, "wrong flow 3");
+  NS_TEST_EXPECT_MSG_EQ (totals[3].rxPackets, 0, "wrong flow 3");
+  NS_TEST_EXPECT_MSG_EQ (totals[3].lostPackets, 1, "wrong flow 3");
+  NS_TEST_EXPECT_MSG_EQ (flowRecords[1], 1, "flow 1 is defined once");
+  NS_TEST_EXPECT_MSG_EQ (flowRecords[2], 2, "flow 2 is defined again after its eviction");
+  NS_TEST_EXPECT_MSG_EQ (flowRecords[3], 2, "flow 3 is defined again for its loss");
+  NS_TEST_EXPECT_MSG_EQ (evictions[1], 1, "flow 1 is evicted once");
+  NS_TEST_EXPECT_MSG_EQ (evictions[2], 1, "flow 2 is evicted once");
+  NS_TEST_EXPECT_MSG_EQ (evictions[3], 2, "flow 3 is evicted after its loss too");
+  Simulator::Destroy ();
+}
+
+class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite ()
+  : TestSuite ("flow-monitor", UNIT)
+{
+  AddTestCase (new FlowMonitorLossTestCase);
+  AddTestCase (new FlowMonitorSamplingTestCase);
+  AddTestCase (new FlowMonitorExportTestCase (FlowMonitorExportWriter::BINARY));
+  AddTestCase (new FlowMonitorExportTestCase (FlowMonitorExportWriter::CSV));
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite;
+
+} // namespace ns3
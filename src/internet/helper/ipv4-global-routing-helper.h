@@ -81,6 +81,9 @@ public:
    * Users must first call PopulateRoutingTables() and then may subsequently
    * call RecomputeRoutingTables() at any later time in the simulation.
    *
+   * When the GlobalRoutingIncrementalSpf global value is set, only the
+   * routers whose shortest path tree depends on a link state advertisement
+   * which changed get their routes removed and computed again.
    */
   static void RecomputeRoutingTables (void);
 private:
@@ -44,22 +44,26 @@ operator<< (std::ostream& os, const CandidateQueue& q)
 {
   typedef CandidateQueue::CandidateList_t List_t;
   typedef List_t::const_iterator CIter_t;
-  const CandidateQueue::CandidateList_t& list = q.m_candidates;
+  // print the candidates in the order they will be popped.
+  List_t list = q.m_candidates;
+  std::sort (list.begin (), list.end (), &CandidateQueue::IsBefore);
 
   os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
   for (CIter_t iter = list.begin (); iter != list.end (); iter++)
     {
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << iter->vertex->GetVertexId () << ", "
+      << iter->vertex->GetDistanceFromRoot () << ", "
+      << iter->vertex->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_candidates (),
+    m_index (),
+    m_sequence (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -87,11 +91,12 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  Candidate candidate;
+  candidate.vertex = vNew;
+  candidate.sequence = m_sequence++;
+  m_candidates.push_back (candidate);
+  m_index[vNew->GetVertexId ()] = m_candidates.size () - 1;
+  SiftUp (m_candidates.size () - 1);
 }
 
 SPFVertex *
@@ -103,8 +108,14 @@ CandidateQueue::Pop (void)
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  SPFVertex *v = m_candidates.front ().vertex;
+  Swap (0, m_candidates.size () - 1);
+  m_candidates.pop_back ();
+  m_index.erase (v->GetVertexId ());
+  if (!m_candidates.empty ())
+    {
+      SiftDown (0);
+    }
   return v;
 }
 
@@ -117,7 +128,7 @@ CandidateQueue::Top (void) const
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_candidates.front ().vertex;
 }
 
 bool
@@ -138,18 +149,12 @@ SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION_NOARGS ();
-  CandidateList_t::const_iterator i = m_candidates.begin ();
-
-  for (; i != m_candidates.end (); i++)
+  CandidateIndex_t::const_iterator i = m_index.find (addr);
+  if (i == m_index.end ())
     {
-      SPFVertex *v = *i;
-      if (v->GetVertexId () == addr)
-        {
-          return v;
-        }
+      return 0;
     }
-
-  return 0;
+  return m_candidates[i->second].vertex;
 }
 
 void
@@ -157,11 +162,93 @@ CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  for (uint32_t i = m_candidates.size () / 2; i > 0; i--)
+    {
+      SiftDown (i - 1);
+    }
+  NS_LOG_LOGIC ("After reordering the CandidateQueue");
+  NS_LOG_LOGIC (*this);
+}
+
+void
+CandidateQueue::Reorder (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+
+  CandidateIndex_t::const_iterator i = m_index.find (v->GetVertexId ());
+  NS_ASSERT_MSG (i != m_index.end () && m_candidates[i->second].vertex == v,
+                 "CandidateQueue::Reorder (): vertex not in the queue");
+  // the vertex now goes after the candidates which were already at its
+  // new distance.
+  m_candidates[i->second].sequence = m_sequence++;
+  SiftUp (i->second);
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+bool
+CandidateQueue::IsBefore (const Candidate &c1, const Candidate &c2)
+{
+  if (CompareSPFVertex (c1.vertex, c2.vertex))
+    {
+      return true;
+    }
+  if (CompareSPFVertex (c2.vertex, c1.vertex))
+    {
+      return false;
+    }
+  return c1.sequence < c2.sequence;
+}
+
+void
+CandidateQueue::Swap (uint32_t i, uint32_t j)
+{
+  std::swap (m_candidates[i], m_candidates[j]);
+  m_index[m_candidates[i].vertex->GetVertexId ()] = i;
+  m_index[m_candidates[j].vertex->GetVertexId ()] = j;
+}
+
+void
+CandidateQueue::SiftUp (uint32_t i)
+{
+  while (i > 0)
+    {
+      uint32_t parent = (i - 1) / 2;
+      if (!IsBefore (m_candidates[i], m_candidates[parent]))
+        {
+          break;
+        }
+      Swap (i, parent);
+      i = parent;
+    }
+}
+
+void
+CandidateQueue::SiftDown (uint32_t i)
+{
+  uint32_t n = m_candidates.size ();
+  while (true)
+    {
+      uint32_t first = i;
+      uint32_t left = 2 * i + 1;
+      uint32_t right = left + 1;
+      if (left < n && IsBefore (m_candidates[left], m_candidates[first]))
+        {
+          first = left;
+        }
+      if (right < n && IsBefore (m_candidates[right], m_candidates[first]))
+        {
+          first = right;
+        }
+      if (first == i)
+        {
+          break;
+        }
+      Swap (i, first);
+      i = first;
+    }
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -22,8 +22,9 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 
@@ -45,6 +46,11 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The queue is a binary heap indexed by vertex ID, so that Push (), Pop ()
+ * and Reorder (SPFVertex*) are logarithmic and Find () is constant time.
+ * Vertices which compare equal are popped in the order they were pushed,
+ * a vertex whose distance was decreased counting as pushed again.
  */
 class CandidateQueue
 {
@@ -162,6 +168,19 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Restores the order of the Candidate Queue after the distance of
+ * one of its vertices decreased.
+ * @internal
+ *
+ * This is equivalent to, but much cheaper than, Reorder () when a single
+ * vertex changed.
+ *
+ * @see SPFVertex
+ * @param v The vertex whose m_distanceFromRoot decreased.
+ */
+  void Reorder (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -189,8 +208,25 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t;
+  /**
+   * An element of the heap: the vertex and the order in which it was
+   * pushed, which breaks the ties of CompareSPFVertex ().
+   */
+  struct Candidate
+  {
+    SPFVertex *vertex;
+    uint32_t sequence;
+  };
+  static bool IsBefore (const Candidate &c1, const Candidate &c2);
+  void Swap (uint32_t i, uint32_t j);
+  void SiftUp (uint32_t i);
+  void SiftDown (uint32_t i);
+
+  typedef std::vector<Candidate> CandidateList_t;
+  typedef sgi::hash_map<Ipv4Address, uint32_t, Ipv4AddressHash> CandidateIndex_t;
   CandidateList_t m_candidates;
+  CandidateIndex_t m_index; //!< position of each vertex in m_candidates
+  uint32_t m_sequence;
 
   friend std::ostream& operator<< (std::ostream& os, const CandidateQueue& q);
 };
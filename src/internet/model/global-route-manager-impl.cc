@@ -27,6 +27,7 @@
 #include <queue>
 #include <algorithm>
 #include <iostream>
+#include <unistd.h>
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -35,15 +36,40 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/core-config.h"
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
 #include "ipv4-global-routing.h"
 
+#ifdef HAVE_PTHREAD_H
+#define NS3_GLOBAL_ROUTING_THREADS 1
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#endif
+
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManager");
 
 namespace ns3 {
 
+static GlobalValue g_spfThreads = GlobalValue ("GlobalRoutingSpfThreads",
+                                               "The number of threads which compute the SPF trees of the "
+                                               "global routers, zero for one per processor",
+                                               UintegerValue (1),
+                                               MakeUintegerChecker<uint32_t> ());
+
+static GlobalValue g_incrementalSpf = GlobalValue ("GlobalRoutingIncrementalSpf",
+                                                   "When recomputing the global routes, only compute again "
+                                                   "the routes of the routers affected by a change of the LSDB",
+                                                   BooleanValue (false),
+                                                   MakeBooleanChecker ());
+
+// number of roots each thread computes before their routes are installed.
+static const uint32_t SPF_ROOTS_PER_THREAD = 32;
+
 std::ostream& 
 operator<< (std::ostream& os, const SPFVertex::NodeExit_t& exit)
 {
@@ -413,6 +439,7 @@ SPFVertex::ClearVertexProcessed (void)
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB ()
   :
     m_database (),
+    m_linkDataIndex (),
     m_extdatabase ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -436,6 +463,7 @@ GlobalRouteManagerLSDB::~GlobalRouteManagerLSDB ()
     }
   NS_LOG_LOGIC ("clear map");
   m_database.clear ();
+  m_linkDataIndex.clear ();
 }
 
 void
@@ -458,9 +486,26 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
       m_extdatabase.push_back (lsa);
     } 
-  else
+  else if (m_database.insert (LSDBPair_t (addr, lsa)).second)
     {
-      m_database.insert (LSDBPair_t (addr, lsa));
+//
+// Index the transit network link records.  Should several LSAs have the same
+// link data, the one with the lowest link state ID is found.
+//
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          if (lr->GetLinkType () != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              continue;
+            }
+          std::pair<LSDBMap_t::iterator, bool> inserted = 
+            m_linkDataIndex.insert (LSDBPair_t (lr->GetLinkData (), lsa));
+          if (!inserted.second && addr < inserted.first->second->GetLinkStateId ())
+            {
+              inserted.first->second = lsa;
+            }
+        }
     }
 }
 
@@ -483,15 +528,12 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i == m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return 0;
     }
-  return 0;
+  return i->second;
 }
 
 GlobalRoutingLSA*
@@ -499,24 +541,228 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (addr);
 //
-// Look up an LSA by its address.
+// Look up an LSA by the link data of one of its transit network records.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_linkDataIndex.find (addr);
+  if (i == m_linkDataIndex.end ())
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
+      return 0;
+    }
+  return i->second;
+}
+
+GlobalRouteManagerLSDB*
+GlobalRouteManagerLSDB::Copy (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GlobalRouteManagerLSDB* copy = new GlobalRouteManagerLSDB ();
+  for (LSDBMap_t::const_iterator i = m_database.begin (); i != m_database.end (); i++)
+    {
+      copy->Insert (i->first, new GlobalRoutingLSA (*i->second));
+    }
+  for (uint32_t j = 0; j < m_extdatabase.size (); j++)
+    {
+      copy->Insert (m_extdatabase[j]->GetLinkStateId (), new GlobalRoutingLSA (*m_extdatabase[j]));
+    }
+  return copy;
+}
+
+bool
+GlobalRouteManagerLSDB::IsSameLSA (GlobalRoutingLSA* a, GlobalRoutingLSA* b)
+{
+  if (a->GetLSType () != b->GetLSType ()
+      || a->GetLinkStateId () != b->GetLinkStateId ()
+      || a->GetAdvertisingRouter () != b->GetAdvertisingRouter ()
+      || a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNode () != b->GetNode ()
+      || a->GetNLinkRecords () != b->GetNLinkRecords ()
+      || a->GetNAttachedRouters () != b->GetNAttachedRouters ())
+    {
+      return false;
+    }
+  for (uint32_t i = 0; i < a->GetNLinkRecords (); i++)
+    {
+      GlobalRoutingLinkRecord *la = a->GetLinkRecord (i);
+      GlobalRoutingLinkRecord *lb = b->GetLinkRecord (i);
+      if (la->GetLinkType () != lb->GetLinkType ()
+          || la->GetLinkId () != lb->GetLinkId ()
+          || la->GetLinkData () != lb->GetLinkData ()
+          || la->GetMetric () != lb->GetMetric ())
         {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
-            {
-              return temp;
-            }
+          return false;
         }
     }
-  return 0;
+  for (uint32_t i = 0; i < a->GetNAttachedRouters (); i++)
+    {
+      if (a->GetAttachedRouter (i) != b->GetAttachedRouter (i))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+//
+// Two versions of an LSA give their vertex the same routes to its own
+// prefixes if they have the same stub networks, the same local addresses on
+// their point-to-point links (see SPFIntraAddRouter) and the same mask.
+//
+bool
+GlobalRouteManagerLSDB::IsSameVertex (GlobalRoutingLSA* a, GlobalRoutingLSA* b)
+{
+  if (a->GetLSType () != b->GetLSType ()
+      || a->GetAdvertisingRouter () != b->GetAdvertisingRouter ()
+      || a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNode () != b->GetNode ())
+    {
+      return false;
+    }
+  uint32_t i = 0;
+  uint32_t j = 0;
+  for (;;)
+    {
+      while (i < a->GetNLinkRecords ()
+             && a->GetLinkRecord (i)->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+          i++;
+        }
+      while (j < b->GetNLinkRecords ()
+             && b->GetLinkRecord (j)->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+          j++;
+        }
+      if (i == a->GetNLinkRecords () || j == b->GetNLinkRecords ())
+        {
+          return i == a->GetNLinkRecords () && j == b->GetNLinkRecords ();
+        }
+      GlobalRoutingLinkRecord *la = a->GetLinkRecord (i++);
+      GlobalRoutingLinkRecord *lb = b->GetLinkRecord (j++);
+      if (la->GetLinkType () != lb->GetLinkType ()
+          || la->GetLinkData () != lb->GetLinkData ())
+        {
+          return false;
+        }
+      if (la->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork
+          && la->GetLinkId () != lb->GetLinkId ())
+        {
+          return false;
+        }
+    }
+}
+
+//
+// The links of an LSA are keyed by the vertex they lead to and their link
+// data, because the link data of a point-to-point link gives the next hop
+// of the reverse link, and that of a transit link tells the network which
+// router is attached.  The attached routers of a network-LSA are resolved
+// to their router ID in this database, as SPFNext does.
+//
+void
+GlobalRouteManagerLSDB::GetLinks (GlobalRoutingLSA* lsa, LinkMap_t& links) const
+{
+  for (uint32_t i = 0; i < lsa->GetNLinkRecords (); i++)
+    {
+      GlobalRoutingLinkRecord *l = lsa->GetLinkRecord (i);
+      if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
+        {
+          continue;
+        }
+      std::pair<Ipv4Address, Ipv4Address> key (l->GetLinkId (), l->GetLinkData ());
+      LinkMap_t::iterator found = links.find (key);
+      if (found == links.end () || found->second > l->GetMetric ())
+        {
+          links[key] = l->GetMetric ();
+        }
+    }
+  for (uint32_t i = 0; i < lsa->GetNAttachedRouters (); i++)
+    {
+      Ipv4Address addr = lsa->GetAttachedRouter (i);
+      GlobalRoutingLSA* w_lsa = GetLSAByLinkData (addr);
+      Ipv4Address to = w_lsa ? w_lsa->GetLinkStateId () : addr;
+      links[std::make_pair (to, addr)] = 0;
+    }
+}
+
+void
+GlobalRouteManagerLSDB::AddLinkChanges (Ipv4Address from, const LinkMap_t& oldLinks,
+                                        const LinkMap_t& newLinks, std::vector<LinkChange>& changes)
+{
+  LinkChange change;
+  change.from = from;
+  for (LinkMap_t::const_iterator i = oldLinks.begin (); i != oldLinks.end (); i++)
+    {
+      LinkMap_t::const_iterator found = newLinks.find (i->first);
+      uint32_t newMetric = found == newLinks.end () ? SPF_INFINITY : found->second;
+      if (newMetric != i->second)
+        {
+          change.to = i->first.first;
+          change.oldMetric = i->second;
+          change.newMetric = newMetric;
+          changes.push_back (change);
+        }
+    }
+  for (LinkMap_t::const_iterator i = newLinks.begin (); i != newLinks.end (); i++)
+    {
+      if (oldLinks.find (i->first) == oldLinks.end ())
+        {
+          change.to = i->first.first;
+          change.oldMetric = SPF_INFINITY;
+          change.newMetric = i->second;
+          changes.push_back (change);
+        }
+    }
+}
+
+void
+GlobalRouteManagerLSDB::GetChanges (const GlobalRouteManagerLSDB* old,
+                                    std::set<Ipv4Address>& vertices,
+                                    std::vector<LinkChange>& links) const
+{
+  NS_LOG_FUNCTION (old);
+  for (LSDBMap_t::const_iterator i = m_database.begin (); i != m_database.end (); i++)
+    {
+      GlobalRoutingLSA* lsa = old->GetLSA (i->first);
+      LinkMap_t oldLinks;
+      LinkMap_t newLinks;
+      GetLinks (i->second, newLinks);
+      if (lsa == 0 || !IsSameVertex (i->second, lsa))
+        {
+          vertices.insert (i->first);
+        }
+      if (lsa != 0)
+        {
+          old->GetLinks (lsa, oldLinks);
+        }
+      AddLinkChanges (i->first, oldLinks, newLinks, links);
+    }
+  for (LSDBMap_t::const_iterator i = old->m_database.begin (); i != old->m_database.end (); i++)
+    {
+      if (GetLSA (i->first) == 0)
+        {
+          LinkMap_t oldLinks;
+          old->GetLinks (i->second, oldLinks);
+          vertices.insert (i->first);
+          AddLinkChanges (i->first, oldLinks, LinkMap_t (), links);
+        }
+    }
+}
+
+bool
+GlobalRouteManagerLSDB::HasSameExtLSAs (const GlobalRouteManagerLSDB* other) const
+{
+  NS_LOG_FUNCTION (other);
+  if (m_extdatabase.size () != other->m_extdatabase.size ())
+    {
+      return false;
+    }
+  for (uint32_t j = 0; j < m_extdatabase.size (); j++)
+    {
+      if (!IsSameLSA (m_extdatabase[j], other->m_extdatabase[j]))
+        {
+          return false;
+        }
+    }
+  return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -525,9 +771,26 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 //
 // ---------------------------------------------------------------------------
 
+//
+// The state shared by the threads computing a batch of SPF trees: each
+// thread takes the next root of the batch until there is none left.
+//
+struct GlobalRouteManagerImpl::SPFBatch
+{
+  std::vector<SPFRoot*>* roots;
+  uint32_t next;
+  uint32_t end;
+#ifdef NS3_GLOBAL_ROUTING_THREADS
+  SystemMutex mutex;
+#endif
+};
+
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_spfstate (0),
+    m_routesComputed (false),
+    m_batch (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -553,6 +816,22 @@ GlobalRouteManagerImpl::DebugUseLsdb (GlobalRouteManagerLSDB* lsdb)
   m_lsdb = lsdb;
 }
 
+void
+GlobalRouteManagerImpl::DeleteRoutes (Ptr<Ipv4GlobalRouting> gr)
+{
+  NS_LOG_FUNCTION (gr);
+  uint32_t j = 0;
+  uint32_t nRoutes = gr->GetNRoutes ();
+  // Each time we delete route 0, the route index shifts downward
+  // We can delete all routes if we delete the route numbered 0
+  // nRoutes times
+  for (j = 0; j < nRoutes; j++)
+    {
+      NS_LOG_LOGIC ("Deleting global route " << j);
+      gr->RemoveRoute (0);
+    }
+}
+
 void
 GlobalRouteManagerImpl::DeleteGlobalRoutes ()
 {
@@ -567,18 +846,8 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
           continue;
         }
       Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-      uint32_t j = 0;
-      uint32_t nRoutes = gr->GetNRoutes ();
       NS_LOG_LOGIC ("Deleting " << gr->GetNRoutes ()<< " routes from node " << node->GetId ());
-      // Each time we delete route 0, the route index shifts downward
-      // We can delete all routes if we delete the route numbered 0
-      // nRoutes times
-      for (j = 0; j < nRoutes; j++)
-        {
-          NS_LOG_LOGIC ("Deleting global route " << j << " from node " << node->GetId ());
-          gr->RemoveRoute (0);
-        }
-      NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
+      DeleteRoutes (gr);
     }
   if (m_lsdb)
     {
@@ -586,6 +855,131 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
       delete m_lsdb;
       m_lsdb = new GlobalRouteManagerLSDB ();
     }
+  m_dependencies.clear ();
+  m_routesComputed = false;
+}
+
+void
+GlobalRouteManagerImpl::RecomputeGlobalRoutes ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  BooleanValue incremental;
+  g_incrementalSpf.GetValue (incremental);
+  if (!incremental.Get () || !m_routesComputed)
+    {
+      DeleteGlobalRoutes ();
+      BuildGlobalRoutingDatabase ();
+      InitializeRoutes ();
+      return;
+    }
+//
+// Build the new database next to the old one and find out what changed.
+//
+  GlobalRouteManagerLSDB* old = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  bool all = !m_lsdb->HasSameExtLSAs (old);
+  std::set<Ipv4Address> vertices;
+  std::vector<GlobalRouteManagerLSDB::LinkChange> links;
+  m_lsdb->GetChanges (old, vertices, links);
+  delete old;
+  NS_LOG_INFO ("Recomputing SPF for " << vertices.size () << " changed vertices, " <<
+               links.size () << " changed links" << (all ? " and changed external LSAs" : ""));
+//
+// The routes of a router only need to be computed again if its SPF tree
+// may change.  Everything else is as in DeleteGlobalRoutes () and
+// InitializeRoutes ().
+//
+  std::vector<SPFRoot*> roots;
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      if (rtr == 0)
+        {
+          continue;
+        }
+      if (node->GetSystemId () != MpiInterface::GetSystemId ())
+        {
+          DeleteRoutes (rtr->GetRoutingProtocol ());
+          continue;
+        }
+      SPFDependencies_t::iterator found = m_dependencies.find (rtr->GetRouterId ());
+      bool affected = all || found == m_dependencies.end ()
+        || IsAffected (rtr->GetRouterId (), found->second, vertices, links);
+      if (!affected)
+        {
+          NS_LOG_LOGIC ("Keeping the routes of node " << node->GetId ());
+          continue;
+        }
+      DeleteRoutes (rtr->GetRoutingProtocol ());
+      if (found != m_dependencies.end ())
+        {
+          m_dependencies.erase (found);
+        }
+      if (rtr->GetNumLSAs ())
+        {
+          roots.push_back (CreateSPFRoot (rtr->GetRouterId (), node));
+        }
+    }
+  SPFCalculateRoots (roots);
+}
+
+//
+// Find out whether the SPF tree of a root can differ after the changes of
+// the LSDB.  The routes to the prefixes of a vertex change with the vertex,
+// and the outgoing interfaces change with the links of the root.  A link
+// which is removed or gets more expensive can only matter if it is in the
+// tree.  The next hop to a neighbor of the root, directly or across a
+// network, is the link data of the link back, so adding or removing such a
+// link matters too.  A link which is added or gets cheaper can only matter
+// if it starts in the tree and gives a path at most as long as the one in
+// the tree, since equal cost paths are merged.
+//
+bool
+GlobalRouteManagerImpl::IsAffected (Ipv4Address root, const SPFTree& tree,
+                                    const std::set<Ipv4Address>& vertices,
+                                    const std::vector<GlobalRouteManagerLSDB::LinkChange>& links)
+{
+  for (std::set<Ipv4Address>::const_iterator i = vertices.begin (); i != vertices.end (); i++)
+    {
+      if (tree.distances.find (*i) != tree.distances.end ())
+        {
+          return true;
+        }
+    }
+  for (uint32_t i = 0; i < links.size (); i++)
+    {
+      const GlobalRouteManagerLSDB::LinkChange& link = links[i];
+      if (link.from == root
+          || tree.links.find (std::make_pair (link.from, link.to)) != tree.links.end ())
+        {
+          return true;
+        }
+      if ((link.oldMetric == SPF_INFINITY || link.newMetric == SPF_INFINITY)
+          && (link.to == root
+              || (tree.links.find (std::make_pair (root, link.to)) != tree.links.end ()
+                  && tree.links.find (std::make_pair (link.to, link.from)) != tree.links.end ())))
+        {
+          return true;
+        }
+      if (link.newMetric >= link.oldMetric)
+        {
+          continue;
+        }
+      sgi::hash_map<Ipv4Address, uint32_t, Ipv4AddressHash>::const_iterator from = tree.distances.find (link.from);
+      if (from == tree.distances.end ())
+        {
+          continue;
+        }
+      sgi::hash_map<Ipv4Address, uint32_t, Ipv4AddressHash>::const_iterator to = tree.distances.find (link.to);
+      if (to == tree.distances.end () || from->second + link.newMetric <= to->second)
+        {
+          return true;
+        }
+    }
+  return false;
 }
 
 //
@@ -688,6 +1082,7 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 // Walk the list of nodes in the system.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+  std::vector<SPFRoot*> roots;
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -711,12 +1106,208 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          roots.push_back (CreateSPFRoot (rtr->GetRouterId (), node));
         }
     }
+  m_dependencies.clear ();
+  SPFCalculateRoots (roots);
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
+//
+// Resolve, in the main thread, the node of the router at the root of an SPF
+// calculation.
+//
+GlobalRouteManagerImpl::SPFRoot*
+GlobalRouteManagerImpl::CreateSPFRoot (Ipv4Address routerId, Ptr<Node> node) const
+{
+  NS_LOG_FUNCTION (routerId << node);
+  SPFRoot* root = new SPFRoot ();
+  root->routerId = routerId;
+  if (node != 0)
+    {
+      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
+      NS_ASSERT (rtr);
+      root->routing = rtr->GetRoutingProtocol ();
+      root->ipv4 = node->GetObject<Ipv4> ();
+      NS_ASSERT_MSG (root->ipv4, 
+                     "GlobalRouteManagerImpl::CreateSPFRoot (): "
+                     "GetObject for <Ipv4> interface failed");
+    }
+  return root;
+}
+
+//
+// Compute the SPF trees of the given roots, in parallel if more than one
+// thread is configured, and install their routes.  The roots are deleted.
+//
+// The threads use their own copy of the LSDB since the SPF calculation keeps
+// its state in the LSAs, and an SPF calculation only touches the LSDB and the
+// Ipv4 of its root: everything which involves the other nodes or the
+// reference counts of shared objects is done here, by the main thread.
+//
+void
+GlobalRouteManagerImpl::SPFCalculateRoots (std::vector<SPFRoot*>& roots)
+{
+  NS_LOG_FUNCTION (roots.size ());
+  UintegerValue value;
+  g_spfThreads.GetValue (value);
+  uint32_t nThreads = value.Get ();
+  if (nThreads == 0)
+    {
+      long processors = sysconf (_SC_NPROCESSORS_ONLN);
+      nThreads = processors > 0 ? processors : 1;
+    }
+  nThreads = std::min<uint32_t> (nThreads, roots.size ());
+#ifndef NS3_GLOBAL_ROUTING_THREADS
+  nThreads = std::min<uint32_t> (nThreads, 1);
+#endif
+
+  if (nThreads <= 1)
+    {
+      for (uint32_t i = 0; i < roots.size (); i++)
+        {
+          SPFCalculate (roots[i]);
+          InstallSPFRoutes (roots[i]);
+          delete roots[i];
+        }
+    }
+#ifdef NS3_GLOBAL_ROUTING_THREADS
+  else
+    {
+      NS_LOG_INFO ("Computing " << roots.size () << " SPF trees with " << nThreads << " threads");
+      SPFBatch batch;
+      batch.roots = &roots;
+      std::vector<GlobalRouteManagerImpl*> workers;
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          GlobalRouteManagerImpl* worker = new GlobalRouteManagerImpl ();
+          worker->DebugUseLsdb (m_lsdb->Copy ());
+          worker->m_batch = &batch;
+          workers.push_back (worker);
+        }
+      for (uint32_t begin = 0; begin < roots.size (); begin = batch.end)
+        {
+          batch.next = begin;
+          batch.end = std::min<uint32_t> (roots.size (), begin + nThreads * SPF_ROOTS_PER_THREAD);
+          std::vector<Ptr<SystemThread> > threads;
+          for (uint32_t t = 1; t < nThreads; t++)
+            {
+              Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&GlobalRouteManagerImpl::SPFCalculateBatch, workers[t]));
+              thread->Start ();
+              threads.push_back (thread);
+            }
+          workers[0]->SPFCalculateBatch ();
+          for (uint32_t t = 0; t < threads.size (); t++)
+            {
+              threads[t]->Join ();
+            }
+          for (uint32_t i = begin; i < batch.end; i++)
+            {
+              InstallSPFRoutes (roots[i]);
+              delete roots[i];
+            }
+        }
+      for (uint32_t t = 0; t < nThreads; t++)
+        {
+          delete workers[t];
+        }
+    }
+#endif
+  roots.clear ();
+  m_routesComputed = true;
+}
+
+void
+GlobalRouteManagerImpl::SPFCalculateBatch (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  while (true)
+    {
+      uint32_t i;
+      {
+#ifdef NS3_GLOBAL_ROUTING_THREADS
+        CriticalSection cs (m_batch->mutex);
+#endif
+        if (m_batch->next == m_batch->end)
+          {
+            return;
+          }
+        i = m_batch->next++;
+      }
+      SPFCalculate ((*m_batch->roots)[i]);
+    }
+}
+
+//
+// Install the routes computed for a root in its routing table, in the order
+// they were computed, and remember what they depend on.
+//
+void
+GlobalRouteManagerImpl::InstallSPFRoutes (const SPFRoot* root)
+{
+  NS_LOG_FUNCTION (root->routerId << root->routes.size ());
+  m_dependencies[root->routerId] = root->tree;
+  if (root->routing == 0)
+    {
+      NS_LOG_LOGIC ("No node with router ID " << root->routerId);
+      return;
+    }
+  for (std::vector<SPFRoute>::const_iterator i = root->routes.begin (); i != root->routes.end (); i++)
+    {
+      switch (i->type)
+        {
+        case SPFRoute::HOST:
+          root->routing->AddHostRouteTo (i->dest, i->nextHop, i->outIf);
+          break;
+        case SPFRoute::NETWORK:
+          root->routing->AddNetworkRouteTo (i->dest, i->mask, i->nextHop, i->outIf);
+          break;
+        case SPFRoute::EXTERNAL:
+          root->routing->AddASExternalRouteTo (i->dest, i->mask, i->nextHop, i->outIf);
+          break;
+        }
+    }
+}
+
+//
+// Add the routes from the root to dest through all the exit directions of
+// vertex v, which are more than one with ECMP.
+//
+void
+GlobalRouteManagerImpl::SPFAddRoutes (SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask,
+                                      SPFVertex* v)
+{
+  NS_LOG_FUNCTION (type << dest << mask << v);
+  for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+    {
+      SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
+        {
+          SPFRoute route;
+          route.type = type;
+          route.dest = dest;
+          route.mask = mask;
+          route.nextHop = nextHop;
+          route.outIf = outIf;
+          m_spfstate->routes.push_back (route);
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << m_spfstate->routerId <<
+                        " add route to " << dest << "/" << mask <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
+        }
+      else
+        {
+          NS_LOG_LOGIC ("(Route " << i << ") Router " << m_spfstate->routerId <<
+                        " NOT able to add route to " << dest << "/" << mask <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative " << outIf);
+        }
+    }
+}
+
 //
 // This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
 // 16.1 (2) for further details.
@@ -945,7 +1536,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If we've changed the cost to get to the vertex represented by <w>, we 
 // must reorder the priority queue keyed to that cost.
 //
-                  candidate.Reorder ();
+                  candidate.Reorder (cw);
                 }
             } // new lower cost path found
         } // end W is already on the candidate list
@@ -1290,6 +1881,7 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
           // The link record LinkID is the router ID of the peer.
           // The Link Data is the local IP interface address
           GlobalRoutingLSA *w_lsa = m_lsdb->GetLSA (transitLink->GetLinkId ());
+          m_spfstate->tree.links.insert (std::make_pair (myRouterId, transitLink->GetLinkId ()));
           uint32_t nLinkRecords = w_lsa->GetNLinkRecords ();
           for (uint32_t j = 0; j < nLinkRecords; ++j)
             {
@@ -1305,15 +1897,15 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
               if (lr->GetLinkId () == myRouterId)
                 {
                   // Next hop is stored in the LinkID field of lr
-                  Ptr<GlobalRouter> router = rlsa->GetNode ()->GetObject<GlobalRouter> ();
-                  NS_ASSERT (router);
-                  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-                  NS_ASSERT (gr);
-                  gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
-                                         FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                  SPFRoute route;
+                  route.type = SPFRoute::NETWORK;
+                  route.dest = Ipv4Address ("0.0.0.0");
+                  route.mask = Ipv4Mask ("0.0.0.0");
+                  route.nextHop = lr->GetLinkData ();
+                  route.outIf = FindOutgoingInterfaceId (transitLink->GetLinkData ());
+                  m_spfstate->routes.push_back (route);
                   NS_LOG_LOGIC ("Inserting default route for node " << myRouterId << " to next hop " << 
-                                lr->GetLinkData () << " via interface " << 
-                                FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                                lr->GetLinkData () << " via interface " << route.outIf);
                   return true;
                 }
             }
@@ -1322,12 +1914,38 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
   return false;
 }
 
-// quagga ospf_spf_calculate
 void
 GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 {
   NS_LOG_FUNCTION (this << root);
+//
+// Look for the node of the root, if any, and compute its routes.
+//
+  Ptr<Node> rootNode = 0;
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr != 0 && rtr->GetRouterId () == root)
+        {
+          rootNode = *i;
+          break;
+        }
+    }
+  SPFRoot* state = CreateSPFRoot (root, rootNode);
+  SPFCalculate (state);
+  InstallSPFRoutes (state);
+  delete state;
+}
+
+// quagga ospf_spf_calculate
+void
+GlobalRouteManagerImpl::SPFCalculate (SPFRoot* state)
+{
+  NS_LOG_FUNCTION (this << state->routerId);
 
+  Ipv4Address root = state->routerId;
+  m_spfstate = state;
   SPFVertex *v;
 //
 // Initialize the Link State Database.
@@ -1353,6 +1971,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
   m_spfroot= v;
   v->SetDistanceFromRoot (0);
   v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+  m_spfstate->tree.distances[root] = 0;
   NS_LOG_LOGIC ("Starting SPFCalculate for node " << root);
 
 //
@@ -1362,10 +1981,12 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // reached.  Instead, short-circuit this computation and just install
 // a default route in the CheckForStubNode() method.
 //
-  if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
+  if (m_spfstate->routing != 0 && CheckForStubNode (root))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
       delete m_spfroot;
+      m_spfroot = 0;
+      m_spfstate = 0;
       return;
     }
 
@@ -1409,6 +2030,11 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
       NS_LOG_LOGIC (candidate);
       v = candidate.Pop ();
       NS_LOG_LOGIC ("Popped vertex " << v->GetVertexId ());
+      m_spfstate->tree.distances[v->GetVertexId ()] = v->GetDistanceFromRoot ();
+      for (uint32_t i = 0; v->GetParent (i) != 0; i++)
+        {
+          m_spfstate->tree.links.insert (std::make_pair (v->GetParent (i)->GetVertexId (), v->GetVertexId ()));
+        }
 //
 // Update the status field of the vertex to indicate that it is in the SPF
 // tree.
@@ -1487,6 +2113,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   delete m_spfroot;
   m_spfroot = 0;
+  m_spfstate = 0;
 }
 
 void
@@ -1540,110 +2167,18 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
     }
   NS_LOG_LOGIC ("External is on remote host: " 
                 << extlsa->GetAdvertisingRouter () << "; installing");
-
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = extlsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add external network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFAddASExternal (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = extlsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+//
+// The root of the SPF tree reaches the external network through all the
+// next-hop-IPs and out-going-interfaces it uses to reach the advertising
+// router 'v'.
+//
+  SPFAddRoutes (SPFRoute::EXTERNAL, tempip, tempmask, v);
 }
 
 
@@ -1703,118 +2238,18 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
       return;
     }
   NS_LOG_LOGIC ("Stub is on remote host: " << v->GetVertexId () << "; installing");
-//
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask (l->GetLinkData ().Get ());
-          Ipv4Address tempip = l->GetLinkId ();
-          tempip = tempip.CombineMask (tempmask);
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+  NS_ASSERT_MSG (v->GetLSA (), 
+                 "GlobalRouteManagerImpl::SPFIntraAddStub (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask (l->GetLinkData ().Get ());
+  Ipv4Address tempip = l->GetLinkId ();
+  tempip = tempip.CombineMask (tempmask);
+//
+// The vertex <v> has the next hop addresses and the outbound interfaces
+// precalculated for us that the root node uses to forward packets to v, and
+// therefore to the stub network behind v.
+//
+  SPFAddRoutes (SPFRoute::NETWORK, tempip, tempmask, v);
 }
 
 //
@@ -1829,70 +2264,18 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 {
   NS_LOG_FUNCTION (a << amask);
 //
-// We have an IP address <a> and a vertex ID of the root of the SPF tree.
-// The question is what interface index does this address correspond to.
-// The answer is a little complicated since we have to find a pointer to
-// the node corresponding to the vertex ID, find the Ipv4 interface on that
-// node in order to iterate the interfaces and find the one corresponding to
-// the address in question.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-//
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
+// We have an IP address <a> and the Ipv4 interface of the node at the root of
+// the SPF tree, which was looked up before the calculation.  Look through the
+// interfaces on this node for one that has the IP address we're looking for.
+// If we find one, return the corresponding interface index, or -1 if not
+// found.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  if (m_spfstate->ipv4 == 0)
     {
-      Ptr<Node> node = *i;
-
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-//
-// If the node doesn't have a GlobalRouter interface it can't be the one
-// we're interested in.
-//
-      if (rtr == 0)
-        {
-          continue;
-        }
-
-      if (rtr->GetRouterId () == routerId)
-        {
-//
-// This is the node we're building the routing table for.  We're going to need
-// the Ipv4 interface to look for the ipv4 interface index.  Since this node
-// is participating in routing IP version 4 packets, it certainly must have 
-// an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                         "GetObject for <Ipv4> interface failed");
-//
-// Look through the interfaces on this node for one that has the IP address
-// we're looking for.  If we find one, return the corresponding interface
-// index, or -1 if not found.
-//
-          int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif 
-          return interface;
-        }
+      NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << m_spfstate->routerId);
+      return -1;
     }
-//
-// Couldn't find it.
-//
-  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
-  return -1;
+  return m_spfstate->ipv4->GetInterfaceForPrefix (a, amask);
 }
 
 //
@@ -1919,70 +2302,17 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
   NS_ASSERT_MSG (m_spfroot, 
                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
 //
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "GetObject for <Ipv4> interface failed");
-//
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
 
-          uint32_t nLinkRecords = lsa->GetNLinkRecords ();
+  uint32_t nLinkRecords = lsa->GetNLinkRecords ();
 //
 // Iterate through the link records on the vertex to which we're going to add
 // routes.  To make sure we're being clear, we're going to add routing table
@@ -1991,18 +2321,18 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // the local side of the point-to-point links found on the node described by
 // the vertex <v>.
 //
-          NS_LOG_LOGIC (" Node " << node->GetId () <<
-                        " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
-          for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
+  NS_LOG_LOGIC (" Router " << m_spfstate->routerId <<
+                " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
+  for (uint32_t j = 0; j < nLinkRecords; ++j)
+    {
 //
 // We are only concerned about point-to-point links
 //
-              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
-              if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                  continue;
-                }
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+        {
+          continue;
+        }
 //
 // Here's why we did all of that work.  We're going to add a host route to the
 // host address found in the m_linkData field of the point-to-point link
@@ -2014,48 +2344,13 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // an m_nextHop address precalculated for us that is the address to which the
 // root node should send packets to be forwarded to these IP addresses.
 // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
+// which the packets should be send for forwarding.  With ECMP, there is a
+// host route for each of the exit directions toward the vertex 'v'.
 //
-              Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-              if (router == 0)
-                {
-                  continue;
-                }
-              Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-              NS_ASSERT (gr);
-              // walk through all available exit directions due to ECMP,
-              // and add host route for each of the exit direction toward
-              // the vertex 'v'
-              for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-                {
-                  SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-                  Ipv4Address nextHop = exit.first;
-                  int32_t outIf = exit.second;
-                  if (outIf >= 0)
-                    {
-                      gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
-                                          outIf);
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " adding host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " and outgoing interface " << outIf);
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " NOT able to add host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " since outgoing interface id is negative " << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
-            }
-//
-// Done adding the routes for the selected node.
-//
-          return;
-        }
+      SPFAddRoutes (SPFRoute::HOST, lr->GetLinkData (), Ipv4Mask::GetOnes (), v);
     }
 }
+
 void
 GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
 {
@@ -2064,105 +2359,21 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
   NS_ASSERT_MSG (m_spfroot, 
                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
 //
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "GetObject for <Ipv4> interface failed");
-//
 // Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = lsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all available exit directions due to ECMP,
-          // and add host route for each of the exit direction toward
-          // the vertex 'v'
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative " << outIf);
-                }
-            }
-        }
-    } 
+// adding the routes to: the network LSA holds the address and the mask of
+// the transit network.
+//
+  GlobalRoutingLSA *lsa = v->GetLSA ();
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = lsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all available exit directions due to ECMP,
+  // and add a network route for each of the exit direction toward
+  // the vertex 'v'
+  SPFAddRoutes (SPFRoute::NETWORK, tempip, tempmask, v);
 }
 
 // Derived from quagga ospf_vertex_add_parents ()
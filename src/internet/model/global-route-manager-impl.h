@@ -26,10 +26,12 @@
 #include <list>
 #include <queue>
 #include <map>
+#include <set>
 #include <vector>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/sgi-hashmap.h"
 #include "global-router-interface.h"
 
 namespace ns3 {
@@ -37,6 +39,7 @@ namespace ns3 {
 const uint32_t SPF_INFINITY = 0xffffffff;
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -577,7 +580,9 @@ private:
  * also export their own LSAs.
  *
  * This class implements a searchable database of LSAs gathered from every
- * router in the simulation.
+ * router in the simulation.  The LSAs are hashed by link state ID, and also
+ * by the link data of their transit network link records for the lookups
+ * of GetLSAByLinkData ().
  */
 class GlobalRouteManagerLSDB
 {
@@ -665,14 +670,81 @@ public:
   GlobalRoutingLSA* GetExtLSA (uint32_t index) const;
   uint32_t GetNumExtLSAs () const;
 
+/**
+ * @brief Create a deep copy of the database.
+ * @internal
+ *
+ * The copy has its own LSAs, whose SPF status flags can be used by an SPF
+ * calculation independently of the LSAs of this database.
+ *
+ * @returns a new database, owned by the caller.
+ */
+  GlobalRouteManagerLSDB* Copy (void) const;
+
+/**
+ * @brief A link of the SPF graph which differs between two databases.
+ *
+ * A link goes from the vertex of an LSA to the vertex of a router or of a
+ * transit network: it is a point-to-point or transit network link record
+ * of a router-LSA, or an attached router of a network-LSA, whose metric
+ * is 0.  The metric of a link which is missing from a database is
+ * SPF_INFINITY.
+ */
+  struct LinkChange
+  {
+    Ipv4Address from;
+    Ipv4Address to;
+    uint32_t oldMetric;
+    uint32_t newMetric;
+  };
+
+/**
+ * @brief Find the differences between this database and an older one.
+ * @internal
+ *
+ * The link state IDs of the LSAs which are only in one of the databases,
+ * or whose routes to their own prefixes differ (the stub link records, the
+ * local addresses of the point-to-point link records, the network mask),
+ * are added to vertices.  The links which were added, removed, or whose
+ * metric or link data changed are added to links.  The AS external LSAs
+ * are not compared; see HasSameExtLSAs ().
+ *
+ * @param old the database to compare with.
+ * @param vertices the set to which the changed vertices are added.
+ * @param links the vector to which the changed links are added.
+ */
+  void GetChanges (const GlobalRouteManagerLSDB* old,
+                   std::set<Ipv4Address>& vertices,
+                   std::vector<LinkChange>& links) const;
+
+/**
+ * @brief Compare the AS external LSAs of this database and another one.
+ * @internal
+ *
+ * @param other the database to compare with.
+ * @returns true if both databases hold the same AS external LSAs, in the
+ * same order.
+ */
+  bool HasSameExtLSAs (const GlobalRouteManagerLSDB* other) const;
 
 private:
-  typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t;
+  typedef sgi::hash_map<Ipv4Address, GlobalRoutingLSA*, Ipv4AddressHash> LSDBMap_t;
   typedef std::pair<Ipv4Address, GlobalRoutingLSA*> LSDBPair_t;
 
   LSDBMap_t m_database;
+  /// the LSAs of m_database, indexed by the link data of their transit links
+  LSDBMap_t m_linkDataIndex;
   std::vector<GlobalRoutingLSA*> m_extdatabase;
 
+  /// the metric of the links of an LSA, by vertex ID and link data
+  typedef std::map<std::pair<Ipv4Address, Ipv4Address>, uint32_t> LinkMap_t;
+
+  static bool IsSameLSA (GlobalRoutingLSA* a, GlobalRoutingLSA* b);
+  static bool IsSameVertex (GlobalRoutingLSA* a, GlobalRoutingLSA* b);
+  void GetLinks (GlobalRoutingLSA* lsa, LinkMap_t& links) const;
+  static void AddLinkChanges (Ipv4Address from, const LinkMap_t& oldLinks,
+                              const LinkMap_t& newLinks, std::vector<LinkChange>& changes);
+
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
  * need for it and a compiler provided shallow copy would be wrong.
@@ -727,6 +799,22 @@ public:
  */
   virtual void InitializeRoutes ();
 
+/**
+ * @brief Delete the routes, rebuild the routing database and compute the
+ * routes again after a change of the topology.
+ * @internal
+ *
+ * This is DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+ * InitializeRoutes () in turn unless the GlobalRoutingIncrementalSpf
+ * global value is set: then, once the routes were computed from scratch,
+ * only the routers whose SPF tree may differ since the last computation get
+ * their routes deleted and computed again: the trees which hold a vertex
+ * whose own prefixes changed, or a link which changed in either direction,
+ * and the trees which a new or cheaper link could shorten.  The routes of
+ * the other routers, including any route added by hand, are left untouched.
+ */
+  virtual void RecomputeGlobalRoutes ();
+
 /**
  * @brief Debugging routine; allow client code to supply a pre-built LSDB
  * @internal
@@ -754,10 +842,82 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+/**
+ * @brief A route computed by an SPF calculation.
+ *
+ * The routes are first computed for the root of the SPF tree, possibly in
+ * another thread, and then installed in the routing table of the root.
+ */
+  struct SPFRoute
+  {
+    enum Type
+    {
+      HOST,     /**< a host route to dest */
+      NETWORK,  /**< a network route to dest/mask */
+      EXTERNAL  /**< an AS external route to dest/mask */
+    } type;
+    Ipv4Address dest;
+    Ipv4Mask mask;
+    Ipv4Address nextHop;
+    uint32_t outIf;
+  };
+
+/**
+ * @brief What the routes of a router depend on: the vertices of its SPF
+ * tree with their distance from the root, and the links of the tree.
+ */
+  struct SPFTree
+  {
+    sgi::hash_map<Ipv4Address, uint32_t, Ipv4AddressHash> distances;
+    /// the links of the tree, as (parent, child) pairs of vertex IDs
+    std::set<std::pair<Ipv4Address, Ipv4Address> > links;
+  };
+
+  static bool IsAffected (Ipv4Address root, const SPFTree& tree,
+                          const std::set<Ipv4Address>& vertices,
+                          const std::vector<GlobalRouteManagerLSDB::LinkChange>& links);
+
+/**
+ * @brief The input and the output of the SPF calculation of one router.
+ *
+ * The node of the router is resolved before the calculation, which only
+ * uses the LSDB and the Ipv4 of the router itself, so that the calculations
+ * of different routers can run in parallel.
+ */
+  struct SPFRoot
+  {
+    Ipv4Address routerId;
+    /// the routing protocol of the router, or zero if there is no such node
+    Ptr<Ipv4GlobalRouting> routing;
+    Ptr<Ipv4> ipv4;
+    std::vector<SPFRoute> routes;
+    /// the SPF tree which the routes were computed from
+    SPFTree tree;
+  };
+
+  struct SPFBatch;
+
+  typedef sgi::hash_map<Ipv4Address, SPFTree, Ipv4AddressHash> SPFDependencies_t;
+
   SPFVertex* m_spfroot;
+  SPFRoot* m_spfstate;
   GlobalRouteManagerLSDB* m_lsdb;
+  /// the dependencies of the SPF calculation of each router, by router ID
+  SPFDependencies_t m_dependencies;
+  /// true if m_dependencies describe the routes currently installed
+  bool m_routesComputed;
+  SPFBatch* m_batch;
+
+  static void DeleteRoutes (Ptr<Ipv4GlobalRouting> gr);
+  SPFRoot* CreateSPFRoot (Ipv4Address routerId, Ptr<Node> node) const;
+  void SPFCalculateRoots (std::vector<SPFRoot*>& roots);
+  void SPFCalculateBatch (void);
+  void InstallSPFRoutes (const SPFRoot* root);
+  void SPFAddRoutes (SPFRoute::Type type, Ipv4Address dest, Ipv4Mask mask,
+                     SPFVertex* v);
   bool CheckForStubNode (Ipv4Address root);
   void SPFCalculate (Ipv4Address root);
+  void SPFCalculate (SPFRoot* root);
   void SPFProcessStubs (SPFVertex* v);
   void ProcessASExternals (SPFVertex* v, GlobalRoutingLSA* extlsa);
   void SPFNext (SPFVertex*, CandidateQueue&);
@@ -53,6 +53,13 @@ GlobalRouteManager::InitializeRoutes (void)
   InitializeRoutes ();
 }
 
+void
+GlobalRouteManager::RecomputeGlobalRoutes (void)
+{
+  SimulationSingleton<GlobalRouteManagerImpl>::Get ()->
+  RecomputeGlobalRoutes ();
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId (void)
 {
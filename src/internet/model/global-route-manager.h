@@ -67,6 +67,14 @@ public:
  */
   static void InitializeRoutes ();
 
+/**
+ * @brief Delete the routes, rebuild the routing database and compute the
+ * routes again, only for the routers affected by a change of the database
+ * if the GlobalRoutingIncrementalSpf global value is set.
+ * @internal
+ */
+  static void RecomputeGlobalRoutes ();
+
 private:
 /**
  * @brief Global Route Manager copy construction is disallowed.  There's no 
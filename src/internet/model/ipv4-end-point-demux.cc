@@ -35,36 +35,34 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  EndPoints endPoints = GetAllEndPoints ();
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      m_endPoints.Remove (endPoint);
       delete endPoint;
     }
-  m_endPoints.clear ();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_endPoints.GetPort (port) != 0;
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  const Index::Bucket *bucket = m_endPoints.GetPort (port);
+  if (bucket == 0)
+    {
+      return false;
+    }
+  for (Index::Bucket::const_iterator i = bucket->begin (); i != bucket->end (); i++) 
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      if (i->second->GetLocalAddress () == addr) 
         {
           return true;
         }
@@ -72,6 +70,22 @@ Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
   return false;
 }
 
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  endPoint->m_demux = this;
+  m_endPoints.Insert (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.GetAll ().size () << "<< endpoints.");
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::Update (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_endPoints.Update (endPoint);
+}
+
 Ipv4EndPoint *
 Ipv4EndPointDemux::Allocate (void)
 {
@@ -82,10 +96,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -98,10 +109,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -121,10 +129,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -132,39 +137,24 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (m_endPoints.Get (localAddress, localPort, peerAddress, peerPort) != 0)
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
-        {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
-        }
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void 
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (m_endPoints.Remove (endPoint))
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      delete endPoint;
     }
 }
 
@@ -176,15 +166,43 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   EndPoints ret;
-
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  const Index::Bucket &all = m_endPoints.GetAll ();
+  for (Index::Bucket::const_iterator i = all.begin (); i != all.end (); i++)
     {
-      Ipv4EndPoint* endP = *i;
-      ret.push_back (endP);
+      ret.push_back (i->second);
     }
   return ret;
 }
 
+/*
+ * Append to endPoints the endpoints of the bucket which are not bound
+ * to another device than the incoming one.
+ */
+bool
+Ipv4EndPointDemux::AddMatches (const Index::Bucket *bucket,
+                               Ptr<Ipv4Interface> incomingInterface,
+                               EndPoints &endPoints)
+{
+  if (bucket == 0)
+    {
+      return false;
+    }
+  for (Index::Bucket::const_iterator i = bucket->begin (); i != bucket->end (); i++)
+    {
+      Ipv4EndPoint *endP = i->second;
+      if (endP->GetBoundNetDevice ()
+          && endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
+        {
+          NS_LOG_LOGIC ("Skipping endpoint " << endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          continue;
+        }
+      endPoints.push_back (endP);
+    }
+  return !endPoints.empty ();
+}
 
 /*
  * If we have an exact match, we return it.
@@ -204,21 +222,61 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
 
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport << incomingInterface);
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  const Index::Bucket *endPoints = m_endPoints.GetPort (dport);
+  if (endPoints == 0)
+    {
+      NS_LOG_LOGIC ("No endpoint matches packet dport " << dport);
+      return retval1;
+    }
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  if (!isBroadcast)
+    {
+      // Each of the four lists holds the endpoints whose four-tuple is
+      // the packet four-tuple with some fields replaced by wildcards.
+      if (AddMatches (m_endPoints.Get (daddr, dport, saddr, sport),
+                      incomingInterface, retval4))
+        { // All 4 match
+          return retval4;
+        }
+      if (AddMatches (m_endPoints.Get (Ipv4Address::GetAny (), dport, saddr, sport),
+                      incomingInterface, retval3))
+        { // All but local address
+          return retval3;
+        }
+      if (AddMatches (m_endPoints.Get (daddr, dport, Ipv4Address::GetAny (), 0),
+                      incomingInterface, retval2))
+        { // Only local port and local address matches exactly
+          return retval2;
+        }
+      // Only local port matches exactly
+      AddMatches (m_endPoints.Get (Ipv4Address::GetAny (), dport, Ipv4Address::GetAny (), 0),
+                  incomingInterface, retval1);
+      return retval1;  // might be empty if no matches
+    }
+
+  // A broadcast matches the endpoints bound to the address of the incoming
+  // interface, so look at all the endpoints of the port.
+  for (Index::Bucket::const_iterator i = endPoints->begin (); i != endPoints->end (); i++) 
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4EndPoint* endP = i->second;
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
                                                  << " sport=" << endP->GetPeerPort ()
                                                  << " saddr=" << endP->GetPeerAddress ());
-      if (endP->GetLocalPort () != dport) 
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
       if (endP->GetBoundNetDevice ())
         {
           if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
@@ -230,30 +288,13 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
 
-      if (isBroadcast)
-        {
-          NS_LOG_DEBUG ("Found bcast, localaddr " << endP->GetLocalAddress ());
-        }
+      NS_LOG_DEBUG ("Found bcast, localaddr " << endP->GetLocalAddress ());
 
-      if (isBroadcast && (endP->GetLocalAddress () != Ipv4Address::GetAny ()))
+      if (endP->GetLocalAddress () != Ipv4Address::GetAny ())
         {
           localAddressMatchesExact = (endP->GetLocalAddress () ==
                                       incomingInterfaceAddr);
@@ -280,7 +321,7 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
         { // Only local port matches exactly
           retval1.push_back (endP);
         }
-      if ((localAddressMatchesExact || (isBroadcast && localAddressMatchesWildCard))&&
+      if ((localAddressMatchesExact || localAddressMatchesWildCard) &&
           remotePeerMatchesWildCard &&
           remoteAddressMatchesWildCard)
         { // Only local port and local address matches exactly
@@ -315,33 +356,33 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
+  const Index::Bucket *exact = m_endPoints.Get (daddr, dport, saddr, sport);
+  if (exact != 0)
+    {
+      /* this is an exact match. */
+      return exact->begin ()->second;
+    }
+  const Index::Bucket *endPoints = m_endPoints.GetPort (dport);
+  if (endPoints == 0)
+    {
+      return 0;
+    }
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (Index::Bucket::const_iterator i = endPoints->begin (); i != endPoints->end (); i++) 
     {
-      if ((*i)->GetLocalPort () != dport) 
-        {
-          continue;
-        }
-      if ((*i)->GetLocalAddress () == daddr &&
-          (*i)->GetPeerPort () == sport &&
-          (*i)->GetPeerAddress () == saddr) 
-        {
-          /* this is an exact match. */
-          return *i;
-        }
       uint32_t tmp = 0;
-      if ((*i)->GetLocalAddress () == Ipv4Address::GetAny ()) 
+      if (i->second->GetLocalAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
-      if ((*i)->GetPeerAddress () == Ipv4Address::GetAny ()) 
+      if (i->second->GetPeerAddress () == Ipv4Address::GetAny ()) 
         {
           tmp++;
         }
       if (tmp < genericity) 
         {
-          generic = (*i);
+          generic = i->second;
           genericity = tmp;
         }
     }
@@ -365,7 +406,7 @@ Ipv4EndPointDemux::AllocateEphemeralPort (void)
         {
           port = m_portFirst;
         }
-    } while (LookupPortLocal (port));
+    } while (m_endPoints.GetPort (port) != 0);
   m_ephemeral = port;
   return port;
 }
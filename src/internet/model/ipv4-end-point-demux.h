@@ -25,6 +25,7 @@
 #include <list>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
+#include "end-point-index.h"
 
 namespace ns3 {
 
@@ -38,6 +39,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are indexed on their local port and on their four-tuple,
+ * so that a lookup only looks at the few endpoints whose four-tuple is
+ * one of the wildcard combinations of the packet four-tuple, instead of
+ * scanning all the endpoints. The endpoints notify the demux when their
+ * addresses change, to be moved to their new place in the index.
  */
 
 class Ipv4EndPointDemux {
@@ -74,12 +81,23 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+  typedef EndPointIndex<Ipv4EndPoint, Ipv4Address, Ipv4AddressHash> Index;
+
   uint16_t AllocateEphemeralPort (void);
+  Ipv4EndPoint *Insert (Ipv4EndPoint *endPoint);
+  /**
+   * Called by an endpoint of this demux when its addresses change.
+   */
+  void Update (Ipv4EndPoint *endPoint);
+  static bool AddMatches (const Index::Bucket *bucket,
+                          Ptr<Ipv4Interface> incomingInterface,
+                          EndPoints &endPoints);
 
   uint16_t m_ephemeral;
   uint16_t m_portLast;
   uint16_t m_portFirst;
-  EndPoints m_endPoints;
+  Index m_endPoints;
 };
 
 } // namespace ns3
@@ -19,6 +19,7 @@
  */
 
 #include "ipv4-end-point.h"
+#include "ipv4-end-point-demux.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -31,7 +32,8 @@ Ipv4EndPoint::Ipv4EndPoint (Ipv4Address address, uint16_t port)
   : m_localAddr (address), 
     m_localPort (port),
     m_peerAddr (Ipv4Address::GetAny ()),
-    m_peerPort (0)
+    m_peerPort (0),
+    m_demux (0)
 {
 }
 Ipv4EndPoint::~Ipv4EndPoint ()
@@ -55,6 +57,10 @@ void
 Ipv4EndPoint::SetLocalAddress (Ipv4Address address)
 {
   m_localAddr = address;
+  if (m_demux != 0)
+    {
+      m_demux->Update (this);
+    }
 }
 
 uint16_t 
@@ -77,6 +83,10 @@ Ipv4EndPoint::SetPeer (Ipv4Address address, uint16_t port)
 {
   m_peerAddr = address;
   m_peerPort = port;
+  if (m_demux != 0)
+    {
+      m_demux->Update (this);
+    }
 }
 
 void
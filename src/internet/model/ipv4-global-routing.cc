@@ -27,6 +27,7 @@
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
 
@@ -51,6 +52,24 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_respondToInterfaceEvents),
                    MakeBooleanChecker ())
+    .AddAttribute ("RouteCacheSize",
+                   "The maximum number of route lookups kept in the route cache, or zero to disable the cache",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&Ipv4GlobalRouting::SetRouteCacheSize,
+                                         &Ipv4GlobalRouting::GetRouteCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RouteCacheHits",
+                   "The number of route lookups found in the route cache",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4GlobalRouting::GetRouteCacheHits),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("RouteCacheMisses",
+                   "The number of route lookups not found in the route cache",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4GlobalRouting::GetRouteCacheMisses),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
@@ -78,6 +97,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  AddToIndex (m_hostRouteIndex, route);
+  m_routeCache.Flush ();
 }
 
 void 
@@ -88,6 +109,8 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  AddToIndex (m_hostRouteIndex, route);
+  m_routeCache.Flush ();
 }
 
 void 
@@ -103,6 +126,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  AddToIndex (m_networkRouteIndex, route);
+  m_routeCache.Flush ();
 }
 
 void 
@@ -116,6 +141,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  AddToIndex (m_networkRouteIndex, route);
+  m_routeCache.Flush ();
 }
 
 void 
@@ -131,88 +158,132 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  AddToIndex (m_ASexternalRouteIndex, route);
+  m_routeCache.Flush ();
 }
 
 
+void
+Ipv4GlobalRouting::AddToIndex (RouteIndex &index, Ipv4RoutingTableEntry *route)
+{
+  uint8_t prefix[4];
+  route->GetDestNetwork ().Serialize (prefix);
+  index.Insert (prefix, route->GetDestNetworkMask ().GetPrefixLength (), route);
+}
+
+void
+Ipv4GlobalRouting::SetRouteCacheSize (uint32_t size)
+{
+  m_routeCache.SetMaxSize (size);
+}
+
+uint32_t
+Ipv4GlobalRouting::GetRouteCacheSize (void) const
+{
+  return m_routeCache.GetMaxSize ();
+}
+
+uint64_t
+Ipv4GlobalRouting::GetRouteCacheHits (void) const
+{
+  return m_routeCache.GetHits ();
+}
+
+uint64_t
+Ipv4GlobalRouting::GetRouteCacheMisses (void) const
+{
+  return m_routeCache.GetMisses ();
+}
+
+void
+Ipv4GlobalRouting::RemoveFromIndex (RouteIndex &index, Ipv4RoutingTableEntry *route)
+{
+  uint8_t prefix[4];
+  route->GetDestNetwork ().Serialize (prefix);
+  if (!index.Remove (prefix, route->GetDestNetworkMask ().GetPrefixLength (), route))
+    {
+      NS_ASSERT_MSG (false, "Route " << route << " is not indexed");
+    }
+}
+
+const Ipv4GlobalRouting::RouteIndex::Group *
+Ipv4GlobalRouting::LookupIndex (const RouteIndex &index, const uint8_t dest[4],
+                                Ptr<NetDevice> oif, RouteIndex::Group &filtered) const
+{
+  if (oif == 0)
+    {
+      return index.Lookup (dest);
+    }
+  // fall back to shorter prefixes when no route of the longest prefix
+  // goes through the requested interface.
+  std::vector<const RouteIndex::Group *> groups;
+  index.LookupAll (dest, groups);
+  filtered.clear ();
+  for (std::vector<const RouteIndex::Group *>::const_iterator i = groups.begin (); i != groups.end (); i++)
+    {
+      for (RouteIndex::Group::const_iterator j = (*i)->begin (); j != (*i)->end (); j++)
+        {
+          if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+            {
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
+            }
+          filtered.push_back (*j);
+        }
+      if (!filtered.empty ())
+        {
+          return &filtered;
+        }
+    }
+  return 0;
+}
+
 Ptr<Ipv4Route>
 Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION_NOARGS ();
   NS_LOG_LOGIC ("Looking for route for destination " << dest);
+  // a random choice among ECMP routes must be made for each packet.
+  bool cacheable = !m_randomEcmpRouting;
   Ptr<Ipv4Route> rtentry = 0;
+  if (cacheable && m_routeCache.Lookup (dest, oif, rtentry))
+    {
+      return rtentry;
+    }
+  uint8_t key[4];
+  dest.Serialize (key);
   // store all available routes that bring packets to their destination
-  typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
-  RouteVec_t allRoutes;
+  RouteIndex::Group filtered;
+  uint32_t nRoutes = 0;
 
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  const RouteIndex::Group *allRoutes = LookupIndex (m_hostRouteIndex, key, oif, filtered);
+  if (allRoutes != 0)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
-        {
-          if (oif != 0)
-            {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
-            }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
-        }
+      nRoutes = allRoutes->size ();
+      NS_LOG_LOGIC (nRoutes << " Found global host route " << allRoutes->front ());
     }
-  if (allRoutes.size () == 0) // if no host route is found
+  if (nRoutes == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      allRoutes = LookupIndex (m_networkRouteIndex, key, oif, filtered);
+      if (allRoutes != 0)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
-            {
-              if (oif != 0)
-                {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
-                }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
-            }
+          nRoutes = allRoutes->size ();
+          NS_LOG_LOGIC (nRoutes << " Found global network route " << allRoutes->front ());
         }
     }
-  if (allRoutes.size () == 0)  // consider external if no host/network found
+  if (nRoutes == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      allRoutes = LookupIndex (m_ASexternalRouteIndex, key, oif, filtered);
+      if (allRoutes != 0)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
-            {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
-                {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
-                    {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
-                    }
-                }
-              allRoutes.push_back (*k);
-              break;
-            }
+          // external routes are not used for ECMP
+          nRoutes = 1;
+          NS_LOG_LOGIC ("Found external route" << allRoutes->front ());
         }
     }
-  if (allRoutes.size () > 0 ) // if route(s) is found
+  if (nRoutes > 0 ) // if route(s) is found
     {
       // pick up one of the routes uniformly at random if random
       // ECMP routing is enabled, or always select the first route
@@ -220,13 +291,13 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
       uint32_t selectIndex;
       if (m_randomEcmpRouting)
         {
-          selectIndex = m_rand->GetInteger (0, allRoutes.size ()-1);
+          selectIndex = m_rand->GetInteger (0, nRoutes-1);
         }
       else 
         {
           selectIndex = 0;
         }
-      Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
+      Ipv4RoutingTableEntry* route = (*allRoutes)[selectIndex]; 
       // create a Ipv4Route object from the selected routing table entry
       rtentry = Create<Ipv4Route> ();
       rtentry->SetDestination (route->GetDest ());
@@ -235,12 +306,12 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
       rtentry->SetGateway (route->GetGateway ());
       uint32_t interfaceIdx = route->GetInterface ();
       rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-      return rtentry;
     }
-  else 
+  if (cacheable)
     {
-      return 0;
+      m_routeCache.Add (dest, oif, rtentry);
     }
+  return rtentry;
 }
 
 uint32_t 
@@ -317,6 +388,8 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              RemoveFromIndex (m_hostRouteIndex, *i);
+              m_routeCache.Flush ();
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -334,6 +407,8 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          RemoveFromIndex (m_networkRouteIndex, *j);
+          m_routeCache.Flush ();
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -350,6 +425,8 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          RemoveFromIndex (m_ASexternalRouteIndex, *k);
+          m_routeCache.Flush ();
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -390,6 +467,10 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostRouteIndex.Clear ();
+  m_networkRouteIndex.Clear ();
+  m_ASexternalRouteIndex.Clear ();
+  m_routeCache.Flush ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -554,6 +635,7 @@ void
 Ipv4GlobalRouting::NotifyInterfaceUp (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  m_routeCache.Flush ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
       GlobalRouteManager::DeleteGlobalRoutes ();
@@ -566,6 +648,7 @@ void
 Ipv4GlobalRouting::NotifyInterfaceDown (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  m_routeCache.Flush ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
       GlobalRouteManager::DeleteGlobalRoutes ();
@@ -578,6 +661,7 @@ void
 Ipv4GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << address);
+  m_routeCache.Flush ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
       GlobalRouteManager::DeleteGlobalRoutes ();
@@ -590,6 +674,7 @@ void
 Ipv4GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << address);
+  m_routeCache.Flush ();
   if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
     {
       GlobalRouteManager::DeleteGlobalRoutes ();
@@ -604,6 +689,7 @@ Ipv4GlobalRouting::SetIpv4 (Ptr<Ipv4> ipv4)
   NS_LOG_FUNCTION (this << ipv4);
   NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
   m_ipv4 = ipv4;
+  m_routeCache.Flush ();
 }
 
 
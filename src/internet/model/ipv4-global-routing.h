@@ -28,6 +28,8 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/prefix-trie.h"
+#include "ns3/ipv4-route-cache.h"
 
 namespace ns3 {
 
@@ -63,6 +65,18 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * Host routes are preferred to network routes, which are preferred to
+ * AS external routes. Within each kind of route, the routes whose
+ * destination network has the longest prefix matching the destination
+ * address are used, and the equal-cost routes to the same destination
+ * are candidates for ECMP. The routes are indexed in prefix tries so that
+ * the cost of a lookup does not depend on the number of routes.
+ *
+ * Unless packets are randomly routed among ECMP routes, the results of
+ * the lookups are kept in an Ipv4RouteCache which is flushed when a route
+ * is added or removed or an interface changes, so that the same Ipv4Route
+ * is returned for all the packets sent to the same destination.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -241,13 +255,28 @@ private:
   typedef std::list<Ipv4RoutingTableEntry *> ASExternalRoutes;
   typedef std::list<Ipv4RoutingTableEntry *>::const_iterator ASExternalRoutesCI;
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
+  typedef PrefixTrie<Ipv4RoutingTableEntry *, 4> RouteIndex;
 
   Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
+  const RouteIndex::Group *LookupIndex (const RouteIndex &index, const uint8_t dest[4],
+                                        Ptr<NetDevice> oif, RouteIndex::Group &filtered) const;
+  static void AddToIndex (RouteIndex &index, Ipv4RoutingTableEntry *route);
+  static void RemoveFromIndex (RouteIndex &index, Ipv4RoutingTableEntry *route);
+  void SetRouteCacheSize (uint32_t size);
+  uint32_t GetRouteCacheSize (void) const;
+  uint64_t GetRouteCacheHits (void) const;
+  uint64_t GetRouteCacheMisses (void) const;
 
   HostRoutes m_hostRoutes;
   NetworkRoutes m_networkRoutes;
   ASExternalRoutes m_ASexternalRoutes; // External routes imported
 
+  // longest-prefix-match indexes of the routes of the lists above
+  RouteIndex m_hostRouteIndex;
+  RouteIndex m_networkRouteIndex;
+  RouteIndex m_ASexternalRouteIndex;
+  Ipv4RouteCache m_routeCache;
+
   Ptr<Ipv4> m_ipv4;
 };
 
@@ -32,6 +32,7 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/segment-offload-tag.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -731,13 +732,17 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   NS_ASSERT (interface >= 0);
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
+  // The super-segments handed down by a transport protocol are not
+  // fragmented by the devices which support segmentation offload
+  SegmentOffloadTag offload;
+  bool offloaded = outDev->SupportsSegmentOffload () && packet->PeekPacketTag (offload);
 
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( !offloaded && packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -766,7 +771,7 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
+          if ( !offloaded && packet->GetSize () > outInterface->GetDevice ()->GetMtu () )
             {
               std::list<Ptr<Packet> > listFragments;
               DoFragmentation (packet, outInterface->GetDevice ()->GetMtu (), listFragments);
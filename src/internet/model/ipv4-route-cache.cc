@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-route-cache.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4RouteCache");
+
+namespace ns3 {
+
+size_t
+Ipv4RouteCache::KeyHash::operator() (const Key &key) const
+{
+  return key.dest.Get () ^ (reinterpret_cast<size_t> (key.oif) >> 4);
+}
+
+bool
+Ipv4RouteCache::KeyEqual::operator() (const Key &a, const Key &b) const
+{
+  return a.dest == b.dest && a.oif == b.oif;
+}
+
+Ipv4RouteCache::Ipv4RouteCache ()
+  : m_maxSize (1024),
+    m_hits (0),
+    m_misses (0)
+{
+}
+
+void
+Ipv4RouteCache::SetMaxSize (uint32_t maxSize)
+{
+  NS_LOG_FUNCTION (this << maxSize);
+  m_maxSize = maxSize;
+  Flush ();
+}
+
+uint32_t
+Ipv4RouteCache::GetMaxSize (void) const
+{
+  return m_maxSize;
+}
+
+bool
+Ipv4RouteCache::Lookup (Ipv4Address dest, Ptr<const NetDevice> oif, Ptr<Ipv4Route> &route)
+{
+  if (m_maxSize == 0)
+    {
+      return false;
+    }
+  Key key;
+  key.dest = dest;
+  key.oif = PeekPointer (oif);
+  Cache::const_iterator i = m_cache.find (key);
+  if (i == m_cache.end ())
+    {
+      m_misses++;
+      return false;
+    }
+  NS_LOG_LOGIC ("Found cached route to " << dest);
+  m_hits++;
+  route = i->second;
+  return true;
+}
+
+void
+Ipv4RouteCache::Add (Ipv4Address dest, Ptr<const NetDevice> oif, Ptr<Ipv4Route> route)
+{
+  if (m_maxSize == 0)
+    {
+      return;
+    }
+  if (m_cache.size () >= m_maxSize)
+    {
+      NS_LOG_LOGIC ("Route cache full, flushing");
+      m_cache.clear ();
+    }
+  Key key;
+  key.dest = dest;
+  key.oif = PeekPointer (oif);
+  m_cache[key] = route;
+}
+
+void
+Ipv4RouteCache::Flush (void)
+{
+  if (!m_cache.empty ())
+    {
+      m_cache.clear ();
+    }
+}
+
+uint64_t
+Ipv4RouteCache::GetHits (void) const
+{
+  return m_hits;
+}
+
+uint64_t
+Ipv4RouteCache::GetMisses (void) const
+{
+  return m_misses;
+}
+
+} // namespace ns3
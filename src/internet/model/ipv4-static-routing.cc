@@ -25,6 +25,7 @@
 
 #include <iomanip>
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
 #include "ns3/names.h"
 #include "ns3/packet.h"
 #include "ns3/node.h"
@@ -48,6 +49,24 @@ Ipv4StaticRouting::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::Ipv4StaticRouting")
     .SetParent<Ipv4RoutingProtocol> ()
     .AddConstructor<Ipv4StaticRouting> ()
+    .AddAttribute ("RouteCacheSize",
+                   "The maximum number of route lookups kept in the route cache, or zero to disable the cache",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&Ipv4StaticRouting::SetRouteCacheSize,
+                                         &Ipv4StaticRouting::GetRouteCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RouteCacheHits",
+                   "The number of route lookups found in the route cache",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4StaticRouting::GetRouteCacheHits),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("RouteCacheMisses",
+                   "The number of route lookups not found in the route cache",
+                   TypeId::ATTR_GET,
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4StaticRouting::GetRouteCacheMisses),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
@@ -71,7 +90,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         nextHop,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddNetworkRoute (route, metric);
 }
 
 void 
@@ -85,7 +104,41 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         interface);
-  m_networkRoutes.push_back (make_pair (route,metric));
+  AddNetworkRoute (route, metric);
+}
+
+void
+Ipv4StaticRouting::AddNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  uint8_t prefix[4];
+  route->GetDestNetwork ().Serialize (prefix);
+  m_networkRoutes.push_back (make_pair (route, metric));
+  m_networkRouteIndex.Insert (prefix, route->GetDestNetworkMask ().GetPrefixLength (), m_networkRoutes.back ());
+  m_routeCache.Flush ();
+}
+
+void
+Ipv4StaticRouting::SetRouteCacheSize (uint32_t size)
+{
+  m_routeCache.SetMaxSize (size);
+}
+
+uint32_t
+Ipv4StaticRouting::GetRouteCacheSize (void) const
+{
+  return m_routeCache.GetMaxSize ();
+}
+
+uint64_t
+Ipv4StaticRouting::GetRouteCacheHits (void) const
+{
+  return m_routeCache.GetHits ();
+}
+
+uint64_t
+Ipv4StaticRouting::GetRouteCacheMisses (void) const
+{
+  return m_routeCache.GetMisses ();
 }
 
 void 
@@ -142,7 +195,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         outputInterface);
-  m_networkRoutes.push_back (make_pair (route,0));
+  AddNetworkRoute (route, 0);
 }
 
 uint32_t 
@@ -223,8 +276,6 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << " " << oif);
   Ptr<Ipv4Route> rtentry = 0;
-  uint16_t longest_mask = 0;
-  uint32_t shortest_metric = 0xffffffff;
   /* when sending on local multicast, there have to be interface specified */
   if (dest.IsLocalMulticast ())
     {
@@ -238,53 +289,45 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
       return rtentry;
     }
 
+  if (m_routeCache.Lookup (dest, oif, rtentry))
+    {
+      return rtentry;
+    }
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  uint8_t key[4];
+  dest.Serialize (key);
+  Ipv4RoutingTableEntry *route = 0;
+  if (oif == 0)
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      const NetworkRouteIndex::Group *routes = m_networkRouteIndex.Lookup (key);
+      if (routes != 0)
         {
-          NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
-          if (oif != 0)
-            {
-              if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
-                {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
-                }
-            }
-          if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
-              continue;
-            }
-          if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-              shortest_metric = 0xffffffff;
-            }
-          longest_mask = masklen;
-          if (metric > shortest_metric)
-            {
-              NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-              continue;
-            }
-          shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
-          uint32_t interfaceIdx = route->GetInterface ();
-          rtentry = Create<Ipv4Route> ();
-          rtentry->SetDestination (route->GetDest ());
-          rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
-          rtentry->SetGateway (route->GetGateway ());
-          rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+          route = SelectRoute (*routes, oif);
+        }
+    }
+  else
+    {
+      // fall back to shorter prefixes when no route of the longest prefix
+      // goes through the requested interface.
+      std::vector<const NetworkRouteIndex::Group *> routes;
+      m_networkRouteIndex.LookupAll (key, routes);
+      for (std::vector<const NetworkRouteIndex::Group *>::const_iterator i = routes.begin ();
+           i != routes.end () && route == 0;
+           i++)
+        {
+          route = SelectRoute (**i, oif);
         }
     }
+  if (route != 0)
+    {
+      uint32_t interfaceIdx = route->GetInterface ();
+      rtentry = Create<Ipv4Route> ();
+      rtentry->SetDestination (route->GetDest ());
+      rtentry->SetSource (SourceAddressSelection (interfaceIdx, route->GetDest ()));
+      rtentry->SetGateway (route->GetGateway ());
+      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+    }
+  m_routeCache.Add (dest, oif, rtentry);
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Matching route via " << rtentry->GetGateway () << " at the end");
@@ -296,6 +339,36 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
   return rtentry;
 }
 
+Ipv4RoutingTableEntry *
+Ipv4StaticRouting::SelectRoute (const NetworkRouteIndex::Group &routes, Ptr<NetDevice> oif)
+{
+  NS_LOG_FUNCTION (this << oif);
+  Ipv4RoutingTableEntry *route = 0;
+  uint32_t shortest_metric = 0xffffffff;
+  for (NetworkRouteIndex::Group::const_iterator i = routes.begin (); i != routes.end (); i++)
+    {
+      Ipv4RoutingTableEntry *j = i->first;
+      uint32_t metric = i->second;
+      NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << j->GetDestNetworkMask ().GetPrefixLength () << ", metric " << metric);
+      if (oif != 0)
+        {
+          if (oif != m_ipv4->GetNetDevice (j->GetInterface ()))
+            {
+              NS_LOG_LOGIC ("Not on requested interface, skipping");
+              continue;
+            }
+        }
+      if (metric > shortest_metric)
+        {
+          NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+          continue;
+        }
+      shortest_metric = metric;
+      route = j;
+    }
+  return route;
+}
+
 Ptr<Ipv4MulticastRoute>
 Ipv4StaticRouting::LookupStatic (
   Ipv4Address origin, 
@@ -442,6 +515,10 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
+          uint8_t prefix[4];
+          j->first->GetDestNetwork ().Serialize (prefix);
+          m_networkRouteIndex.Remove (prefix, j->first->GetDestNetworkMask ().GetPrefixLength (), *j);
+          m_routeCache.Flush ();
           delete j->first;
           m_networkRoutes.erase (j);
           return;
@@ -590,6 +667,8 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkRouteIndex.Clear ();
+  m_routeCache.Flush ();
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -604,6 +683,7 @@ void
 Ipv4StaticRouting::NotifyInterfaceUp (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  m_routeCache.Flush ();
   // If interface address and network mask have been set, add a route
   // to the network of the interface (like e.g. ifconfig does on a
   // Linux box)
@@ -623,6 +703,7 @@ void
 Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
 {
   NS_LOG_FUNCTION (this << i);
+  m_routeCache.Flush ();
   // Remove all static routes that are going through this interface
   uint32_t j = 0;
   while (j < GetNRoutes ())
@@ -643,6 +724,7 @@ void
 Ipv4StaticRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << " " << address.GetLocal ());
+  m_routeCache.Flush ();
   if (!m_ipv4->IsUp (interface))
     {
       return;
@@ -661,6 +743,7 @@ void
 Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
   NS_LOG_FUNCTION (this << interface << " " << address.GetLocal ());
+  m_routeCache.Flush ();
   if (!m_ipv4->IsUp (interface))
     {
       return;
@@ -686,6 +769,7 @@ void
 Ipv4StaticRouting::SetIpv4 (Ptr<Ipv4> ipv4)
 {
   NS_LOG_FUNCTION (this << ipv4);
+  m_routeCache.Flush ();
   NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
   m_ipv4 = ipv4;
   for (uint32_t i = 0; i < m_ipv4->GetNInterfaces (); i++)
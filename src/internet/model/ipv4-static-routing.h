@@ -31,6 +31,8 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/prefix-trie.h"
+#include "ns3/ipv4-route-cache.h"
 
 namespace ns3 {
 
@@ -62,6 +64,14 @@ class Node;
  * Ipv4RoutingProtocol that defines the interface methods that a routing 
  * protocol must support.
  *
+ * A unicast lookup selects, among the routes whose destination network has
+ * the longest prefix matching the destination address, the one with the
+ * smallest metric. The routes are indexed in a prefix trie so that the
+ * cost of a lookup does not depend on the number of routes. The results
+ * of the lookups are kept in an Ipv4RouteCache which is flushed when a
+ * route is added or removed or an interface changes, so that the same
+ * Ipv4Route is returned for all the packets sent to the same destination.
+ *
  * \see Ipv4RoutingProtocol
  * \see Ipv4ListRouting
  * \see Ipv4ListRouting::AddRoutingProtocol
@@ -378,6 +388,7 @@ private:
   typedef std::list<std::pair <Ipv4RoutingTableEntry *, uint32_t> > NetworkRoutes;
   typedef std::list<std::pair <Ipv4RoutingTableEntry *, uint32_t> >::const_iterator NetworkRoutesCI;
   typedef std::list<std::pair <Ipv4RoutingTableEntry *, uint32_t> >::iterator NetworkRoutesI;
+  typedef PrefixTrie<std::pair <Ipv4RoutingTableEntry *, uint32_t>, 4> NetworkRouteIndex;
 
   typedef std::list<Ipv4MulticastRoutingTableEntry *> MulticastRoutes;
   typedef std::list<Ipv4MulticastRoutingTableEntry *>::const_iterator MulticastRoutesCI;
@@ -387,9 +398,19 @@ private:
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
 
+  Ipv4RoutingTableEntry *SelectRoute (const NetworkRouteIndex::Group &routes, Ptr<NetDevice> oif);
+  void AddNetworkRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+  void SetRouteCacheSize (uint32_t size);
+  uint32_t GetRouteCacheSize (void) const;
+  uint64_t GetRouteCacheHits (void) const;
+  uint64_t GetRouteCacheMisses (void) const;
+
   Ipv4Address SourceAddressSelection (uint32_t interface, Ipv4Address dest);
 
   NetworkRoutes m_networkRoutes;
+  // longest-prefix-match index of m_networkRoutes
+  NetworkRouteIndex m_networkRouteIndex;
+  Ipv4RouteCache m_routeCache;
   MulticastRoutes m_multicastRoutes;
 
   Ptr<Ipv4> m_ipv4;
@@ -37,34 +37,32 @@ Ipv6EndPointDemux::Ipv6EndPointDemux ()
 Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  EndPoints endPoints = GetEndPoints ();
+  for (EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      m_endPoints.Remove (endPoint);
       delete endPoint;
     }
-  m_endPoints.clear ();
 }
 
 bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort  () == port)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_endPoints.GetPort (port) != 0;
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  const Index::Bucket *bucket = m_endPoints.GetPort (port);
+  if (bucket == 0)
+    {
+      return false;
+    }
+  for (Index::Bucket::const_iterator i = bucket->begin (); i != bucket->end (); i++)
     {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
+      if (i->second->GetLocalAddress () == addr)
         {
           return true;
         }
@@ -72,6 +70,20 @@ bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
   return false;
 }
 
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  endPoint->m_demux = this;
+  m_endPoints.Insert (endPoint);
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.GetAll ().size () << "<< endpoints.");
+  return endPoint;
+}
+
+void Ipv6EndPointDemux::Update (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_endPoints.Update (endPoint);
+}
+
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -81,10 +93,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -96,10 +105,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (uint16_t port)
@@ -117,49 +123,54 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Insert (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t localPort,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  if (m_endPoints.Get (localAddress, localPort, peerAddress, peerPort) != 0)
     {
-      if ((*i)->GetLocalPort () == localPort
-          && (*i)->GetLocalAddress () == localAddress
-          && (*i)->GetPeerPort () == peerPort
-          && (*i)->GetPeerAddress () == peerAddress)
-        {
-          NS_LOG_WARN ("No way we can allocate this end-point.");
-          /* no way we can allocate this end-point. */
-          return 0;
-        }
+      NS_LOG_WARN ("No way we can allocate this end-point.");
+      /* no way we can allocate this end-point. */
+      return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
-  return endPoint;
+  return Insert (endPoint);
 }
 
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  if (m_endPoints.Remove (endPoint))
+    {
+      delete endPoint;
+    }
+}
+
+bool Ipv6EndPointDemux::AddMatches (const Index::Bucket *bucket, Ptr<Ipv6Interface> incomingInterface, EndPoints &endPoints)
+{
+  if (bucket == 0)
+    {
+      return false;
+    }
+  for (Index::Bucket::const_iterator i = bucket->begin (); i != bucket->end (); i++)
     {
-      if (*i == endPoint)
+      Ipv6EndPoint* endP = i->second;
+      if (endP->GetBoundNetDevice ()
+          && endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
         {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
+          NS_LOG_LOGIC ("Skipping endpoint " << endP
+                                             << " because endpoint is bound to specific device and"
+                                             << endP->GetBoundNetDevice ()
+                                             << " does not match packet device " << incomingInterface->GetDevice ());
+          continue;
         }
+      endPoints.push_back (endP);
     }
+  return !endPoints.empty ();
 }
 
 /*
@@ -179,102 +190,23 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval4; /* Exact match on all 4 */
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      Ipv6EndPoint* endP = *i;
-      NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
-                                                 << " daddr=" << endP->GetLocalAddress ()
-                                                 << " sport=" << endP->GetPeerPort ()
-                                                 << " saddr=" << endP->GetPeerAddress ());
-      if (endP->GetLocalPort () != dport)
-        {
-          NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                             << " because endpoint dport "
-                                             << endP->GetLocalPort ()
-                                             << " does not match packet dport " << dport);
-          continue;
-        }
-
-      if (endP->GetBoundNetDevice ())
-        {
-          if (endP->GetBoundNetDevice () != incomingInterface->GetDevice ())
-            {
-              NS_LOG_LOGIC ("Skipping endpoint " << &endP
-                                                 << " because endpoint is bound to specific device and"
-                                                 << endP->GetBoundNetDevice ()
-                                                 << " does not match packet device " << incomingInterface->GetDevice ());
-              continue;
-            }
-        }
-
-      /*    Ipv6Address incomingInterfaceAddr = incomingInterface->GetAddress (); */
-      NS_LOG_DEBUG ("dest addr " << daddr);
-
-      bool localAddressMatchesWildCard = endP->GetLocalAddress () == Ipv6Address::GetAny ();
-      bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
-      bool localAddressMatchesAllRouters = endP->GetLocalAddress () == Ipv6Address::GetAllRoutersMulticast ();
-
-      /* if no match here, keep looking */
-      if (!(localAddressMatchesExact || localAddressMatchesWildCard))
-        {
-          continue;
-        }
-      bool remotePeerMatchesExact = endP->GetPeerPort () == sport;
-      bool remotePeerMatchesWildCard = endP->GetPeerPort () == 0;
-      bool remoteAddressMatchesExact = endP->GetPeerAddress () == saddr;
-      bool remoteAddressMatchesWildCard = endP->GetPeerAddress () == Ipv6Address::GetAny ();
-
-      /* If remote does not match either with exact or wildcard,i
-         skip this one */
-      if (!(remotePeerMatchesExact || remotePeerMatchesWildCard))
-        {
-          continue;
-        }
-      if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-          continue;
-        }
-
-      /* Now figure out which return list to add this one to */
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port matches exactly */
-          retval1.push_back (endP);
-        }
-      if ((localAddressMatchesExact || (localAddressMatchesAllRouters))
-          && remotePeerMatchesWildCard
-          && remoteAddressMatchesWildCard)
-        { /* Only local port and local address matches exactly */
-          retval2.push_back (endP);
-        }
-      if (localAddressMatchesWildCard
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All but local address */
-          retval3.push_back (endP);
-        }
-      if (localAddressMatchesExact
-          && remotePeerMatchesExact
-          && remoteAddressMatchesExact)
-        { /* All 4 match */
-          retval4.push_back (endP);
-        }
-    }
 
-  /* Here we find the most exact match */
-  if (!retval4.empty ())
+  /* Each list holds the end points whose four-tuple is the packet
+     four-tuple with some fields replaced by wildcards: look for the
+     most exact match first */
+  if (AddMatches (m_endPoints.Get (daddr, dport, saddr, sport), incomingInterface, retval4))
     {
       return retval4;
     }
-  if (!retval3.empty ())
+  if (AddMatches (m_endPoints.Get (Ipv6Address::GetAny (), dport, saddr, sport), incomingInterface, retval3))
     {
       return retval3;
     }
-  if (!retval2.empty ())
+  if (AddMatches (m_endPoints.Get (daddr, dport, Ipv6Address::GetAny (), 0), incomingInterface, retval2))
     {
       return retval2;
     }
+  AddMatches (m_endPoints.Get (Ipv6Address::GetAny (), dport, Ipv6Address::GetAny (), 0), incomingInterface, retval1);
   return retval1;  /* might be empty if no matches */
 }
 
@@ -283,35 +215,36 @@ Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport,
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  const Index::Bucket *exact = m_endPoints.Get (dst, dport, src, sport);
+  if (exact != 0)
     {
-      uint32_t tmp = 0;
+      /* this is an exact match. */
+      return exact->begin ()->second;
+    }
 
-      if ((*i)->GetLocalPort () != dport)
-        {
-          continue;
-        }
+  const Index::Bucket *endPoints = m_endPoints.GetPort (dport);
+  if (endPoints == 0)
+    {
+      return 0;
+    }
 
-      if ((*i)->GetLocalAddress () == dst && (*i)->GetPeerPort () == sport
-          && (*i)->GetPeerAddress () == src)
-        {
-          /* this is an exact match. */
-          return *i;
-        }
+  for (Index::Bucket::const_iterator i = endPoints->begin (); i != endPoints->end (); i++)
+    {
+      uint32_t tmp = 0;
 
-      if ((*i)->GetLocalAddress () == Ipv6Address::GetAny ())
+      if (i->second->GetLocalAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
-      if ((*i)->GetPeerAddress () == Ipv6Address::GetAny ())
+      if (i->second->GetPeerAddress () == Ipv6Address::GetAny ())
         {
           tmp++;
         }
 
       if (tmp < genericity)
         {
-          generic = (*i);
+          generic = i->second;
           genericity = tmp;
         }
     }
@@ -335,14 +268,20 @@ uint16_t Ipv6EndPointDemux::AllocateEphemeralPort ()
           port = m_portFirst;
         }
     }
-  while (LookupPortLocal (port));
+  while (m_endPoints.GetPort (port) != 0);
   m_ephemeral = port;
   return port;
 }
 
 Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::GetEndPoints () const
 {
-  return m_endPoints;
+  EndPoints ret;
+  const Index::Bucket &all = m_endPoints.GetAll ();
+  for (Index::Bucket::const_iterator i = all.begin (); i != all.end (); i++)
+    {
+      ret.push_back (i->second);
+    }
+  return ret;
 }
 
 } /* namespace ns3 */
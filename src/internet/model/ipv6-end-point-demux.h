@@ -25,6 +25,7 @@
 #include <list>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
+#include "end-point-index.h"
 
 namespace ns3 {
 
@@ -33,6 +34,11 @@ class Ipv6EndPoint;
 /**
  * \class Ipv6EndPointDemux
  * \brief Demultiplexor for end points.
+ *
+ * The end points are indexed on their local port and on their four-tuple,
+ * so that a lookup only looks at the end points whose four-tuple is one
+ * of the wildcard combinations of the packet four-tuple. The end points
+ * notify the demux when their addresses or ports change.
  */
 class Ipv6EndPointDemux
 {
@@ -137,12 +143,42 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief Index of the end points.
+   */
+  typedef EndPointIndex<Ipv6EndPoint, Ipv6Address, Ipv6AddressHash> Index;
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
    */
   uint16_t AllocateEphemeralPort ();
 
+  /**
+   * \brief Add a new end point to the index.
+   * \param endPoint the end point
+   * \return the end point
+   */
+  Ipv6EndPoint* Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Index again an end point whose addresses or ports changed.
+   * \param endPoint the end point
+   */
+  void Update (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Append the end points of a bucket which are not bound to
+   * another device than the incoming one.
+   * \param bucket the bucket, or 0
+   * \param incomingInterface the incoming interface
+   * \param endPoints the list to append the end points to
+   * \return true if endPoints is not empty
+   */
+  static bool AddMatches (const Index::Bucket *bucket, Ptr<Ipv6Interface> incomingInterface, EndPoints &endPoints);
+
   /**
    * \brief The ephemeral port.
    */
@@ -159,9 +195,9 @@ private:
   uint16_t m_portLast;
 
   /**
-   * \brief A list of IPv6 end points.
+   * \brief The IPv6 end points.
    */
-  EndPoints m_endPoints;
+  Index m_endPoints;
 };
 
 } /* namespace ns3 */
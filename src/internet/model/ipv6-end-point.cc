@@ -23,6 +23,7 @@
 #include "ns3/simulator.h"
 
 #include "ipv6-end-point.h"
+#include "ipv6-end-point-demux.h"
 
 namespace ns3
 {
@@ -33,7 +34,8 @@ Ipv6EndPoint::Ipv6EndPoint (Ipv6Address addr, uint16_t port)
   : m_localAddr (addr),
     m_localPort (port),
     m_peerAddr (Ipv6Address::GetAny ()),
-    m_peerPort (0)
+    m_peerPort (0),
+    m_demux (0)
 {
 }
 
@@ -56,6 +58,10 @@ Ipv6Address Ipv6EndPoint::GetLocalAddress ()
 void Ipv6EndPoint::SetLocalAddress (Ipv6Address addr)
 {
   m_localAddr = addr;
+  if (m_demux != 0)
+    {
+      m_demux->Update (this);
+    }
 }
 
 uint16_t Ipv6EndPoint::GetLocalPort ()
@@ -66,6 +72,10 @@ uint16_t Ipv6EndPoint::GetLocalPort ()
 void Ipv6EndPoint::SetLocalPort (uint16_t port)
 {
   m_localPort = port;
+  if (m_demux != 0)
+    {
+      m_demux->Update (this);
+    }
 }
 
 Ipv6Address Ipv6EndPoint::GetPeerAddress ()
@@ -93,6 +103,10 @@ void Ipv6EndPoint::SetPeer (Ipv6Address addr, uint16_t port)
 {
   m_peerAddr = addr;
   m_peerPort = port;
+  if (m_demux != 0)
+    {
+      m_demux->Update (this);
+    }
 }
 
 void Ipv6EndPoint::SetRxCallback (Callback<void, Ptr<Packet>, Ipv6Header, uint16_t> callback)
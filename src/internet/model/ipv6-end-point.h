@@ -33,6 +33,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \class Ipv6EndPoint
@@ -168,6 +169,8 @@ public:
                     uint8_t code, uint32_t info);
 
 private:
+  friend class Ipv6EndPointDemux;
+
   /**
    * \brief ForwardUp wrapper.
    * \param p packet
@@ -227,6 +230,11 @@ private:
    * \brief The destroy callback.
    */
   Callback<void> m_destroyCallback;
+
+  /**
+   * \brief The demux which indexes this end point, if any.
+   */
+  Ipv6EndPointDemux *m_demux;
 };
 
 } /* namespace ns3 */
@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -49,6 +50,12 @@ class Ipv6MulticastRoutingTableEntry;
  * \ingroup ipv6StaticRouting
  * \class Ipv6StaticRouting
  * \brief Static routing protocol for IP version 6 stack.
+ *
+ * A unicast lookup selects, among the routes whose destination network has
+ * the longest prefix matching the destination address, the one with the
+ * smallest metric. The routes are indexed in a prefix trie so that the
+ * cost of a lookup does not depend on the number of routes.
+ *
  * \see Ipv6RoutingProtocol
  * \see Ipv6ListRouting
  */
@@ -253,6 +260,7 @@ private:
   typedef std::list<std::pair <Ipv6RoutingTableEntry *, uint32_t> > NetworkRoutes;
   typedef std::list<std::pair <Ipv6RoutingTableEntry *, uint32_t> >::const_iterator NetworkRoutesCI;
   typedef std::list<std::pair <Ipv6RoutingTableEntry *, uint32_t> >::iterator NetworkRoutesI;
+  typedef PrefixTrie<std::pair <Ipv6RoutingTableEntry *, uint32_t>, 16> NetworkRouteIndex;
 
   typedef std::list<Ipv6MulticastRoutingTableEntry *> MulticastRoutes;
   typedef std::list<Ipv6MulticastRoutingTableEntry *>::const_iterator MulticastRoutesCI;
@@ -275,6 +283,28 @@ private:
    */
   Ptr<Ipv6MulticastRoute> LookupStatic (Ipv6Address origin, Ipv6Address group, uint32_t ifIndex);
 
+  /**
+   * \brief Select the route with the smallest metric among routes to the same network.
+   * \param routes the routes to a network
+   * \param interface output interface if any (put 0 otherwise)
+   * \return the last of the routes on the interface which have the smallest metric, or 0
+   */
+  Ipv6RoutingTableEntry* SelectRoute (const NetworkRouteIndex::Group &routes, Ptr<NetDevice> interface);
+
+  /**
+   * \brief Append a route to the forwarding table and index it.
+   * \param route the route
+   * \param metric metric of the route
+   */
+  void AddNetworkRoute (Ipv6RoutingTableEntry* route, uint32_t metric);
+
+  /**
+   * \brief Remove a route from the forwarding table and delete it.
+   * \param it the route
+   * \return the route which followed it
+   */
+  NetworkRoutesI RemoveNetworkRoute (NetworkRoutesI it);
+
   /**
    * \brief Choose the source address to use with destination address.
    * \param interface interface index
@@ -288,6 +318,11 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the longest-prefix-match index of the forwarding table for network.
+   */
+  NetworkRouteIndex m_networkRouteIndex;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -0,0 +1,345 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include "ns3/assert.h"
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ * \brief longest-prefix-match index of the routes of a routing table
+ *
+ * A path-compressed binary trie over N-byte keys in network byte order
+ * (4 for IPv4, 16 for IPv6): each node holds a prefix and only the nodes
+ * whose prefix is a branching point or the destination of a route are
+ * stored, so that a lookup visits at most one node per distinct prefix
+ * length which matches the key. The values associated with the same
+ * prefix (such as the routes of an ECMP group) are kept contiguously in
+ * their order of insertion.
+ *
+ * The trie only indexes values: the routing tables keep owning their
+ * entries and must remove them from the trie when they delete them.
+ */
+template <typename T, uint32_t N>
+class PrefixTrie
+{
+public:
+  /**
+   * The values associated with a prefix, in their order of insertion.
+   */
+  typedef std::vector<T> Group;
+
+  PrefixTrie ();
+  ~PrefixTrie ();
+
+  /**
+   * \param prefix the prefix, whose bits past length are ignored.
+   * \param length the length of the prefix, in bits.
+   * \param value the value to append to the group of the prefix.
+   */
+  void Insert (const uint8_t prefix[N], uint32_t length, const T &value);
+  /**
+   * \param prefix the prefix, whose bits past length are ignored.
+   * \param length the length of the prefix, in bits.
+   * \param value the value to remove from the group of the prefix.
+   * \returns false if the value was not associated with the prefix.
+   */
+  bool Remove (const uint8_t prefix[N], uint32_t length, const T &value);
+  /**
+   * Remove all the values.
+   */
+  void Clear (void);
+  /**
+   * \param key the key to look up.
+   * \returns the group of the longest prefix of key which has values, or
+   *          zero if there is none.
+   */
+  const Group *Lookup (const uint8_t key[N]) const;
+  /**
+   * \param key the key to look up.
+   * \param groups filled with the groups of all the prefixes of key which
+   *        have values, from the longest prefix to the shortest.
+   */
+  void LookupAll (const uint8_t key[N], std::vector<const Group *> &groups) const;
+
+private:
+  struct Node
+  {
+    uint8_t key[N];
+    uint32_t length;
+    Node *child[2];
+    Group values;
+  };
+
+  PrefixTrie (const PrefixTrie &o);
+  PrefixTrie &operator = (const PrefixTrie &o);
+
+  static uint32_t GetBit (const uint8_t *key, uint32_t i);
+  static uint32_t GetCommonLength (const uint8_t *a, const uint8_t *b, uint32_t max);
+  static bool IsMatch (const Node *node, const uint8_t *key);
+  static Node *CreateNode (const uint8_t *prefix, uint32_t length);
+  static void DeleteNodes (Node *node);
+  void Collapse (Node **link);
+
+  Node *m_root;
+};
+
+} // namespace ns3
+
+namespace ns3 {
+
+template <typename T, uint32_t N>
+PrefixTrie<T,N>::PrefixTrie ()
+  : m_root (CreateNode (0, 0))
+{
+}
+
+template <typename T, uint32_t N>
+PrefixTrie<T,N>::~PrefixTrie ()
+{
+  DeleteNodes (m_root);
+  m_root = 0;
+}
+
+template <typename T, uint32_t N>
+uint32_t
+PrefixTrie<T,N>::GetBit (const uint8_t *key, uint32_t i)
+{
+  return (key[i >> 3] >> (7 - (i & 7))) & 1;
+}
+
+template <typename T, uint32_t N>
+uint32_t
+PrefixTrie<T,N>::GetCommonLength (const uint8_t *a, const uint8_t *b, uint32_t max)
+{
+  for (uint32_t i = 0; i * 8 < max; i++)
+    {
+      uint8_t diff = a[i] ^ b[i];
+      if (diff != 0)
+        {
+          uint32_t length = i * 8;
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              length++;
+            }
+          return std::min (length, max);
+        }
+    }
+  return max;
+}
+
+template <typename T, uint32_t N>
+bool
+PrefixTrie<T,N>::IsMatch (const Node *node, const uint8_t *key)
+{
+  return GetCommonLength (node->key, key, node->length) == node->length;
+}
+
+template <typename T, uint32_t N>
+typename PrefixTrie<T,N>::Node *
+PrefixTrie<T,N>::CreateNode (const uint8_t *prefix, uint32_t length)
+{
+  NS_ASSERT (length <= N * 8);
+  Node *node = new Node ();
+  for (uint32_t i = 0; i < N; i++)
+    {
+      if (length >= (i + 1) * 8)
+        {
+          node->key[i] = prefix[i];
+        }
+      else if (length > i * 8)
+        {
+          node->key[i] = prefix[i] & (0xff << (8 - (length - i * 8)));
+        }
+      else
+        {
+          node->key[i] = 0;
+        }
+    }
+  node->length = length;
+  node->child[0] = 0;
+  node->child[1] = 0;
+  return node;
+}
+
+template <typename T, uint32_t N>
+void
+PrefixTrie<T,N>::DeleteNodes (Node *node)
+{
+  if (node != 0)
+    {
+      DeleteNodes (node->child[0]);
+      DeleteNodes (node->child[1]);
+      delete node;
+    }
+}
+
+template <typename T, uint32_t N>
+void
+PrefixTrie<T,N>::Insert (const uint8_t prefix[N], uint32_t length, const T &value)
+{
+  NS_ASSERT (length <= N * 8);
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      uint32_t common = GetCommonLength (node->key, prefix, std::min (node->length, length));
+      if (common < node->length)
+        {
+          // the new prefix branches off, or is a prefix of, the prefix of
+          // the node: insert a node for the common prefix above it.
+          Node *split = CreateNode (prefix, common);
+          split->child[GetBit (node->key, common)] = node;
+          *link = split;
+          if (common == length)
+            {
+              split->values.push_back (value);
+            }
+          else
+            {
+              Node *leaf = CreateNode (prefix, length);
+              leaf->values.push_back (value);
+              split->child[GetBit (prefix, common)] = leaf;
+            }
+          return;
+        }
+      if (node->length == length)
+        {
+          node->values.push_back (value);
+          return;
+        }
+      link = &node->child[GetBit (prefix, node->length)];
+      if (*link == 0)
+        {
+          *link = CreateNode (prefix, length);
+          (*link)->values.push_back (value);
+          return;
+        }
+    }
+}
+
+template <typename T, uint32_t N>
+void
+PrefixTrie<T,N>::Collapse (Node **link)
+{
+  // the root stays even when it has no values; other nodes are only kept
+  // if they have values or if they are branching points.
+  Node *node = *link;
+  if (link == &m_root || !node->values.empty ()
+      || (node->child[0] != 0 && node->child[1] != 0))
+    {
+      return;
+    }
+  *link = node->child[0] != 0 ? node->child[0] : node->child[1];
+  delete node;
+}
+
+template <typename T, uint32_t N>
+bool
+PrefixTrie<T,N>::Remove (const uint8_t prefix[N], uint32_t length, const T &value)
+{
+  NS_ASSERT (length <= N * 8);
+  Node **parentLink = 0;
+  Node **link = &m_root;
+  while (*link != 0 && (*link)->length < length)
+    {
+      if (!IsMatch (*link, prefix))
+        {
+          return false;
+        }
+      parentLink = link;
+      link = &(*link)->child[GetBit (prefix, (*link)->length)];
+    }
+  Node *node = *link;
+  if (node == 0 || node->length != length || !IsMatch (node, prefix))
+    {
+      return false;
+    }
+  typename Group::iterator i = std::find (node->values.begin (), node->values.end (), value);
+  if (i == node->values.end ())
+    {
+      return false;
+    }
+  node->values.erase (i);
+  // removing the node can leave its parent with a single child.
+  Collapse (link);
+  if (parentLink != 0)
+    {
+      Collapse (parentLink);
+    }
+  return true;
+}
+
+template <typename T, uint32_t N>
+void
+PrefixTrie<T,N>::Clear (void)
+{
+  DeleteNodes (m_root);
+  m_root = CreateNode (0, 0);
+}
+
+template <typename T, uint32_t N>
+const typename PrefixTrie<T,N>::Group *
+PrefixTrie<T,N>::Lookup (const uint8_t key[N]) const
+{
+  const Group *found = 0;
+  const Node *node = m_root;
+  while (node != 0 && IsMatch (node, key))
+    {
+      if (!node->values.empty ())
+        {
+          found = &node->values;
+        }
+      if (node->length == N * 8)
+        {
+          break;
+        }
+      node = node->child[GetBit (key, node->length)];
+    }
+  return found;
+}
+
+template <typename T, uint32_t N>
+void
+PrefixTrie<T,N>::LookupAll (const uint8_t key[N], std::vector<const Group *> &groups) const
+{
+  groups.clear ();
+  const Node *node = m_root;
+  while (node != 0 && IsMatch (node, key))
+    {
+      if (!node->values.empty ())
+        {
+          groups.push_back (&node->values);
+        }
+      if (node->length == N * 8)
+        {
+          break;
+        }
+      node = node->child[GetBit (key, node->length)];
+    }
+  std::reverse (groups.begin (), groups.end ());
+}
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
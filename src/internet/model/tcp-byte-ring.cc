@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "ns3/packet.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include "tcp-byte-ring.h"
+
+NS_LOG_COMPONENT_DEFINE ("TcpByteRing");
+
+namespace ns3 {
+
+TcpByteRing::TcpByteRing ()
+  : m_head (0),
+    m_extent (0),
+    m_position (0)
+{
+}
+
+uint32_t
+TcpByteRing::GetCapacity (void) const
+{
+  return m_bytes.size ();
+}
+
+void
+TcpByteRing::Reserve (uint32_t size)
+{
+  uint32_t capacity = m_bytes.size ();
+  if (size <= capacity)
+    {
+      return;
+    }
+  uint32_t newCapacity = std::max<uint32_t> (capacity, 4096);
+  while (newCapacity < size)
+    {
+      newCapacity *= 2;
+    }
+  NS_LOG_LOGIC ("Grow the ring from " << capacity << " to " << newCapacity << " bytes");
+  // Move the bytes written so far to the beginning of the new storage
+  std::vector<uint8_t> bytes (newCapacity);
+  if (m_extent > 0)
+    {
+      uint32_t first = std::min (m_extent, capacity - m_head);
+      std::memcpy (&bytes[0], &m_bytes[m_head], first);
+      if (first < m_extent)
+        {
+          std::memcpy (&bytes[first], &m_bytes[0], m_extent - first);
+        }
+    }
+  m_bytes.swap (bytes);
+  m_head = 0;
+}
+
+void
+TcpByteRing::Write (uint32_t offset, Ptr<const Packet> p, uint32_t start, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << offset << p << start << size);
+  NS_ASSERT (start + size <= p->GetSize ());
+  if (size == 0)
+    {
+      return;
+    }
+  Reserve (offset + size);
+  if (m_scratch.size () < start + size)
+    {
+      m_scratch.resize (start + size);
+    }
+  p->CopyData (&m_scratch[0], start + size);
+  const uint8_t *data = &m_scratch[start];
+
+  // Record the non-zero bytes, merging their range with the ranges that
+  // it overlaps or touches
+  uint32_t first = 0;
+  while (first < size && data[first] == 0)
+    {
+      first++;
+    }
+  if (first < size)
+    {
+      uint32_t last = size;
+      while (data[last - 1] == 0)
+        {
+          last--;
+        }
+      uint64_t begin = m_position + offset + first;
+      uint64_t end = m_position + offset + last;
+      std::map<uint64_t, uint64_t>::iterator i = m_nonZero.upper_bound (begin);
+      if (i != m_nonZero.begin ())
+        {
+          std::map<uint64_t, uint64_t>::iterator previous = i;
+          --previous;
+          if (previous->second >= begin)
+            {
+              i = previous;
+            }
+        }
+      while (i != m_nonZero.end () && i->first <= end)
+        {
+          begin = std::min (begin, i->first);
+          end = std::max (end, i->second);
+          m_nonZero.erase (i++);
+        }
+      m_nonZero[begin] = end;
+    }
+
+  uint32_t mask = m_bytes.size () - 1;
+  uint32_t index = (m_head + offset) & mask;
+  uint32_t part = std::min<uint32_t> (size, m_bytes.size () - index);
+  std::memcpy (&m_bytes[index], data, part);
+  if (part < size)
+    {
+      std::memcpy (&m_bytes[0], data + part, size - part);
+    }
+  m_extent = std::max (m_extent, offset + size);
+}
+
+bool
+TcpByteRing::IsZero (uint64_t begin, uint64_t end) const
+{
+  std::map<uint64_t, uint64_t>::const_iterator i = m_nonZero.upper_bound (begin);
+  if (i != m_nonZero.end () && i->first < end)
+    {
+      return false;
+    }
+  if (i != m_nonZero.begin ())
+    {
+      --i;
+      if (i->second > begin)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+Ptr<Packet>
+TcpByteRing::Read (uint32_t offset, uint32_t size) const
+{
+  NS_LOG_FUNCTION (this << offset << size);
+  NS_ASSERT (offset + size <= m_extent);
+  if (size == 0 || IsZero (m_position + offset, m_position + offset + size))
+    {
+      return Create<Packet> (size);
+    }
+  uint32_t mask = m_bytes.size () - 1;
+  uint32_t index = (m_head + offset) & mask;
+  if (index + size <= m_bytes.size ())
+    {
+      return Create<Packet> (&m_bytes[index], size);
+    }
+  if (m_scratch.size () < size)
+    {
+      m_scratch.resize (size);
+    }
+  uint32_t part = m_bytes.size () - index;
+  std::memcpy (&m_scratch[0], &m_bytes[index], part);
+  std::memcpy (&m_scratch[part], &m_bytes[0], size - part);
+  return Create<Packet> (&m_scratch[0], size);
+}
+
+void
+TcpByteRing::Discard (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  size = std::min (size, m_extent);
+  if (!m_bytes.empty ())
+    {
+      m_head = (m_head + size) & (m_bytes.size () - 1);
+    }
+  m_extent -= size;
+  m_position += size;
+  while (!m_nonZero.empty () && m_nonZero.begin ()->second <= m_position)
+    {
+      m_nonZero.erase (m_nonZero.begin ());
+    }
+}
+
+void
+TcpByteRing::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_position += m_extent;
+  m_head = 0;
+  m_extent = 0;
+  m_nonZero.clear ();
+}
+
+} // namespace ns3
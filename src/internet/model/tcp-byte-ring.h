@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_BYTE_RING_H
+#define TCP_BYTE_RING_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief a ring of bytes which stores the data of TcpTxBuffer and
+ *        TcpRxBuffer in their ring storage mode
+ *
+ * The bytes are addressed by their offset from the head of the ring, and
+ * the capacity of the ring doubles whenever a write goes beyond it, so
+ * that writing, reading and discarding bytes cost a copy of these bytes,
+ * whatever the number of packets that they came from.
+ *
+ * Most simulations send dummy data, i.e., packets with a virtual
+ * zero-filled payload. The ring remembers which bytes were written from
+ * non-zero data, and a read of bytes which are all zero returns a packet
+ * with a virtual payload again.
+ *
+ * The packet tags and byte tags of the written packets are not kept.
+ */
+class TcpByteRing
+{
+public:
+  TcpByteRing ();
+
+  /**
+   * \param offset the offset from the head of the ring of the first byte
+   *        to write
+   * \param p the packet holding the bytes to write
+   * \param start the offset in the packet of the first byte to write
+   * \param size the number of bytes to write
+   */
+  void Write (uint32_t offset, Ptr<const Packet> p, uint32_t start, uint32_t size);
+  /**
+   * \param offset the offset from the head of the ring of the first byte
+   *        to read, which must have been written
+   * \param size the number of bytes to read
+   * \returns a packet with these bytes
+   */
+  Ptr<Packet> Read (uint32_t offset, uint32_t size) const;
+  /**
+   * Move the head of the ring forward.
+   *
+   * \param size the number of bytes to discard
+   */
+  void Discard (uint32_t size);
+  /**
+   * Discard all the bytes, but keep the memory of the ring.
+   */
+  void Clear (void);
+  /**
+   * \returns the number of bytes that the ring can hold without growing
+   */
+  uint32_t GetCapacity (void) const;
+
+private:
+  void Reserve (uint32_t size);
+  bool IsZero (uint64_t begin, uint64_t end) const;
+
+  std::vector<uint8_t> m_bytes;            //< Storage, a power of two bytes
+  uint32_t m_head;                         //< Index of the byte at offset 0
+  uint32_t m_extent;                       //< Offset after the last byte written
+  uint64_t m_position;                     //< Position in the stream of the byte at offset 0
+  std::map<uint64_t, uint64_t> m_nonZero;  //< Ranges of positions written with non-zero data
+  mutable std::vector<uint8_t> m_scratch;  //< Bytes of the packet being written or read
+};
+
+} // namespace ns3
+
+#endif /* TCP_BYTE_RING_H */
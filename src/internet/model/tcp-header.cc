@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <iostream>
 #include "tcp-header.h"
+#include "ns3/assert.h"
 #include "ns3/buffer.h"
 #include "ns3/address-utils.h"
 
@@ -28,6 +29,8 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (TcpHeader);
 
+const uint32_t TcpHeader::MAX_SACK_BLOCKS;
+
 TcpHeader::TcpHeader ()
   : m_sourcePort (0),
     m_destinationPort (0),
@@ -37,6 +40,7 @@ TcpHeader::TcpHeader ()
     m_flags (0),
     m_windowSize (0xffff),
     m_urgentPointer (0),
+    m_sackPermitted (false),
     m_calcChecksum (false),
     m_goodChecksum (true)
 {
@@ -118,6 +122,57 @@ uint16_t TcpHeader::GetUrgentPointer () const
   return m_urgentPointer;
 }
 
+void
+TcpHeader::SetSackPermitted (bool permitted)
+{
+  m_sackPermitted = permitted;
+  UpdateLength ();
+}
+bool
+TcpHeader::IsSackPermitted (void) const
+{
+  return m_sackPermitted;
+}
+void
+TcpHeader::SetSackBlocks (const SackList &blocks)
+{
+  NS_ASSERT (blocks.size () <= MAX_SACK_BLOCKS);
+  m_sackBlocks = blocks;
+  UpdateLength ();
+}
+const TcpHeader::SackList &
+TcpHeader::GetSackBlocks (void) const
+{
+  return m_sackBlocks;
+}
+
+/*
+ * Each option is preceded by NOPs so that it is aligned on 32 bits, as
+ * recommended by RFC 2018: two NOPs and the two bytes of the
+ * SACK-permitted option, then two NOPs, the kind and length bytes and the
+ * blocks of the SACK option.
+ */
+uint32_t
+TcpHeader::GetOptionsSize (void) const
+{
+  uint32_t size = 0;
+  if (m_sackPermitted)
+    {
+      size += 4;
+    }
+  if (!m_sackBlocks.empty ())
+    {
+      size += 4 + 8 * m_sackBlocks.size ();
+    }
+  return size;
+}
+
+void
+TcpHeader::UpdateLength (void)
+{
+  m_length = 5 + GetOptionsSize () / 4;
+}
+
 void 
 TcpHeader::InitializeChecksum (Ipv4Address source, 
                                Ipv4Address destination,
@@ -252,6 +307,14 @@ void TcpHeader::Print (std::ostream &os)  const
       os<<"]";
     }
   os<<" Seq="<<m_sequenceNumber<<" Ack="<<m_ackNumber<<" Win="<<m_windowSize;
+  if (m_sackPermitted)
+    {
+      os<<" SackPermitted";
+    }
+  for (SackList::const_iterator i = m_sackBlocks.begin (); i != m_sackBlocks.end (); ++i)
+    {
+      os<<" Sack="<<i->first<<"-"<<i->second;
+    }
 }
 uint32_t TcpHeader::GetSerializedSize (void)  const
 {
@@ -269,6 +332,33 @@ void TcpHeader::Serialize (Buffer::Iterator start)  const
   i.WriteHtonU16 (0);
   i.WriteHtonU16 (m_urgentPointer);
 
+  uint32_t optionsSize = 0;
+  if (m_sackPermitted)
+    {
+      i.WriteU8 (NOP);
+      i.WriteU8 (NOP);
+      i.WriteU8 (SACK_PERMITTED);
+      i.WriteU8 (2);
+      optionsSize += 4;
+    }
+  if (!m_sackBlocks.empty ())
+    {
+      i.WriteU8 (NOP);
+      i.WriteU8 (NOP);
+      i.WriteU8 (SACK);
+      i.WriteU8 (2 + 8 * m_sackBlocks.size ());
+      for (SackList::const_iterator j = m_sackBlocks.begin (); j != m_sackBlocks.end (); ++j)
+        {
+          i.WriteHtonU32 (j->first.GetValue ());
+          i.WriteHtonU32 (j->second.GetValue ());
+        }
+      optionsSize += 4 + 8 * m_sackBlocks.size ();
+    }
+  for (; optionsSize < 4 * m_length - 20u; optionsSize++)
+    {
+      i.WriteU8 (EOL);
+    }
+
   if(m_calcChecksum)
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
@@ -294,6 +384,55 @@ uint32_t TcpHeader::Deserialize (Buffer::Iterator start)
   i.Next (2);
   m_urgentPointer = i.ReadNtohU16 ();
 
+  // Options: only SACK-permitted and SACK are understood, the others are
+  // skipped
+  m_sackPermitted = false;
+  m_sackBlocks.clear ();
+  uint32_t optionsSize = m_length > 5 ? 4 * m_length - 20 : 0;
+  uint32_t read = 0;
+  while (read < optionsSize)
+    {
+      uint8_t kind = i.ReadU8 ();
+      read++;
+      if (kind == EOL)
+        {
+          break;
+        }
+      if (kind == NOP)
+        {
+          continue;
+        }
+      if (read == optionsSize)
+        {
+          break;
+        }
+      uint8_t length = i.ReadU8 ();
+      read++;
+      if (length < 2 || read + length - 2 > optionsSize)
+        { // Malformed option
+          break;
+        }
+      if (kind == SACK_PERMITTED)
+        {
+          m_sackPermitted = true;
+        }
+      else if (kind == SACK)
+        {
+          for (uint32_t blocks = (length - 2) / 8; blocks > 0; blocks--)
+            {
+              SequenceNumber32 begin = SequenceNumber32 (i.ReadNtohU32 ());
+              SequenceNumber32 end = SequenceNumber32 (i.ReadNtohU32 ());
+              m_sackBlocks.push_back (SackBlock (begin, end));
+            }
+          i.Next ((length - 2) % 8);
+        }
+      else
+        {
+          i.Next (length - 2);
+        }
+      read += length - 2;
+    }
+
   if(m_calcChecksum)
     {
       uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
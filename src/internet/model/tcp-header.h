@@ -22,6 +22,8 @@
 #define TCP_HEADER_H
 
 #include <stdint.h>
+#include <list>
+#include <utility>
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "ns3/tcp-socket-factory.h"
@@ -143,6 +145,40 @@ public:
   typedef enum { NONE = 0, FIN = 1, SYN = 2, RST = 4, PSH = 8, ACK = 16, 
                  URG = 32, ECE = 64, CWR = 128} Flags_t;
 
+  typedef enum { EOL = 0, NOP = 1, SACK_PERMITTED = 4, SACK = 5 } Option_t;
+
+  /**
+   * A block of data received by the sender of a SACK option, from its
+   * first byte to the byte following its last one (RFC 2018).
+   */
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  typedef std::list<SackBlock> SackList;
+
+  /**
+   * The maximum number of blocks of a SACK option, given the 40 bytes of
+   * option space of a TCP header.
+   */
+  static const uint32_t MAX_SACK_BLOCKS = 4;
+
+  /**
+   * \param permitted whether this header, which should be a SYN, carries
+   *        the SACK-permitted option
+   */
+  void SetSackPermitted (bool permitted);
+  /**
+   * \return true if this header carries the SACK-permitted option
+   */
+  bool IsSackPermitted (void) const;
+  /**
+   * \param blocks the blocks of the SACK option of this header, at most
+   *        MAX_SACK_BLOCKS of them, or an empty list for no SACK option
+   */
+  void SetSackBlocks (const SackList &blocks);
+  /**
+   * \return the blocks of the SACK option of this header, if any
+   */
+  const SackList &GetSackBlocks (void) const;
+
   static TypeId GetTypeId (void);
   virtual TypeId GetInstanceTypeId (void) const;
   virtual void Print (std::ostream &os) const;
@@ -158,6 +194,8 @@ public:
 
 private:
   uint16_t CalculateHeaderChecksum (uint16_t size) const;
+  uint32_t GetOptionsSize (void) const;
+  void UpdateLength (void);
   uint16_t m_sourcePort;
   uint16_t m_destinationPort;
   SequenceNumber32 m_sequenceNumber;
@@ -166,6 +204,8 @@ private:
   uint8_t m_flags;      // really a uint6_t
   uint16_t m_windowSize;
   uint16_t m_urgentPointer;
+  bool m_sackPermitted;
+  SackList m_sackBlocks;
 
   Address m_source;
   Address m_destination;
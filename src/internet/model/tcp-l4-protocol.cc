@@ -29,6 +29,7 @@
 #include "ns3/simulator.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv6-route.h"
+#include "ns3/segment-offload-tag.h"
 
 #include "tcp-l4-protocol.h"
 #include "tcp-header.h"
@@ -610,7 +611,6 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
   // XXX outgoingHeader cannot be logged
 
   TcpHeader outgoingHeader = outgoing;
-  outgoingHeader.SetLength (5); //header length in units of 32bit words
   /* outgoingHeader.SetUrgentPointer (0); //XXX */
   if(Node::ChecksumEnabled ())
     {
@@ -638,12 +638,44 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
           NS_LOG_ERROR ("No IPV4 Routing Protocol");
           route = 0;
         }
+      SegmentOffloadTag offload;
+      if (route != 0 && !route->GetOutputDevice ()->SupportsSegmentOffload ()
+          && packet->PeekPacketTag (offload) && offload.GetSegmentSize () > 0)
+        {
+          // The output device cannot send this super-segment: segment it here
+          TcpHeader added;
+          packet->RemovePacketTag (offload);
+          packet->RemoveHeader (added);
+          SendSegments (packet, outgoingHeader, offload.GetSegmentSize (), saddr, daddr, route);
+          return;
+        }
       m_downTarget (packet, saddr, daddr, PROT_NUMBER, route);
     }
   else
     NS_FATAL_ERROR ("Trying to use Tcp on a node without an Ipv4 interface");
 }
 
+void
+TcpL4Protocol::SendSegments (Ptr<Packet> payload, const TcpHeader &header, uint32_t segmentSize,
+                             Ipv4Address saddr, Ipv4Address daddr, Ptr<Ipv4Route> route)
+{
+  NS_LOG_FUNCTION (this << payload << segmentSize << saddr << daddr);
+  uint32_t size = payload->GetSize ();
+  for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+      uint32_t length = std::min (segmentSize, size - offset);
+      Ptr<Packet> segment = payload->CreateFragment (offset, length);
+      TcpHeader segmentHeader = header;
+      segmentHeader.SetSequenceNumber (header.GetSequenceNumber () + SequenceNumber32 (offset));
+      if (offset + length < size)
+        { // Only the last segment carries the FIN
+          segmentHeader.SetFlags (header.GetFlags () & ~TcpHeader::FIN);
+        }
+      segment->AddHeader (segmentHeader);
+      m_downTarget (segment, saddr, daddr, PROT_NUMBER, route);
+    }
+}
+
 void
 TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
                            Ipv6Address saddr, Ipv6Address daddr, Ptr<NetDevice> oif)
@@ -661,7 +693,6 @@ TcpL4Protocol::SendPacket (Ptr<Packet> packet, const TcpHeader &outgoing,
       return (SendPacket (packet, outgoing, saddr.GetIpv4MappedAddress(), daddr.GetIpv4MappedAddress(), oif));
     }
   TcpHeader outgoingHeader = outgoing;
-  outgoingHeader.SetLength (5); //header length in units of 32bit words
   /* outgoingHeader.SetUrgentPointer (0); //XXX */
   if(Node::ChecksumEnabled ())
     {
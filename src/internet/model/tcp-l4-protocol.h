@@ -164,6 +164,13 @@ private:
                    Ipv4Address, Ipv4Address, Ptr<NetDevice> oif = 0);
   void SendPacket (Ptr<Packet>, const TcpHeader &,
                    Ipv6Address, Ipv6Address, Ptr<NetDevice> oif = 0);
+  /**
+   * Send the payload of a super-segment in segments of at most
+   * segmentSize bytes, for output devices which do not support
+   * segmentation offload.
+   */
+  void SendSegments (Ptr<Packet> payload, const TcpHeader &header, uint32_t segmentSize,
+                     Ipv4Address saddr, Ipv4Address daddr, Ptr<Ipv4Route> route);
   TcpL4Protocol (const TcpL4Protocol &o);
   TcpL4Protocol &operator = (const TcpL4Protocol &o);
 
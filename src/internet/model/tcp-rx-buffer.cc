@@ -48,7 +48,8 @@ TcpRxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpRxBuffer::TcpRxBuffer (uint32_t n)
-  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0)
+  : m_nextRxSeq (n), m_gotFin (false), m_size (0), m_maxBuffer (32768), m_availBytes (0),
+    m_ringStorage (false)
 {
 }
 
@@ -110,6 +111,10 @@ TcpRxBuffer::MaxRxSequence (void) const
     { // No data allowed beyond FIN
       return m_finSeq;
     }
+  else if (m_ringStorage && !m_ranges.empty ())
+    { // No data allowed beyond Rx window allowed
+      return m_ranges.begin ()->first + SequenceNumber32 (m_maxBuffer);
+    }
   else if (m_data.size ())
     { // No data allowed beyond Rx window allowed
       return m_data.begin ()->first + SequenceNumber32 (m_maxBuffer);
@@ -138,6 +143,10 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
 {
   NS_LOG_FUNCTION (this << p << tcph);
 
+  if (m_ringStorage)
+    {
+      return AddToRing (p, tcph);
+    }
   uint32_t pktSize = p->GetSize ();
   SequenceNumber32 headSeq = tcph.GetSequenceNumber ();
   SequenceNumber32 tailSeq = headSeq + SequenceNumber32 (pktSize);
@@ -152,8 +161,14 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet. The buffered packets do not
+  // overlap, so the scan starts at the last one which begins before the
+  // incoming packet.
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -189,24 +204,40 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       p = p->CreateFragment (start, length);
       NS_ASSERT (length == p->GetSize ());
     }
-  // Insert packet into buffer
+  // Insert packet into buffer, coalescing it with the buffered packets
+  // that it is contiguous with, so that in-order data makes a single entry
   NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
-  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
-  // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  BufIterator next = m_data.lower_bound (headSeq);
+  BufIterator entry = next;
+  if (entry != m_data.begin ())
+    {
+      --entry;
+    }
+  if (entry != next && entry->first + SequenceNumber32 (entry->second->GetSize ()) == headSeq)
+    {
+      entry->second->AddAtEnd (p);
+    }
+  else
+    {
+      entry = m_data.insert (next, std::make_pair (headSeq, p));
+    }
+  if (next != m_data.end () && next->first == tailSeq)
+    {
+      entry->second->AddAtEnd (next->second);
+      m_data.erase (next);
+    }
+  m_lastAddedSeq = headSeq;
+  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << tailSeq - headSeq);
+  // Update variables
+  for (BufIterator i = entry; i != m_data.end () && i->first <= m_nextRxSeq; ++i)
     {
-      if (i->first < m_nextRxSeq)
+      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
+      if (lastByteSeq > m_nextRxSeq)
         {
-          continue;
+          m_availBytes += lastByteSeq - m_nextRxSeq.Get ();
+          m_nextRxSeq = lastByteSeq;
         }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -224,6 +255,10 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   uint32_t extractSize = std::min (maxSize, m_availBytes);
   NS_LOG_LOGIC ("Requested to extract " << extractSize << " bytes from TcpRxBuffer of size=" << m_size);
   if (extractSize == 0) return 0;  // No contiguous block to return
+  if (m_ringStorage)
+    {
+      return ExtractFromRing (extractSize);
+    }
   NS_ASSERT (m_data.size ()); // At least we have something to extract
   Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
   BufIterator i;
@@ -261,4 +296,172 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   return outPkt;
 }
 
+TcpHeader::SackList
+TcpRxBuffer::GetSackBlocks (uint32_t maxBlocks) const
+{
+  NS_LOG_FUNCTION (this << maxBlocks);
+  // The buffered data is coalesced when contiguous, so each packet (or
+  // range, in ring storage mode) above m_nextRxSeq is a block
+  TcpHeader::SackList above;
+  if (m_ringStorage)
+    {
+      for (std::map<SequenceNumber32, SequenceNumber32>::const_iterator i = m_ranges.upper_bound (m_nextRxSeq);
+           i != m_ranges.end (); ++i)
+        {
+          above.push_back (TcpHeader::SackBlock (i->first, i->second));
+        }
+    }
+  else
+    {
+      for (std::map<SequenceNumber32, Ptr<Packet> >::const_iterator i = m_data.upper_bound (m_nextRxSeq);
+           i != m_data.end (); ++i)
+        {
+          above.push_back (TcpHeader::SackBlock (i->first, i->first + SequenceNumber32 (i->second->GetSize ())));
+        }
+    }
+  TcpHeader::SackList blocks;
+  if (maxBlocks == 0 || above.empty ())
+    {
+      return blocks;
+    }
+  SequenceNumber32 recent = m_nextRxSeq;
+  for (TcpHeader::SackList::const_reverse_iterator j = above.rbegin (); j != above.rend (); ++j)
+    {
+      if (j->first <= m_lastAddedSeq)
+        {
+          if (m_lastAddedSeq < j->second)
+            {
+              recent = j->first;
+              blocks.push_back (*j);
+            }
+          break;
+        }
+    }
+  for (TcpHeader::SackList::const_reverse_iterator j = above.rbegin ();
+       j != above.rend () && blocks.size () < maxBlocks; ++j)
+    {
+      if (j->first != recent)
+        {
+          blocks.push_back (*j);
+        }
+    }
+  return blocks;
+}
+
+void
+TcpRxBuffer::SetRingStorage (bool ring)
+{
+  NS_LOG_FUNCTION (this << ring);
+  NS_ASSERT_MSG (m_size == 0, "Cannot change the storage of a buffer holding data");
+  m_ringStorage = ring;
+}
+
+bool
+TcpRxBuffer::GetRingStorage (void) const
+{
+  return m_ringStorage;
+}
+
+bool
+TcpRxBuffer::AddToRing (Ptr<Packet> p, TcpHeader const& tcph)
+{
+  NS_LOG_FUNCTION (this << p << tcph);
+
+  SequenceNumber32 headSeq = tcph.GetSequenceNumber ();
+  SequenceNumber32 tailSeq = headSeq + SequenceNumber32 (p->GetSize ());
+  NS_LOG_LOGIC ("Add pkt " << p << " len=" << p->GetSize () << " seq=" << headSeq
+                           << ", when NextRxSeq=" << m_nextRxSeq << ", buffsize=" << m_size);
+
+  // Trim packet to fit Rx window specification
+  if (headSeq < m_nextRxSeq) headSeq = m_nextRxSeq;
+  if (!m_ranges.empty ())
+    {
+      SequenceNumber32 maxSeq = m_ranges.begin ()->first + SequenceNumber32 (m_maxBuffer);
+      if (maxSeq < tailSeq) tailSeq = maxSeq;
+    }
+  if (headSeq >= tailSeq)
+    {
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false;
+    }
+  if (m_ranges.empty ())
+    { // Rebase the ring on the next byte expected
+      m_ring.Clear ();
+      m_ringHead = m_nextRxSeq;
+    }
+
+  // Merge the range of the packet with the buffered ranges that it overlaps
+  // or touches, counting the bytes which were buffered already
+  SequenceNumber32 begin = headSeq;
+  SequenceNumber32 end = tailSeq;
+  uint32_t buffered = 0;
+  std::map<SequenceNumber32, SequenceNumber32>::iterator i = m_ranges.upper_bound (begin);
+  if (i != m_ranges.begin ())
+    {
+      std::map<SequenceNumber32, SequenceNumber32>::iterator previous = i;
+      --previous;
+      if (previous->second >= begin)
+        {
+          i = previous;
+        }
+    }
+  while (i != m_ranges.end () && i->first <= end)
+    {
+      SequenceNumber32 first = std::max (i->first, headSeq);
+      SequenceNumber32 last = std::min (i->second, tailSeq);
+      if (last > first)
+        {
+          buffered += last - first;
+        }
+      begin = std::min (begin, i->first);
+      end = std::max (end, i->second);
+      m_ranges.erase (i++);
+    }
+  m_ranges[begin] = end;
+  if (buffered == static_cast<uint32_t> (tailSeq - headSeq))
+    {
+      NS_LOG_LOGIC ("Nothing to buffer");
+      return false;
+    }
+  // The bytes buffered already are the same, so the whole range is written
+  m_ring.Write (headSeq - m_ringHead, p, headSeq - tcph.GetSequenceNumber (), tailSeq - headSeq);
+  m_size += (tailSeq - headSeq) - buffered;
+  m_lastAddedSeq = headSeq;
+  NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << tailSeq - headSeq);
+  // Update variables
+  std::map<SequenceNumber32, SequenceNumber32>::iterator first = m_ranges.begin ();
+  if (first->first <= m_nextRxSeq && first->second > m_nextRxSeq)
+    {
+      m_availBytes += first->second - m_nextRxSeq.Get ();
+      m_nextRxSeq = first->second;
+    }
+  NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
+  if (m_gotFin && m_nextRxSeq == m_finSeq)
+    { // Account for the FIN packet
+      ++m_nextRxSeq;
+    };
+  return true;
+}
+
+Ptr<Packet>
+TcpRxBuffer::ExtractFromRing (uint32_t extractSize)
+{
+  NS_LOG_FUNCTION (this << extractSize);
+  NS_ASSERT (!m_ranges.empty () && m_ranges.begin ()->first == m_ringHead);
+  Ptr<Packet> outPkt = m_ring.Read (0, extractSize);
+  m_ring.Discard (extractSize);
+  m_ringHead += extractSize;
+  SequenceNumber32 end = m_ranges.begin ()->second;
+  m_ranges.erase (m_ranges.begin ());
+  if (end > m_ringHead)
+    {
+      m_ranges[m_ringHead] = end;
+    }
+  m_size -= extractSize;
+  m_availBytes -= extractSize;
+  NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
+                             << ", num ranges in buffer=" << m_ranges.size ());
+  return outPkt;
+}
+
 } //namepsace ns3
@@ -27,6 +27,7 @@
 #include "ns3/sequence-number.h"
 #include "ns3/ptr.h"
 #include "ns3/tcp-header.h"
+#include "tcp-byte-ring.h"
 
 namespace ns3 {
 class Packet;
@@ -72,6 +73,37 @@ public:
    * The extracted data is going to be forwarded to the application.
    */
   Ptr<Packet> Extract (uint32_t maxSize);
+
+  /**
+   * Get the blocks of out-of-order data for a SACK option: the block which
+   * holds the data received last first, then the others from the highest
+   * (RFC 2018).
+   *
+   * \param maxBlocks the maximum number of blocks to return
+   * \return the blocks, first byte to byte after the last
+   */
+  TcpHeader::SackList GetSackBlocks (uint32_t maxBlocks) const;
+
+  /**
+   * Choose how the data is stored: as a map of the packets received, or in
+   * a TcpByteRing with the map of the ranges of bytes received, which makes
+   * Extract independent of the number of packets received. The ring does
+   * not keep the tags of the packets received. Supposed to be called only
+   * when the buffer is empty.
+   *
+   * \param ring true to store the data in a ring
+   */
+  void SetRingStorage (bool ring);
+
+  /**
+   * \returns true if the data is stored in a ring
+   */
+  bool GetRingStorage (void) const;
+
+private:
+  bool AddToRing (Ptr<Packet> p, TcpHeader const& tcph);
+  Ptr<Packet> ExtractFromRing (uint32_t extractSize);
+
 public:
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //< Seqnum of the first missing byte in data (RCV.NXT)
@@ -80,8 +112,14 @@ public:
   uint32_t m_size;                           //< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //< Number of bytes available to read, i.e. contiguous block at head
+  SequenceNumber32 m_lastAddedSeq;           //< Seqnum of the data buffered last
   std::map<SequenceNumber32, Ptr<Packet> > m_data;
   //< Corresponding data (may be null)
+  bool m_ringStorage;                        //< Whether the data is in m_ring rather than m_data
+  TcpByteRing m_ring;                        //< Corresponding data in ring storage mode
+  SequenceNumber32 m_ringHead;               //< Seqnum of the byte at offset 0 of m_ring
+  std::map<SequenceNumber32, SequenceNumber32> m_ranges;
+  //< Ranges of bytes in m_ring, first byte to byte after the last
 };
 
 } //namepsace ns3
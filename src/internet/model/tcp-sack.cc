@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#define NS_LOG_APPEND_CONTEXT \
+  if (m_node) { std::clog << Simulator::Now ().GetSeconds () << " [node " << m_node->GetId () << "] "; }
+
+#include "tcp-sack.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+
+NS_LOG_COMPONENT_DEFINE ("TcpSack");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (TcpSack);
+
+TypeId
+TcpSack::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpSack")
+    .SetParent<TcpNewReno> ()
+    .AddConstructor<TcpSack> ()
+  ;
+  return tid;
+}
+
+TcpSack::TcpSack (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpSack::TcpSack (const TcpSack& sock)
+  : TcpNewReno (sock),
+    m_highRxt (sock.m_highRxt)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("Invoked the copy constructor");
+}
+
+TcpSack::~TcpSack (void)
+{
+}
+
+Ptr<TcpSocketBase>
+TcpSack::Fork (void)
+{
+  return CopyObject<TcpSack> (this);
+}
+
+/** New ACK (up to seqnum seq) received. A partial ACK in fast recovery sends
+ *  from the scoreboard, everything else is handled as in TcpNewReno
+ */
+void
+TcpSack::NewAck (const SequenceNumber32& seq)
+{
+  NS_LOG_FUNCTION (this << seq);
+  if (m_sackPermitted && m_inFastRec && seq < m_recover)
+    { // Partial ACK: no window deflation, the pipe accounts for the data
+      // which left the network (RFC6675 sec.5 step (C))
+      NS_LOG_INFO ("Partial ACK in SACK recovery, pipe " << Pipe () << " cwnd " << m_cWnd);
+      TcpSocketBase::NewAck (seq);
+      SendRecoveryData ();
+      return;
+    }
+  TcpNewReno::NewAck (seq);
+}
+
+/** Enter fast recovery upon the dupack threshold or when the scoreboard shows
+ *  that the first segment is lost, then send as the pipe allows
+ */
+void
+TcpSack::DupAck (const TcpHeader& t, uint32_t count)
+{
+  NS_LOG_FUNCTION (this << count);
+  if (!m_sackPermitted)
+    {
+      TcpNewReno::DupAck (t, count);
+      return;
+    }
+  if (m_inFastRec)
+    {
+      SendRecoveryData ();
+    }
+  else if ((count == m_retxThresh
+            || m_txBuffer.LostBoundary (m_retxThresh, m_segmentSize) > m_txBuffer.HeadSequence ())
+           && m_txBuffer.HeadSequence () >= m_recover)
+    { // RFC6675 sec.5 step (4)
+      EnterRecovery ();
+    }
+  else
+    { // Limited transmit, if enabled
+      TcpNewReno::DupAck (t, count);
+    }
+}
+
+/** Retransmit timeout */
+void
+TcpSack::Retransmit (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_sackPermitted)
+    { // Do not enter fast recovery again before the data sent so far is
+      // acknowledged (RFC6582 sec.4)
+      m_recover = m_highTxMark;
+      m_highRxt = m_txBuffer.HeadSequence ();
+    }
+  TcpNewReno::Retransmit ();
+}
+
+void
+TcpSack::EnterRecovery (void)
+{
+  NS_LOG_FUNCTION (this);
+  SequenceNumber32 head = m_txBuffer.HeadSequence ();
+  m_ssThresh = std::max (2 * m_segmentSize, BytesInFlight () / 2);
+  m_cWnd = m_ssThresh;
+  m_recover = m_highTxMark;
+  m_inFastRec = true;
+  NS_LOG_INFO ("Enter SACK recovery mode. Reset cwnd to " << m_cWnd <<
+               ", ssthresh to " << m_ssThresh << " at fast recovery seqnum " << m_recover);
+  // Retransmit the first segment (RFC6675 sec.5 step (4.3)), then fill the pipe
+  uint32_t hole;
+  m_txBuffer.NextUnsacked (head, hole);
+  uint32_t sz = SendDataPacket (head, std::min (hole, m_segmentSize), true);
+  m_highRxt = head + SequenceNumber32 (sz);
+  m_nextTxSequence = std::max (m_nextTxSequence.Get (), m_highRxt);
+  SendRecoveryData ();
+}
+
+void
+TcpSack::SendRecoveryData (void)
+{
+  NS_LOG_FUNCTION (this);
+  SequenceNumber32 seq;
+  uint32_t size;
+  while (m_cWnd.Get () >= Pipe () + m_segmentSize && NextSegment (seq, size))
+    {
+      uint32_t sz = SendDataPacket (seq, size, true);
+      if (sz == 0)
+        {
+          break;
+        }
+      if (seq >= m_nextTxSequence)
+        { // New data
+          m_nextTxSequence = seq + SequenceNumber32 (sz);
+        }
+      else
+        {
+          m_highRxt = std::max (m_highRxt, seq + SequenceNumber32 (sz));
+        }
+      NS_LOG_LOGIC ("Sent " << sz << " bytes at " << seq << " in SACK recovery, pipe " << Pipe ());
+    }
+}
+
+/** The bytes which are neither SACKed nor deemed lost, plus the bytes
+ *  retransmitted, between the head of the Tx buffer and the highest byte sent
+ */
+uint32_t
+TcpSack::Pipe (void) const
+{
+  SequenceNumber32 head = m_txBuffer.HeadSequence ();
+  SequenceNumber32 high = std::max (m_highTxMark.Get (), head);
+  uint32_t sacked = m_txBuffer.SackedBytes ();
+  SequenceNumber32 lost = m_txBuffer.LostBoundary (m_retxThresh, m_segmentSize);
+  SequenceNumber32 rxt = std::min (std::max (m_highRxt, head), high);
+  uint32_t unsacked = (high - head) - sacked;
+  uint32_t lostBytes = (lost - head) - (sacked - m_txBuffer.SackedBytesFrom (lost));
+  uint32_t rxtBytes = (rxt - head) - (sacked - m_txBuffer.SackedBytesFrom (rxt));
+  return unsacked - std::min (lostBytes, unsacked) + rxtBytes;
+}
+
+/** Choose the next segment to send in fast recovery: a lost hole, new data,
+ *  or a hole which is not deemed lost yet, in this order
+ */
+bool
+TcpSack::NextSegment (SequenceNumber32 &seq, uint32_t &size) const
+{
+  uint32_t hole;
+  SequenceNumber32 next = m_txBuffer.NextUnsacked (m_highRxt, hole);
+  bool below = next < m_txBuffer.HighestSacked () && hole > 0;
+  if (below && next < m_txBuffer.LostBoundary (m_retxThresh, m_segmentSize))
+    { // Rule 1: the first lost hole which was not retransmitted yet
+      seq = next;
+      size = std::min (hole, m_segmentSize);
+      return true;
+    }
+  uint32_t unacked = m_nextTxSequence.Get () - m_txBuffer.HeadSequence ();
+  uint32_t available = m_txBuffer.SizeFromSequence (m_nextTxSequence);
+  if (available > 0 && m_rWnd.Get () > unacked)
+    { // Rule 2: new data, if the receiver window allows it
+      seq = m_nextTxSequence;
+      size = std::min (std::min (available, m_segmentSize), m_rWnd.Get () - unacked);
+      return true;
+    }
+  if (below)
+    { // Rule 3: a hole which is not deemed lost yet
+      seq = next;
+      size = std::min (hole, m_segmentSize);
+      return true;
+    }
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,67 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_SACK_H
+#define TCP_SACK_H
+
+#include "tcp-newreno.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup socket
+ * \ingroup tcp
+ *
+ * \brief An implementation of a stream socket using TCP.
+ *
+ * This class contains the SACK-based loss recovery of TCP, as of RFC6675.
+ * The segments to send in fast recovery are chosen from the scoreboard of
+ * the Tx buffer, which holds the ranges reported by the peer in its SACK
+ * options, and the amount of data in flight is estimated by the pipe of
+ * RFC6675 instead of inflating the congestion window on each dupack. The
+ * SACK option must be enabled on both ends (see the "Sack" attribute of
+ * TcpSocketBase); when it is not negotiated, the socket behaves as
+ * TcpNewReno.
+ */
+class TcpSack : public TcpNewReno
+{
+public:
+  static TypeId GetTypeId (void);
+  /**
+   * Create an unbound tcp socket.
+   */
+  TcpSack (void);
+  TcpSack (const TcpSack& sock);
+  virtual ~TcpSack (void);
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void); // Call CopyObject<TcpSack> to clone me
+  virtual void NewAck (SequenceNumber32 const& seq); // Send from the scoreboard on partial ACKs
+  virtual void DupAck (const TcpHeader& t, uint32_t count); // Enter or continue fast recovery
+  virtual void Retransmit (void); // Forget the retransmissions of fast recovery upon timeout
+
+private:
+  void EnterRecovery (void);      // Cut cwnd and retransmit the first hole
+  void SendRecoveryData (void);   // Send while cwnd allows it, RFC6675 sec.5 step (C)
+  uint32_t Pipe (void) const;     // Bytes in flight, RFC6675 sec.4 SetPipe()
+  bool NextSegment (SequenceNumber32 &seq, uint32_t &size) const; // RFC6675 sec.4 NextSeg()
+
+  SequenceNumber32 m_highRxt;     //< Byte after the highest retransmitted in fast recovery (HighRxt)
+};
+
+} // namespace ns3
+
+#endif /* TCP_SACK_H */
@@ -30,6 +30,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv6.h"
 #include "ns3/ipv4-interface-address.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv6-route.h"
 #include "ns3/ipv4-routing-protocol.h"
@@ -37,8 +38,10 @@
 #include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
+#include "ns3/segment-offload-tag.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
@@ -56,6 +59,13 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (TcpSocketBase);
 
+// A super-segment must fit in an IPv4 datagram along with the largest
+// IPv4 and TCP headers, options included
+static const uint32_t IPV4_MAX_DATAGRAM_SIZE = 0xffff;
+static const uint32_t IPV4_MAX_HEADER_SIZE = 60;
+static const uint32_t TCP_MAX_HEADER_SIZE = 60;
+static const uint32_t MAX_OFFLOAD_PAYLOAD_SIZE = IPV4_MAX_DATAGRAM_SIZE - IPV4_MAX_HEADER_SIZE - TCP_MAX_HEADER_SIZE;
+
 TypeId
 TcpSocketBase::GetTypeId (void)
 {
@@ -83,6 +93,24 @@ TcpSocketBase::GetTypeId (void)
                    CallbackValue (),
                    MakeCallbackAccessor (&TcpSocketBase::m_icmpCallback6),
                    MakeCallbackChecker ())                   
+    .AddAttribute ("OffloadSegments",
+                   "Maximum number of segments handed down at once to IPv4 as a single "
+                   "super-segment (segmentation offload), 1 to disable it",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpSocketBase::m_offloadSegments),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("Sack",
+                   "Enable the selective acknowledgment option (RFC 2018)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sack),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RingBuffers",
+                   "Store the data of the Tx and Rx buffers in byte rings rather than "
+                   "in lists of packets. The packet tags of the data are not kept.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::SetRingBuffers,
+                                        &TcpSocketBase::GetRingBuffers),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RTO",
                      "Retransmission timeout",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_rto))
@@ -108,6 +136,8 @@ TcpSocketBase::GetTypeId (void)
 TcpSocketBase::TcpSocketBase (void)
   : m_dupAckCount (0),
     m_delAckCount (0),
+    m_coalescedAcks (1),
+    m_pendingAcks (1),
     m_endPoint (0),
     m_endPoint6 (0),
     m_node (0),
@@ -126,6 +156,7 @@ TcpSocketBase::TcpSocketBase (void)
     m_shutdownRecv (false),
     m_connected (false),
     m_segmentSize (0),
+    m_sackPermitted (false),
     // For attribute initialization consistency (quiet valgrind)
     m_rWnd (0)
 {
@@ -138,6 +169,8 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_dupAckCount (sock.m_dupAckCount),
     m_delAckCount (0),
     m_delAckMaxCount (sock.m_delAckMaxCount),
+    m_coalescedAcks (1),
+    m_pendingAcks (1),
     m_noDelay (sock.m_noDelay),
     m_cnRetries (sock.m_cnRetries),
     m_delAckTimeout (sock.m_delAckTimeout),
@@ -162,6 +195,9 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_msl (sock.m_msl),
     m_segmentSize (sock.m_segmentSize),
     m_maxWinSize (sock.m_maxWinSize),
+    m_offloadSegments (sock.m_offloadSegments),
+    m_sack (sock.m_sack),
+    m_sackPermitted (sock.m_sackPermitted),
     m_rWnd (sock.m_rWnd)
 {
   NS_LOG_FUNCTION (this);
@@ -1054,6 +1090,13 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
 {
   NS_LOG_FUNCTION (this << tcpHeader);
 
+  // A pure ACK may stand for the ACKs of several segments of a super-segment
+  SegmentOffloadTag offloadTag;
+  if (packet->GetSize () == 0 && packet->PeekPacketTag (offloadTag))
+    {
+      m_coalescedAcks = std::max<uint32_t> (offloadTag.GetSegments (), 1);
+    }
+
   // Received ACK. Compare the ACK number against highest unacked seqno
   if (0 == (tcpHeader.GetFlags () & TcpHeader::ACK))
     { // Ignore if no ACK flag
@@ -1067,7 +1110,10 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       if (tcpHeader.GetAckNumber () < m_nextTxSequence && packet->GetSize() == 0)
         {
           NS_LOG_LOGIC ("Dupack of " << tcpHeader.GetAckNumber ());
-          DupAck (tcpHeader, ++m_dupAckCount);
+          for (uint32_t i = 0; i < m_coalescedAcks; ++i)
+            {
+              DupAck (tcpHeader, ++m_dupAckCount);
+            }
         }
       // otherwise, the ACK is precisely equal to the nextTxSequence
       NS_ASSERT (tcpHeader.GetAckNumber () <= m_nextTxSequence);
@@ -1078,6 +1124,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       NewAck (tcpHeader.GetAckNumber ());
       m_dupAckCount = 0;
     }
+  m_coalescedAcks = 1;
   // If there is any data piggybacked, store it into m_rxBuffer
   if (packet->GetSize () > 0)
     {
@@ -1595,6 +1642,12 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
   bool hasSyn = flags & TcpHeader::SYN;
   bool hasFin = flags & TcpHeader::FIN;
   bool isAck = flags == TcpHeader::ACK;
+  if (isAck && m_pendingAcks > 1)
+    { // This ACK stands for the ACKs of several segments of a super-segment
+      p->AddPacketTag (SegmentOffloadTag (m_pendingAcks, 0, Ipv4Header ().GetSerializedSize ()
+                                          + header.GetSerializedSize ()));
+    }
+  m_pendingAcks = 1;
   if (hasSyn)
     {
       if (m_cnCount == 0)
@@ -1871,6 +1924,12 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
       m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
+  if (sz > m_segmentSize)
+    { // Super-segment, see SendPendingData
+      uint16_t segments = (sz + m_segmentSize - 1) / m_segmentSize;
+      p->AddPacketTag (SegmentOffloadTag (segments, m_segmentSize, Ipv4Header ().GetSerializedSize ()
+                                          + header.GetSerializedSize ()));
+    }
   NS_LOG_LOGIC ("Send packet via TcpL4Protocol with flags 0x" << std::hex << static_cast<uint32_t> (flags) << std::dec);
   if (m_endPoint)
     {
@@ -1941,7 +2000,24 @@ TcpSocketBase::SendPendingData (bool withAck)
           NS_LOG_LOGIC ("Invoking Nagle's algorithm. Wait to send.");
           break;
         }
+      uint32_t hole = w;
+      if (m_sackPermitted)
+        { // Skip the data that the peer already reported, e.g. after a timeout
+          m_nextTxSequence = m_txBuffer.NextUnsacked (m_nextTxSequence, hole);
+          if (hole == 0)
+            {
+              break;
+            }
+        }
       uint32_t s = std::min (w, m_segmentSize);  // Send no more than window
+      if (m_offloadSegments > 1 && m_endPoint != 0)
+        { // Segmentation offload: send as many full segments as the window
+          // allows at once, within the maximum size of an IPv4 packet
+          uint32_t segments = std::min<uint32_t> (w / m_segmentSize, m_offloadSegments);
+          segments = std::min<uint32_t> (segments, MAX_OFFLOAD_PAYLOAD_SIZE / m_segmentSize);
+          s = std::max (s, segments * m_segmentSize);
+        }
+      s = std::min (s, hole);
       uint32_t sz = SendDataPacket (m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_nextTxSequence += sz;                     // Advance next tx sequence
@@ -1987,6 +2063,31 @@ TcpSocketBase::AdvertisedWindowSize ()
   return std::min (m_rxBuffer.MaxBufferSize () - m_rxBuffer.Size (), (uint32_t)m_maxWinSize);
 }
 
+// Increase of cwnd based on current phase (slow start or congestion
+// avoidance), once per ACK that the ACK being processed stands for: an ACK
+// of a super-segment stands for m_coalescedAcks ACKs, see OffloadSegments
+void
+TcpSocketBase::IncreaseCwnd (TracedValue<uint32_t>& cWnd, uint32_t ssThresh)
+{
+  NS_LOG_FUNCTION (this << m_coalescedAcks);
+  for (uint32_t i = 0; i < m_coalescedAcks; ++i)
+    {
+      if (cWnd < ssThresh)
+        { // Slow start mode, add one segSize to cWnd. Default m_ssThresh is 65535. (RFC2001, sec.1)
+          cWnd += m_segmentSize;
+          NS_LOG_INFO ("In SlowStart, updated to cwnd " << cWnd << " ssthresh " << ssThresh);
+        }
+      else
+        { // Congestion avoidance mode, increase by (segSize*segSize)/cwnd. (RFC2581, sec.3.1)
+          // To increase cwnd for one segSize per RTT, it should be (ackBytes*segSize)/cwnd
+          double adder = static_cast<double> (m_segmentSize * m_segmentSize) / cWnd.Get ();
+          adder = std::max (1.0, adder);
+          cWnd += static_cast<uint32_t> (adder);
+          NS_LOG_INFO ("In CongAvoid, updated to cwnd " << cWnd << " ssthresh " << ssThresh);
+        }
+    }
+}
+
 // Receipt of new packet, put into Rx buffer
 void
 TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
@@ -1996,6 +2097,14 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
                 " ack " << tcpHeader.GetAckNumber () <<
                 " pkt size " << p->GetSize () );
 
+  // A super-segment counts as several segments for the ACK policy
+  uint32_t segments = 1;
+  SegmentOffloadTag offloadTag;
+  if (p->RemovePacketTag (offloadTag))
+    {
+      segments = std::max<uint32_t> (offloadTag.GetSegments (), 1);
+    }
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer.NextRxSequence ();
   if (!m_rxBuffer.Add (p, tcpHeader))
@@ -2006,15 +2115,28 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
   // Now send a new ACK packet acknowledging all received and delivered data
   if (m_rxBuffer.Size () > m_rxBuffer.Available () || m_rxBuffer.NextRxSequence () > expectedSeq + p->GetSize ())
     { // A gap exists in the buffer, or we filled a gap: Always ACK
+      m_pendingAcks = segments;
       SendEmptyPacket (TcpHeader::ACK);
     }
   else
     { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+      m_delAckCount += segments;
+      if (m_delAckCount >= m_delAckMaxCount)
         {
-          m_delAckEvent.Cancel ();
-          m_delAckCount = 0;
-          SendEmptyPacket (TcpHeader::ACK);
+          uint32_t delAckMaxCount = std::max<uint32_t> (m_delAckMaxCount, 1);
+          uint32_t leftOver = 0;
+          if (m_delAckCount - segments < delAckMaxCount)
+            { // One ACK per m_delAckMaxCount segments; the segments left
+              // over are counted towards the next ACK
+              m_pendingAcks = m_delAckCount / delAckMaxCount;
+              leftOver = m_delAckCount % delAckMaxCount;
+            }
+          else
+            { // An immediate ACK was requested, e.g. after a gap was filled
+              m_pendingAcks = std::max<uint32_t> (segments / delAckMaxCount, 1);
+            }
+          SendEmptyPacket (TcpHeader::ACK); // Cancels m_delAckEvent and resets m_delAckCount
+          m_delAckCount = leftOver;
         }
       else if (m_delAckEvent.IsExpired ())
         {
@@ -2293,6 +2415,19 @@ TcpSocketBase::GetRcvBufSize (void) const
   return m_rxBuffer.MaxBufferSize ();
 }
 
+void
+TcpSocketBase::SetRingBuffers (bool ring)
+{
+  m_txBuffer.SetRingStorage (ring);
+  m_rxBuffer.SetRingStorage (ring);
+}
+
+bool
+TcpSocketBase::GetRingBuffers (void) const
+{
+  return m_txBuffer.GetRingStorage ();
+}
+
 void
 TcpSocketBase::SetSegSize (uint32_t size)
 {
@@ -2391,16 +2526,45 @@ TcpSocketBase::GetAllowBroadcast (void) const
   return false;
 }
 
-/** Placeholder function for future extension that reads more from the TCP header */
+/** Read the options of the TCP header: negotiate SACK on the SYNs and
+ *  update the scoreboard of the Tx buffer with the SACK blocks
+ */
 void
-TcpSocketBase::ReadOptions (const TcpHeader&)
+TcpSocketBase::ReadOptions (const TcpHeader& header)
 {
+  if (header.GetFlags () & TcpHeader::SYN)
+    {
+      m_sackPermitted = m_sack && header.IsSackPermitted ();
+      NS_LOG_LOGIC ("SACK " << (m_sackPermitted ? "permitted" : "not permitted"));
+    }
+  else if (m_sackPermitted && (header.GetFlags () & TcpHeader::ACK))
+    {
+      TcpHeader::SackList blocks = header.GetSackBlocks ();
+      for (TcpHeader::SackList::const_iterator i = blocks.begin (); i != blocks.end (); ++i)
+        {
+          m_txBuffer.Sack (i->first, i->second);
+        }
+    }
 }
 
-/** Placeholder function for future extension that changes the TCP header */
+/** Add the options to the TCP header: offer SACK on the SYNs and report the
+ *  out-of-order data of the Rx buffer once SACK is negotiated
+ */
 void
-TcpSocketBase::AddOptions (TcpHeader&)
+TcpSocketBase::AddOptions (TcpHeader& header)
 {
+  if (header.GetFlags () & TcpHeader::SYN)
+    {
+      header.SetSackPermitted ((header.GetFlags () & TcpHeader::ACK) ? m_sackPermitted : m_sack);
+    }
+  else if (m_sackPermitted && (header.GetFlags () & TcpHeader::ACK))
+    {
+      TcpHeader::SackList blocks = m_rxBuffer.GetSackBlocks (TcpHeader::MAX_SACK_BLOCKS);
+      if (!blocks.empty ())
+        {
+          header.SetSackBlocks (blocks);
+        }
+    }
 }
 
 } // namespace ns3
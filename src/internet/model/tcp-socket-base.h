@@ -125,6 +125,8 @@ protected:
   virtual Time     GetPersistTimeout (void) const;
   virtual bool     SetAllowBroadcast (bool allowBroadcast);
   virtual bool     GetAllowBroadcast (void) const;
+  void             SetRingBuffers (bool ring);
+  bool             GetRingBuffers (void) const;
 
   // Helper functions: Connection set up
   int SetupCallback (void);        // Common part of the two Bind(), i.e. set callback and remembering local addr:port
@@ -173,6 +175,7 @@ protected:
   virtual uint32_t Window (void);               // Return the max possible number of unacked bytes
   virtual uint32_t AvailableWindow (void);      // Return unfilled portion of window
   virtual uint16_t AdvertisedWindowSize (void); // The amount of Rx window announced to the peer
+  void IncreaseCwnd (TracedValue<uint32_t>& cWnd, uint32_t ssThresh); // Slow start or congestion avoidance, once per ACK that the ACK being processed stands for
 
   // Manage data tx/rx
   virtual Ptr<TcpSocketBase> Fork (void) = 0; // Call CopyObject<> to clone me
@@ -200,6 +203,8 @@ protected:
   uint32_t          m_dupAckCount;     //< Dupack counter
   uint32_t          m_delAckCount;     //< Delayed ACK counter
   uint32_t          m_delAckMaxCount;  //< Number of packet to fire an ACK before delay timeout
+  uint32_t          m_coalescedAcks;   //< Number of ACKs that the ACK being processed stands for
+  uint32_t          m_pendingAcks;     //< Number of ACKs that the next pure ACK sent stands for
   bool              m_noDelay;         //< Set to true to disable Nagle's algorithm
   uint32_t          m_cnCount;         //< Count of remaining connection retries
   uint32_t          m_cnRetries;       //< Number of connection retries before giving up
@@ -239,6 +244,9 @@ protected:
   // Window management
   uint32_t              m_segmentSize; //< Segment size
   uint16_t              m_maxWinSize;  //< Maximum window size to advertise
+  uint16_t              m_offloadSegments; //< Maximum number of segments of a super-segment
+  bool                  m_sack;        //< Offer and accept the SACK option
+  bool                  m_sackPermitted; //< SACK negotiated with the peer
   TracedValue<uint32_t> m_rWnd;        //< Flow control window at remote side
 };
 
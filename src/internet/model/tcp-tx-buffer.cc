@@ -53,7 +53,8 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0),
+    m_ringStorage (false), m_sackedBytes (0)
 {
 }
 
@@ -105,7 +106,13 @@ TcpTxBuffer::Add (Ptr<Packet> p)
                                   << m_firstByteSeq << ", availSize="<< Available ());
   if (p->GetSize () <= Available ())
     {
-      if (p->GetSize () > 0)
+      if (p->GetSize () > 0 && m_ringStorage)
+        {
+          m_ring.Write (m_size, p, 0, p->GetSize ());
+          m_size += p->GetSize ();
+          NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
+        }
+      else if (p->GetSize () > 0)
         {
           m_data.push_back (p);
           m_size += p->GetSize ();
@@ -138,6 +145,10 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     {
       return Create<Packet> (); // Empty packet returned
     }
+  if (m_ringStorage)
+    {
+      return m_ring.Read (seq - m_firstByteSeq.Get (), s);
+    }
   if (m_data.size () == 0)
     { // No actual data, just return dummy-data packet of correct size
       return Create<Packet> (s);
@@ -217,6 +228,13 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
   uint32_t pktSize;
   NS_LOG_LOGIC ("Offset=" << offset);
+  if (m_ringStorage)
+    {
+      uint32_t discarded = std::min (offset, m_size);
+      m_ring.Discard (discarded);
+      m_size -= discarded;
+      m_firstByteSeq += discarded;
+    }
   BufIterator i = m_data.begin ();
   while (i != m_data.end ())
     {
@@ -244,9 +262,157 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
     {
       m_firstByteSeq = seq;
     }
+  // Forget the SACKed ranges below the new head
+  while (!m_sacked.empty () && m_sacked.begin ()->first < m_firstByteSeq)
+    {
+      Scoreboard::iterator i = m_sacked.begin ();
+      SequenceNumber32 end = i->second;
+      m_sackedBytes -= end - i->first;
+      m_sacked.erase (i);
+      if (end > m_firstByteSeq)
+        {
+          m_sacked[m_firstByteSeq] = end;
+          m_sackedBytes += end - m_firstByteSeq.Get ();
+        }
+    }
   NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
                         <<" numPkts="<< m_data.size ());
   NS_ASSERT (m_firstByteSeq == seq);
 }
 
+void
+TcpTxBuffer::SetRingStorage (bool ring)
+{
+  NS_LOG_FUNCTION (this << ring);
+  NS_ASSERT_MSG (m_size == 0, "Cannot change the storage of a buffer holding data");
+  m_ringStorage = ring;
+}
+
+bool
+TcpTxBuffer::GetRingStorage (void) const
+{
+  return m_ringStorage;
+}
+
+uint32_t
+TcpTxBuffer::Sack (const SequenceNumber32& begin, const SequenceNumber32& end)
+{
+  NS_LOG_FUNCTION (this << begin << end);
+  SequenceNumber32 first = std::max (begin, m_firstByteSeq.Get ());
+  SequenceNumber32 last = std::min (end, TailSequence ());
+  if (last <= first)
+    {
+      return 0;
+    }
+  uint32_t before = m_sackedBytes;
+  // Merge the new range with the ranges that it overlaps or touches
+  Scoreboard::iterator i = m_sacked.upper_bound (first);
+  if (i != m_sacked.begin ())
+    {
+      Scoreboard::iterator previous = i;
+      --previous;
+      if (previous->second >= first)
+        {
+          i = previous;
+        }
+    }
+  while (i != m_sacked.end () && i->first <= last)
+    {
+      first = std::min (first, i->first);
+      last = std::max (last, i->second);
+      m_sackedBytes -= i->second - i->first;
+      m_sacked.erase (i++);
+    }
+  m_sacked[first] = last;
+  m_sackedBytes += last - first;
+  NS_LOG_LOGIC ("SACKed " << first << "-" << last << ", " << m_sacked.size () << " ranges, "
+                          << m_sackedBytes << " bytes");
+  return m_sackedBytes - before;
+}
+
+void
+TcpTxBuffer::ResetScoreboard (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sacked.clear ();
+  m_sackedBytes = 0;
+}
+
+bool
+TcpTxBuffer::IsSacked (const SequenceNumber32& seq) const
+{
+  Scoreboard::const_iterator i = m_sacked.upper_bound (seq);
+  if (i == m_sacked.begin ())
+    {
+      return false;
+    }
+  --i;
+  return seq < i->second;
+}
+
+uint32_t
+TcpTxBuffer::SackedBytes (void) const
+{
+  return m_sackedBytes;
+}
+
+SequenceNumber32
+TcpTxBuffer::HighestSacked (void) const
+{
+  if (m_sacked.empty ())
+    {
+      return m_firstByteSeq;
+    }
+  return m_sacked.rbegin ()->second;
+}
+
+SequenceNumber32
+TcpTxBuffer::NextUnsacked (const SequenceNumber32& seq, uint32_t &size) const
+{
+  SequenceNumber32 next = std::max (seq, m_firstByteSeq.Get ());
+  Scoreboard::const_iterator i = m_sacked.upper_bound (next);
+  if (i != m_sacked.begin ())
+    {
+      Scoreboard::const_iterator previous = i;
+      --previous;
+      if (next < previous->second)
+        {
+          next = previous->second;
+        }
+    }
+  // The ranges do not touch, so i is the first range above next
+  SequenceNumber32 limit = i != m_sacked.end () ? i->first : TailSequence ();
+  size = limit > next ? limit - next : 0;
+  return next;
+}
+
+SequenceNumber32
+TcpTxBuffer::LostBoundary (uint32_t dupThresh, uint32_t segmentSize) const
+{
+  uint32_t ranges = 0;
+  uint32_t bytes = 0;
+  for (Scoreboard::const_reverse_iterator i = m_sacked.rbegin (); i != m_sacked.rend (); ++i)
+    {
+      ranges++;
+      bytes += i->second - i->first;
+      if (ranges >= dupThresh || bytes > (dupThresh - 1) * segmentSize)
+        {
+          return i->first;
+        }
+    }
+  return m_firstByteSeq;
+}
+
+uint32_t
+TcpTxBuffer::SackedBytesFrom (const SequenceNumber32& seq) const
+{
+  uint32_t bytes = 0;
+  for (Scoreboard::const_reverse_iterator i = m_sacked.rbegin ();
+       i != m_sacked.rend () && i->second > seq; ++i)
+    {
+      bytes += i->second - std::max (i->first, seq);
+    }
+  return bytes;
+}
+
 } // namepsace ns3
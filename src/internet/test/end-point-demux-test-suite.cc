@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-interface.h"
+
+using namespace ns3;
+
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Check the indexed lookups of Ipv4EndPointDemux")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  interface->SetDevice (device);
+  interface->AddAddress (Ipv4InterfaceAddress (Ipv4Address ("10.0.0.1"), Ipv4Mask ("255.255.255.0")));
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address peer ("10.0.0.2");
+  Ipv4Address any = Ipv4Address::GetAny ();
+  Ipv4EndPointDemux::EndPoints found;
+
+  Ipv4EndPointDemux demux;
+  Ipv4EndPoint *listener = demux.Allocate (80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "could not allocate port 80");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (80), 0, "port 80 is already bound");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), true, "port 80 is bound");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (any, 80), true, "port 80 is bound to the wildcard address");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupLocal (local, 80), false, "port 80 is not bound to 10.0.0.1");
+
+  found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "the listener should match");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), listener, "the listener should match");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 81, peer, 1000, interface).size (), 0, "nothing on port 81");
+
+  // the endpoints bound to the local address take precedence over the
+  // wildcard ones, and the connected endpoints over both.
+  Ipv4EndPoint *bound = demux.Allocate (local, 80);
+  NS_TEST_ASSERT_MSG_NE (bound, 0, "could not bind port 80 to 10.0.0.1");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1000, interface).front (), bound, "the bound endpoint should match");
+  Ipv4EndPoint *connection = demux.Allocate (local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (connection, 0, "could not allocate a connection");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1000), 0, "duplicate four-tuple");
+  found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "only the connection should match");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), connection, "only the connection should match");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1000), connection, "exact match expected");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1001, interface).front (), bound, "other peers go to the bound endpoint");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (peer, 80, peer, 1001, interface).front (), listener, "other addresses go to the listener");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1001), connection, "the most specific generic match");
+
+  // an endpoint moves to its new place in the index when it connects.
+  Ipv4EndPoint *client = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (client, 0, "could not allocate an ephemeral port");
+  uint16_t port = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, peer, 2000, interface).front (), client, "the client should match");
+  client->SetLocalAddress (local);
+  client->SetPeer (peer, 2000);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, peer, 2000, interface).front (), client, "the client should match");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, peer, 2001, interface).size (), 0, "the client is connected");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, port, peer, 2000), 0, "duplicate four-tuple");
+
+  // ephemeral ports in use are skipped.
+  Ipv4EndPoint *next = demux.Allocate (port + 1);
+  Ipv4EndPoint *other = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (other, 0, "could not allocate an ephemeral port");
+  NS_TEST_EXPECT_MSG_EQ (other->GetLocalPort (), port + 2, "the next ephemeral port is in use");
+
+  // endpoints bound to another device are ignored.
+  Ptr<SimpleNetDevice> otherDevice = CreateObject<SimpleNetDevice> ();
+  connection->BindToNetDevice (otherDevice);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1000, interface).front (), bound, "the connection is bound to another device");
+
+  // broadcasts match the endpoints bound to the address of the interface.
+  found = demux.Lookup (Ipv4Address ("10.0.0.255"), 80, peer, 1001, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 2, "the broadcast should match the bound endpoint and the listener");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), listener, "the endpoints are listed in their order of allocation");
+  NS_TEST_EXPECT_MSG_EQ (found.back (), bound, "the endpoints are listed in their order of allocation");
+
+  demux.DeAllocate (bound);
+  demux.DeAllocate (connection);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1000, interface).front (), listener, "only the listener is left");
+  demux.DeAllocate (listener);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), false, "port 80 is free");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 3, "three endpoints are left");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().front (), client, "the endpoints are listed in their order of allocation");
+  demux.DeAllocate (next);
+  demux.DeAllocate (other);
+
+  Simulator::Destroy ();
+}
+
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Check the indexed lookups of Ipv6EndPointDemux")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  interface->SetDevice (device);
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address peer ("2001:db8::2");
+  Ipv6EndPointDemux::EndPoints found;
+
+  Ipv6EndPointDemux demux;
+  Ipv6EndPoint *listener = demux.Allocate (80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "could not allocate port 80");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (80), 0, "port 80 is already bound");
+  Ipv6EndPoint *connection = demux.Allocate (local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (connection, 0, "could not allocate a connection");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (local, 80, peer, 1000), 0, "duplicate four-tuple");
+
+  found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "only the connection should match");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), connection, "only the connection should match");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1001, interface).front (), listener, "other peers go to the listener");
+  NS_TEST_EXPECT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1000), connection, "exact match expected");
+
+  Ipv6EndPoint *client = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (client, 0, "could not allocate an ephemeral port");
+  uint16_t port = client->GetLocalPort ();
+  client->SetLocalAddress (local);
+  client->SetPeer (peer, 2000);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, peer, 2000, interface).front (), client, "the client should match");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, peer, 2001, interface).size (), 0, "the client is connected");
+  client->SetLocalPort (port + 10);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "the client moved to another port");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port + 10, peer, 2000, interface).front (), client, "the client should match");
+
+  Ipv6EndPoint *next = demux.Allocate (port + 1);
+  Ipv6EndPoint *other = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_NE (other, 0, "could not allocate an ephemeral port");
+  NS_TEST_EXPECT_MSG_EQ (other->GetLocalPort (), port + 2, "the next ephemeral port is in use");
+
+  demux.DeAllocate (connection);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, 80, peer, 1000, interface).front (), listener, "only the listener is left");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 4, "four end points are left");
+  demux.DeAllocate (listener);
+  demux.DeAllocate (client);
+  demux.DeAllocate (next);
+  demux.DeAllocate (other);
+  NS_TEST_EXPECT_MSG_EQ (demux.GetEndPoints ().size (), 0, "all the end points were released");
+
+  Simulator::Destroy ();
+}
+
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite ()
+  : TestSuite ("end-point-demux", UNIT)
+{
+  AddTestCase (new Ipv4EndPointDemuxTestCase);
+  AddTestCase (new Ipv6EndPointDemuxTestCase);
+}
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite;
@@ -26,7 +26,19 @@
 #include "ns3/global-route-manager-impl.h"
 #include "ns3/candidate-queue.h"
 #include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/global-router-interface.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include <cstdlib> // for rand()
+#include <sstream>
 
 using namespace ns3;
 
@@ -214,6 +226,286 @@ GlobalRouteManagerImplTestCase::DoRun (void)
 }
 
 
+class CandidateQueueTestCase : public TestCase
+{
+public:
+  CandidateQueueTestCase ();
+  virtual void DoRun (void);
+};
+
+CandidateQueueTestCase::CandidateQueueTestCase ()
+  : TestCase ("Check the order in which the CandidateQueue pops its vertices")
+{
+}
+
+void
+CandidateQueueTestCase::DoRun (void)
+{
+  CandidateQueue candidate;
+  std::vector<SPFVertex *> vertices;
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      SPFVertex *v = new SPFVertex;
+      v->SetVertexId (Ipv4Address (i + 1));
+      v->SetVertexType (std::rand () % 2 ? SPFVertex::VertexRouter : SPFVertex::VertexNetwork);
+      v->SetDistanceFromRoot (100 + std::rand () % 20);
+      candidate.Push (v);
+      vertices.push_back (v);
+    }
+  NS_TEST_EXPECT_MSG_EQ (candidate.Find (Ipv4Address (42)), vertices[41], "Find () failed");
+  NS_TEST_EXPECT_MSG_EQ (candidate.Find (Ipv4Address (1000)), 0, "Find () found a missing vertex");
+
+  // decrease the distance of some vertices
+  for (uint32_t i = 0; i < vertices.size (); i += 7)
+    {
+      vertices[i]->SetDistanceFromRoot (vertices[i]->GetDistanceFromRoot () - std::rand () % 20);
+      candidate.Reorder (vertices[i]);
+    }
+
+  SPFVertex *previous = 0;
+  uint32_t n = 0;
+  while (!candidate.Empty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (candidate.Top (), candidate.Top (), "Top () is not stable");
+      SPFVertex *v = candidate.Pop ();
+      NS_TEST_EXPECT_MSG_EQ (candidate.Find (v->GetVertexId ()), 0, "popped vertex still found");
+      if (previous != 0)
+        {
+          NS_TEST_EXPECT_MSG_LT (previous->GetDistanceFromRoot (), v->GetDistanceFromRoot () + 1,
+                                 "vertices not popped by increasing distance");
+          if (previous->GetDistanceFromRoot () == v->GetDistanceFromRoot ())
+            {
+              NS_TEST_EXPECT_MSG_EQ ((previous->GetVertexType () == SPFVertex::VertexRouter
+                                      && v->GetVertexType () == SPFVertex::VertexNetwork), false,
+                                     "a network vertex was popped after a router at the same distance");
+            }
+        }
+      delete previous;
+      previous = v;
+      n++;
+    }
+  delete previous;
+  NS_TEST_EXPECT_MSG_EQ (n, 200, "wrong number of popped vertices");
+
+  // equal vertices are popped in the order they were pushed, or last
+  // reordered.
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      SPFVertex *v = new SPFVertex;
+      v->SetVertexId (Ipv4Address (i + 1));
+      v->SetVertexType (SPFVertex::VertexRouter);
+      v->SetDistanceFromRoot (i == 0 ? 2 : 1);
+      candidate.Push (v);
+    }
+  candidate.Find (Ipv4Address (1))->SetDistanceFromRoot (1);
+  candidate.Reorder (candidate.Find (Ipv4Address (1)));
+  uint32_t expected[] = { 2, 3, 4, 1 };
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      SPFVertex *v = candidate.Pop ();
+      NS_TEST_EXPECT_MSG_EQ (v->GetVertexId (), Ipv4Address (expected[i]), "ties not broken in FIFO order");
+      delete v;
+    }
+}
+
+static std::string
+GetRoutes (Ptr<Node> node)
+{
+  Ptr<Ipv4GlobalRouting> routing = node->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  std::ostringstream oss;
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      oss << *routing->GetRoute (i) << std::endl;
+    }
+  return oss.str ();
+}
+
+static std::vector<std::string>
+GetAllRoutes (NodeContainer nodes)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      routes.push_back (GetRoutes (nodes.Get (i)));
+    }
+  return routes;
+}
+
+static void
+AddSimpleLink (Ptr<Node> a, Ptr<Node> b, Ipv4AddressHelper& address)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  NetDeviceContainer devices;
+  Ptr<Node> nodes[] = { a, b };
+  for (uint32_t j = 0; j < 2; j++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      device->SetChannel (channel);
+      nodes[j]->AddDevice (device);
+      devices.Add (device);
+    }
+  address.Assign (devices);
+  address.NewNetwork ();
+}
+
+/**
+ * Build a network of two disjoint chains of three nodes, each link being a
+ * SimpleChannel between two SimpleNetDevices, with global routing.
+ */
+class GlobalRouteManagerImplSpfTestCase : public TestCase
+{
+public:
+  GlobalRouteManagerImplSpfTestCase ();
+  virtual void DoRun (void);
+private:
+  NodeContainer m_nodes;
+};
+
+GlobalRouteManagerImplSpfTestCase::GlobalRouteManagerImplSpfTestCase ()
+  : TestCase ("Check that threaded and incremental SPF compute the same routes as the serial one")
+{
+}
+
+void
+GlobalRouteManagerImplSpfTestCase::DoRun (void)
+{
+  m_nodes.Create (6);
+  InternetStackHelper internet;
+  internet.Install (m_nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      if (i % 3 == 2)
+        {
+          continue;
+        }
+      AddSimpleLink (m_nodes.Get (i), m_nodes.Get (i + 1), address);
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> serial = GetAllRoutes (m_nodes);
+  NS_TEST_ASSERT_MSG_NE (serial[0], "", "no routes computed");
+
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (4));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> threaded = GetAllRoutes (m_nodes);
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (threaded[i], serial[i], "threaded SPF differs for node " << i);
+    }
+
+  // add a route by hand to a node of each chain: the incremental mode
+  // leaves the routes alone while nothing changes.
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  Ptr<Ipv4GlobalRouting> first = m_nodes.Get (0)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  Ptr<Ipv4GlobalRouting> second = m_nodes.Get (3)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  first->AddHostRouteTo (Ipv4Address ("192.168.0.1"), Ipv4Address ("10.1.0.2"), 1);
+  second->AddHostRouteTo (Ipv4Address ("192.168.0.1"), Ipv4Address ("10.1.2.2"), 1);
+  uint32_t nRoutes = first->GetNRoutes ();
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_EXPECT_MSG_EQ (first->GetNRoutes (), nRoutes, "unchanged routes were recomputed");
+
+  // then break the first chain: only its routes are recomputed.
+  m_nodes.Get (2)->GetObject<Ipv4> ()->SetDown (1);
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> incremental = GetAllRoutes (m_nodes);
+  NS_TEST_EXPECT_MSG_NE (incremental[0], serial[0], "the routes of the first chain were not recomputed");
+  NS_TEST_EXPECT_MSG_NE (incremental[3], serial[3], "the routes of the second chain were recomputed");
+
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> full = GetAllRoutes (m_nodes);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (incremental[i], full[i], "incremental SPF differs for node " << i);
+    }
+  for (uint32_t i = 3; i < m_nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (full[i], serial[i], "full SPF differs for node " << i);
+    }
+
+  Config::SetGlobal ("GlobalRoutingSpfThreads", UintegerValue (1));
+  Simulator::Destroy ();
+}
+
+/**
+ * Build a ring of four nodes, A to D, and change the metric of the link
+ * from B to the network between B and C.  The SPF trees of A and B use
+ * this link, so their routes are recomputed; those of C and D do not, so
+ * their routes are kept, and they are the same as after a full
+ * recomputation.
+ */
+class GlobalRouteManagerImplIncrementalTestCase : public TestCase
+{
+public:
+  GlobalRouteManagerImplIncrementalTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Set the metric of the interface of B to C, recompute the routes in
+   * the incremental mode and check which routes were recomputed.
+   */
+  void CheckMetric (NodeContainer nodes, uint16_t metric);
+};
+
+GlobalRouteManagerImplIncrementalTestCase::GlobalRouteManagerImplIncrementalTestCase ()
+  : TestCase ("Check that incremental SPF only recomputes the trees which a link change affects")
+{
+}
+
+void
+GlobalRouteManagerImplIncrementalTestCase::CheckMetric (NodeContainer nodes, uint16_t metric)
+{
+  std::vector<std::string> before = GetAllRoutes (nodes);
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  // a route added by hand is only deleted if the routes are recomputed
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> routing = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      routing->AddHostRouteTo (Ipv4Address ("192.168.0.1"), 1);
+    }
+  nodes.Get (1)->GetObject<Ipv4> ()->SetMetric (2, metric);
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> incremental = GetAllRoutes (nodes);
+  Config::SetGlobal ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::vector<std::string> full = GetAllRoutes (nodes);
+
+  NS_TEST_EXPECT_MSG_NE (full[0], before[0], "the routes of A do not use the link");
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (incremental[i], full[i], "the routes of node " << i << " were not recomputed");
+    }
+  for (uint32_t i = 2; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_NE (incremental[i], full[i], "the routes of node " << i << " were recomputed");
+      NS_TEST_EXPECT_MSG_EQ (full[i], before[i], "the routes of node " << i << " changed");
+    }
+}
+
+void
+GlobalRouteManagerImplIncrementalTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      AddSimpleLink (nodes.Get (i), nodes.Get ((i + 1) % nodes.GetN ()), address);
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  // B to C gets more expensive than B to A to D to C, then cheaper again
+  CheckMetric (nodes, 10);
+  CheckMetric (nodes, 1);
+  Simulator::Destroy ();
+}
+
 static class GlobalRouteManagerImplTestSuite : public TestSuite
 {
 public:
@@ -221,5 +513,8 @@ public:
     : TestSuite ("global-route-manager-impl", UNIT)
   {
     AddTestCase (new GlobalRouteManagerImplTestCase ());
+    AddTestCase (new CandidateQueueTestCase ());
+    AddTestCase (new GlobalRouteManagerImplSpfTestCase ());
+    AddTestCase (new GlobalRouteManagerImplIncrementalTestCase ());
   }
 } g_globalRoutingManagerImplTestSuite;
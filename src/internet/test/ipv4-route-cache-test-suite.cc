@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-global-routing.h"
+
+using namespace ns3;
+
+/**
+ * Build a node with two interfaces, 10.0.0.1/24 on the first device and
+ * 10.0.1.1/24 on the second one.
+ */
+static Ptr<Ipv4L3Protocol>
+CreateRouter (Ptr<Ipv4RoutingProtocol> routing)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  ipv4->SetRoutingProtocol (routing);
+  node->AggregateObject (ipv4);
+  const char *addresses[] = { "10.0.0.1", "10.0.1.1" };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      device->SetAddress (Mac48Address::Allocate ());
+      node->AddDevice (device);
+      uint32_t interface = ipv4->AddInterface (device);
+      ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address (addresses[i]), Ipv4Mask ("255.255.255.0")));
+      ipv4->SetUp (interface);
+    }
+  return ipv4;
+}
+
+static Ptr<Ipv4Route>
+RouteOutput (Ptr<Ipv4RoutingProtocol> routing, const char *destination, Ptr<NetDevice> oif = 0)
+{
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address (destination));
+  Socket::SocketErrno error;
+  return routing->RouteOutput (0, header, oif, error);
+}
+
+static uint64_t
+GetCounter (Ptr<Ipv4RoutingProtocol> routing, const char *name)
+{
+  UintegerValue value;
+  routing->GetAttribute (name, value);
+  return value.Get ();
+}
+
+class Ipv4StaticRoutingCacheTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingCacheTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4StaticRoutingCacheTestCase::Ipv4StaticRoutingCacheTestCase ()
+  : TestCase ("Check that Ipv4StaticRouting caches its routes until its table changes")
+{
+}
+
+void
+Ipv4StaticRoutingCacheTestCase::DoRun (void)
+{
+  Ptr<Ipv4StaticRouting> routing = CreateObject<Ipv4StaticRouting> ();
+  Ptr<Ipv4L3Protocol> ipv4 = CreateRouter (routing);
+  routing->AddNetworkRouteTo (Ipv4Address ("192.168.0.0"), Ipv4Mask ("255.255.0.0"), Ipv4Address ("10.0.0.2"), 1);
+  uint64_t hits = GetCounter (routing, "RouteCacheHits");
+  uint64_t misses = GetCounter (routing, "RouteCacheMisses");
+
+  Ptr<Ipv4Route> first = RouteOutput (routing, "192.168.1.1");
+  NS_TEST_ASSERT_MSG_NE (first, 0, "no route to 192.168.1.1");
+  NS_TEST_EXPECT_MSG_EQ (first->GetGateway (), Ipv4Address ("10.0.0.2"), "wrong gateway");
+  Ptr<Ipv4Route> second = RouteOutput (routing, "192.168.1.1");
+  NS_TEST_EXPECT_MSG_EQ (second, first, "the cached route should be shared");
+  NS_TEST_EXPECT_MSG_EQ (GetCounter (routing, "RouteCacheHits"), hits + 1, "one hit expected");
+  NS_TEST_EXPECT_MSG_EQ (GetCounter (routing, "RouteCacheMisses"), misses + 1, "one miss expected");
+
+  NS_TEST_EXPECT_MSG_EQ (RouteOutput (routing, "172.16.0.1"), 0, "no route to 172.16.0.1");
+  NS_TEST_EXPECT_MSG_EQ (RouteOutput (routing, "172.16.0.1"), 0, "no route to 172.16.0.1");
+  NS_TEST_EXPECT_MSG_EQ (GetCounter (routing, "RouteCacheHits"), hits + 2, "the absence of a route is cached");
+
+  // adding a route flushes the cache.
+  routing->AddNetworkRouteTo (Ipv4Address ("192.168.1.0"), Ipv4Mask ("255.255.255.0"), Ipv4Address ("10.0.1.2"), 2);
+  Ptr<Ipv4Route> third = RouteOutput (routing, "192.168.1.1");
+  NS_TEST_ASSERT_MSG_NE (third, 0, "no route to 192.168.1.1");
+  NS_TEST_EXPECT_MSG_EQ (third->GetGateway (), Ipv4Address ("10.0.1.2"), "the cache was not flushed");
+
+  // the output device is part of the key.
+  Ptr<Ipv4Route> onFirstDevice = RouteOutput (routing, "192.168.1.1", ipv4->GetNetDevice (1));
+  NS_TEST_ASSERT_MSG_NE (onFirstDevice, 0, "no route to 192.168.1.1 on the first device");
+  NS_TEST_EXPECT_MSG_EQ (onFirstDevice->GetGateway (), Ipv4Address ("10.0.0.2"), "wrong route on the first device");
+
+  // so is the state of the interfaces.
+  ipv4->SetDown (2);
+  Ptr<Ipv4Route> fourth = RouteOutput (routing, "192.168.1.1");
+  NS_TEST_ASSERT_MSG_NE (fourth, 0, "no route to 192.168.1.1");
+  NS_TEST_EXPECT_MSG_EQ (fourth->GetGateway (), Ipv4Address ("10.0.0.2"), "the cache was not flushed");
+
+  routing->SetAttribute ("RouteCacheSize", UintegerValue (0));
+  hits = GetCounter (routing, "RouteCacheHits");
+  RouteOutput (routing, "192.168.1.1");
+  RouteOutput (routing, "192.168.1.1");
+  NS_TEST_EXPECT_MSG_EQ (GetCounter (routing, "RouteCacheHits"), hits, "the cache is disabled");
+
+  Simulator::Destroy ();
+}
+
+class Ipv4GlobalRoutingCacheTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingCacheTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingCacheTestCase::Ipv4GlobalRoutingCacheTestCase ()
+  : TestCase ("Check that Ipv4GlobalRouting caches its routes unless ECMP routes are randomly chosen")
+{
+}
+
+void
+Ipv4GlobalRoutingCacheTestCase::DoRun (void)
+{
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  CreateRouter (routing);
+  routing->AddHostRouteTo (Ipv4Address ("192.168.0.1"), Ipv4Address ("10.0.0.2"), 1);
+  routing->AddNetworkRouteTo (Ipv4Address ("192.168.1.0"), Ipv4Mask ("255.255.255.0"), Ipv4Address ("10.0.1.2"), 2);
+
+  Ptr<Ipv4Route> first = RouteOutput (routing, "192.168.0.1");
+  NS_TEST_ASSERT_MSG_NE (first, 0, "no route to 192.168.0.1");
+  NS_TEST_EXPECT_MSG_EQ (RouteOutput (routing, "192.168.0.1"), first, "the cached route should be shared");
+  Ptr<Ipv4Route> second = RouteOutput (routing, "192.168.1.1");
+  NS_TEST_ASSERT_MSG_NE (second, 0, "no route to 192.168.1.1");
+  NS_TEST_EXPECT_MSG_EQ (second->GetGateway (), Ipv4Address ("10.0.1.2"), "wrong gateway");
+  NS_TEST_EXPECT_MSG_EQ (GetCounter (routing, "RouteCacheHits"), 1, "one hit expected");
+  NS_TEST_EXPECT_MSG_EQ (GetCounter (routing, "RouteCacheMisses"), 2, "two misses expected");
+
+  routing->RemoveRoute (1);
+  NS_TEST_EXPECT_MSG_EQ (RouteOutput (routing, "192.168.1.1"), 0, "the cache was not flushed");
+
+  routing->SetAttribute ("RandomEcmpRouting", BooleanValue (true));
+  RouteOutput (routing, "192.168.0.1");
+  RouteOutput (routing, "192.168.0.1");
+  NS_TEST_EXPECT_MSG_EQ (GetCounter (routing, "RouteCacheHits"), 1, "random ECMP routes are not cached");
+
+  Simulator::Destroy ();
+}
+
+class Ipv4RouteCacheTestSuite : public TestSuite
+{
+public:
+  Ipv4RouteCacheTestSuite ();
+};
+
+Ipv4RouteCacheTestSuite::Ipv4RouteCacheTestSuite ()
+  : TestSuite ("ipv4-route-cache", UNIT)
+{
+  AddTestCase (new Ipv4StaticRoutingCacheTestCase);
+  AddTestCase (new Ipv4GlobalRoutingCacheTestCase);
+}
+
+static Ipv4RouteCacheTestSuite g_ipv4RouteCacheTestSuite;
@@ -0,0 +1,309 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/prefix-trie.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+
+#include <vector>
+
+using namespace ns3;
+
+class PrefixTrieIpv4TestCase : public TestCase
+{
+public:
+  PrefixTrieIpv4TestCase ();
+  virtual void DoRun (void);
+
+private:
+  typedef PrefixTrie<uint32_t, 4> Trie;
+
+  void Insert (Trie &trie, const char *network, uint32_t length, uint32_t value);
+  bool Remove (Trie &trie, const char *network, uint32_t length, uint32_t value);
+  std::vector<uint32_t> Lookup (const Trie &trie, const char *address);
+};
+
+PrefixTrieIpv4TestCase::PrefixTrieIpv4TestCase ()
+  : TestCase ("Check longest prefix matches of IPv4 addresses")
+{
+}
+
+void
+PrefixTrieIpv4TestCase::Insert (Trie &trie, const char *network, uint32_t length, uint32_t value)
+{
+  uint8_t prefix[4];
+  Ipv4Address (network).Serialize (prefix);
+  trie.Insert (prefix, length, value);
+}
+
+bool
+PrefixTrieIpv4TestCase::Remove (Trie &trie, const char *network, uint32_t length, uint32_t value)
+{
+  uint8_t prefix[4];
+  Ipv4Address (network).Serialize (prefix);
+  return trie.Remove (prefix, length, value);
+}
+
+std::vector<uint32_t>
+PrefixTrieIpv4TestCase::Lookup (const Trie &trie, const char *address)
+{
+  uint8_t key[4];
+  Ipv4Address (address).Serialize (key);
+  const Trie::Group *group = trie.Lookup (key);
+  if (group == 0)
+    {
+      return std::vector<uint32_t> ();
+    }
+  return *group;
+}
+
+void
+PrefixTrieIpv4TestCase::DoRun (void)
+{
+  Trie trie;
+  NS_TEST_EXPECT_MSG_EQ (Lookup (trie, "10.1.1.1").size (), 0, "empty trie");
+
+  Insert (trie, "10.0.0.0", 8, 1);
+  Insert (trie, "10.1.0.0", 16, 2);
+  Insert (trie, "10.1.1.0", 24, 3);
+  Insert (trie, "10.1.1.1", 32, 4);
+  Insert (trie, "0.0.0.0", 0, 5);
+  // the bits past the prefix length are ignored.
+  Insert (trie, "10.1.7.7", 16, 6);
+
+  std::vector<uint32_t> group = Lookup (trie, "10.1.1.1");
+  NS_TEST_ASSERT_MSG_EQ (group.size (), 1, "host route");
+  NS_TEST_EXPECT_MSG_EQ (group[0], 4, "host route");
+  group = Lookup (trie, "10.1.1.2");
+  NS_TEST_ASSERT_MSG_EQ (group.size (), 1, "/24 route");
+  NS_TEST_EXPECT_MSG_EQ (group[0], 3, "/24 route");
+  group = Lookup (trie, "10.1.2.1");
+  NS_TEST_ASSERT_MSG_EQ (group.size (), 2, "/16 routes");
+  NS_TEST_EXPECT_MSG_EQ (group[0], 2, "values are kept in their order of insertion");
+  NS_TEST_EXPECT_MSG_EQ (group[1], 6, "values are kept in their order of insertion");
+  group = Lookup (trie, "10.2.0.0");
+  NS_TEST_ASSERT_MSG_EQ (group.size (), 1, "/8 route");
+  NS_TEST_EXPECT_MSG_EQ (group[0], 1, "/8 route");
+  group = Lookup (trie, "192.168.0.1");
+  NS_TEST_ASSERT_MSG_EQ (group.size (), 1, "default route");
+  NS_TEST_EXPECT_MSG_EQ (group[0], 5, "default route");
+
+  uint8_t key[4];
+  Ipv4Address ("10.1.1.1").Serialize (key);
+  std::vector<const Trie::Group *> groups;
+  trie.LookupAll (key, groups);
+  NS_TEST_ASSERT_MSG_EQ (groups.size (), 5, "all the prefixes match");
+  NS_TEST_EXPECT_MSG_EQ ((*groups[0])[0], 4, "longest prefix first");
+  NS_TEST_EXPECT_MSG_EQ ((*groups[4])[0], 5, "shortest prefix last");
+
+  NS_TEST_EXPECT_MSG_EQ (Remove (trie, "10.1.1.0", 24, 4), false, "not a value of the prefix");
+  NS_TEST_EXPECT_MSG_EQ (Remove (trie, "10.1.1.0", 25, 3), false, "not a prefix of the trie");
+  NS_TEST_EXPECT_MSG_EQ (Remove (trie, "10.1.1.0", 24, 3), true, "remove /24 route");
+  group = Lookup (trie, "10.1.1.2");
+  NS_TEST_EXPECT_MSG_EQ (group.size (), 2, "/16 routes once the /24 route is removed");
+  NS_TEST_EXPECT_MSG_EQ (Remove (trie, "10.1.0.0", 16, 2), true, "remove /16 route");
+  group = Lookup (trie, "10.1.1.2");
+  NS_TEST_ASSERT_MSG_EQ (group.size (), 1, "remaining /16 route");
+  NS_TEST_EXPECT_MSG_EQ (group[0], 6, "remaining /16 route");
+  NS_TEST_EXPECT_MSG_EQ (Remove (trie, "0.0.0.0", 0, 5), true, "remove default route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (trie, "192.168.0.1").size (), 0, "no default route");
+
+  trie.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (Lookup (trie, "10.1.1.1").size (), 0, "cleared trie");
+}
+
+/**
+ * Insert and remove random prefixes and check that lookups return the
+ * same values as a linear search for the longest matching prefix.
+ */
+class PrefixTrieRandomTestCase : public TestCase
+{
+public:
+  PrefixTrieRandomTestCase ();
+  virtual void DoRun (void);
+
+private:
+  struct Entry
+  {
+    uint32_t prefix;
+    uint32_t length;
+    uint32_t value;
+  };
+
+  uint32_t NextRandom (void);
+  static void Serialize (uint32_t address, uint8_t buf[4]);
+  static bool IsMatch (const Entry &entry, uint32_t address);
+
+  uint32_t m_seed;
+};
+
+PrefixTrieRandomTestCase::PrefixTrieRandomTestCase ()
+  : TestCase ("Check the prefix trie against a linear search"),
+    m_seed (1)
+{
+}
+
+uint32_t
+PrefixTrieRandomTestCase::NextRandom (void)
+{
+  m_seed = m_seed * 1103515245 + 12345;
+  return m_seed >> 8;
+}
+
+void
+PrefixTrieRandomTestCase::Serialize (uint32_t address, uint8_t buf[4])
+{
+  buf[0] = (address >> 24) & 0xff;
+  buf[1] = (address >> 16) & 0xff;
+  buf[2] = (address >> 8) & 0xff;
+  buf[3] = address & 0xff;
+}
+
+bool
+PrefixTrieRandomTestCase::IsMatch (const Entry &entry, uint32_t address)
+{
+  uint32_t mask = entry.length == 0 ? 0 : 0xffffffff << (32 - entry.length);
+  return (entry.prefix & mask) == (address & mask);
+}
+
+void
+PrefixTrieRandomTestCase::DoRun (void)
+{
+  PrefixTrie<uint32_t, 4> trie;
+  std::vector<Entry> entries;
+  for (uint32_t i = 0; i < 5000; i++)
+    {
+      // keep the prefixes in a small part of the address space so that
+      // they overlap.
+      uint32_t address = 0x0a000000 | ((NextRandom () & 0xff) << 16) | (NextRandom () & 0x3) << 8 | (NextRandom () & 0x3);
+      uint32_t operation = NextRandom () % 4;
+      if (operation == 0 && !entries.empty ())
+        {
+          uint32_t index = NextRandom () % entries.size ();
+          uint8_t prefix[4];
+          Serialize (entries[index].prefix, prefix);
+          NS_TEST_ASSERT_MSG_EQ (trie.Remove (prefix, entries[index].length, entries[index].value), true,
+                                 "failed to remove an entry");
+          entries.erase (entries.begin () + index);
+        }
+      else if (operation == 1)
+        {
+          static const uint32_t lengths[] = { 0, 8, 12, 16, 20, 23, 24, 30, 32 };
+          Entry entry;
+          entry.prefix = address;
+          entry.length = lengths[NextRandom () % (sizeof (lengths) / sizeof (lengths[0]))];
+          entry.value = i;
+          uint8_t prefix[4];
+          Serialize (entry.prefix, prefix);
+          trie.Insert (prefix, entry.length, entry.value);
+          entries.push_back (entry);
+        }
+      else
+        {
+          std::vector<uint32_t> expected;
+          uint32_t longest = 0;
+          for (std::vector<Entry>::const_iterator j = entries.begin (); j != entries.end (); j++)
+            {
+              if (!IsMatch (*j, address) || (!expected.empty () && j->length < longest))
+                {
+                  continue;
+                }
+              if (expected.empty () || j->length > longest)
+                {
+                  expected.clear ();
+                  longest = j->length;
+                }
+              expected.push_back (j->value);
+            }
+          uint8_t key[4];
+          Serialize (address, key);
+          const PrefixTrie<uint32_t, 4>::Group *group = trie.Lookup (key);
+          std::vector<uint32_t> found;
+          if (group != 0)
+            {
+              found = *group;
+            }
+          NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "unexpected lookup result for " << Ipv4Address (address));
+        }
+    }
+}
+
+class PrefixTrieIpv6TestCase : public TestCase
+{
+public:
+  PrefixTrieIpv6TestCase ();
+  virtual void DoRun (void);
+};
+
+PrefixTrieIpv6TestCase::PrefixTrieIpv6TestCase ()
+  : TestCase ("Check longest prefix matches of IPv6 addresses")
+{
+}
+
+void
+PrefixTrieIpv6TestCase::DoRun (void)
+{
+  PrefixTrie<uint32_t, 16> trie;
+  uint8_t prefix[16];
+  Ipv6Address ("2001:db8::").Serialize (prefix);
+  trie.Insert (prefix, 32, 1);
+  Ipv6Address ("2001:db8:0:1::").Serialize (prefix);
+  trie.Insert (prefix, 64, 2);
+  Ipv6Address ("2001:db8:0:1::1").Serialize (prefix);
+  trie.Insert (prefix, 128, 3);
+  Ipv6Address ("::").Serialize (prefix);
+  trie.Insert (prefix, 0, 4);
+
+  uint8_t key[16];
+  Ipv6Address ("2001:db8:0:1::1").Serialize (key);
+  NS_TEST_ASSERT_MSG_NE (trie.Lookup (key), 0, "host route");
+  NS_TEST_EXPECT_MSG_EQ ((*trie.Lookup (key))[0], 3, "host route");
+  Ipv6Address ("2001:db8:0:1::2").Serialize (key);
+  NS_TEST_ASSERT_MSG_NE (trie.Lookup (key), 0, "/64 route");
+  NS_TEST_EXPECT_MSG_EQ ((*trie.Lookup (key))[0], 2, "/64 route");
+  Ipv6Address ("2001:db8:0:2::1").Serialize (key);
+  NS_TEST_ASSERT_MSG_NE (trie.Lookup (key), 0, "/32 route");
+  NS_TEST_EXPECT_MSG_EQ ((*trie.Lookup (key))[0], 1, "/32 route");
+  Ipv6Address ("2001:db9::1").Serialize (key);
+  NS_TEST_ASSERT_MSG_NE (trie.Lookup (key), 0, "default route");
+  NS_TEST_EXPECT_MSG_EQ ((*trie.Lookup (key))[0], 4, "default route");
+
+  Ipv6Address ("2001:db8:0:1::").Serialize (prefix);
+  NS_TEST_EXPECT_MSG_EQ (trie.Remove (prefix, 64, 2), true, "remove /64 route");
+  Ipv6Address ("2001:db8:0:1::2").Serialize (key);
+  NS_TEST_ASSERT_MSG_NE (trie.Lookup (key), 0, "/32 route");
+  NS_TEST_EXPECT_MSG_EQ ((*trie.Lookup (key))[0], 1, "/32 route once the /64 route is removed");
+  Ipv6Address ("2001:db8:0:1::1").Serialize (key);
+  NS_TEST_ASSERT_MSG_NE (trie.Lookup (key), 0, "host route");
+  NS_TEST_EXPECT_MSG_EQ ((*trie.Lookup (key))[0], 3, "host route once the /64 route is removed");
+}
+
+class PrefixTrieTestSuite : public TestSuite
+{
+public:
+  PrefixTrieTestSuite ();
+};
+
+PrefixTrieTestSuite::PrefixTrieTestSuite ()
+  : TestSuite ("prefix-trie", UNIT)
+{
+  AddTestCase (new PrefixTrieIpv4TestCase);
+  AddTestCase (new PrefixTrieRandomTestCase);
+  AddTestCase (new PrefixTrieIpv6TestCase);
+}
+
+static PrefixTrieTestSuite g_prefixTrieTestSuite;
@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-tx-buffer.h"
+
+using namespace ns3;
+
+// The ring storage of TcpTxBuffer and TcpRxBuffer must behave exactly as
+// the packet storage. The data is a pattern, with runs of zeros so that
+// the ring has to mix virtual and real payloads.
+
+namespace {
+
+uint8_t
+StreamByte (uint32_t position)
+{
+  return (position / 3000) % 2 ? 0 : position % 251 + 1;
+}
+
+Ptr<Packet>
+StreamPacket (uint32_t position, uint32_t size)
+{
+  std::vector<uint8_t> bytes (size);
+  bool zero = true;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      bytes[i] = StreamByte (position + i);
+      zero = zero && bytes[i] == 0;
+    }
+  if (zero)
+    {
+      return Create<Packet> (size);
+    }
+  return Create<Packet> (&bytes[0], size);
+}
+
+bool
+SameData (Ptr<const Packet> a, Ptr<const Packet> b)
+{
+  if (a == 0 || b == 0)
+    {
+      return a == b;
+    }
+  if (a->GetSize () != b->GetSize ())
+    {
+      return false;
+    }
+  std::vector<uint8_t> x (a->GetSize () + 1), y (b->GetSize () + 1);
+  a->CopyData (&x[0], a->GetSize ());
+  b->CopyData (&y[0], b->GetSize ());
+  return x == y;
+}
+
+// A linear congruential generator, so that the test does not depend on the
+// random variable streams
+class Lcg
+{
+public:
+  Lcg () : m_state (12345) {}
+  uint32_t Next (uint32_t n)
+  {
+    m_state = m_state * 1103515245 + 12345;
+    return (m_state >> 8) % n;
+  }
+private:
+  uint32_t m_state;
+};
+
+} // anonymous namespace
+
+class TcpTxBufferRingTestCase : public TestCase
+{
+public:
+  TcpTxBufferRingTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpTxBufferRingTestCase::TcpTxBufferRingTestCase ()
+  : TestCase ("Check that the ring storage of TcpTxBuffer keeps the same data as the packet storage")
+{
+}
+
+void
+TcpTxBufferRingTestCase::DoRun (void)
+{
+  TcpTxBuffer list (1);
+  TcpTxBuffer ring (1);
+  ring.SetRingStorage (true);
+  list.SetMaxBufferSize (20000);
+  ring.SetMaxBufferSize (20000);
+  Lcg lcg;
+  uint32_t written = 0;
+  for (uint32_t round = 0; round < 2000; round++)
+    {
+      // The application writes
+      uint32_t size = 1 + lcg.Next (3000);
+      Ptr<Packet> p = StreamPacket (written, size);
+      bool added = list.Add (p->Copy ());
+      NS_TEST_ASSERT_MSG_EQ (ring.Add (p), added, "Add differs in round " << round);
+      if (added)
+        {
+          written += size;
+        }
+      NS_TEST_ASSERT_MSG_EQ (ring.TailSequence (), list.TailSequence (), "tail differs in round " << round);
+      // Segments are sent, some are sent again
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          SequenceNumber32 seq = list.HeadSequence () + lcg.Next (list.Size () + 1);
+          uint32_t bytes = 1 + lcg.Next (1460);
+          Ptr<Packet> a = list.CopyFromSequence (bytes, seq);
+          Ptr<Packet> b = ring.CopyFromSequence (bytes, seq);
+          NS_TEST_ASSERT_MSG_EQ (SameData (a, b), true, "CopyFromSequence differs in round " << round);
+        }
+      // Data is acknowledged
+      SequenceNumber32 ack = list.HeadSequence () + lcg.Next (list.Size () / 2 + 1);
+      list.DiscardUpTo (ack);
+      ring.DiscardUpTo (ack);
+      NS_TEST_ASSERT_MSG_EQ (ring.HeadSequence (), list.HeadSequence (), "head differs in round " << round);
+      NS_TEST_ASSERT_MSG_EQ (ring.Size (), list.Size (), "size differs in round " << round);
+    }
+  // All the data is acknowledged
+  list.DiscardUpTo (list.TailSequence ());
+  ring.DiscardUpTo (ring.TailSequence ());
+  NS_TEST_EXPECT_MSG_EQ (ring.Size (), 0, "the ring should be empty");
+  NS_TEST_EXPECT_MSG_EQ (ring.CopyFromSequence (100, ring.HeadSequence ())->GetSize (), 0, "no data expected");
+}
+
+class TcpRxBufferRingTestCase : public TestCase
+{
+public:
+  TcpRxBufferRingTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpRxBufferRingTestCase::TcpRxBufferRingTestCase ()
+  : TestCase ("Check that the ring storage of TcpRxBuffer reassembles the same data as the packet storage")
+{
+}
+
+void
+TcpRxBufferRingTestCase::DoRun (void)
+{
+  TcpRxBuffer list (1);
+  TcpRxBuffer ring (1);
+  ring.SetRingStorage (true);
+  list.SetMaxBufferSize (30000);
+  ring.SetMaxBufferSize (30000);
+  Lcg lcg;
+  for (uint32_t round = 0; round < 5000; round++)
+    {
+      // Segments arrive out of order, duplicated or overlapping
+      uint32_t offset = lcg.Next (20000);
+      uint32_t size = 1 + lcg.Next (1460);
+      SequenceNumber32 seq = list.NextRxSequence () + SequenceNumber32 (offset - 500);
+      TcpHeader header;
+      header.SetSequenceNumber (seq);
+      Ptr<Packet> p = StreamPacket (seq.GetValue () - 1, size);
+      bool added = list.Add (p->Copy (), header);
+      NS_TEST_ASSERT_MSG_EQ (ring.Add (p, header), added, "Add differs in round " << round);
+      NS_TEST_ASSERT_MSG_EQ (ring.NextRxSequence (), list.NextRxSequence (), "RCV.NXT differs in round " << round);
+      NS_TEST_ASSERT_MSG_EQ (ring.Size (), list.Size (), "size differs in round " << round);
+      NS_TEST_ASSERT_MSG_EQ (ring.Available (), list.Available (), "available bytes differ in round " << round);
+      NS_TEST_ASSERT_MSG_EQ (ring.MaxRxSequence (), list.MaxRxSequence (), "window differs in round " << round);
+      TcpHeader::SackList a = list.GetSackBlocks (TcpHeader::MAX_SACK_BLOCKS);
+      TcpHeader::SackList b = ring.GetSackBlocks (TcpHeader::MAX_SACK_BLOCKS);
+      NS_TEST_ASSERT_MSG_EQ ((a == b), true, "SACK blocks differ in round " << round);
+      // The application reads
+      if (lcg.Next (4) == 0)
+        {
+          uint32_t bytes = lcg.Next (8000);
+          Ptr<Packet> x = list.Extract (bytes);
+          Ptr<Packet> y = ring.Extract (bytes);
+          NS_TEST_ASSERT_MSG_EQ (SameData (x, y), true, "Extract differs in round " << round);
+        }
+    }
+  NS_TEST_EXPECT_MSG_GT (list.NextRxSequence (), SequenceNumber32 (100000), "too little data was reassembled");
+}
+
+class TcpBufferTestSuite : public TestSuite
+{
+public:
+  TcpBufferTestSuite ();
+};
+
+TcpBufferTestSuite::TcpBufferTestSuite ()
+  : TestSuite ("tcp-buffers", UNIT)
+{
+  AddTestCase (new TcpTxBufferRingTestCase);
+  AddTestCase (new TcpRxBufferRingTestCase);
+}
+
+static TcpBufferTestSuite tcpBufferTestSuite;
@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+#include "ns3/tcp-tx-buffer.h"
+
+using namespace ns3;
+
+class TcpSackHeaderTestCase : public TestCase
+{
+public:
+  TcpSackHeaderTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpSackHeaderTestCase::TcpSackHeaderTestCase ()
+  : TestCase ("Check the serialization of the SACK options of TcpHeader")
+{
+}
+
+void
+TcpSackHeaderTestCase::DoRun (void)
+{
+  TcpHeader syn;
+  syn.SetFlags (TcpHeader::SYN);
+  NS_TEST_EXPECT_MSG_EQ (syn.GetSerializedSize (), 20, "no option expected");
+  syn.SetSackPermitted (true);
+  NS_TEST_EXPECT_MSG_EQ (syn.GetSerializedSize (), 24, "the SACK-permitted option takes 4 bytes");
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (syn);
+  TcpHeader synCopy;
+  p->RemoveHeader (synCopy);
+  NS_TEST_EXPECT_MSG_EQ (synCopy.IsSackPermitted (), true, "the SACK-permitted option was lost");
+  NS_TEST_EXPECT_MSG_EQ (synCopy.GetSerializedSize (), 24, "wrong header length");
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 0, "the options were not all read");
+
+  TcpHeader::SackList blocks;
+  blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (3001), SequenceNumber32 (4001)));
+  blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (1001), SequenceNumber32 (2001)));
+  TcpHeader ack;
+  ack.SetFlags (TcpHeader::ACK);
+  ack.SetAckNumber (SequenceNumber32 (1));
+  ack.SetSackBlocks (blocks);
+  NS_TEST_EXPECT_MSG_EQ (ack.GetSerializedSize (), 40, "two SACK blocks take 20 bytes");
+  p = Create<Packet> (100);
+  p->AddHeader (ack);
+  TcpHeader ackCopy;
+  p->RemoveHeader (ackCopy);
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 100, "the options were not all read");
+  NS_TEST_EXPECT_MSG_EQ (ackCopy.IsSackPermitted (), false, "unexpected SACK-permitted option");
+  TcpHeader::SackList copy = ackCopy.GetSackBlocks ();
+  NS_TEST_ASSERT_MSG_EQ (copy.size (), 2, "the SACK blocks were lost");
+  NS_TEST_EXPECT_MSG_EQ (copy.front ().first, SequenceNumber32 (3001), "wrong first block");
+  NS_TEST_EXPECT_MSG_EQ (copy.front ().second, SequenceNumber32 (4001), "wrong first block");
+  NS_TEST_EXPECT_MSG_EQ (copy.back ().first, SequenceNumber32 (1001), "wrong second block");
+  NS_TEST_EXPECT_MSG_EQ (copy.back ().second, SequenceNumber32 (2001), "wrong second block");
+
+  // MAX_SACK_BLOCKS blocks fit in the option space
+  for (uint32_t i = 2; i < TcpHeader::MAX_SACK_BLOCKS; i++)
+    {
+      blocks.push_back (TcpHeader::SackBlock (SequenceNumber32 (5001 + 1000 * i), SequenceNumber32 (5501 + 1000 * i)));
+    }
+  ack.SetSackBlocks (blocks);
+  NS_TEST_EXPECT_MSG_EQ (ack.GetSerializedSize (), 56, "four SACK blocks take 36 bytes");
+  p = Create<Packet> ();
+  p->AddHeader (ack);
+  p->RemoveHeader (ackCopy);
+  NS_TEST_EXPECT_MSG_EQ (ackCopy.GetSackBlocks ().size (), TcpHeader::MAX_SACK_BLOCKS, "the SACK blocks were lost");
+  ack.SetSackBlocks (TcpHeader::SackList ());
+  NS_TEST_EXPECT_MSG_EQ (ack.GetSerializedSize (), 20, "the SACK option was not removed");
+}
+
+class TcpScoreboardTestCase : public TestCase
+{
+public:
+  TcpScoreboardTestCase ();
+  virtual void DoRun (void);
+};
+
+TcpScoreboardTestCase::TcpScoreboardTestCase ()
+  : TestCase ("Check the SACK scoreboard of TcpTxBuffer")
+{
+}
+
+void
+TcpScoreboardTestCase::DoRun (void)
+{
+  TcpTxBuffer buffer (1);
+  buffer.SetMaxBufferSize (100000);
+  buffer.Add (Create<Packet> (10000));
+  uint32_t size;
+
+  NS_TEST_EXPECT_MSG_EQ (buffer.HighestSacked (), SequenceNumber32 (1), "nothing SACKed yet");
+  NS_TEST_EXPECT_MSG_EQ (buffer.Sack (SequenceNumber32 (1001), SequenceNumber32 (2001)), 1000, "1000 bytes SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer.Sack (SequenceNumber32 (3001), SequenceNumber32 (4001)), 1000, "1000 bytes SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer.Sack (SequenceNumber32 (1501), SequenceNumber32 (3001)), 1000, "the ranges overlap");
+  NS_TEST_EXPECT_MSG_EQ (buffer.SackedBytes (), 3000, "the ranges should be merged");
+  NS_TEST_EXPECT_MSG_EQ (buffer.HighestSacked (), SequenceNumber32 (4001), "wrong highest SACKed byte");
+  NS_TEST_EXPECT_MSG_EQ (buffer.IsSacked (SequenceNumber32 (1000)), false, "byte 1000 was not SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer.IsSacked (SequenceNumber32 (1001)), true, "byte 1001 was SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer.IsSacked (SequenceNumber32 (4001)), false, "byte 4001 was not SACKed");
+  NS_TEST_EXPECT_MSG_EQ (buffer.Sack (SequenceNumber32 (20001), SequenceNumber32 (21001)), 0, "beyond the tail");
+
+  NS_TEST_EXPECT_MSG_EQ (buffer.NextUnsacked (SequenceNumber32 (1), size), SequenceNumber32 (1), "the head is a hole");
+  NS_TEST_EXPECT_MSG_EQ (size, 1000, "the hole ends at the first range");
+  NS_TEST_EXPECT_MSG_EQ (buffer.NextUnsacked (SequenceNumber32 (1501), size), SequenceNumber32 (4001), "skip the range");
+  NS_TEST_EXPECT_MSG_EQ (size, 6000, "no range above");
+
+  // the head is lost: more than (3 - 1) * 1000 bytes were SACKed above it
+  NS_TEST_EXPECT_MSG_EQ (buffer.LostBoundary (3, 1000), SequenceNumber32 (1001), "the first hole is lost");
+  NS_TEST_EXPECT_MSG_EQ (buffer.LostBoundary (3, 1500), SequenceNumber32 (1), "nothing is lost");
+  buffer.Sack (SequenceNumber32 (6001), SequenceNumber32 (6101));
+  buffer.Sack (SequenceNumber32 (8001), SequenceNumber32 (8101));
+  NS_TEST_EXPECT_MSG_EQ (buffer.LostBoundary (3, 1500), SequenceNumber32 (1001), "three ranges above the head");
+  NS_TEST_EXPECT_MSG_EQ (buffer.SackedBytesFrom (SequenceNumber32 (2001)), 2200, "wrong SACKed bytes above 2001");
+
+  buffer.DiscardUpTo (SequenceNumber32 (2501));
+  NS_TEST_EXPECT_MSG_EQ (buffer.SackedBytes (), 1700, "the range below the head should be trimmed");
+  NS_TEST_EXPECT_MSG_EQ (buffer.NextUnsacked (SequenceNumber32 (1), size), SequenceNumber32 (4001), "the head was SACKed");
+  buffer.DiscardUpTo (SequenceNumber32 (7001));
+  NS_TEST_EXPECT_MSG_EQ (buffer.SackedBytes (), 100, "the ranges below the head should be dropped");
+  buffer.ResetScoreboard ();
+  NS_TEST_EXPECT_MSG_EQ (buffer.SackedBytes (), 0, "the scoreboard should be empty");
+  NS_TEST_EXPECT_MSG_EQ (buffer.HighestSacked (), SequenceNumber32 (7001), "the scoreboard should be empty");
+}
+
+class TcpRxSackBlocksTestCase : public TestCase
+{
+public:
+  TcpRxSackBlocksTestCase ();
+  virtual void DoRun (void);
+private:
+  void Add (TcpRxBuffer &buffer, uint32_t seq, uint32_t size);
+};
+
+TcpRxSackBlocksTestCase::TcpRxSackBlocksTestCase ()
+  : TestCase ("Check the SACK blocks reported by TcpRxBuffer")
+{
+}
+
+void
+TcpRxSackBlocksTestCase::Add (TcpRxBuffer &buffer, uint32_t seq, uint32_t size)
+{
+  TcpHeader header;
+  header.SetSequenceNumber (SequenceNumber32 (seq));
+  buffer.Add (Create<Packet> (size), header);
+}
+
+void
+TcpRxSackBlocksTestCase::DoRun (void)
+{
+  TcpRxBuffer buffer;
+  buffer.SetNextRxSequence (SequenceNumber32 (1));
+  Add (buffer, 1, 100);
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetSackBlocks (4).size (), 0, "no out-of-order data");
+
+  Add (buffer, 601, 100);
+  Add (buffer, 301, 100);
+  Add (buffer, 401, 100);
+  TcpHeader::SackList blocks = buffer.GetSackBlocks (4);
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 2, "two blocks of out-of-order data");
+  NS_TEST_EXPECT_MSG_EQ (blocks.front ().first, SequenceNumber32 (301), "the last data received comes first");
+  NS_TEST_EXPECT_MSG_EQ (blocks.front ().second, SequenceNumber32 (501), "the contiguous data should be merged");
+  NS_TEST_EXPECT_MSG_EQ (blocks.back ().first, SequenceNumber32 (601), "wrong second block");
+  NS_TEST_EXPECT_MSG_EQ (blocks.back ().second, SequenceNumber32 (701), "wrong second block");
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetSackBlocks (1).size (), 1, "at most one block requested");
+
+  Add (buffer, 101, 200);
+  blocks = buffer.GetSackBlocks (4);
+  NS_TEST_EXPECT_MSG_EQ (buffer.NextRxSequence (), SequenceNumber32 (501), "the hole was filled");
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 1, "one block of out-of-order data is left");
+  NS_TEST_EXPECT_MSG_EQ (blocks.front ().first, SequenceNumber32 (601), "wrong block");
+
+  Simulator::Destroy ();
+}
+
+class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ();
+};
+
+TcpSackTestSuite::TcpSackTestSuite ()
+  : TestSuite ("tcp-sack", UNIT)
+{
+  AddTestCase (new TcpSackHeaderTestCase);
+  AddTestCase (new TcpScoreboardTestCase);
+  AddTestCase (new TcpRxSackBlocksTestCase);
+}
+
+static TcpSackTestSuite g_tcpSackTestSuite;
@@ -27,15 +27,258 @@
 #include <ns3/string.h>
 #include <ns3/double.h>
 #include "ns3/uinteger.h"
+#include "ns3/abort.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/core-config.h"
 #include <fstream>
+#include <sstream>
 #include <ns3/simulator.h>
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 NS_LOG_COMPONENT_DEFINE ("TraceFadingLossModel");
 
 namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (TraceFadingLossModel);
-  
+
+namespace {
+
+/**
+ * Header of the binary fading traces, all in host byte order. The header
+ * is followed by rbNum * samplesNum 32-bit floats, RB by RB.
+ */
+struct BinaryTraceHeader
+{
+  uint32_t magic;          //!< always BINARY_TRACE_MAGIC
+  uint32_t version;        //!< always BINARY_TRACE_VERSION
+  uint32_t headerSize;     //!< offset of the samples from the start of the file
+  uint32_t rbNum;          //!< number of RBs
+  uint32_t samplesNum;     //!< number of samples of each RB
+  uint32_t samplePeriodUs; //!< time between two samples in microseconds
+  uint32_t windowSizeUs;   //!< size of the fading window in microseconds
+  uint32_t reserved;       //!< zero
+};
+
+const uint32_t BINARY_TRACE_MAGIC = 0x4e534654;
+const uint32_t BINARY_TRACE_MAGIC_SWAPPED = 0x5446534e;
+const uint32_t BINARY_TRACE_VERSION = 1;
+
+} // anonymous namespace
+
+/**
+ * A fading trace loaded once and shared read-only by all the
+ * TraceFadingLossModel instances which use it. The samples of a binary
+ * trace are mapped in memory if possible; the samples of a text trace are
+ * stored as read.
+ */
+class TraceFadingLossModel::SharedTrace : public SimpleRefCount<TraceFadingLossModel::SharedTrace>
+{
+public:
+  /**
+   * \param fileName the name of the trace
+   * \param rbNum the number of RBs of a text trace
+   * \param samplesNum the number of samples of each RB of a text trace
+   * \return the trace, loaded by this call if no other model uses it
+   */
+  static Ptr<const SharedTrace> Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+
+  ~SharedTrace ();
+
+  /**
+   * \param rb the RB of the sample
+   * \param sample the index of the sample of the RB
+   * \return the fading of the RB in dB
+   */
+  double GetValue (uint32_t rb, uint32_t sample) const
+  {
+    uint32_t i = rb * m_samplesNum + sample;
+    return m_binarySamples != 0 ? m_binarySamples[i] : m_textSamples[i];
+  }
+
+  bool IsBinary (void) const
+  {
+    return m_binarySamples != 0;
+  }
+  uint32_t GetRbNum (void) const
+  {
+    return m_rbNum;
+  }
+  uint32_t GetSamplesNum (void) const
+  {
+    return m_samplesNum;
+  }
+  Time GetSamplePeriod (void) const
+  {
+    return MicroSeconds (m_samplePeriodUs);
+  }
+  Time GetWindowSize (void) const
+  {
+    return MicroSeconds (m_windowSizeUs);
+  }
+
+private:
+  SharedTrace (std::string key);
+  void LoadText (std::string fileName, uint32_t rbNum, uint32_t samplesNum);
+  void LoadBinary (std::string fileName);
+  static std::map<std::string, SharedTrace *> *GetTraces (void);
+
+  std::string m_key;
+  uint32_t m_rbNum;
+  uint32_t m_samplesNum;
+  uint32_t m_samplePeriodUs;
+  uint32_t m_windowSizeUs;
+  std::vector<double> m_textSamples;
+  std::vector<float> m_binaryCopy;
+  const float *m_binarySamples;
+  void *m_map;
+  size_t m_mapLength;
+};
+
+std::map<std::string, TraceFadingLossModel::SharedTrace *> *
+TraceFadingLossModel::SharedTrace::GetTraces (void)
+{
+  // never deleted, so that a trace can outlive the static objects
+  static std::map<std::string, SharedTrace *> *traces = new std::map<std::string, SharedTrace *> ();
+  return traces;
+}
+
+Ptr<const TraceFadingLossModel::SharedTrace>
+TraceFadingLossModel::SharedTrace::Get (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  // a binary trace is known by its name; a text trace is read according
+  // to the attributes of the model, so the same file read with other
+  // attributes is another trace
+  std::ostringstream textKey;
+  textKey << fileName << ":" << rbNum << "x" << samplesNum;
+  std::map<std::string, SharedTrace *> *traces = GetTraces ();
+  std::map<std::string, SharedTrace *>::iterator it = traces->find (fileName);
+  if (it == traces->end ())
+    {
+      it = traces->find (textKey.str ());
+    }
+  if (it != traces->end ())
+    {
+      return Ptr<const SharedTrace> (it->second);
+    }
+
+  std::ifstream ifTraceFile (fileName.c_str (), std::ifstream::in | std::ifstream::binary);
+  if (!ifTraceFile.good ())
+    {
+      NS_FATAL_ERROR ("Fading trace file " << fileName << " not found");
+    }
+  uint32_t magic = 0;
+  ifTraceFile.read (reinterpret_cast<char *> (&magic), sizeof (magic));
+  ifTraceFile.close ();
+  NS_ABORT_MSG_IF (magic == BINARY_TRACE_MAGIC_SWAPPED,
+                   "Fading trace " << fileName << " was written on a host of the other byte order");
+
+  Ptr<SharedTrace> trace;
+  if (magic == BINARY_TRACE_MAGIC)
+    {
+      trace = Ptr<SharedTrace> (new SharedTrace (fileName), false);
+      trace->LoadBinary (fileName);
+    }
+  else
+    {
+      trace = Ptr<SharedTrace> (new SharedTrace (textKey.str ()), false);
+      trace->LoadText (fileName, rbNum, samplesNum);
+    }
+  traces->insert (std::make_pair (trace->m_key, PeekPointer (trace)));
+  return trace;
+}
+
+TraceFadingLossModel::SharedTrace::SharedTrace (std::string key)
+  : m_key (key),
+    m_rbNum (0),
+    m_samplesNum (0),
+    m_samplePeriodUs (0),
+    m_windowSizeUs (0),
+    m_binarySamples (0),
+    m_map (0),
+    m_mapLength (0)
+{
+}
+
+TraceFadingLossModel::SharedTrace::~SharedTrace ()
+{
+  GetTraces ()->erase (m_key);
+#ifdef HAVE_SYS_MMAN_H
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapLength);
+    }
+#endif
+}
+
+void
+TraceFadingLossModel::SharedTrace::LoadText (std::string fileName, uint32_t rbNum, uint32_t samplesNum)
+{
+  NS_LOG_FUNCTION (this << fileName << rbNum << samplesNum);
+  std::ifstream ifTraceFile;
+  ifTraceFile.open (fileName.c_str (), std::ifstream::in);
+  m_rbNum = rbNum;
+  m_samplesNum = samplesNum;
+  m_textSamples.reserve (rbNum * samplesNum);
+  for (uint32_t i = 0; i < rbNum * samplesNum; i++)
+    {
+      double sample;
+      ifTraceFile >> sample;
+      m_textSamples.push_back (sample);
+    }
+}
+
+void
+TraceFadingLossModel::SharedTrace::LoadBinary (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  BinaryTraceHeader header;
+  std::ifstream ifTraceFile (fileName.c_str (), std::ifstream::in | std::ifstream::binary);
+  ifTraceFile.read (reinterpret_cast<char *> (&header), sizeof (header));
+  NS_ABORT_MSG_UNLESS (ifTraceFile.good (), "Truncated header in fading trace " << fileName);
+  NS_ABORT_MSG_UNLESS (header.version == BINARY_TRACE_VERSION && header.headerSize >= sizeof (header)
+                       && header.headerSize % sizeof (float) == 0,
+                       "Unsupported header in fading trace " << fileName);
+  NS_ABORT_MSG_IF (header.rbNum == 0 || header.samplesNum == 0 || header.samplePeriodUs == 0,
+                   "Empty fading trace " << fileName);
+  m_rbNum = header.rbNum;
+  m_samplesNum = header.samplesNum;
+  m_samplePeriodUs = header.samplePeriodUs;
+  m_windowSizeUs = header.windowSizeUs;
+  uint64_t samplesSize = static_cast<uint64_t> (m_rbNum) * m_samplesNum * sizeof (float);
+
+#ifdef HAVE_SYS_MMAN_H
+  ifTraceFile.close ();
+  int fd = open (fileName.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd == -1, "Cannot open fading trace " << fileName);
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) == -1, "Cannot stat fading trace " << fileName);
+  NS_ABORT_MSG_IF (static_cast<uint64_t> (st.st_size) < header.headerSize + samplesSize,
+                   "Truncated samples in fading trace " << fileName);
+  m_mapLength = header.headerSize + samplesSize;
+  m_map = mmap (0, m_mapLength, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (m_map != MAP_FAILED)
+    {
+      m_binarySamples = reinterpret_cast<const float *> (static_cast<const char *> (m_map) + header.headerSize);
+      return;
+    }
+  NS_LOG_WARN ("Cannot map fading trace " << fileName << " in memory, reading it");
+  m_map = 0;
+  ifTraceFile.open (fileName.c_str (), std::ifstream::in | std::ifstream::binary);
+#endif
+  m_binaryCopy.resize (m_rbNum * m_samplesNum);
+  ifTraceFile.seekg (header.headerSize);
+  ifTraceFile.read (reinterpret_cast<char *> (&m_binaryCopy[0]), samplesSize);
+  NS_ABORT_MSG_UNLESS (ifTraceFile.good (), "Truncated samples in fading trace " << fileName);
+  m_binarySamples = &m_binaryCopy[0];
+}
+
 
 
 TraceFadingLossModel::TraceFadingLossModel ()
@@ -47,7 +290,7 @@ TraceFadingLossModel::TraceFadingLossModel ()
 
 TraceFadingLossModel::~TraceFadingLossModel ()
 {
-  m_fadingTrace.clear ();
+  m_fadingTrace = 0;
   m_windowOffsetsMap.clear ();
   m_startVariableMap.clear ();
 }
@@ -60,7 +303,9 @@ TraceFadingLossModel::GetTypeId (void)
     .SetParent<SpectrumPropagationLossModel> ()
     .AddConstructor<TraceFadingLossModel> ()
     .AddAttribute ("TraceFilename",
-                   "Name of file to load a trace from.",
+                   "Name of file to load a trace from, either in the text format "
+                   "or in the binary format. The header of a binary trace "
+                   "overrides TraceLength, SamplesNum, WindowSize and RbNum.",
                    StringValue (""),
                    MakeStringAccessor (&TraceFadingLossModel::SetTraceFileName),
                    MakeStringChecker ())
@@ -113,28 +358,17 @@ void
 TraceFadingLossModel::LoadTrace ()
 {
   NS_LOG_FUNCTION (this << "Loading Fading Trace " << m_traceFile);
-  std::ifstream ifTraceFile;
-  ifTraceFile.open (m_traceFile.c_str (), std::ifstream::in);
-  m_fadingTrace.clear ();
-  if (!ifTraceFile.good ())
-    {
-      NS_LOG_INFO (this << " File: " << m_traceFile);
-      NS_ASSERT_MSG(ifTraceFile.good (), " Fading trace file not found");
-    }
-
-//   NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds ());
-//   NS_LOG_INFO (this << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
-  for (uint32_t i = 0; i < m_rbNum; i++)
+  m_fadingTrace = SharedTrace::Get (m_traceFile, m_rbNum, m_samplesNum);
+  if (m_fadingTrace->IsBinary ())
     {
-      FadingTraceSample rbTimeFadingTrace;
-      for (uint32_t j = 0; j < m_samplesNum; j++)
-        {
-          double sample;
-          ifTraceFile >> sample;
-          rbTimeFadingTrace.push_back (sample);
-        }
-      m_fadingTrace.push_back (rbTimeFadingTrace);
+      NS_ABORT_MSG_IF (m_fadingTrace->GetRbNum () > 255,
+                       "Too many RBs in fading trace " << m_traceFile);
+      m_rbNum = m_fadingTrace->GetRbNum ();
+      m_samplesNum = m_fadingTrace->GetSamplesNum ();
+      m_traceLength = MicroSeconds (m_fadingTrace->GetSamplePeriod ().GetMicroSeconds () * m_samplesNum);
+      m_windowSize = m_fadingTrace->GetWindowSize ();
     }
+  NS_LOG_INFO (this << " length " << m_traceLength.GetSeconds () << " RB " << (uint32_t)m_rbNum << " samples " << m_samplesNum);
   m_timeGranularity = m_traceLength.GetMilliSeconds () / m_samplesNum;
   m_lastWindowUpdate = Simulator::Now ();
 }
@@ -188,7 +422,7 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
   //double speed = std::sqrt (std::pow (aSpeedVector.x-bSpeedVector.x,2) + std::pow (aSpeedVector.y-bSpeedVector.y,2));
 
   NS_LOG_LOGIC (this << *rxPsd);
-  NS_ASSERT (!m_fadingTrace.empty ());
+  NS_ASSERT (m_fadingTrace != 0);
   int now_ms = static_cast<int> (Simulator::Now ().GetMilliSeconds () * m_timeGranularity);
   int lastUpdate_ms = static_cast<int> (m_lastWindowUpdate.GetMilliSeconds () * m_timeGranularity);
   int index = ((*itOff).second + now_ms - lastUpdate_ms) % m_samplesNum;
@@ -198,7 +432,8 @@ TraceFadingLossModel::DoCalcRxPowerSpectralDensity (
       NS_ASSERT (subChannel < 100);
       if (*vit != 0.)
         {
-          double fading = m_fadingTrace.at (subChannel).at (index);
+          NS_ABORT_MSG_IF (subChannel >= m_rbNum, "Fading trace " << m_traceFile << " has only " << (uint32_t)m_rbNum << " RBs");
+          double fading = m_fadingTrace->GetValue (subChannel, index);
           NS_LOG_INFO (this << " FADING now " << now_ms << " offset " << (*itOff).second << " id " << index << " fading " << fading);
           double power = *vit; // in Watt/Hz
           power = 10 * std::log10 (180000 * power); // in dB
@@ -235,6 +470,44 @@ TraceFadingLossModel::AssignStreams (int64_t stream)
   return (currentStream - stream);
 }
 
+void
+TraceFadingLossModel::ConvertTrace (std::string textFileName, std::string binaryFileName,
+                                    uint32_t rbNum, uint32_t samplesNum,
+                                    Time traceLength, Time windowSize)
+{
+  NS_LOG_FUNCTION (textFileName << binaryFileName << rbNum << samplesNum << traceLength << windowSize);
+  NS_ABORT_MSG_IF (rbNum == 0 || samplesNum == 0, "Empty fading trace");
+  NS_ABORT_MSG_IF (traceLength.GetMicroSeconds () % samplesNum != 0,
+                   "The trace length is not a multiple of the number of samples in microseconds");
+
+  std::ifstream ifTraceFile (textFileName.c_str (), std::ifstream::in);
+  NS_ABORT_MSG_UNLESS (ifTraceFile.good (), "Fading trace file " << textFileName << " not found");
+  std::vector<float> samples (rbNum * samplesNum);
+  for (uint32_t i = 0; i < rbNum * samplesNum; i++)
+    {
+      double sample;
+      ifTraceFile >> sample;
+      NS_ABORT_MSG_IF (ifTraceFile.fail (), "Fading trace " << textFileName << " has fewer than "
+                       << rbNum << " x " << samplesNum << " samples");
+      samples[i] = static_cast<float> (sample);
+    }
+
+  BinaryTraceHeader header;
+  header.magic = BINARY_TRACE_MAGIC;
+  header.version = BINARY_TRACE_VERSION;
+  header.headerSize = sizeof (header);
+  header.rbNum = rbNum;
+  header.samplesNum = samplesNum;
+  header.samplePeriodUs = traceLength.GetMicroSeconds () / samplesNum;
+  header.windowSizeUs = windowSize.GetMicroSeconds ();
+  header.reserved = 0;
+  std::ofstream ofTraceFile (binaryFileName.c_str (), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+  ofTraceFile.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  ofTraceFile.write (reinterpret_cast<const char *> (&samples[0]), samples.size () * sizeof (float));
+  ofTraceFile.close ();
+  NS_ABORT_MSG_IF (ofTraceFile.fail (), "Cannot write fading trace " << binaryFileName);
+}
+
 
 
 } // namespace ns3
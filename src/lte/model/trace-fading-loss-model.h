@@ -27,6 +27,7 @@
 #include <ns3/object.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <map>
+#include <string>
 #include "ns3/random-variable-stream.h"
 #include <ns3/nstime.h>
 
@@ -40,6 +41,17 @@ class MobilityModel;
  * \ingroup lte
  *
  * \brief fading loss model based on precalculated fading traces
+ *
+ * The trace is read either from the text format written by
+ * fading_trace_generator.m, or from a binary format made of a header,
+ * which gives the number of RBs, the number of samples, the sampling
+ * period and the window size of the trace, followed by the samples as
+ * 32-bit floats in host byte order, RB by RB. A binary trace is mapped in
+ * memory rather than read; ConvertTrace writes the binary version of a
+ * text trace.
+ *
+ * The instances of this model which load the same trace share a single
+ * read-only copy of it.
  */
 class TraceFadingLossModel : public SpectrumPropagationLossModel
 {
@@ -66,8 +78,24 @@ public:
   */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \brief Write the binary version of a fading trace in the text format
+   *
+   * \param textFileName the name of the trace in the text format
+   * \param binaryFileName the name of the trace to write in the binary format
+   * \param rbNum the number of RBs of the trace
+   * \param samplesNum the number of samples of each RB
+   * \param traceLength the duration of the trace
+   * \param windowSize the size of the window for the fading trace
+   */
+  static void ConvertTrace (std::string textFileName, std::string binaryFileName,
+                            uint32_t rbNum, uint32_t samplesNum,
+                            Time traceLength, Time windowSize);
+
   
 private:
+  class SharedTrace;
+
   /**
    * @param txPower set of values vs frequency representing the
    * transmission power. See SpectrumChannel for details.
@@ -101,20 +129,13 @@ private:
   
   mutable std::map <ChannelRealizationId_t, Ptr<UniformRandomVariable> > m_startVariableMap;
   
-  /**
-   * Vector with fading samples in time domain (for a fixed RB)
-   */
-  typedef std::vector<double> FadingTraceSample;
-  /**
-   * Vector collecting the time fading traces in the frequency domain (per RB)
-   */
-  typedef std::vector<FadingTraceSample> FadingTrace;
-
-
-  
   std::string m_traceFile;
   
-  FadingTrace m_fadingTrace;
+  /**
+   * The fading samples, per RB in the frequency domain and in the time
+   * domain for each RB
+   */
+  Ptr<const SharedTrace> m_fadingTrace;
 
   
   Time m_traceLength;
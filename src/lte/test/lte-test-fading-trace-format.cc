@@ -0,0 +1,172 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/trace-fading-loss-model.h"
+#include <fstream>
+#include <cmath>
+#include <cstdio>
+
+NS_LOG_COMPONENT_DEFINE ("LteTestFadingTraceFormat");
+
+namespace ns3 {
+
+static const uint32_t RB_NUM = 6;
+static const uint32_t SAMPLES_NUM = 1000;
+
+/**
+ * Check that a fading trace gives the same fading whether it is read in
+ * the text format or in the binary format written by
+ * TraceFadingLossModel::ConvertTrace, and that the models which use the
+ * same binary trace share it.
+ */
+class LteFadingTraceFormatTestCase : public TestCase
+{
+public:
+  LteFadingTraceFormatTestCase ();
+  virtual ~LteFadingTraceFormatTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \return the fading in dB of the sample of the RB of the test trace
+   */
+  static double GetFading (uint32_t rb, uint32_t sample);
+  /**
+   * Check the fading of every RB against the test trace
+   */
+  void CheckModel (Ptr<TraceFadingLossModel> model, double tolerance);
+};
+
+LteFadingTraceFormatTestCase::LteFadingTraceFormatTestCase ()
+  : TestCase ("Fading trace in the text and in the binary format")
+{
+}
+
+LteFadingTraceFormatTestCase::~LteFadingTraceFormatTestCase ()
+{
+}
+
+double
+LteFadingTraceFormatTestCase::GetFading (uint32_t rb, uint32_t sample)
+{
+  // unique in each RB, so that the fading of RB 0 gives the sample
+  return -20.0 + 0.01 * sample + 0.5 * rb;
+}
+
+void
+LteFadingTraceFormatTestCase::CheckModel (Ptr<TraceFadingLossModel> model, double tolerance)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < RB_NUM; i++)
+    {
+      freqs.push_back (2.0e9 + i * 180.0e3);
+    }
+  Ptr<SpectrumModel> sm = Create<SpectrumModel> (freqs);
+  Ptr<SpectrumValue> txPsd = Create<SpectrumValue> (sm);
+  (*txPsd) = 1.0e-12;
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+
+  Ptr<SpectrumValue> rxPsd = model->CalcRxPowerSpectralDensity (txPsd, a, b);
+  double fading0 = 10 * std::log10 ((*rxPsd)[0] / (*txPsd)[0]);
+  double sample = (fading0 - GetFading (0, 0)) / 0.01;
+  uint32_t index = static_cast<uint32_t> (sample + 0.5);
+  NS_TEST_ASSERT_MSG_LT (index, SAMPLES_NUM, "fading out of the trace");
+  for (uint32_t rb = 0; rb < RB_NUM; rb++)
+    {
+      double fading = 10 * std::log10 ((*rxPsd)[rb] / (*txPsd)[rb]);
+      NS_TEST_ASSERT_MSG_EQ_TOL (fading, GetFading (rb, index), tolerance, "wrong fading in RB " << rb);
+    }
+}
+
+void
+LteFadingTraceFormatTestCase::DoRun (void)
+{
+  std::string textFileName = CreateTempDirFilename ("fading-trace.fad");
+  std::string binaryFileName = CreateTempDirFilename ("fading-trace.bin");
+  std::ofstream textFile (textFileName.c_str ());
+  for (uint32_t rb = 0; rb < RB_NUM; rb++)
+    {
+      for (uint32_t j = 0; j < SAMPLES_NUM; j++)
+        {
+          textFile << GetFading (rb, j) << " ";
+        }
+      textFile << std::endl;
+    }
+  textFile.close ();
+  TraceFadingLossModel::ConvertTrace (textFileName, binaryFileName, RB_NUM, SAMPLES_NUM,
+                                      Seconds (1.0), Seconds (0.5));
+
+  Ptr<TraceFadingLossModel> textModel = CreateObject<TraceFadingLossModel> ();
+  textModel->SetAttribute ("TraceFilename", StringValue (textFileName));
+  textModel->SetAttribute ("TraceLength", TimeValue (Seconds (1.0)));
+  textModel->SetAttribute ("SamplesNum", UintegerValue (SAMPLES_NUM));
+  textModel->SetAttribute ("WindowSize", TimeValue (Seconds (0.5)));
+  textModel->SetAttribute ("RbNum", UintegerValue (RB_NUM));
+  textModel->Start ();
+  CheckModel (textModel, 1e-9);
+
+  // the header of the binary trace overrides the default attributes
+  Ptr<TraceFadingLossModel> binaryModel = CreateObject<TraceFadingLossModel> ();
+  binaryModel->SetAttribute ("TraceFilename", StringValue (binaryFileName));
+  binaryModel->Start ();
+  UintegerValue samplesNum;
+  binaryModel->GetAttribute ("SamplesNum", samplesNum);
+  NS_TEST_ASSERT_MSG_EQ (samplesNum.Get (), SAMPLES_NUM, "SamplesNum not read from the trace");
+  UintegerValue rbNum;
+  binaryModel->GetAttribute ("RbNum", rbNum);
+  NS_TEST_ASSERT_MSG_EQ (rbNum.Get (), RB_NUM, "RbNum not read from the trace");
+  TimeValue windowSize;
+  binaryModel->GetAttribute ("WindowSize", windowSize);
+  NS_TEST_ASSERT_MSG_EQ (windowSize.Get (), Seconds (0.5), "WindowSize not read from the trace");
+  CheckModel (binaryModel, 1e-4);
+
+  // a model which uses a trace already loaded does not read the file
+  std::remove (binaryFileName.c_str ());
+  Ptr<TraceFadingLossModel> sharingModel = CreateObject<TraceFadingLossModel> ();
+  sharingModel->SetAttribute ("TraceFilename", StringValue (binaryFileName));
+  sharingModel->Start ();
+  CheckModel (sharingModel, 1e-4);
+
+  std::remove (textFileName.c_str ());
+  Simulator::Destroy ();
+}
+
+
+class LteFadingTraceFormatTestSuite : public TestSuite
+{
+public:
+  LteFadingTraceFormatTestSuite ();
+};
+
+LteFadingTraceFormatTestSuite::LteFadingTraceFormatTestSuite ()
+  : TestSuite ("lte-fading-trace-format", UNIT)
+{
+  AddTestCase (new LteFadingTraceFormatTestCase);
+}
+
+static LteFadingTraceFormatTestSuite lteFadingTraceFormatTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "mobility-grid-index.h"
+
+NS_LOG_COMPONENT_DEFINE ("MobilityGridIndex");
+
+namespace ns3 {
+
+MobilityGridIndex::MobilityGridIndex ()
+  : m_cellSize (100.0),
+    m_maxSpeed (0.0),
+    m_lastMovingRefresh (Seconds (0.0))
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityGridIndex::~MobilityGridIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+MobilityGridIndex::SetCellSize (double cellSize)
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT (cellSize > 0.0);
+  m_cellSize = cellSize;
+  m_cells.clear ();
+  m_moving.clear ();
+  m_maxSpeed = 0.0;
+  m_lastMovingRefresh = Simulator::Now ();
+  m_dirty.clear ();
+  for (uint32_t i = 0; i < m_items.size (); ++i)
+    {
+      m_items[i].speed = 0.0;
+      m_items[i].dirty = true;
+      m_items[i].bucketed = false;
+      m_dirty.push_back (i);
+    }
+}
+
+double
+MobilityGridIndex::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint32_t
+MobilityGridIndex::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  NS_ASSERT (mobility != 0);
+  uint32_t id = m_items.size ();
+  Item item;
+  item.mobility = mobility;
+  item.speed = 0.0;
+  item.dirty = true;
+  item.bucketed = false;
+  m_items.push_back (item);
+  m_dirty.push_back (id);
+
+  std::vector<uint32_t> &ids = m_mobilityItems[PeekPointer (mobility)];
+  if (ids.empty ())
+    {
+      mobility->TraceConnectWithoutContext ("CourseChange",
+                                            MakeCallback (&MobilityGridIndex::NotifyCourseChange, this));
+    }
+  ids.push_back (id);
+  return id;
+}
+
+uint32_t
+MobilityGridIndex::GetN (void) const
+{
+  return m_items.size ();
+}
+
+void
+MobilityGridIndex::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_mobilityItems.begin ();
+       i != m_mobilityItems.end (); ++i)
+    {
+      Ptr<MobilityModel> mobility = m_items[i->second.front ()].mobility;
+      mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                               MakeCallback (&MobilityGridIndex::NotifyCourseChange, this));
+    }
+  m_mobilityItems.clear ();
+  m_items.clear ();
+  m_cells.clear ();
+  m_dirty.clear ();
+  m_moving.clear ();
+  m_maxSpeed = 0.0;
+}
+
+void
+MobilityGridIndex::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_mobilityItems.find (PeekPointer (mobility));
+  NS_ASSERT (i != m_mobilityItems.end ());
+  for (std::vector<uint32_t>::const_iterator j = i->second.begin (); j != i->second.end (); ++j)
+    {
+      if (!m_items[*j].dirty)
+        {
+          m_items[*j].dirty = true;
+          m_dirty.push_back (*j);
+        }
+    }
+}
+
+int64_t
+MobilityGridIndex::GetCellCoordinate (double v) const
+{
+  return static_cast<int64_t> (std::floor (v / m_cellSize));
+}
+
+void
+MobilityGridIndex::Unbucket (uint32_t id)
+{
+  std::vector<uint32_t> &ids = m_cells[m_items[id].cell];
+  ids.erase (std::find (ids.begin (), ids.end (), id));
+  if (ids.empty ())
+    {
+      m_cells.erase (m_items[id].cell);
+    }
+}
+
+void
+MobilityGridIndex::Bucket (uint32_t id)
+{
+  Item &item = m_items[id];
+  Vector position = item.mobility->GetPosition ();
+  Vector velocity = item.mobility->GetVelocity ();
+  double speed = std::sqrt (velocity.x * velocity.x + velocity.y * velocity.y + velocity.z * velocity.z);
+  if (speed > 0.0 && item.speed == 0.0)
+    {
+      m_moving.push_back (id);
+    }
+  else if (speed == 0.0 && item.speed > 0.0)
+    {
+      m_moving.erase (std::find (m_moving.begin (), m_moving.end (), id));
+    }
+  item.speed = speed;
+  item.cell = Cell (GetCellCoordinate (position.x), GetCellCoordinate (position.y));
+  item.dirty = false;
+  item.bucketed = true;
+  m_cells[item.cell].push_back (id);
+  m_maxSpeed = std::max (m_maxSpeed, speed);
+}
+
+void
+MobilityGridIndex::Refresh (void)
+{
+  for (std::vector<uint32_t>::const_iterator i = m_dirty.begin (); i != m_dirty.end (); ++i)
+    {
+      if (m_items[*i].bucketed)
+        {
+          Unbucket (*i);
+        }
+      Bucket (*i);
+    }
+  m_dirty.clear ();
+
+  Time now = Simulator::Now ();
+  double slack = m_maxSpeed * (now - m_lastMovingRefresh).GetSeconds ();
+  if (slack > m_cellSize / 2)
+    {
+      NS_LOG_LOGIC ("re-bucket " << m_moving.size () << " moving items, slack=" << slack);
+      std::vector<uint32_t> moving = m_moving;
+      m_maxSpeed = 0.0;
+      for (std::vector<uint32_t>::const_iterator i = moving.begin (); i != moving.end (); ++i)
+        {
+          Unbucket (*i);
+          Bucket (*i);
+        }
+    }
+  if (m_moving.empty () || slack > m_cellSize / 2)
+    {
+      m_lastMovingRefresh = now;
+    }
+}
+
+void
+MobilityGridIndex::GetCandidates (const Vector &position, double range,
+                                  std::vector<uint32_t> &candidates)
+{
+  NS_LOG_FUNCTION (this << position << range);
+  Refresh ();
+  double r = range + m_maxSpeed * (Simulator::Now () - m_lastMovingRefresh).GetSeconds ();
+  int64_t minX = GetCellCoordinate (position.x - r);
+  int64_t maxX = GetCellCoordinate (position.x + r);
+  int64_t minY = GetCellCoordinate (position.y - r);
+  int64_t maxY = GetCellCoordinate (position.y + r);
+
+  candidates.clear ();
+  double nCells = static_cast<double> (maxX - minX + 1) * static_cast<double> (maxY - minY + 1);
+  if (nCells > m_cells.size ())
+    {
+      // the query covers more cells than are occupied: visit the
+      // occupied ones only.
+      for (Cells::const_iterator i = m_cells.begin (); i != m_cells.end (); ++i)
+        {
+          if (i->first.first >= minX && i->first.first <= maxX
+              && i->first.second >= minY && i->first.second <= maxY)
+            {
+              candidates.insert (candidates.end (), i->second.begin (), i->second.end ());
+            }
+        }
+    }
+  else
+    {
+      for (int64_t x = minX; x <= maxX; ++x)
+        {
+          Cells::const_iterator i = m_cells.lower_bound (Cell (x, minY));
+          for (; i != m_cells.end () && i->first.first == x && i->first.second <= maxY; ++i)
+            {
+              candidates.insert (candidates.end (), i->second.begin (), i->second.end ());
+            }
+        }
+    }
+  std::sort (candidates.begin (), candidates.end ());
+}
+
+} // namespace ns3
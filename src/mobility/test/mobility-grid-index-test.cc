@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <algorithm>
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/rectangle.h"
+#include "ns3/test.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/mobility-grid-index.h"
+
+namespace ns3 {
+
+class MobilityGridIndexTest : public TestCase
+{
+public:
+  MobilityGridIndexTest ()
+    : TestCase ("Check that the mobility grid index returns all the items within range") {}
+  virtual ~MobilityGridIndexTest () {}
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Check (uint32_t item, double range);
+
+  std::vector<Ptr<MobilityModel> > m_models;
+  MobilityGridIndex m_index;
+};
+
+void
+MobilityGridIndexTest::DoTeardown (void)
+{
+  m_index.Clear ();
+  m_models.clear ();
+}
+
+void
+MobilityGridIndexTest::Check (uint32_t item, double range)
+{
+  Vector position = m_models[item]->GetPosition ();
+  position.x += range * 0.9;
+  std::vector<uint32_t> candidates;
+  m_index.GetCandidates (position, range, candidates);
+  for (uint32_t i = 1; i < candidates.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_LT (candidates[i - 1], candidates[i], "candidates are not sorted");
+    }
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      if (CalculateDistance (m_models[i]->GetPosition (), position) <= range)
+        {
+          NS_TEST_EXPECT_MSG_EQ (std::binary_search (candidates.begin (), candidates.end (), i), true,
+                                 "item " << i << " within range is not a candidate");
+        }
+    }
+  NS_TEST_EXPECT_MSG_LT (candidates.size (), m_models.size (), "no item was culled");
+}
+
+void
+MobilityGridIndexTest::DoRun (void)
+{
+  SeedManager::SetSeed (123);
+  m_index.SetCellSize (20.0);
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<ConstantPositionMobilityModel> model = CreateObject<ConstantPositionMobilityModel> ();
+      model->SetPosition (Vector (10.0 * i, 0.0, 0.0));
+      m_models.push_back (model);
+    }
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> model = CreateObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector (0.0, 10.0 * i, 0.0));
+      model->SetVelocity (Vector (30.0, 0.0, 0.0));
+      m_models.push_back (model);
+    }
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<RandomWalk2dMobilityModel> model = CreateObject<RandomWalk2dMobilityModel> ();
+      model->SetAttribute ("Bounds", RectangleValue (Rectangle (0.0, 1000.0, 0.0, 1000.0)));
+      model->SetAttribute ("Speed", StringValue ("ns3::UniformRandomVariable[Min=1.0|Max=2.0]"));
+      model->SetPosition (Vector (10.0 * i + 5.0, 10.0 * i + 5.0, 0.0));
+      m_models.push_back (model);
+      Simulator::Schedule (Seconds (0.0), &Object::Start, model);
+    }
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_index.Add (m_models[i]), i, "unexpected item identifier");
+    }
+
+  // static items moved by hand.
+  Simulator::Schedule (Seconds (10.0), &MobilityModel::SetPosition, m_models[3], Vector (500.0, 500.0, 0.0));
+  for (uint32_t t = 0; t < 100; t++)
+    {
+      for (uint32_t k = 0; k < 10; k++)
+        {
+          uint32_t item = (t * 37 + k * 31) % m_models.size ();
+          Simulator::Schedule (Seconds (t + k / 10.0), &MobilityGridIndexTest::Check, this, item, 10.0);
+        }
+    }
+  Simulator::Stop (Seconds (100.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+struct MobilityGridIndexTestSuite : public TestSuite
+{
+  MobilityGridIndexTestSuite () : TestSuite ("mobility-grid-index", UNIT)
+  {
+    AddTestCase (new MobilityGridIndexTest);
+  }
+} g_mobilityGridIndexTestSuite;
+
+} // namespace ns3
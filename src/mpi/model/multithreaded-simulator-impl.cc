@@ -0,0 +1,1016 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#include "ns3/thread-local.h"
+
+#include <algorithm>
+#include <unistd.h>
+
+#if defined (HAVE_PTHREAD_H) && defined (HAVE_TLS) && defined (HAVE_SYNC_BUILTINS)
+#define NS3_MULTITHREADED_SIMULATOR 1
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/mpsc-ring.h"
+#include <sched.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+namespace ns3 {
+
+// number of slots of the ring used to send events to a partition.
+static const uint32_t REMOTE_EVENTS_RING_SIZE = 4096;
+static const uint32_t GLOBAL_PARTITION = 0xffffffff;
+static const uint64_t NO_TIMESTAMP = ~static_cast<uint64_t> (0);
+
+/**
+ * The events and the clock of a group of nodes simulated by one thread.
+ */
+struct SimulatorPartition
+{
+  /**
+   * An event sent by another partition, which is inserted in the
+   * scheduler of this partition at the end of the window.
+   */
+  struct RemoteEvent
+  {
+    uint64_t ts;
+    uint64_t sequence;
+    uint32_t context;
+    uint32_t source;
+    EventImpl *impl;
+  };
+
+  SimulatorPartition (MultithreadedSimulatorImpl *simulator, uint32_t index);
+  /**
+   * The body of the thread of the partition.
+   */
+  void Run (void);
+
+  MultithreadedSimulatorImpl *simulator;
+  uint32_t index;
+  Ptr<Scheduler> events;
+  uint32_t uid;
+  uint32_t currentUid;
+  uint64_t currentTs;
+  uint32_t currentContext;
+  // end (excluded) of the window of events this partition is processing.
+  uint64_t windowEnd;
+  // timestamp of the next event, published to the other partitions.
+  uint64_t nextTs;
+  // number of events sent to other partitions.
+  uint64_t sent;
+  // the lower 32 bits of the uid of the next packet created by this
+  // partition, see Packet::SetUidStream.
+  uint32_t packetUid;
+  // set by Simulator::Stop from an event of this partition, and read by
+  // the other partitions only between the two barriers of a window.
+  bool stop;
+  uint32_t barrierSense;
+  std::vector<RemoteEvent> received;
+#ifdef NS3_MULTITHREADED_SIMULATOR
+  MpscRing<RemoteEvent> inbox;
+  // events which did not fit in the inbox.
+  std::vector<RemoteEvent> overflow;
+  SystemMutex overflowMutex;
+#endif
+};
+
+SimulatorPartition::SimulatorPartition (MultithreadedSimulatorImpl *simulator_, uint32_t index_)
+  : simulator (simulator_),
+    index (index_),
+    events (0),
+    // uids are allocated from 4.
+    // uid 0 is "invalid" events
+    // uid 1 is "now" events
+    // uid 2 is "destroy" events
+    uid (4),
+    currentUid (0),
+    currentTs (0),
+    currentContext (0xffffffff),
+    windowEnd (0),
+    nextTs (NO_TIMESTAMP),
+    sent (0),
+    packetUid (0),
+    stop (false),
+    barrierSense (0)
+#ifdef NS3_MULTITHREADED_SIMULATOR
+    , inbox (REMOTE_EVENTS_RING_SIZE)
+#endif
+{
+}
+
+void
+SimulatorPartition::Run (void)
+{
+  simulator->RunPartition (this);
+}
+
+static bool
+RemoteEventLess (const SimulatorPartition::RemoteEvent &a, const SimulatorPartition::RemoteEvent &b)
+{
+  if (a.ts != b.ts)
+    {
+      return a.ts < b.ts;
+    }
+  if (a.source != b.source)
+    {
+      return a.source < b.source;
+    }
+  return a.sequence < b.sequence;
+}
+
+/**
+ * A point-to-point channel which may connect nodes of different partitions.
+ */
+struct PartitionLink
+{
+  uint32_t a;
+  uint32_t b;
+  uint64_t delay;
+};
+
+// the partition whose events the calling thread is running, if any.
+static NS_THREAD_LOCAL SimulatorPartition *g_currentPartition = 0;
+// the simulator which is running, if any.
+static MultithreadedSimulatorImpl *g_runningSimulator = 0;
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("MaxThreads",
+                   "The maximum number of partitions created when the nodes "
+                   "are partitioned automatically, or zero to use the number "
+                   "of processors.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_maxThreads),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+#ifndef NS3_MULTITHREADED_SIMULATOR
+  NS_FATAL_ERROR ("Can't use the multithreaded simulator without threads, "
+                  "thread-local storage and atomic builtins");
+#endif
+  m_stop = false;
+  m_running = false;
+  m_global = new SimulatorPartition (this, GLOBAL_PARTITION);
+  m_lookAhead = NO_TIMESTAMP;
+  m_maxThreads = 0;
+  m_windows = 0;
+  m_barrierCount = 0;
+  m_barrierSense = 0;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      delete m_partitions[i];
+    }
+  m_partitions.clear ();
+  delete m_global;
+  m_global = 0;
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<SimulatorPartition *> partitions = m_partitions;
+  partitions.push_back (m_global);
+  for (uint32_t i = 0; i < partitions.size (); i++)
+    {
+      Ptr<Scheduler> events = partitions[i]->events;
+      while (events != 0 && !events->IsEmpty ())
+        {
+          Scheduler::Event next = events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      partitions[i]->events = 0;
+    }
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT_MSG (!m_running, "Can't change the scheduler of a running simulation");
+  m_schedulerFactory = schedulerFactory;
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+  if (m_global->events != 0)
+    {
+      while (!m_global->events->IsEmpty ())
+        {
+          Scheduler::Event next = m_global->events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_global->events = scheduler;
+  // the partitions hold no events outside of Run.
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      m_partitions[i]->events = schedulerFactory.Create<Scheduler> ();
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+SimulatorPartition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  SimulatorPartition *partition = g_currentPartition;
+  if (partition == 0)
+    {
+      return m_global;
+    }
+  return partition;
+}
+
+SimulatorPartition *
+MultithreadedSimulatorImpl::LookupPartition (uint32_t context) const
+{
+  if (context == 0xffffffff)
+    {
+      return m_global;
+    }
+  if (context < m_partitionOf.size ())
+    {
+      return m_partitions[m_partitionOf[context]];
+    }
+  return m_partitions[0];
+}
+
+SimulatorPartition *
+MultithreadedSimulatorImpl::GetEventPartition (uint32_t context) const
+{
+  if (!m_running)
+    {
+      return m_global;
+    }
+  return LookupPartition (context);
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t nNodes = NodeList::GetNNodes ();
+
+  // the nodes which must be simulated by the same partition are
+  // grouped with a union-find structure.
+  std::vector<uint32_t> group (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      group[i] = i;
+    }
+  std::vector<struct PartitionLink> links;
+  TypeId pointToPointChannel;
+  bool havePointToPoint = TypeId::LookupByNameFailSafe ("ns3::PointToPointChannel", &pointToPointChannel);
+  bool useSystemId = false;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<Node> node = NodeList::GetNode (i);
+      useSystemId |= node->GetSystemId () != 0;
+      for (uint32_t j = 0; j < node->GetNDevices (); j++)
+        {
+          Ptr<Channel> channel = node->GetDevice (j)->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          if (havePointToPoint && channel->GetInstanceTypeId () == pointToPointChannel
+              && channel->GetNDevices () == 2)
+            {
+              TimeValue delay;
+              PointerValue loss;
+              channel->GetAttribute ("Delay", delay);
+              channel->GetAttribute ("LossModel", loss);
+              if (delay.Get ().IsStrictlyPositive () && loss.GetObject () == 0)
+                {
+                  uint32_t peer = channel->GetDevice (0)->GetNode ()->GetId ();
+                  if (peer == i)
+                    {
+                      peer = channel->GetDevice (1)->GetNode ()->GetId ();
+                    }
+                  struct PartitionLink link;
+                  link.a = i;
+                  link.b = peer;
+                  link.delay = delay.Get ().GetTimeStep ();
+                  links.push_back (link);
+                  continue;
+                }
+            }
+          for (uint32_t k = 0; k < channel->GetNDevices (); k++)
+            {
+              uint32_t a = i;
+              uint32_t b = channel->GetDevice (k)->GetNode ()->GetId ();
+              while (group[a] != a)
+                {
+                  a = group[a];
+                }
+              while (group[b] != b)
+                {
+                  b = group[b];
+                }
+              group[std::max (a, b)] = std::min (a, b);
+            }
+        }
+    }
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      // the root of a group is its smallest node id, which has already
+      // been resolved.
+      group[i] = group[group[i]];
+    }
+
+  m_partitionOf.resize (nNodes);
+  uint32_t nPartitions = 1;
+  if (useSystemId)
+    {
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          m_partitionOf[i] = NodeList::GetNode (i)->GetSystemId ();
+          nPartitions = std::max (nPartitions, m_partitionOf[i] + 1);
+          if (m_partitionOf[i] != m_partitionOf[group[i]])
+            {
+              NS_FATAL_ERROR ("Node " << i << " and node " << group[i] << " have different system ids "
+                              "but share a channel which can't be split between partitions");
+            }
+        }
+    }
+  else
+    {
+      uint32_t maxThreads = m_maxThreads;
+      if (maxThreads == 0)
+        {
+          long processors = sysconf (_SC_NPROCESSORS_ONLN);
+          maxThreads = processors > 0 ? processors : 1;
+        }
+      uint32_t nGroups = 0;
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          nGroups += group[i] == i ? 1 : 0;
+        }
+      nPartitions = std::max (1U, std::min (maxThreads, nGroups));
+      // fill the partitions in turn with groups of consecutive node ids,
+      // which are likely to be close in the topology.
+      std::vector<uint32_t> size (nNodes, 0);
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          size[group[i]]++;
+        }
+      uint32_t target = (nNodes + nPartitions - 1) / nPartitions;
+      uint32_t current = 0;
+      uint32_t load = 0;
+      for (uint32_t i = 0; i < nNodes; i++)
+        {
+          if (group[i] != i)
+            {
+              m_partitionOf[i] = m_partitionOf[group[i]];
+              continue;
+            }
+          if (load >= target && current + 1 < nPartitions)
+            {
+              current++;
+              load = 0;
+            }
+          m_partitionOf[i] = current;
+          load += size[i];
+        }
+    }
+
+  m_lookAhead = NO_TIMESTAMP;
+  for (std::vector<struct PartitionLink>::const_iterator i = links.begin (); i != links.end (); ++i)
+    {
+      if (m_partitionOf[i->a] != m_partitionOf[i->b])
+        {
+          m_lookAhead = std::min (m_lookAhead, i->delay);
+        }
+    }
+
+  for (uint32_t i = 0; i < nPartitions; i++)
+    {
+      SimulatorPartition *partition = new SimulatorPartition (this, i);
+      partition->events = m_schedulerFactory.Create<Scheduler> ();
+      m_partitions.push_back (partition);
+    }
+  NS_LOG_INFO ("nodes=" << nNodes << ", partitions=" << nPartitions << ", lookahead=" << m_lookAhead);
+}
+
+void
+MultithreadedSimulatorImpl::DistributeEvents (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the events which were scheduled outside of Run move to the
+  // partition of their context.
+  Ptr<Scheduler> global = m_schedulerFactory.Create<Scheduler> ();
+  while (!m_global->events->IsEmpty ())
+    {
+      Scheduler::Event next = m_global->events->RemoveNext ();
+      SimulatorPartition *partition = LookupPartition (next.key.m_context);
+      if (partition == m_global)
+        {
+          global->Insert (next);
+        }
+      else
+        {
+          partition->events->Insert (next);
+        }
+    }
+  m_global->events = global;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      m_partitions[i]->uid = m_global->uid;
+      m_partitions[i]->currentContext = 0xffffffff;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CollectEvents (void)
+{
+  NS_LOG_FUNCTION (this);
+  // outside of Run, all the events are kept by the global partition,
+  // whose clock is that of the most advanced partition.
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      SimulatorPartition *partition = m_partitions[i];
+      while (!partition->events->IsEmpty ())
+        {
+          m_global->events->Insert (partition->events->RemoveNext ());
+        }
+      m_global->uid = std::max (m_global->uid, partition->uid);
+      if (partition->currentTs > m_global->currentTs)
+        {
+          m_global->currentTs = partition->currentTs;
+          m_global->currentUid = partition->currentUid;
+        }
+    }
+  m_global->currentContext = 0xffffffff;
+}
+
+void
+MultithreadedSimulatorImpl::WaitBarrier (SimulatorPartition *partition)
+{
+#ifdef NS3_MULTITHREADED_SIMULATOR
+  // sense-reversing barrier: the last thread to arrive releases the others.
+  uint32_t sense = !partition->barrierSense;
+  partition->barrierSense = sense;
+  if (__sync_sub_and_fetch (&m_barrierCount, 1) == 0)
+    {
+      m_barrierCount = m_partitions.size ();
+      __sync_synchronize ();
+      m_barrierSense = sense;
+    }
+  else
+    {
+      uint32_t spins = 0;
+      while (m_barrierSense != sense)
+        {
+          spins++;
+          if (spins > 1000)
+            {
+              sched_yield ();
+            }
+        }
+    }
+  __sync_synchronize ();
+#endif
+}
+
+void
+MultithreadedSimulatorImpl::Insert (SimulatorPartition *partition, const Scheduler::Event &ev)
+{
+  Scheduler::Event event = ev;
+  event.key.m_uid = partition->uid;
+  partition->uid++;
+  partition->events->Insert (event);
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveRemoteEvents (SimulatorPartition *partition)
+{
+#ifdef NS3_MULTITHREADED_SIMULATOR
+  // the events are sorted to give them an order which does not depend on
+  // the order in which the partitions sent them.
+  SimulatorPartition::RemoteEvent remote;
+  while (partition->inbox.Dequeue (remote))
+    {
+      partition->received.push_back (remote);
+    }
+  partition->received.insert (partition->received.end (), partition->overflow.begin (), partition->overflow.end ());
+  partition->overflow.clear ();
+  std::sort (partition->received.begin (), partition->received.end (), &RemoteEventLess);
+  for (std::vector<SimulatorPartition::RemoteEvent>::const_iterator i = partition->received.begin ();
+       i != partition->received.end (); ++i)
+    {
+      Scheduler::Event ev;
+      ev.impl = i->impl;
+      ev.key.m_ts = i->ts;
+      ev.key.m_context = i->context;
+      Insert (partition, ev);
+    }
+  partition->received.clear ();
+#endif
+}
+
+void
+MultithreadedSimulatorImpl::ProcessEvents (SimulatorPartition *partition, uint64_t windowEnd)
+{
+  while (!partition->events->IsEmpty () && !partition->stop)
+    {
+      Scheduler::Event next = partition->events->PeekNext ();
+      if (next.key.m_ts >= windowEnd)
+        {
+          break;
+        }
+      partition->events->RemoveNext ();
+      NS_ASSERT (next.key.m_ts >= partition->currentTs);
+      partition->currentTs = next.key.m_ts;
+      partition->currentContext = next.key.m_context;
+      partition->currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessGlobalEvents (uint64_t ts)
+{
+  // the other threads wait on the barrier while the main thread runs
+  // the events which belong to no partition.
+  // the packets they create take their uids from the default sequence.
+  g_currentPartition = m_global;
+  uint32_t packetUid = Packet::GetUidStreamNext ();
+  Packet::SetUidStream (0, 0);
+  while (!m_global->events->IsEmpty () && !m_global->stop)
+    {
+      Scheduler::Event next = m_global->events->PeekNext ();
+      if (next.key.m_ts != ts)
+        {
+          break;
+        }
+      m_global->events->RemoveNext ();
+      m_global->currentTs = next.key.m_ts;
+      m_global->currentContext = next.key.m_context;
+      m_global->currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  Packet::SetUidStream (m_partitions[0]->index + 1, packetUid);
+  g_currentPartition = m_partitions[0];
+}
+
+bool
+MultithreadedSimulatorImpl::IsStopped (void) const
+{
+  bool stop = m_global->stop;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      stop |= m_partitions[i]->stop;
+    }
+  return stop;
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (SimulatorPartition *partition)
+{
+  NS_LOG_FUNCTION (this << partition->index);
+  g_currentPartition = partition;
+  // the uids of the packets created by a partition do not depend on the
+  // progress of the other partitions.
+  Packet::SetUidStream (partition->index + 1, partition->packetUid);
+  while (true)
+    {
+      // wait for all the events of the previous window to be sent.
+      WaitBarrier (partition);
+      // no event runs until the next barrier: all the partitions see
+      // the same stop flags.
+      bool stop = IsStopped ();
+      ReceiveRemoteEvents (partition);
+      partition->nextTs = partition->events->IsEmpty () ? NO_TIMESTAMP : partition->events->PeekNext ().key.m_ts;
+      if (partition->index == 0)
+        {
+          ReceiveRemoteEvents (m_global);
+          m_global->nextTs = m_global->events->IsEmpty () ? NO_TIMESTAMP : m_global->events->PeekNext ().key.m_ts;
+          m_windows++;
+        }
+      WaitBarrier (partition);
+
+      // all the threads take the same decision from the same data.
+      uint64_t next = NO_TIMESTAMP;
+      for (uint32_t i = 0; i < m_partitions.size (); i++)
+        {
+          next = std::min (next, m_partitions[i]->nextTs);
+        }
+      uint64_t globalNext = m_global->nextTs;
+      if (stop || (next == NO_TIMESTAMP && globalNext == NO_TIMESTAMP))
+        {
+          break;
+        }
+      if (globalNext <= next)
+        {
+          if (partition->index == 0)
+            {
+              ProcessGlobalEvents (globalNext);
+            }
+          continue;
+        }
+      // no event can be received from another partition before the
+      // earliest event plus the lookahead.
+      uint64_t windowEnd = globalNext;
+      if (m_lookAhead < windowEnd - next)
+        {
+          windowEnd = next + m_lookAhead;
+        }
+      partition->windowEnd = windowEnd;
+      ProcessEvents (partition, windowEnd);
+    }
+  partition->packetUid = Packet::GetUidStreamNext ();
+  Packet::SetUidStream (0, 0);
+  g_currentPartition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (g_currentPartition == 0, "Run can't be called from an event");
+  if (m_partitions.empty ())
+    {
+      CreatePartitions ();
+    }
+  DistributeEvents ();
+  m_stop = false;
+  m_global->stop = false;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      m_partitions[i]->stop = false;
+    }
+  m_running = true;
+  g_runningSimulator = this;
+  m_barrierCount = m_partitions.size ();
+
+#ifdef NS3_MULTITHREADED_SIMULATOR
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < m_partitions.size (); i++)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&SimulatorPartition::Run, m_partitions[i]));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+#endif
+  RunPartition (m_partitions[0]);
+#ifdef NS3_MULTITHREADED_SIMULATOR
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+#endif
+
+  g_runningSimulator = 0;
+  m_running = false;
+  m_stop = IsStopped ();
+  CollectEvents ();
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_running)
+    {
+      // the other partitions see it at the end of the window.
+      GetCurrentPartition ()->stop = true;
+    }
+  else
+    {
+      m_stop = true;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &time)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep ());
+  Simulator::Schedule (time, &Simulator::Stop);
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  return m_global->events->IsEmpty () || m_stop;
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << time.GetTimeStep () << event);
+  SimulatorPartition *partition = GetCurrentPartition ();
+
+  Time tAbsolute = time + TimeStep (partition->currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (partition->currentTs));
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = partition->currentContext;
+  Insert (partition, ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, partition->uid - 1);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << time.GetTimeStep () << event);
+  NS_ASSERT_MSG (!m_running || g_currentPartition != 0,
+                 "Simulator::ScheduleWithContext can't be called from other threads than those of the simulation");
+  SimulatorPartition *partition = GetCurrentPartition ();
+  SimulatorPartition *target = GetEventPartition (context);
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = partition->currentTs + time.GetTimeStep ();
+  ev.key.m_context = context;
+  if (target == partition || partition == m_global)
+    {
+      // events of the global partition are run while the other
+      // partitions wait.
+      Insert (target, ev);
+      return;
+    }
+
+#ifdef NS3_MULTITHREADED_SIMULATOR
+  if (ev.key.m_ts < partition->windowEnd)
+    {
+      NS_FATAL_ERROR ("An event of context " << partition->currentContext << " at time " << partition->currentTs
+                      << " schedules an event of context " << context << " of another partition at time "
+                      << ev.key.m_ts << ", earlier than the lookahead allows (" << partition->windowEnd << ")");
+    }
+  SimulatorPartition::RemoteEvent remote;
+  remote.ts = ev.key.m_ts;
+  remote.sequence = partition->sent;
+  remote.context = context;
+  remote.source = partition->index;
+  remote.impl = event;
+  partition->sent++;
+  if (!target->inbox.Enqueue (remote))
+    {
+      CriticalSection cs (target->overflowMutex);
+      target->overflow.push_back (remote);
+    }
+#endif
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  SimulatorPartition *partition = GetCurrentPartition ();
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = partition->currentTs;
+  ev.key.m_context = partition->currentContext;
+  Insert (partition, ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, partition->uid - 1);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  NS_ASSERT_MSG (g_currentPartition == 0 || g_currentPartition == m_global,
+                 "Simulator::ScheduleDestroy can only be called from the main thread");
+
+  EventId id (Ptr<EventImpl> (event, false), m_global->currentTs, 0xffffffff, 2);
+  m_destroyEvents.push_back (id);
+  m_global->uid++;
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (GetCurrentPartition ()->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - GetCurrentPartition ()->currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  SimulatorPartition *partition = GetEventPartition (id.GetContext ());
+  NS_ASSERT_MSG (partition == GetCurrentPartition () || GetCurrentPartition () == m_global,
+                 "Events can only be removed from their own partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &ev) const
+{
+  if (ev.GetUid () == 2)
+    {
+      if (ev.PeekEventImpl () == 0 ||
+          ev.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == ev)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  SimulatorPartition *partition = GetEventPartition (ev.GetContext ());
+  // the clock of another partition changes while this one runs, except
+  // for that of the global partition, which runs alone.
+  NS_ASSERT_MSG (partition == GetCurrentPartition () || partition == m_global || GetCurrentPartition () == m_global,
+                 "The events of a partition can't be checked from another partition");
+  if (ev.PeekEventImpl () == 0 ||
+      ev.GetTs () < partition->currentTs ||
+      (ev.GetTs () == partition->currentTs &&
+       ev.GetUid () <= partition->currentUid) ||
+      ev.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  return GetCurrentPartition ()->currentContext;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_partitions.size ();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  NS_ASSERT (context < m_partitionOf.size ());
+  return m_partitionOf[context];
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  if (m_lookAhead == NO_TIMESTAMP)
+    {
+      return GetMaximumSimulationTime ();
+    }
+  return TimeStep (m_lookAhead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetRemoteEventCount (void) const
+{
+  uint64_t sent = 0;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      sent += m_partitions[i]->sent;
+    }
+  return sent;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetWindowCount (void) const
+{
+  return m_windows;
+}
+
+bool
+MultithreadedSimulatorImpl::IsRemote (uint32_t context)
+{
+  MultithreadedSimulatorImpl *simulator = g_runningSimulator;
+  SimulatorPartition *current = g_currentPartition;
+  if (simulator == 0 || current == 0 || current == simulator->m_global)
+    {
+      return false;
+    }
+  return simulator->LookupPartition (context) != current;
+}
+
+} // namespace ns3
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+struct SimulatorPartition;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief parallel simulator implementation which runs partitions of the
+ * nodes in the threads of a single process
+ *
+ * Like DistributedSimulatorImpl, this implementation splits the nodes in
+ * partitions which are simulated concurrently and synchronized with a
+ * conservative algorithm whose lookahead is the smallest delay of the
+ * point-to-point channels between two partitions. The partitions are
+ * simulated by the threads of one process instead of MPI processes:
+ * events are sent to other partitions through lock-free queues, and
+ * packets cross partitions as a PointToPointChannel hands them to the
+ * receiving device without being serialized.
+ *
+ * Time advances in windows: all the partitions process their events
+ * which are earlier than the smallest timestamp of the next event of any
+ * partition plus the lookahead, then wait for each other and receive the
+ * events sent to them during the window. Events scheduled without the
+ * context of a node (which includes the events scheduled from the main
+ * program with Simulator::Schedule, and Simulator::Stop (Time)) belong
+ * to no partition: they are run by the main thread while the other
+ * threads wait, so that they can safely access any node.
+ *
+ * When the nodes have non-zero system ids, they are used as partition
+ * numbers, as with DistributedSimulatorImpl. Otherwise, the nodes are
+ * partitioned automatically when Run is first called: the nodes which
+ * share a channel other than a PointToPointChannel with a delay and no
+ * loss model are kept together, and the resulting groups of nodes are
+ * spread across at most "MaxThreads" partitions by ascending node id.
+ *
+ * The models executed by different partitions must not share state:
+ * objects which receive the traces of nodes of several partitions (such
+ * as FlowMonitor, the animation interface or a shared ascii trace
+ * stream), random variables shared between nodes and nodes created
+ * after the first call to Run, which are all assigned to the first
+ * partition, are not supported. An event can only cancel or check the
+ * events of its own partition and those without context. Log components
+ * must not be enabled or disabled by events, and the log output of
+ * different partitions may be interleaved.
+ *
+ * Simulator::Stop () called by an event stops its partition right away
+ * and the other partitions at the end of the current window. The order
+ * of events which have the same timestamp is deterministic but may
+ * differ from that of DefaultSimulatorImpl. Each partition gives its own
+ * sequence of uids to the packets it creates (see Packet::SetUidStream):
+ * packet uids are reproducible from one run to the next, but differ from
+ * those of DefaultSimulatorImpl and only increase within a partition.
+ *
+ * This implementation requires threads, thread-local storage and the GCC
+ * atomic builtins.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MultithreadedSimulatorImpl ();
+  ~MultithreadedSimulatorImpl ();
+
+  // virtual from SimulatorImpl
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &time);
+  virtual EventId Schedule (Time const &time, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &time, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &ev);
+  virtual void Cancel (const EventId &ev);
+  virtual bool IsExpired (const EventId &ev) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \returns the number of partitions, which is zero until Run is
+   *          first called.
+   */
+  uint32_t GetPartitionCount (void) const;
+  /**
+   * \param context the id of a node
+   * \returns the partition of the node.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /**
+   * \returns the lookahead between partitions, or the maximum simulation
+   *          time when no channel crosses partitions.
+   */
+  Time GetLookAhead (void) const;
+  /**
+   * \returns the number of events sent by a partition to another one.
+   */
+  uint64_t GetRemoteEventCount (void) const;
+  /**
+   * \returns the number of synchronization windows.
+   */
+  uint64_t GetWindowCount (void) const;
+
+  /**
+   * \param context the context of an event
+   * \returns true if an event scheduled with this context from the
+   *          calling thread is run by another thread, in which case
+   *          its arguments must not share any reference-counted state
+   *          with the objects of the calling thread.
+   *
+   * Returns false when the simulator is not a MultithreadedSimulatorImpl
+   * or is not running.
+   */
+  static bool IsRemote (uint32_t context);
+
+private:
+  friend struct SimulatorPartition;
+
+  virtual void DoDispose (void);
+  void CreatePartitions (void);
+  void DistributeEvents (void);
+  void CollectEvents (void);
+  void RunPartition (SimulatorPartition *partition);
+  void ProcessEvents (SimulatorPartition *partition, uint64_t windowEnd);
+  void ProcessGlobalEvents (uint64_t ts);
+  void ReceiveRemoteEvents (SimulatorPartition *partition);
+  void WaitBarrier (SimulatorPartition *partition);
+  bool IsStopped (void) const;
+  void Insert (SimulatorPartition *partition, const Scheduler::Event &ev);
+  SimulatorPartition *GetCurrentPartition (void) const;
+  SimulatorPartition *GetEventPartition (uint32_t context) const;
+  SimulatorPartition *LookupPartition (uint32_t context) const;
+
+  typedef std::list<EventId> DestroyEvents;
+  DestroyEvents m_destroyEvents;
+  // set by Stop outside of Run, and by Run when a partition stopped;
+  // while the simulation runs, each partition has its own stop flag.
+  bool m_stop;
+  bool m_running;
+  ObjectFactory m_schedulerFactory;
+
+  // the events which belong to no partition, and all the events while
+  // the simulation is not running.
+  SimulatorPartition *m_global;
+  std::vector<SimulatorPartition *> m_partitions;
+  // the partition of each node, indexed by node id.
+  std::vector<uint32_t> m_partitionOf;
+  uint64_t m_lookAhead;
+  uint32_t m_maxThreads;
+  uint64_t m_windows;
+
+  volatile uint32_t m_barrierCount;
+  volatile uint32_t m_barrierSense;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -18,8 +18,10 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "packet-allocator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/thread-local.h"
 
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
@@ -46,99 +48,13 @@ static struct Zeroes
 namespace ns3 {
 
 
-uint32_t Buffer::g_recommendedStart = 0;
-#ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
+/**
+ * location in a newly-allocated buffer where you should start
+ * writing data. i.e., m_start should be initialized to this
+ * value. It is learned by each thread which creates buffers.
  */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
-{
-  NS_LOG_FUNCTION (this);
-  if (IS_INITIALIZED (g_freeList))
-    {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
-        {
-          Buffer::Deallocate (*i);
-        }
-      delete g_freeList;
-      g_freeList = DESTROYED;
-    }
-}
+static NS_THREAD_LOCAL uint32_t g_recommendedStart = 0;
 
-void
-Buffer::Recycle (struct Buffer::Data *data)
-{
-  NS_LOG_FUNCTION (data);
-  NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
-    {
-      Buffer::Deallocate (data);
-    }
-  else
-    {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
-    }
-}
-
-Buffer::Data *
-Buffer::Create (uint32_t dataSize)
-{
-  NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
-  if (IS_UNINITIALIZED (g_freeList))
-    {
-      g_freeList = new Buffer::FreeList ();
-    }
-  else if (IS_INITIALIZED (g_freeList))
-    {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
-    }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
-  NS_ASSERT (data->m_count == 1);
-  return data;
-}
-#else /* BUFFER_FREE_LIST */
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
@@ -153,7 +69,6 @@ Buffer::Create (uint32_t size)
   NS_LOG_FUNCTION (size);
   return Allocate (size);
 }
-#endif /* BUFFER_FREE_LIST */
 
 struct Buffer::Data *
 Buffer::Allocate (uint32_t reqSize)
@@ -165,9 +80,11 @@ Buffer::Allocate (uint32_t reqSize)
     }
   NS_ASSERT (reqSize >= 1);
   uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
-  uint8_t *b = new uint8_t [size];
+  // the allocator may round the size up: make the extra bytes available.
+  uint32_t capacity = PacketAllocator::GetCapacity (size);
+  uint8_t *b = static_cast<uint8_t *> (PacketAllocator::Allocate (size));
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
-  data->m_size = reqSize;
+  data->m_size = capacity + 1 - sizeof (struct Buffer::Data);
   data->m_count = 1;
   return data;
 }
@@ -177,8 +94,7 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
+  PacketAllocator::Deallocate (data, data->m_size - 1 + sizeof (struct Buffer::Data));
 }
 
 Buffer::Buffer ()
@@ -202,6 +118,13 @@ Buffer::Buffer (uint32_t dataSize, bool initialize)
     }
 }
 
+Buffer::Buffer (Ptr<const SharedPayload> payload)
+{
+  NS_LOG_FUNCTION (this << payload);
+  Initialize (payload->GetSize ());
+  m_payload = payload;
+}
+
 bool
 Buffer::CheckInternalState (void) const
 {
@@ -248,6 +171,8 @@ Buffer::Initialize (uint32_t zeroSize)
   m_end = m_zeroAreaEnd;
   m_data->m_dirtyStart = m_start;
   m_data->m_dirtyEnd = m_end;
+  m_payload = 0;
+  m_payloadStart = 0;
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -272,6 +197,8 @@ Buffer::operator = (Buffer const&o)
   m_zeroAreaEnd = o.m_zeroAreaEnd;
   m_start = o.m_start;
   m_end = o.m_end;
+  m_payload = o.m_payload;
+  m_payloadStart = o.m_payloadStart;
   NS_ASSERT (CheckInternalState ());
   return *this;
 }
@@ -411,18 +338,28 @@ void
 Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
+  uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
   if (m_data->m_count == 1 &&
       m_end == m_zeroAreaEnd &&
       m_end == m_data->m_dirtyEnd &&
       o.m_start == o.m_zeroAreaStart &&
-      o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+      o.m_zeroAreaEnd - o.m_zeroAreaStart > 0 &&
+      (zeroSize == 0 ||
+       (m_payload == o.m_payload &&
+        (m_payload == 0 || m_payloadStart + zeroSize == o.m_payloadStart))))
     {
       /**
        * This is an optimization which kicks in when
        * we attempt to aggregate two buffers which contain
-       * adjacent zero areas.
+       * adjacent zero areas, or adjacent parts of the same
+       * shared payload.
        */
-      uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
+      if (zeroSize == 0)
+        {
+          m_payload = o.m_payload;
+          m_payloadStart = o.m_payloadStart;
+        }
+      zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
       m_zeroAreaEnd += zeroSize;
       m_end = m_zeroAreaEnd;
       m_data->m_dirtyEnd = m_zeroAreaEnd;
@@ -468,6 +405,7 @@ Buffer::RemoveAtStart (uint32_t start)
       m_start = m_zeroAreaStart;
       m_zeroAreaEnd -= delta;
       m_end -= delta;
+      m_payloadStart += delta;
     } 
   else if (newStart <= m_end)
     {
@@ -480,6 +418,8 @@ Buffer::RemoveAtStart (uint32_t start)
       m_end -= zeroSize;
       m_zeroAreaStart = m_start;
       m_zeroAreaEnd = m_start;
+      m_payload = 0;
+      m_payloadStart = 0;
     }
   else 
     {
@@ -488,6 +428,8 @@ Buffer::RemoveAtStart (uint32_t start)
       m_start = m_end;
       m_zeroAreaEnd = m_end;
       m_zeroAreaStart = m_end;
+      m_payload = 0;
+      m_payloadStart = 0;
     }
   m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
   LOG_INTERNAL_STATE ("rem start=" << start << ", ");
@@ -516,6 +458,8 @@ Buffer::RemoveAtEnd (uint32_t end)
       m_end = newEnd;
       m_zeroAreaEnd = newEnd;
       m_zeroAreaStart = newEnd;
+      m_payload = 0;
+      m_payloadStart = 0;
     }
   else
     {
@@ -523,6 +467,8 @@ Buffer::RemoveAtEnd (uint32_t end)
       m_end = m_start;
       m_zeroAreaEnd = m_start;
       m_zeroAreaStart = m_start;
+      m_payload = 0;
+      m_payloadStart = 0;
     }
   m_maxZeroAreaStart = std::max (m_maxZeroAreaStart, m_zeroAreaStart);
   LOG_INTERNAL_STATE ("rem end=" << end << ", ");
@@ -550,7 +496,15 @@ Buffer::CreateFullCopy (void) const
     {
       Buffer tmp;
       tmp.AddAtStart (m_zeroAreaEnd - m_zeroAreaStart);
-      tmp.Begin ().WriteU8 (0, m_zeroAreaEnd - m_zeroAreaStart);
+      if (m_payload == 0)
+        {
+          tmp.Begin ().WriteU8 (0, m_zeroAreaEnd - m_zeroAreaStart);
+        }
+      else
+        {
+          tmp.Begin ().Write (m_payload->PeekData () + m_payloadStart,
+                              m_zeroAreaEnd - m_zeroAreaStart);
+        }
       uint32_t dataStart = m_zeroAreaStart - m_start;
       tmp.AddAtStart (dataStart);
       tmp.Begin ().Write (m_data->m_data+m_start, dataStart);
@@ -566,10 +520,40 @@ Buffer::CreateFullCopy (void) const
   return *this;
 }
 
+Buffer
+Buffer::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (CheckInternalState ());
+  Buffer copy (0, false);
+  copy.m_data = Buffer::Create (GetInternalEnd ());
+  memcpy (copy.m_data->m_data + m_start, m_data->m_data + m_start, GetInternalSize ());
+  copy.m_data->m_dirtyStart = m_start;
+  copy.m_data->m_dirtyEnd = m_end;
+  copy.m_maxZeroAreaStart = m_maxZeroAreaStart;
+  copy.m_zeroAreaStart = m_zeroAreaStart;
+  copy.m_zeroAreaEnd = m_zeroAreaEnd;
+  copy.m_start = m_start;
+  copy.m_end = m_end;
+  copy.m_payloadStart = 0;
+  if (m_payload != 0)
+    {
+      copy.m_payload = ns3::Create<SharedPayload> (m_payload->PeekData () + m_payloadStart,
+                                                   m_zeroAreaEnd - m_zeroAreaStart);
+    }
+  NS_ASSERT (copy.CheckInternalState ());
+  return copy;
+}
+
 uint32_t 
 Buffer::GetSerializedSize (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_payload != 0)
+    {
+      // the serialized format only knows about zero-filled payloads.
+      return CreateFullCopy ().GetSerializedSize ();
+    }
   uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
   uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -590,6 +574,10 @@ uint32_t
 Buffer::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
   NS_LOG_FUNCTION (this << &buffer << maxSize);
+  if (m_payload != 0)
+    {
+      return CreateFullCopy ().Serialize (buffer, maxSize);
+    }
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
@@ -747,7 +735,11 @@ Buffer::CopyData (std::ostream *os, uint32_t size) const
         { 
           size -= m_zeroAreaStart-m_start;
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
-          uint32_t left = tmpsize;
+          if (m_payload != 0)
+            {
+              os->write ((const char*)(m_payload->PeekData () + m_payloadStart), tmpsize);
+            }
+          uint32_t left = m_payload == 0 ? tmpsize : 0;
           while (left > 0)
             {
               uint32_t toWrite = std::min (left, g_zeroes.size);
@@ -778,7 +770,12 @@ Buffer::CopyData (uint8_t *buffer, uint32_t size) const
       if (size > 0) 
         { 
           tmpsize = std::min (m_zeroAreaEnd - m_zeroAreaStart, size);
-          uint32_t left = tmpsize;
+          if (m_payload != 0)
+            {
+              memcpy (buffer, m_payload->PeekData () + m_payloadStart, tmpsize);
+              buffer += tmpsize;
+            }
+          uint32_t left = m_payload == 0 ? tmpsize : 0;
           while (left > 0)
             {
               uint32_t toWrite = std::min (left, g_zeroes.size);
@@ -879,7 +876,14 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      if (start.m_payload == 0)
+        {
+          memset (&m_data[m_current], 0, toCopy);
+        }
+      else
+        {
+          memcpy (&m_data[m_current], &start.m_payload[start.m_current - start.m_zeroStart], toCopy);
+        }
       start.m_current += toCopy;
       m_current += toCopy;
       size -= toCopy;
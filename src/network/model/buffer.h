@@ -24,8 +24,8 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
-
-#define noBUFFER_FREE_LIST 1
+#include "ns3/ptr.h"
+#include "shared-payload.h"
 
 namespace ns3 {
 
@@ -70,6 +70,12 @@ namespace ns3 {
  * a pair of integers which describe where in the buffer content
  * the "virtual zero area" starts and ends.
  *
+ * The virtual zero area can also be backed by a SharedPayload: its
+ * bytes are then read from the shared, immutable, payload rather than
+ * being zero, which allows many buffers to carry the same non-zero
+ * payload without copying it. m_payloadStart keeps track of the offset
+ * in the SharedPayload of the first byte of the virtual zero area.
+ *
  * \verbatim
  * ***: unused bytes
  * xxx: bytes "added" at the front of the zero area
@@ -412,6 +418,11 @@ private:
      * to this pointer.
      */
     uint8_t *m_data;
+    /* a pointer to the byte of the shared payload which backs the first
+     * byte of the "virtual zero area", or zero if this area is really
+     * filled with zeros.
+     */
+    uint8_t const *m_payload;
   };
 
   /**
@@ -500,6 +511,17 @@ private:
 
   Buffer CreateFullCopy (void) const;
 
+  /**
+   * \returns a copy of this buffer which does not share any state with it.
+   *
+   * Unlike the copy constructor, which shares the underlying byte buffer
+   * and SharedPayload and only copies them on write, this method copies
+   * them right away so that the copy and the original can be used from
+   * different threads. The layout of the copy, including the position
+   * of the virtual zero area, is that of this buffer.
+   */
+  Buffer DeepCopy (void) const;
+
   /**
    * \return the number of bytes required for serialization 
    */
@@ -545,6 +567,14 @@ private:
   Buffer ();
   Buffer (uint32_t dataSize);
   Buffer (uint32_t dataSize, bool initialize);
+  /**
+   * \param payload the payload referenced by the new buffer.
+   *
+   * Create a buffer whose bytes are those of the payload. The bytes
+   * are not copied: like the zero bytes of Buffer (uint32_t), they are
+   * kept in the "virtual zero area" of the buffer.
+   */
+  Buffer (Ptr<const SharedPayload> payload);
   ~Buffer ();
 private:
   /**
@@ -606,12 +636,6 @@ private:
    * m_zeroAreaStart.
    */
   uint32_t m_maxZeroAreaStart;
-  /**
-   * location in a newly-allocated buffer where you should start
-   * writing data. i.e., m_start should be initialized to this 
-   * value.
-   */
-  static uint32_t g_recommendedStart;
 
   /* offset to the start of the virtual zero area from the start 
    * of m_data->m_data
@@ -629,17 +653,15 @@ private:
    * instance from the start of m_data->m_data
    */
   uint32_t m_end;
+  /* the payload whose bytes are those of the virtual zero area, or
+   * zero if this area is really filled with zeros.
+   */
+  Ptr<const SharedPayload> m_payload;
+  /* offset from the start of m_payload to the byte which backs the
+   * start of the virtual zero area.
+   */
+  uint32_t m_payloadStart;
 
-#ifdef BUFFER_FREE_LIST
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize;
-  static FreeList *g_freeList;
-  static struct LocalStaticDestructor g_localStaticDestructor;
-#endif
 };
 
 } // namespace ns3
@@ -655,7 +677,8 @@ Buffer::Iterator::Iterator ()
     m_dataStart (0),
     m_dataEnd (0),
     m_current (0),
-    m_data (0)
+    m_data (0),
+    m_payload (0)
 {
 }
 Buffer::Iterator::Iterator (Buffer const*buffer)
@@ -677,6 +700,11 @@ Buffer::Iterator::Construct (const Buffer *buffer)
   m_dataStart = buffer->m_start;
   m_dataEnd = buffer->m_end;
   m_data = buffer->m_data->m_data;
+  m_payload = 0;
+  if (buffer->m_payload != 0)
+    {
+      m_payload = buffer->m_payload->PeekData () + buffer->m_payloadStart;
+    }
 }
 
 void 
@@ -855,8 +883,9 @@ Buffer::Iterator::ReadU8 (void)
     }
   else if (m_current < m_zeroEnd)
     {
+      uint8_t data = m_payload == 0 ? 0 : m_payload[m_current - m_zeroStart];
       m_current++;
-      return 0;
+      return data;
     }
   else
     {
@@ -894,7 +923,9 @@ Buffer::Buffer (Buffer const&o)
     m_zeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaEnd (o.m_zeroAreaEnd),
     m_start (o.m_start),
-    m_end (o.m_end)
+    m_end (o.m_end),
+    m_payload (o.m_payload),
+    m_payloadStart (o.m_payloadStart)
 {
   m_data->m_count++;
   NS_ASSERT (CheckInternalState ());
@@ -127,6 +127,12 @@ private:
 
   void RemoveAll (void);
 
+  /**
+   * \returns a copy of this list which does not share its storage
+   *          with it, and can thus be used from another thread.
+   */
+  ByteTagList DeepCopy (void) const;
+
   /**
    * \param offsetStart the offset which uniquely identifies the first data byte 
    *        present in the byte buffer associated to this ByteTagList.
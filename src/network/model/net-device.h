@@ -331,6 +331,13 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this interface can transmit the super-segments marked
+   *         by a SegmentOffloadTag, whose size may exceed the MTU, false
+   *         otherwise. The default implementation returns false.
+   */
+  virtual bool SupportsSegmentOffload (void) const;
+
 };
 
 } // namespace ns3
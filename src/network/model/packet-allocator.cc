@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "packet-allocator.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/assert.h"
+#include "ns3/thread-local.h"
+#include <algorithm>
+#include <new>
+
+#if defined (HAVE_TLS) && defined (HAVE_PTHREAD_H)
+#include <pthread.h>
+#define PACKET_ALLOCATOR_FLUSH_ON_THREAD_EXIT 1
+#endif
+
+namespace ns3 {
+
+// blocks are pooled by powers of two from 2^PACKET_ALLOCATOR_MIN_SHIFT
+// to 2^PACKET_ALLOCATOR_MAX_SHIFT bytes.
+static const uint32_t PACKET_ALLOCATOR_MIN_SHIFT = 5;
+static const uint32_t PACKET_ALLOCATOR_MAX_SHIFT = 16;
+static const uint32_t PACKET_ALLOCATOR_CLASSES = PACKET_ALLOCATOR_MAX_SHIFT - PACKET_ALLOCATOR_MIN_SHIFT + 1;
+
+static GlobalValue g_packetAllocatorMaxCachedBytes =
+  GlobalValue ("PacketAllocatorMaxCachedBytes",
+               "The maximum number of bytes each thread keeps in the free lists "
+               "of the packet allocator. Read by each thread the first time it "
+               "allocates a packet buffer or tag.",
+               UintegerValue (8 << 20),
+               MakeUintegerChecker<uint64_t> ());
+
+struct PacketAllocatorFreeBlock
+{
+  PacketAllocatorFreeBlock *next;
+};
+
+/* The state of the cache of a thread starts as uninitialized (which is
+ * what the zero-initialized storage of the thread-local variable holds
+ * before the constructors run), becomes initialized upon first use, and
+ * destroyed once the static destructors of this compilation unit have run
+ * for the main thread, or when another thread exits: in this last state,
+ * blocks are not cached anymore.
+ */
+enum PacketAllocatorCacheState
+{
+  CACHE_UNINITIALIZED = 0,
+  CACHE_INITIALIZED,
+  CACHE_DESTROYED
+};
+
+struct PacketAllocatorCache
+{
+  PacketAllocatorFreeBlock *freeList[PACKET_ALLOCATOR_CLASSES];
+  uint32_t state;
+  uint64_t maxCachedBytes;
+  struct PacketAllocator::Statistics stats;
+};
+
+static NS_THREAD_LOCAL struct PacketAllocatorCache g_packetAllocatorCache;
+
+static void
+FlushPacketAllocatorCache (struct PacketAllocatorCache *cache)
+{
+  for (uint32_t i = 0; i < PACKET_ALLOCATOR_CLASSES; i++)
+    {
+      while (cache->freeList[i] != 0)
+        {
+          PacketAllocatorFreeBlock *block = cache->freeList[i];
+          cache->freeList[i] = block->next;
+          ::operator delete (block);
+        }
+    }
+  cache->stats.cachedBytes = 0;
+}
+
+static struct PacketAllocatorLocalStaticDestructor
+{
+  ~PacketAllocatorLocalStaticDestructor ()
+  {
+    FlushPacketAllocatorCache (&g_packetAllocatorCache);
+    g_packetAllocatorCache.state = CACHE_DESTROYED;
+  }
+} g_packetAllocatorLocalStaticDestructor;
+
+#ifdef PACKET_ALLOCATOR_FLUSH_ON_THREAD_EXIT
+static pthread_key_t g_packetAllocatorKey;
+static pthread_once_t g_packetAllocatorKeyOnce = PTHREAD_ONCE_INIT;
+
+static void
+FlushPacketAllocatorCacheOnThreadExit (void *cache)
+{
+  FlushPacketAllocatorCache (static_cast<struct PacketAllocatorCache *> (cache));
+  static_cast<struct PacketAllocatorCache *> (cache)->state = CACHE_DESTROYED;
+}
+
+static void
+CreatePacketAllocatorKey (void)
+{
+  pthread_key_create (&g_packetAllocatorKey, &FlushPacketAllocatorCacheOnThreadExit);
+}
+#endif /* PACKET_ALLOCATOR_FLUSH_ON_THREAD_EXIT */
+
+static struct PacketAllocatorCache *
+GetPacketAllocatorCache (void)
+{
+  struct PacketAllocatorCache *cache = &g_packetAllocatorCache;
+  if (cache->state == CACHE_UNINITIALIZED)
+    {
+      UintegerValue maxCachedBytes;
+      g_packetAllocatorMaxCachedBytes.GetValue (maxCachedBytes);
+      cache->maxCachedBytes = maxCachedBytes.Get ();
+      cache->state = CACHE_INITIALIZED;
+#ifdef PACKET_ALLOCATOR_FLUSH_ON_THREAD_EXIT
+      // return the free blocks of other threads to the system when they exit.
+      pthread_once (&g_packetAllocatorKeyOnce, &CreatePacketAllocatorKey);
+      pthread_setspecific (g_packetAllocatorKey, cache);
+#endif
+    }
+  return cache;
+}
+
+/**
+ * \returns the size class of a request of size bytes, or
+ *          PACKET_ALLOCATOR_CLASSES if it is too large to be pooled.
+ */
+static uint32_t
+GetSizeClass (uint32_t size)
+{
+  uint32_t sizeClass = 0;
+  uint32_t capacity = 1 << PACKET_ALLOCATOR_MIN_SHIFT;
+  while (capacity < size && sizeClass < PACKET_ALLOCATOR_CLASSES)
+    {
+      capacity <<= 1;
+      sizeClass++;
+    }
+  return sizeClass;
+}
+
+uint32_t
+PacketAllocator::GetCapacity (uint32_t size)
+{
+  uint32_t sizeClass = GetSizeClass (size);
+  if (sizeClass == PACKET_ALLOCATOR_CLASSES)
+    {
+      return size;
+    }
+  return 1 << (sizeClass + PACKET_ALLOCATOR_MIN_SHIFT);
+}
+
+void *
+PacketAllocator::Allocate (uint32_t size)
+{
+  struct PacketAllocatorCache *cache = GetPacketAllocatorCache ();
+  uint32_t sizeClass = GetSizeClass (size);
+  uint32_t capacity = GetCapacity (size);
+  cache->stats.allocations++;
+  cache->stats.bytesInUse += capacity;
+  cache->stats.peakBytesInUse = std::max (cache->stats.peakBytesInUse, cache->stats.bytesInUse);
+  if (sizeClass < PACKET_ALLOCATOR_CLASSES && cache->freeList[sizeClass] != 0)
+    {
+      PacketAllocatorFreeBlock *block = cache->freeList[sizeClass];
+      cache->freeList[sizeClass] = block->next;
+      cache->stats.cachedBytes -= capacity;
+      cache->stats.hits++;
+      return block;
+    }
+  return ::operator new (capacity);
+}
+
+void
+PacketAllocator::Deallocate (void *buffer, uint32_t size)
+{
+  if (buffer == 0)
+    {
+      return;
+    }
+  struct PacketAllocatorCache *cache = GetPacketAllocatorCache ();
+  uint32_t sizeClass = GetSizeClass (size);
+  uint32_t capacity = GetCapacity (size);
+  cache->stats.bytesInUse -= capacity;
+  if (sizeClass < PACKET_ALLOCATOR_CLASSES
+      && cache->state == CACHE_INITIALIZED
+      && cache->stats.cachedBytes + capacity <= cache->maxCachedBytes)
+    {
+      PacketAllocatorFreeBlock *block = static_cast<PacketAllocatorFreeBlock *> (buffer);
+      block->next = cache->freeList[sizeClass];
+      cache->freeList[sizeClass] = block;
+      cache->stats.cachedBytes += capacity;
+      return;
+    }
+  ::operator delete (buffer);
+}
+
+struct PacketAllocator::Statistics
+PacketAllocator::GetStatistics (void)
+{
+  return g_packetAllocatorCache.stats;
+}
+
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PACKET_ALLOCATOR_H
+#define PACKET_ALLOCATOR_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief pool allocator for the storage of packet buffers and tags
+ *
+ * The byte buffers of Buffer, and the storage of PacketTagList and
+ * ByteTagList, are allocated and released at a very high rate. This
+ * allocator rounds allocation requests up to a power of two between 32
+ * bytes and 64KiB and keeps released blocks in one free list per size
+ * class so that they can be handed out again without going through the
+ * general-purpose allocator. Larger requests are not pooled.
+ *
+ * When the compiler supports thread-local storage, each thread has its
+ * own free lists and statistics and the allocator can be used
+ * concurrently from multiple threads. A block can be released by another
+ * thread than the one which allocated it. The number of bytes kept in the
+ * free lists of each thread is bounded by the
+ * "PacketAllocatorMaxCachedBytes" global value, which is read by each
+ * thread the first time it uses the allocator; extra blocks are returned
+ * to the system.
+ */
+class PacketAllocator
+{
+public:
+  /**
+   * Allocation statistics of a thread.
+   */
+  struct Statistics
+  {
+    /// number of blocks allocated
+    uint64_t allocations;
+    /// number of blocks allocated from the free lists
+    uint64_t hits;
+    /// number of bytes allocated and not yet released
+    int64_t bytesInUse;
+    /// largest value of bytesInUse
+    int64_t peakBytesInUse;
+    /// number of bytes held in the free lists
+    uint64_t cachedBytes;
+  };
+
+  /**
+   * \param size a number of bytes
+   * \returns the number of bytes usable in a block allocated for size bytes.
+   */
+  static uint32_t GetCapacity (uint32_t size);
+  /**
+   * \param size the number of bytes to allocate.
+   * \returns a block of GetCapacity (size) bytes.
+   */
+  static void *Allocate (uint32_t size);
+  /**
+   * \param buffer a block returned by Allocate.
+   * \param size the size requested when the block was allocated, or its
+   *        capacity.
+   */
+  static void Deallocate (void *buffer, uint32_t size);
+  /**
+   * \returns the statistics of the calling thread.
+   *
+   * When blocks are released by another thread than the one which
+   * allocated them, the bytes in use are accounted to the allocating
+   * thread and released from the releasing thread, so that only the sum
+   * of the bytesInUse fields of all threads is meaningful.
+   */
+  static struct Statistics GetStatistics (void);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_ALLOCATOR_H */
@@ -22,7 +22,11 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/thread-local.h"
 #include "packet-metadata.h"
+#include "packet-allocator.h"
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -34,19 +38,18 @@ namespace ns3 {
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
-
-PacketMetadata::DataFreeList::~DataFreeList ()
-{
-  NS_LOG_FUNCTION (this);
-  for (iterator i = begin (); i != end (); i++)
-    {
-      PacketMetadata::Deallocate (*i);
-    }
-  PacketMetadata::m_enable = false;
-}
+// the size of the largest metadata buffer and the uid of the next
+// item: each thread which creates packets keeps its own.
+static NS_THREAD_LOCAL uint32_t g_maxSize = 0;
+static NS_THREAD_LOCAL uint16_t g_chunkUid = 0;
+uint32_t PacketMetadata::m_samplingInterval = 1;
+
+static GlobalValue g_packetMetadataSamplingInterval =
+  GlobalValue ("PacketMetadataSamplingInterval",
+               "When packet metadata is enabled, record it for one packet "
+               "out of this number of packets.",
+               UintegerValue (1),
+               MakeUintegerChecker<uint32_t> (1));
 
 void 
 PacketMetadata::Enable (void)
@@ -59,9 +62,19 @@ PacketMetadata::Enable (void)
                  "after sending any packets.  One way to fix this problem is "
                  "to call ns3::PacketMetadata::Enable () near the beginning of"
                  " the program, before any packets are sent.");
+  UintegerValue interval;
+  g_packetMetadataSamplingInterval.GetValue (interval);
+  m_samplingInterval = interval.Get ();
   m_enable = true;
 }
 
+bool
+PacketMetadata::IsSampled (uint64_t uid)
+{
+  // the low 32 bits of the uid are the global packet uid.
+  return (uid & 0xffffffff) % m_samplingInterval == 0;
+}
+
 void 
 PacketMetadata::EnableChecking (void)
 {
@@ -582,48 +595,22 @@ struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
-  NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
-  if (size > m_maxSize)
+  NS_LOG_LOGIC ("create size="<<size<<", max="<<g_maxSize);
+  if (size > g_maxSize)
     {
-      m_maxSize = size;
-    }
-  while (!m_freeList.empty ()) 
-    {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
-      if (data->m_size >= size) 
-        {
-          NS_LOG_LOGIC ("create found size="<<data->m_size);
-          data->m_count = 1;
-          return data;
-        }
-      PacketMetadata::Deallocate (data);
-      NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
+      g_maxSize = size;
     }
-  NS_LOG_LOGIC ("create alloc size="<<m_maxSize);
-  return PacketMetadata::Allocate (m_maxSize);
+  NS_LOG_LOGIC ("create alloc size="<<g_maxSize);
+  return PacketMetadata::Allocate (g_maxSize);
 }
 
 void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
-    {
-      PacketMetadata::Deallocate (data);
-      return;
-    } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
+  NS_LOG_LOGIC ("recycle size="<<data->m_size);
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
-      data->m_size < m_maxSize) 
-    {
-      PacketMetadata::Deallocate (data);
-    } 
-  else 
-    {
-      m_freeList.push_back (data);
-    }
+  PacketMetadata::Deallocate (data);
 }
 
 struct PacketMetadata::Data *
@@ -636,9 +623,11 @@ PacketMetadata::Allocate (uint32_t n)
       n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
   size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-  uint8_t *buf = new uint8_t [size];
+  // the allocator may round the size up: make the extra bytes available.
+  uint32_t capacity = PacketAllocator::GetCapacity (size);
+  uint8_t *buf = static_cast<uint8_t *> (PacketAllocator::Allocate (size));
   struct PacketMetadata::Data *data = (struct PacketMetadata::Data *)buf;
-  data->m_size = n;
+  data->m_size = capacity - sizeof (struct Data) + PACKET_METADATA_DATA_M_DATA_SIZE;
   data->m_count = 1;
   data->m_dirtyEnd = 0;
   return data;
@@ -647,11 +636,19 @@ void
 PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  uint8_t *buf = (uint8_t *)data;
-  delete [] buf;
+  PacketAllocator::Deallocate (data, data->m_size + sizeof (struct Data) - PACKET_METADATA_DATA_M_DATA_SIZE);
 }
 
 
+PacketMetadata
+PacketMetadata::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  PacketMetadata copy = *this;
+  copy.ReserveCopy (0);
+  return copy;
+}
+
 PacketMetadata 
 PacketMetadata::CreateFragment (uint32_t start, uint32_t end) const
 {
@@ -675,9 +672,12 @@ void
 PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
 {
   NS_LOG_FUNCTION (this << uid << size);
-  if (!m_enable)
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
       return;
     }
 
@@ -686,8 +686,8 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   item.prev = 0xffff;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = g_chunkUid;
+  g_chunkUid++;
   uint16_t written = AddSmall (&item);
   UpdateHead (written);
 }
@@ -697,9 +697,12 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
   uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &header << size);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -745,9 +748,12 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable)
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -755,8 +761,8 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   item.prev = m_tail;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = g_chunkUid;
+  g_chunkUid++;
   uint16_t written = AddSmall (&item);
   UpdateTail (written);
   NS_ASSERT (IsStateOk ());
@@ -767,9 +773,12 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
   uint32_t uid = trailer.GetInstanceTypeId ().GetUid () << 1;
   NS_LOG_FUNCTION (this << &trailer << size);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
       return;
     }
   struct PacketMetadata::SmallItem item;
@@ -814,9 +823,21 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
 {
   NS_LOG_FUNCTION (this << &o);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
+      return;
+    }
+  if (!o.m_sampled)
+    {
+      // We know nothing about the content we append so we
+      // stop recording the metadata of this packet.
+      m_head = 0xffff;
+      m_tail = 0xffff;
+      m_sampled = false;
       return;
     }
   if (m_tail == 0xffff)
@@ -891,9 +912,12 @@ void
 PacketMetadata::AddPaddingAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
-  if (!m_enable)
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
       return;
     }
 }
@@ -902,9 +926,12 @@ PacketMetadata::RemoveAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
       return;
     }
   NS_ASSERT (m_data != 0);
@@ -934,6 +961,7 @@ PacketMetadata::RemoveAtStart (uint32_t start)
         {
           // fragment the list item.
           PacketMetadata fragment (m_packetUid, 0);
+          fragment.m_sampled = true;
           extraItem.fragmentStart += leftToRemove;
           leftToRemove = 0;
           uint16_t written = fragment.AddBig (0xffff, fragment.m_tail,
@@ -965,9 +993,12 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (IsStateOk ());
-  if (!m_enable) 
+  if (!m_sampled)
     {
-      m_metadataSkipped = true;
+      if (!m_enable)
+        {
+          m_metadataSkipped = true;
+        }
       return;
     }
   NS_ASSERT (m_data != 0);
@@ -998,6 +1029,7 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
         {
           // fragment the list item.
           PacketMetadata fragment (m_packetUid, 0);
+          fragment.m_sampled = true;
           NS_ASSERT (extraItem.fragmentEnd > leftToRemove);
           extraItem.fragmentEnd -= leftToRemove;
           leftToRemove = 0;
@@ -1151,13 +1183,13 @@ PacketMetadata::GetSerializedSize (void) const
   NS_LOG_FUNCTION (this);
   uint32_t totalSize = 0;
 
-  // add 8 bytes for the packet uid
-  totalSize += 8;
+  // add 8 bytes for the packet uid and 1 byte for the sampled flag
+  totalSize += 8 + 1;
 
-  // if packet-metadata not enabled, total size
-  // is simply 4-bytes for itself plus 8-bytes 
-  // for packet uid
-  if (!m_enable)
+  // if packet-metadata not enabled or if this packet
+  // is not sampled, total size is simply 4-bytes for
+  // itself plus 8-bytes for packet uid and the flag
+  if (!m_sampled)
     {
       return totalSize;
     }
@@ -1202,6 +1234,13 @@ PacketMetadata::Serialize (uint8_t* buffer, uint32_t maxSize) const
       return 0;
     }
 
+  // a sampled packet may have no items yet
+  buffer = AddToRawU8 (m_sampled ? 1 : 0, start, buffer, maxSize);
+  if (buffer == 0) 
+    {
+      return 0;
+    }
+
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t current = m_head;
@@ -1301,6 +1340,11 @@ PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
   buffer = ReadFromRawU64 (m_packetUid, start, buffer, size);
   desSize -= 8;
 
+  uint8_t sampled = 0;
+  buffer = ReadFromRawU8 (sampled, start, buffer, size);
+  desSize--;
+  m_sampled = sampled != 0;
+
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   while (desSize > 0)
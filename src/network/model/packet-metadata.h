@@ -75,6 +75,19 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * The byte buffers are allocated with the PacketAllocator, which
+ * recycles them through per-thread free lists.
+ *
+ * Because recording the metadata of every packet is costly, it can be
+ * recorded for only one packet out of N, where N is the value of the
+ * "PacketMetadataSamplingInterval" global value, read when Enable is
+ * called, so that the simulation threads only ever read the
+ * interval. The packets whose uid is
+ * not a multiple of N carry no metadata: printing them prints nothing.
+ * A sampled packet to which the content of a packet which is not sampled
+ * is appended stops being sampled, since its metadata would describe
+ * only part of its content.
  */
 class PacketMetadata 
 {
@@ -147,6 +160,11 @@ private:
    * and then, RemoveAtEnd (end).
    */
   PacketMetadata CreateFragment (uint32_t start, uint32_t end) const;
+  /**
+   * \returns a copy of this metadata which does not share its buffer
+   *          with it, and can thus be used from another thread.
+   */
+  PacketMetadata DeepCopy (void) const;
   void AddAtEnd (PacketMetadata const&o);
   void AddPaddingAtEnd (uint32_t end);
   void RemoveAtStart (uint32_t start);
@@ -292,13 +310,6 @@ private:
     uint64_t packetUid;
   };
 
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   friend class ItemIterator;
 
   PacketMetadata ();
@@ -334,8 +345,12 @@ public:
   static void Recycle (struct PacketMetadata::Data *data);
   static struct PacketMetadata::Data *Allocate (uint32_t n);
   static void Deallocate (struct PacketMetadata::Data *data);
+  /**
+   * \param uid the uid of a packet
+   * \returns true if the metadata of this packet must be recorded.
+   */
+  static bool IsSampled (uint64_t uid);
 
-  static DataFreeList m_freeList;
   static bool m_enable;
   static bool m_enableChecking;
 
@@ -344,8 +359,9 @@ public:
   // middle of a simulation, which isn't allowed.
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize;
-  static uint16_t m_chunkUid;
+  // one packet out of m_samplingInterval is sampled; set by Enable
+  // from the PacketMetadataSamplingInterval global value.
+  static uint32_t m_samplingInterval;
 
   struct Data *m_data;
   /**
@@ -356,6 +372,8 @@ public:
   uint16_t m_head;
   uint16_t m_tail;
   uint16_t m_used;
+  // true if the metadata of this packet is recorded.
+  bool m_sampled;
   uint64_t m_packetUid;
 };
 
@@ -368,6 +386,7 @@ PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
     m_head (0xffff),
     m_tail (0xffff),
     m_used (0),
+    m_sampled (m_enable && IsSampled (uid)),
     m_packetUid (uid)
 {
   memset (m_data->m_data, 0xff, 4);
@@ -381,6 +400,7 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
     m_head (o.m_head),
     m_tail (o.m_tail),
     m_used (o.m_used),
+    m_sampled (o.m_sampled),
     m_packetUid (o.m_packetUid)
 {
   NS_ASSERT (m_data != 0);
@@ -406,6 +426,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
   m_head = o.m_head;
   m_tail = o.m_tail;
   m_used = o.m_used;
+  m_sampled = o.m_sampled;
   m_packetUid = o.m_packetUid;
   return *this;
 }
@@ -58,15 +58,18 @@ public:
 
   const struct PacketTagList::TagData *Head (void) const;
 
+  /**
+   * \returns a copy of this list which does not share any tag with it,
+   *          and can thus be used from another thread.
+   */
+  PacketTagList DeepCopy (void) const;
+
 private:
 
   bool Remove (TypeId tid);
   struct PacketTagList::TagData *AllocData (void) const;
   void FreeData (struct TagData *data) const;
 
-  static struct PacketTagList::TagData *g_free;
-  static uint32_t g_nfree;
-
   struct TagData *m_next;
 };
 
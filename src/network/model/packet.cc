@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/thread-local.h"
 #include <string>
 #include <cstdarg>
 
@@ -30,6 +31,34 @@ namespace ns3 {
 
 uint32_t Packet::m_globalUid = 0;
 
+// the sequence of uids of the calling thread, see Packet::SetUidStream.
+static NS_THREAD_LOCAL uint32_t g_packetUidStream = 0;
+static NS_THREAD_LOCAL uint32_t g_packetUidNext = 0;
+
+uint64_t
+Packet::AllocateUid (void)
+{
+  if (g_packetUidStream == 0)
+    {
+      return static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++;
+    }
+  return static_cast<uint64_t> (g_packetUidStream) << 32 | g_packetUidNext++;
+}
+
+void
+Packet::SetUidStream (uint32_t stream, uint32_t next)
+{
+  NS_LOG_FUNCTION (stream << next);
+  g_packetUidStream = stream;
+  g_packetUidNext = next;
+}
+
+uint32_t
+Packet::GetUidStreamNext (void)
+{
+  return g_packetUidNext;
+}
+
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
 {
@@ -137,6 +166,21 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::DeepCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Packet> copy = Ptr<Packet> (new Packet (m_buffer.DeepCopy (),
+                                              m_byteTagList.DeepCopy (),
+                                              m_packetTagList.DeepCopy (),
+                                              m_metadata.DeepCopy ()), false);
+  if (m_nixVector)
+    {
+      copy->m_nixVector = m_nixVector->Copy ();
+    }
+  return copy;
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -147,11 +191,10 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (AllocateUid (), 0),
     m_nixVector (0)
 {
   NS_LOG_FUNCTION (this);
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -190,11 +233,10 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
   NS_LOG_FUNCTION (this << size);
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -218,16 +260,31 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (AllocateUid (), size),
     m_nixVector (0)
 {
   NS_LOG_FUNCTION (this << &buffer << size);
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
 }
 
+Packet::Packet (Ptr<const SharedPayload> payload)
+  : m_buffer (payload),
+    m_byteTagList (),
+    m_packetTagList (),
+    /* The upper 32 bits of the packet id in 
+     * metadata is for the system id. For non-
+     * distributed simulations, this is simply 
+     * zero.  The lower 32 bits are for the 
+     * global UID
+     */
+    m_metadata (AllocateUid (), payload->GetSize ()),
+    m_nixVector (0)
+{
+  NS_LOG_FUNCTION (this << payload);
+}
+
 Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList, 
                 const PacketTagList &packetTagList, const PacketMetadata &metadata)
   : m_buffer (buffer),
@@ -242,6 +242,17 @@ public:
    * \param size the size of the input buffer.
    */
   Packet (uint8_t const*buffer, uint32_t size);
+  /**
+   * Create a packet whose payload is the content of this shared
+   * payload. The payload bytes are not copied: like the zero-filled
+   * payload of Packet (uint32_t), they are referenced by the packet
+   * and its copies and fragments until they need to be made contiguous
+   * with the headers of the packet, for example by PeekData. The
+   * packet is allocated with a new uid (as returned by getUid).
+   *
+   * \param payload the payload of the packet.
+   */
+  Packet (Ptr<const SharedPayload> payload);
   /**
    * Create a new packet which contains a fragment of the original
    * packet. The returned packet shares the same uid as this packet.
@@ -374,6 +385,17 @@ public:
    */
   Ptr<Packet> Copy (void) const;
 
+  /**
+   * \returns a copy of the packet which does not share any state with it.
+   *
+   * The packets returned by Copy share their buffers and tags with the
+   * original packet through reference counts which are not thread-safe.
+   * This method copies all of them right away so that the copy can be
+   * handed to another thread, at the cost of copying the packet bytes.
+   * The copy keeps the uid of the original packet.
+   */
+  Ptr<Packet> DeepCopy (void) const;
+
   /**
    * A packet is allocated a new uid when it is created
    * empty or with zero-filled payload.
@@ -431,6 +453,24 @@ public:
    */
   static void EnableChecking (void);
 
+  /**
+   * \param stream zero for the default sequence of uids, otherwise the
+   *        upper 32 bits of the uids of the packets created by the
+   *        calling thread from now on.
+   * \param next the lower 32 bits of the next uid of that sequence.
+   *
+   * By default, all the packets take their uid from a single sequence.
+   * The threads of a parallel simulator give their own sequence to the
+   * packets they create, so that the uids do not depend on how the
+   * threads are scheduled.
+   */
+  static void SetUidStream (uint32_t stream, uint32_t next);
+  /**
+   * \returns the lower 32 bits of the next uid of the sequence which
+   *          was set with SetUidStream by the calling thread.
+   */
+  static uint32_t GetUidStreamNext (void);
+
   /**
    * For packet serializtion, the total size is checked 
    * in order to determine the size of the buffer 
@@ -558,6 +598,10 @@ private:
           const PacketTagList &packetTagList, const PacketMetadata &metadata);
 
   uint32_t Deserialize (uint8_t const*buffer, uint32_t size);
+  /**
+   * \returns the uid of a new packet.
+   */
+  static uint64_t AllocateUid (void);
 
   Buffer m_buffer;
   ByteTagList m_byteTagList;
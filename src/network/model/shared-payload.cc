@@ -0,0 +1,46 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "shared-payload.h"
+#include "ns3/log.h"
+#include <cstring>
+
+NS_LOG_COMPONENT_DEFINE ("SharedPayload");
+
+namespace ns3 {
+
+SharedPayload::SharedPayload (uint8_t const *buffer, uint32_t size)
+  : m_data (new uint8_t [size]),
+    m_size (size)
+{
+  NS_LOG_FUNCTION (this << &buffer << size);
+  std::memcpy (m_data, buffer, size);
+}
+
+SharedPayload::SharedPayload (uint8_t fill, uint32_t size)
+  : m_data (new uint8_t [size]),
+    m_size (size)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (fill) << size);
+  std::memset (m_data, fill, size);
+}
+
+SharedPayload::~SharedPayload ()
+{
+  NS_LOG_FUNCTION (this);
+  delete [] m_data;
+}
+
+} // namespace ns3
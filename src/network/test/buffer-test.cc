@@ -2,6 +2,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
+#include <sstream>
 
 using namespace ns3;
 
@@ -323,6 +324,85 @@ BufferTest::DoRun (void)
   free (cBuf);
 }
 //-----------------------------------------------------------------------------
+class SharedPayloadBufferTest : public TestCase {
+public:
+  virtual void DoRun (void);
+  SharedPayloadBufferTest ();
+};
+
+SharedPayloadBufferTest::SharedPayloadBufferTest ()
+  : TestCase ("Buffer backed by a SharedPayload") {
+}
+
+void
+SharedPayloadBufferTest::DoRun (void)
+{
+  uint8_t bytes[1000];
+  for (uint32_t i = 0; i < sizeof (bytes); i++)
+    {
+      bytes[i] = i * 7 + 1;
+    }
+  Ptr<SharedPayload> payload = Create<SharedPayload> (bytes, sizeof (bytes));
+
+  // headers and trailers surround the shared bytes.
+  Buffer buffer (payload);
+  buffer.AddAtStart (4);
+  buffer.Begin ().WriteHtonU32 (0xdeadbeef);
+  buffer.AddAtEnd (2);
+  Buffer::Iterator i = buffer.End ();
+  i.Prev (2);
+  i.WriteU8 (0x55, 2);
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 1006, "wrong size");
+  i = buffer.Begin ();
+  NS_TEST_ASSERT_MSG_EQ (i.ReadNtohU32 (), 0xdeadbeef, "header corrupted");
+  for (uint32_t j = 0; j < sizeof (bytes); j++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((uint32_t)i.ReadU8 (), (uint32_t)bytes[j], "wrong payload byte " << j);
+    }
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t)i.ReadU8 (), 0x55, "trailer corrupted");
+
+  // the payload is materialized when copied out.
+  uint8_t out[1006];
+  NS_TEST_ASSERT_MSG_EQ (buffer.CopyData (out, sizeof (out)), 1006, "wrong copy size");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (out + 4, bytes, sizeof (bytes)), 0, "wrong copied payload");
+  std::ostringstream os;
+  buffer.CopyData (&os, 1006);
+  NS_TEST_ASSERT_MSG_EQ (memcmp (os.str ().c_str () + 4, bytes, sizeof (bytes)), 0, "wrong streamed payload");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (buffer.CreateFullCopy ().PeekData (), out, sizeof (out)), 0,
+                         "wrong full copy");
+
+  // fragments see the right part of the payload and adjacent fragments
+  // can be concatenated again.
+  Buffer first = buffer.CreateFragment (0, 504);
+  Buffer second = buffer.CreateFragment (504, 502);
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t)second.Begin ().ReadU8 (), (uint32_t)bytes[500], "wrong fragment start");
+  first.AddAtEnd (second);
+  NS_TEST_ASSERT_MSG_EQ (first.GetSize (), 1006, "wrong reassembled size");
+  NS_TEST_ASSERT_MSG_EQ (first.CopyData (out, sizeof (out)), 1006, "wrong copy size");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (out + 4, bytes, sizeof (bytes)), 0, "wrong reassembled payload");
+
+  // non-adjacent payloads are concatenated by copying them.
+  Buffer a (payload);
+  a.RemoveAtEnd (900);
+  Buffer b (payload);
+  a.AddAtEnd (b);
+  NS_TEST_ASSERT_MSG_EQ (a.GetSize (), 1100, "wrong concatenated size");
+  i = a.Begin ();
+  i.Next (100);
+  NS_TEST_ASSERT_MSG_EQ ((uint32_t)i.ReadU8 (), (uint32_t)bytes[0], "wrong concatenated payload");
+
+  // serialization writes the payload bytes.
+  std::vector<uint8_t> serialized (buffer.GetSerializedSize ());
+  NS_TEST_ASSERT_MSG_EQ (buffer.Serialize (&serialized[0], serialized.size ()), 1, "serialization failed");
+  Buffer deserialized;
+  // the size given to Deserialize accounts for the length field
+  // written by Packet::Serialize in front of the buffer.
+  deserialized.Deserialize (&serialized[0], serialized.size () + 4);
+  NS_TEST_ASSERT_MSG_EQ (deserialized.GetSize (), 1006, "wrong deserialized size");
+  NS_TEST_ASSERT_MSG_EQ (memcmp (deserialized.PeekData () + 4, bytes, sizeof (bytes)), 0,
+                         "wrong deserialized payload");
+}
+//-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -333,6 +413,7 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest);
+  AddTestCase (new SharedPayloadBufferTest);
 }
 
 static BufferTestSuite g_bufferTestSuite;
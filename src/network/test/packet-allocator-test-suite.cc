@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/packet-allocator.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class PacketAllocatorTestCase : public TestCase
+{
+public:
+  PacketAllocatorTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+PacketAllocatorTestCase::PacketAllocatorTestCase ()
+  : TestCase ("Check the size classes, reuse and statistics of the packet allocator")
+{
+}
+
+void
+PacketAllocatorTestCase::DoRun (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetCapacity (1), 32, "smallest size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetCapacity (32), 32, "exact size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetCapacity (33), 64, "rounded up");
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetCapacity (1500), 2048, "rounded up");
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetCapacity (65536), 65536, "largest size class");
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetCapacity (65537), 65537, "not pooled");
+
+  struct PacketAllocator::Statistics before = PacketAllocator::GetStatistics ();
+  void *a = PacketAllocator::Allocate (1000);
+  struct PacketAllocator::Statistics stats = PacketAllocator::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (stats.allocations, before.allocations + 1, "allocation not counted");
+  NS_TEST_EXPECT_MSG_EQ (stats.bytesInUse, before.bytesInUse + 1024, "capacity not accounted");
+  NS_TEST_EXPECT_MSG_GT (stats.peakBytesInUse, stats.bytesInUse - 1, "peak below current");
+
+  // a released block is handed out again for any size of the same class.
+  PacketAllocator::Deallocate (a, 1000);
+  stats = PacketAllocator::GetStatistics ();
+  NS_TEST_EXPECT_MSG_EQ (stats.bytesInUse, before.bytesInUse, "release not accounted");
+  NS_TEST_EXPECT_MSG_GT (stats.cachedBytes, 1023, "block not cached");
+  void *b = PacketAllocator::Allocate (600);
+  NS_TEST_EXPECT_MSG_EQ (a, b, "cached block not reused");
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetStatistics ().hits, stats.hits + 1, "hit not counted");
+  PacketAllocator::Deallocate (b, 600);
+
+  // blocks beyond the largest class are never cached.
+  stats = PacketAllocator::GetStatistics ();
+  void *c = PacketAllocator::Allocate (100000);
+  PacketAllocator::Deallocate (c, 100000);
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetStatistics ().cachedBytes, stats.cachedBytes, "large block cached");
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetStatistics ().hits, stats.hits, "large block hit");
+
+  // packets draw their buffers and tags from the allocator and give them
+  // back when they are destroyed.
+  stats = PacketAllocator::GetStatistics ();
+  {
+    Ptr<Packet> p = Create<Packet> (1000);
+    p->AddPaddingAtEnd (100);
+    Ptr<Packet> copy = p->Copy ();
+    copy->AddAtEnd (p);
+  }
+  struct PacketAllocator::Statistics after = PacketAllocator::GetStatistics ();
+  NS_TEST_EXPECT_MSG_GT (after.allocations, stats.allocations, "packet buffers not pooled");
+  NS_TEST_EXPECT_MSG_EQ (after.bytesInUse, stats.bytesInUse, "packet buffers leaked");
+}
+
+class PacketAllocatorTestSuite : public TestSuite
+{
+public:
+  PacketAllocatorTestSuite ();
+};
+
+PacketAllocatorTestSuite::PacketAllocatorTestSuite ()
+  : TestSuite ("packet-allocator", UNIT)
+{
+  AddTestCase (new PacketAllocatorTestCase);
+}
+
+static PacketAllocatorTestSuite g_packetAllocatorTestSuite;
@@ -25,6 +25,8 @@
 #include "ns3/trailer.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -820,6 +822,89 @@ PacketMetadataTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (msg, std::string ("hello world"), "Could not find original data in received packet");
 }
 //-----------------------------------------------------------------------------
+class PacketMetadataSamplingTest : public TestCase {
+public:
+  PacketMetadataSamplingTest ();
+  virtual void DoRun (void);
+};
+
+PacketMetadataSamplingTest::PacketMetadataSamplingTest ()
+  : TestCase ("Packet metadata sampling")
+{
+}
+
+void
+PacketMetadataSamplingTest::DoRun (void)
+{
+  GlobalValue::Bind ("PacketMetadataSamplingInterval", UintegerValue (4));
+  PacketMetadata::Enable ();
+
+  Ptr<Packet> sampled;
+  Ptr<Packet> notSampled;
+  uint32_t nSampled = 0;
+  for (uint32_t i = 0; i < 16; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (10);
+      p->AddHeader (HistoryHeader<5> ());
+      if (p->BeginItem ().HasNext ())
+        {
+          nSampled++;
+          sampled = p;
+        }
+      else
+        {
+          notSampled = p;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (nSampled, 4, "one packet out of four should be sampled");
+
+  // sampled packets keep their complete metadata.
+  HistoryTrailer<3> trailer;
+  sampled->AddTrailer (trailer);
+  Ptr<Packet> fragment = sampled->CreateFragment (2, 14);
+  PacketMetadata::ItemIterator k = fragment->BeginItem ();
+  uint32_t sizes[] = { 3, 10, 1 };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (k.HasNext (), true, "missing item");
+      NS_TEST_EXPECT_MSG_EQ (k.Next ().currentSize, sizes[i], "wrong item size");
+    }
+  NS_TEST_EXPECT_MSG_EQ (k.HasNext (), false, "unexpected item");
+  sampled->RemoveTrailer (trailer);
+
+  // the others can still be manipulated.
+  notSampled->AddTrailer (trailer);
+  notSampled->RemoveAtStart (7);
+  notSampled->RemoveAtEnd (4);
+  NS_TEST_EXPECT_MSG_EQ (notSampled->GetSize (), 7, "wrong size");
+  NS_TEST_EXPECT_MSG_EQ (notSampled->BeginItem ().HasNext (), false, "unexpected metadata");
+
+  // appending a packet which is not sampled drops the metadata.
+  sampled->AddAtEnd (notSampled);
+  NS_TEST_EXPECT_MSG_EQ (sampled->BeginItem ().HasNext (), false, "partial metadata kept");
+  sampled->RemoveAtStart (20);
+  NS_TEST_EXPECT_MSG_EQ (sampled->GetSize (), 2, "wrong size");
+  sampled->AddHeader (HistoryHeader<5> ());
+  NS_TEST_EXPECT_MSG_EQ (sampled->BeginItem ().HasNext (), false, "metadata recorded again");
+
+  // a sampled packet without any item stays sampled once deserialized.
+  Ptr<Packet> empty = Create<Packet> ();
+  while (empty->GetUid () % 4 != 0)
+    {
+      empty = Create<Packet> ();
+    }
+  uint32_t size = empty->GetSerializedSize ();
+  uint8_t *buffer = new uint8_t[size];
+  empty->Serialize (buffer, size);
+  Ptr<Packet> deserialized = Create<Packet> (buffer, size, true);
+  delete [] buffer;
+  deserialized->AddHeader (HistoryHeader<5> ());
+  NS_TEST_EXPECT_MSG_EQ (deserialized->BeginItem ().HasNext (), true, "sampled flag lost");
+
+  GlobalValue::Bind ("PacketMetadataSamplingInterval", UintegerValue (1));
+  PacketMetadata::Enable ();
+}
+//-----------------------------------------------------------------------------
 class PacketMetadataTestSuite : public TestSuite
 {
 public:
@@ -830,6 +915,7 @@ PacketMetadataTestSuite::PacketMetadataTestSuite ()
   : TestSuite ("packet-metadata", UNIT)
 {
   AddTestCase (new PacketMetadataTest);
+  AddTestCase (new PacketMetadataSamplingTest);
 }
 
 PacketMetadataTestSuite g_packetMetadataTest;
@@ -21,6 +21,7 @@
 #include "ns3/test.h"
 #include <string>
 #include <cstdarg>
+#include <cstring>
 
 using namespace ns3;
 
@@ -434,6 +435,36 @@ PacketTest::DoRun (void)
     CHECK (tmp, 1, E (20, 1, 1001));
 #endif
   }
+
+  {
+    Ptr<Packet> tmp = Create<Packet> (reinterpret_cast<const uint8_t*> ("hello"), 5);
+    tmp->AddHeader (ATestHeader<2> ());
+    tmp->AddByteTag (ATestTag<20> ());
+    ATestTag<10> a;
+    tmp->AddPacketTag (a);
+    Ptr<Packet> deep = tmp->DeepCopy ();
+    CHECK (deep, 1, E (20, 0, 7));
+    NS_TEST_EXPECT_MSG_EQ (deep->GetUid (), tmp->GetUid (), "trivial");
+    NS_TEST_EXPECT_MSG_EQ (deep->PeekPacketTag (a), true, "trivial");
+    uint8_t expected[7];
+    uint8_t copied[7];
+    tmp->CopyData (expected, 7);
+    deep->CopyData (copied, 7);
+    NS_TEST_EXPECT_MSG_EQ (memcmp (expected, copied, 7), 0, "trivial");
+    deep->RemovePacketTag (a);
+    ATestHeader<2> header;
+    deep->RemoveHeader (header);
+    NS_TEST_EXPECT_MSG_EQ (deep->GetSize (), 5, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (tmp->GetSize (), 7, "trivial");
+    NS_TEST_EXPECT_MSG_EQ (tmp->PeekPacketTag (a), true, "trivial");
+
+    Ptr<Packet> shared = Create<Packet> (Create<SharedPayload> ((uint8_t) 0x42, 100));
+    shared->RemoveAtStart (10);
+    Ptr<Packet> sharedCopy = shared->DeepCopy ();
+    NS_TEST_EXPECT_MSG_EQ (sharedCopy->GetSize (), 90, "trivial");
+    sharedCopy->CopyData (copied, 1);
+    NS_TEST_EXPECT_MSG_EQ ((uint32_t)copied[0], 0x42, "trivial");
+  }
 }
 //-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
@@ -20,10 +20,13 @@
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
+#include <fstream>
 #include <cstring>
 
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
 
 using namespace ns3;
 
@@ -1101,6 +1104,121 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that the write buffer and the writer thread do not
+// change the content of the file
+// ===========================================================================
+class WriteBufferTestHeader : public Header
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::WriteBufferTestHeader")
+      .SetParent<Header> ()
+      .AddConstructor<WriteBufferTestHeader> ()
+    ;
+    return tid;
+  }
+  virtual TypeId GetInstanceTypeId (void) const
+  {
+    return GetTypeId ();
+  }
+  virtual void Print (std::ostream &os) const
+  {
+  }
+  virtual uint32_t GetSerializedSize (void) const
+  {
+    return 20;
+  }
+  virtual void Serialize (Buffer::Iterator start) const
+  {
+    for (uint8_t i = 0; i < 20; i++)
+      {
+        start.WriteU8 (0xa0 + i);
+      }
+  }
+  virtual uint32_t Deserialize (Buffer::Iterator start)
+  {
+    return 20;
+  }
+};
+
+class WriteBufferTestCase : public TestCase
+{
+public:
+  WriteBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  std::string WriteFile (std::string name, uint32_t bufferSize, bool async, uint32_t maxBuffers);
+  std::string ReadFile (std::string filename);
+};
+
+WriteBufferTestCase::WriteBufferTestCase ()
+  : TestCase ("Check that buffered and threaded writes give the same file")
+{
+}
+
+std::string
+WriteBufferTestCase::WriteFile (std::string name, uint32_t bufferSize, bool async, uint32_t maxBuffers)
+{
+  std::string filename = CreateTempDirFilename (name);
+  PcapFile f;
+  f.Open (filename, std::ios::out);
+  f.SetWriteBufferSize (bufferSize);
+  f.SetAsyncWrite (async, maxBuffers);
+  f.Init (1, 100);
+
+  uint8_t data[300];
+  for (uint32_t i = 0; i < sizeof (data); i++)
+    {
+      data[i] = i;
+    }
+  WriteBufferTestHeader header;
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      // Some records are truncated by the snapshot length, some within the
+      // header
+      uint32_t size = (i * 37) % sizeof (data);
+      switch (i % 3)
+        {
+        case 0:
+          f.Write (i, 0, data, size);
+          break;
+        case 1:
+          f.Write (i, 1, Create<Packet> (data, size));
+          break;
+        default:
+          f.Write (i, 2, header, Create<Packet> (data, size));
+          break;
+        }
+    }
+  f.Close ();
+  return filename;
+}
+
+std::string
+WriteBufferTestCase::ReadFile (std::string filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf ();
+  return content.str ();
+}
+
+void
+WriteBufferTestCase::DoRun (void)
+{
+  std::string expected = ReadFile (WriteFile ("unbuffered.pcap", 0, false, 1));
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 100000, "the file is too small");
+  NS_TEST_EXPECT_MSG_EQ ((ReadFile (WriteFile ("buffered.pcap", 1000, false, 1)) == expected), true,
+                         "the write buffer changed the file");
+  NS_TEST_EXPECT_MSG_EQ ((ReadFile (WriteFile ("async.pcap", 1000, true, 8)) == expected), true,
+                         "the writer thread changed the file");
+  NS_TEST_EXPECT_MSG_EQ ((ReadFile (WriteFile ("async-small.pcap", 50, true, 1)) == expected), true,
+                         "the writer thread changed the file");
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1118,6 +1236,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase);
   AddTestCase (new ReadFileTestCase);
   AddTestCase (new DiffTestCase);
+  AddTestCase (new WriteBufferTestCase);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "ns3/fatal-error.h"
+#include "pcap-file-async-writer.h"
+
+namespace ns3 {
+
+PcapFileAsyncWriter::PcapFileAsyncWriter (std::ostream *file, uint32_t maxBuffers)
+  : m_file (file),
+    m_maxBuffers (std::max<uint32_t> (maxBuffers, 1)),
+    m_writing (false),
+    m_stop (false)
+{
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_cond_init (&m_ready, 0);
+  pthread_cond_init (&m_written, 0);
+  int rc = pthread_create (&m_thread, 0, &PcapFileAsyncWriter::Run, this);
+  if (rc != 0)
+    {
+      NS_FATAL_ERROR ("PcapFileAsyncWriter: cannot create the writer thread: " << std::strerror (rc));
+    }
+}
+
+PcapFileAsyncWriter::~PcapFileAsyncWriter ()
+{
+  pthread_mutex_lock (&m_mutex);
+  m_stop = true;
+  pthread_cond_signal (&m_ready);
+  pthread_mutex_unlock (&m_mutex);
+  pthread_join (m_thread, 0);
+  pthread_cond_destroy (&m_written);
+  pthread_cond_destroy (&m_ready);
+  pthread_mutex_destroy (&m_mutex);
+}
+
+void
+PcapFileAsyncWriter::Push (std::vector<uint8_t> &buffer, uint32_t size)
+{
+  pthread_mutex_lock (&m_mutex);
+  while (m_blocks.size () >= m_maxBuffers)
+    {
+      pthread_cond_wait (&m_written, &m_mutex);
+    }
+  m_blocks.push_back (Block ());
+  m_blocks.back ().data.swap (buffer);
+  m_blocks.back ().size = size;
+  if (!m_free.empty ())
+    {
+      buffer.swap (m_free.back ());
+      m_free.pop_back ();
+    }
+  pthread_cond_signal (&m_ready);
+  pthread_mutex_unlock (&m_mutex);
+}
+
+void
+PcapFileAsyncWriter::Drain (void)
+{
+  pthread_mutex_lock (&m_mutex);
+  while (!m_blocks.empty () || m_writing)
+    {
+      pthread_cond_wait (&m_written, &m_mutex);
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+
+void *
+PcapFileAsyncWriter::Run (void *writer)
+{
+  static_cast<PcapFileAsyncWriter *> (writer)->DoRun ();
+  return 0;
+}
+
+void
+PcapFileAsyncWriter::DoRun (void)
+{
+  Block block;
+  pthread_mutex_lock (&m_mutex);
+  for (;;)
+    {
+      while (m_blocks.empty () && !m_stop)
+        {
+          pthread_cond_wait (&m_ready, &m_mutex);
+        }
+      if (m_blocks.empty ())
+        {
+          // m_stop is set and everything is written
+          break;
+        }
+      block.data.swap (m_blocks.front ().data);
+      block.size = m_blocks.front ().size;
+      m_blocks.pop_front ();
+      m_writing = true;
+      pthread_mutex_unlock (&m_mutex);
+
+      m_file->write ((const char *)&block.data[0], block.size);
+
+      pthread_mutex_lock (&m_mutex);
+      m_free.push_back (std::vector<uint8_t> ());
+      m_free.back ().swap (block.data);
+      m_writing = false;
+      // Push waits for room in the queue and Drain for an empty queue
+      pthread_cond_broadcast (&m_written);
+    }
+  pthread_mutex_unlock (&m_mutex);
+}
+
+} // namespace ns3
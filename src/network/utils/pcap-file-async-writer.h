@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_FILE_ASYNC_WRITER_H
+#define PCAP_FILE_ASYNC_WRITER_H
+
+#include <ostream>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+#include <pthread.h>
+
+namespace ns3 {
+
+/*
+ * Writes the full buffers of a PcapFile to its stream from a separate
+ * thread.  The simulation thread blocks only when the thread has
+ * maxBuffers buffers left to write.
+ *
+ * Like PcapFile, this class is used by the test framework, so it relies
+ * on pthreads directly rather than on the ns-3 thread classes.
+ */
+class PcapFileAsyncWriter
+{
+public:
+  PcapFileAsyncWriter (std::ostream *file, uint32_t maxBuffers);
+  ~PcapFileAsyncWriter ();
+  /*
+   * Take the first size bytes of buffer, which is swapped with a buffer
+   * already written, or with an empty one
+   */
+  void Push (std::vector<uint8_t> &buffer, uint32_t size);
+  /*
+   * Wait until all the buffers are written
+   */
+  void Drain (void);
+
+private:
+  struct Block
+  {
+    Block () : size (0) {}
+    std::vector<uint8_t> data;
+    uint32_t size;
+  };
+  static void *Run (void *writer);
+  void DoRun (void);
+
+  std::ostream *m_file;
+  uint32_t m_maxBuffers;
+  std::deque<Block> m_blocks;
+  std::vector<std::vector<uint8_t> > m_free;
+  bool m_writing;
+  bool m_stop;
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_ready;   // a block was queued, or m_stop was set
+  pthread_cond_t m_written; // a block was written
+  pthread_t m_thread;
+};
+
+} // namespace ns3
+
+#endif /* PCAP_FILE_ASYNC_WRITER_H */
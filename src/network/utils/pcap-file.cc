@@ -20,6 +20,7 @@
 
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 #include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
@@ -28,6 +29,10 @@
 #include "ns3/buffer.h"
 #include "pcap-file.h"
 #include "ns3/log.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "pcap-file-async-writer.h"
+#endif
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
 // adding any ns-3 specific constructs such as Packet to this file.
@@ -46,10 +51,14 @@ const uint32_t NS_SWAPPED_MAGIC = 0xd43cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 const int32_t  SIGFIGS_DEFAULT = 0;           /**< Significant figures for timestamps (libpcap doesn't even bother) */
+const uint32_t RECORD_HEADER_SIZE = 16;       /**< Size of a record header in the file */
 
 PcapFile::PcapFile ()
   : m_file (),
-    m_swapMode (false)
+    m_swapMode (false),
+    m_writeBufferUsed (0),
+    m_writeBufferSize (0),
+    m_asyncWriter (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file);
@@ -87,9 +96,81 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  SetAsyncWrite (false);
+  WriteBuffer ();
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBufferSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  WriteBuffer ();
+  m_writeBufferSize = size;
+  std::vector<uint8_t> (size).swap (m_writeBuffer);
+}
+
+void
+PcapFile::SetAsyncWrite (bool enable, uint32_t maxBuffers)
+{
+  NS_LOG_FUNCTION (this << enable << maxBuffers);
+#ifdef HAVE_PTHREAD_H
+  if (enable && m_asyncWriter == 0)
+    {
+      WriteBuffer ();
+      m_asyncWriter = new PcapFileAsyncWriter (&m_file, maxBuffers);
+    }
+  else if (!enable && m_asyncWriter != 0)
+    {
+      WriteBuffer ();
+      delete m_asyncWriter;
+      m_asyncWriter = 0;
+    }
+#else
+  if (enable)
+    {
+      NS_LOG_WARN ("No thread support, the records are written synchronously");
+    }
+#endif
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  WriteBuffer ();
+#ifdef HAVE_PTHREAD_H
+  if (m_asyncWriter != 0)
+    {
+      m_asyncWriter->Drain ();
+    }
+#endif
+  m_file.flush ();
+}
+
+void
+PcapFile::WriteBuffer (void)
+{
+  if (m_writeBufferUsed == 0)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_asyncWriter != 0)
+    {
+      m_asyncWriter->Push (m_writeBuffer, m_writeBufferUsed);
+      m_writeBufferUsed = 0;
+      if (m_writeBuffer.size () < m_writeBufferSize)
+        {
+          m_writeBuffer.resize (m_writeBufferSize);
+        }
+      return;
+    }
+#endif
+  m_file.write ((const char *)&m_writeBuffer[0], m_writeBufferUsed);
+  m_writeBufferUsed = 0;
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -198,6 +279,7 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
+  Flush ();
   m_file.seekp (0, std::ios::beg);
  
   //
@@ -371,13 +453,13 @@ PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrect
   WriteFileHeader ();
 }
 
-uint32_t
-PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
+uint8_t *
+PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t &inclLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (m_asyncWriter != 0 || m_file.good ());
 
-  uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+  inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
   PcapRecordHeader header;
   header.m_tsSec = tsSec;
@@ -390,31 +472,60 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
       Swap (&header, &header);
     }
 
+  //
+  // The whole record is gathered in the write buffer, so that it reaches the
+  // file in one write, or in a batch of records.
+  //
+  uint32_t recordSize = RECORD_HEADER_SIZE + inclLen;
+  if (m_writeBufferUsed + recordSize > m_writeBufferSize)
+    {
+      WriteBuffer ();
+    }
+  if (m_writeBuffer.size () < m_writeBufferUsed + recordSize)
+    {
+      m_writeBuffer.resize (m_writeBufferUsed + recordSize);
+    }
+  uint8_t *buffer = &m_writeBuffer[m_writeBufferUsed];
+  m_writeBufferUsed += recordSize;
+
   //
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  return inclLen;
+  std::memcpy (buffer, &header.m_tsSec, sizeof(header.m_tsSec));
+  std::memcpy (buffer + 4, &header.m_tsUsec, sizeof(header.m_tsUsec));
+  std::memcpy (buffer + 8, &header.m_inclLen, sizeof(header.m_inclLen));
+  std::memcpy (buffer + 12, &header.m_origLen, sizeof(header.m_origLen));
+  return buffer + RECORD_HEADER_SIZE;
+}
+
+void
+PcapFile::EndRecord (void)
+{
+  if (m_writeBufferUsed >= m_writeBufferSize)
+    {
+      WriteBuffer ();
+    }
 }
 
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
-  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
+  uint32_t inclLen;
+  uint8_t *buffer = WritePacketHeader (tsSec, tsUsec, totalLen, inclLen);
+  std::memcpy (buffer, data, inclLen);
+  EndRecord ();
 }
 
 void 
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
-  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
+  uint32_t inclLen;
+  uint8_t *buffer = WritePacketHeader (tsSec, tsUsec, p->GetSize (), inclLen);
+  p->CopyData (buffer, inclLen);
+  EndRecord ();
 }
 
 void 
@@ -423,15 +534,22 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Header &header, Ptr<const Pack
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &header << p);
   uint32_t headerSize = header.GetSerializedSize ();
   uint32_t totalSize = headerSize + p->GetSize ();
-  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
+  uint32_t inclLen;
+  uint8_t *buffer = WritePacketHeader (tsSec, tsUsec, totalSize, inclLen);
 
   Buffer headerBuffer;
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
-  inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  headerBuffer.CopyData (buffer, toCopy);
+  //
+  // The packet is not read at all if the snapshot length ends in the header.
+  //
+  if (inclLen > toCopy)
+    {
+      p->CopyData (buffer + toCopy, inclLen - toCopy);
+    }
+  EndRecord ();
 }
 
 void
@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -30,6 +31,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class PcapFileAsyncWriter;
 
 /*
  * A class representing a pcap file.  This allows easy creation, writing and 
@@ -79,10 +81,41 @@ public:
   void Open (std::string const &filename, std::ios::openmode mode);
 
   /**
-   * Close the underlying file.
+   * Close the underlying file, after writing the buffered records.
    */
   void Close (void);
 
+  /**
+   * \brief Batch the records written to the file
+   *
+   * The records are gathered in a buffer of this size, which is written to
+   * the file in one piece when it is full, by Flush and by Close.  Zero
+   * writes each record as soon as it is given, which is the default.  The
+   * buffered records are lost if the program aborts.
+   *
+   * \param size The size of the buffer, in bytes
+   */
+  void SetWriteBufferSize (uint32_t size);
+
+  /**
+   * \brief Write the full buffers from a separate thread
+   *
+   * The writer thread takes at most \p maxBuffers full buffers at a time:
+   * Write blocks when the disk cannot keep up.  This makes sense with a
+   * write buffer (see SetWriteBufferSize) and does nothing if the system
+   * has no thread support.  While the thread is running, Fail only reports
+   * the errors of the records written up to the last Flush.
+   *
+   * \param enable Whether to use the writer thread
+   * \param maxBuffers The number of full buffers the thread can take
+   */
+  void SetAsyncWrite (bool enable, uint32_t maxBuffers = 8);
+
+  /**
+   * \brief Write all the records given so far to the file
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -283,13 +316,29 @@ private:
   void Swap (PcapRecordHeader *from, PcapRecordHeader *to);
 
   void WriteFileHeader (void);
-  uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * Append the header of a record to the write buffer, with room for its data
+   * \returns the place of the data in the write buffer
+   */
+  uint8_t *WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen, uint32_t &inclLen);
+  /**
+   * Called once the data of a record is in the write buffer
+   */
+  void EndRecord (void);
+  /**
+   * Give the content of the write buffer to the file, or to the writer thread
+   */
+  void WriteBuffer (void);
   void ReadAndVerifyFileHeader (void);
 
   std::string    m_filename;
   std::fstream   m_file;
   PcapFileHeader m_fileHeader;
   bool m_swapMode;
+  std::vector<uint8_t> m_writeBuffer;
+  uint32_t m_writeBufferUsed;
+  uint32_t m_writeBufferSize;
+  PcapFileAsyncWriter *m_asyncWriter;
 };
 
 } // namespace ns3
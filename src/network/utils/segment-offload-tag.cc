@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "segment-offload-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SegmentOffloadTag);
+
+TypeId 
+SegmentOffloadTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SegmentOffloadTag")
+    .SetParent<Tag> ()
+    .AddConstructor<SegmentOffloadTag> ()
+  ;
+  return tid;
+}
+TypeId 
+SegmentOffloadTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t 
+SegmentOffloadTag::GetSerializedSize (void) const
+{
+  return 6;
+}
+void 
+SegmentOffloadTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU16 (m_segments);
+  buf.WriteU16 (m_segmentSize);
+  buf.WriteU16 (m_headerSize);
+}
+void 
+SegmentOffloadTag::Deserialize (TagBuffer buf)
+{
+  m_segments = buf.ReadU16 ();
+  m_segmentSize = buf.ReadU16 ();
+  m_headerSize = buf.ReadU16 ();
+}
+void 
+SegmentOffloadTag::Print (std::ostream &os) const
+{
+  os << "Segments=" << m_segments << " SegmentSize=" << m_segmentSize
+     << " HeaderSize=" << m_headerSize;
+}
+SegmentOffloadTag::SegmentOffloadTag ()
+  : Tag (),
+    m_segments (1),
+    m_segmentSize (0),
+    m_headerSize (0)
+{
+}
+SegmentOffloadTag::SegmentOffloadTag (uint16_t segments, uint16_t segmentSize, uint16_t headerSize)
+  : Tag (),
+    m_segments (segments),
+    m_segmentSize (segmentSize),
+    m_headerSize (headerSize)
+{
+}
+
+uint16_t
+SegmentOffloadTag::GetSegments (void) const
+{
+  return m_segments;
+}
+uint16_t
+SegmentOffloadTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+uint16_t
+SegmentOffloadTag::GetHeaderSize (void) const
+{
+  return m_headerSize;
+}
+uint32_t
+SegmentOffloadTag::GetReplicatedSize (uint32_t frameOverhead) const
+{
+  if (m_segments <= 1)
+    {
+      return 0;
+    }
+  return (m_segments - 1) * (m_headerSize + frameOverhead);
+}
+
+} // namespace ns3
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SEGMENT_OFFLOAD_TAG_H
+#define SEGMENT_OFFLOAD_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * \brief packet tag which marks a super-segment
+ *
+ * A transport protocol which supports segmentation offload can hand down
+ * a single packet, the super-segment, which stands for several segments
+ * of the same flow: each of these segments carries the headers of the
+ * super-segment and at most GetSegmentSize bytes of its payload. The
+ * NetDevices which support segmentation offload (see
+ * NetDevice::SupportsSegmentOffload) transmit a super-segment at once
+ * but account for the headers of all its segments, as returned by
+ * GetReplicatedSize, in its transmission time.
+ *
+ * A super-segment without payload, such as a TCP ACK, stands for several
+ * copies of the same segment.
+ */
+class SegmentOffloadTag : public Tag
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  SegmentOffloadTag ();
+  /**
+   * \param segments the number of segments of the super-segment
+   * \param segmentSize the maximum payload size of each segment
+   * \param headerSize the size of the layer 3 and layer 4 headers of
+   *        each segment
+   */
+  SegmentOffloadTag (uint16_t segments, uint16_t segmentSize, uint16_t headerSize);
+
+  uint16_t GetSegments (void) const;
+  uint16_t GetSegmentSize (void) const;
+  uint16_t GetHeaderSize (void) const;
+  /**
+   * \param frameOverhead the size of the link layer header and trailer
+   *        of a frame
+   * \returns the number of bytes that the headers of all the segments but
+   *          the first one add to the size of the super-segment.
+   */
+  uint32_t GetReplicatedSize (uint32_t frameOverhead) const;
+private:
+  uint16_t m_segments;
+  uint16_t m_segmentSize;
+  uint16_t m_headerSize;
+};
+
+} // namespace ns3
+
+#endif /* SEGMENT_OFFLOAD_TAG_H */
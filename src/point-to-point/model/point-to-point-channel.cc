@@ -24,6 +24,7 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/multithreaded-simulator-impl.h"
 
 NS_LOG_COMPONENT_DEFINE ("PointToPointChannel");
 
@@ -89,6 +90,11 @@ PointToPointChannel::Attach (Ptr<PointToPointNetDevice> device)
     {
       m_link[0].m_dst = m_link[1].m_src;
       m_link[1].m_dst = m_link[0].m_src;
+      if (m_link[0].m_dst->GetNode () != 0 && m_link[1].m_dst->GetNode () != 0)
+        {
+          m_link[0].m_dstContext = m_link[0].m_dst->GetNode ()->GetId ();
+          m_link[1].m_dstContext = m_link[1].m_dst->GetNode ()->GetId ();
+        }
       m_link[0].m_state = IDLE;
       m_link[1].m_state = IDLE;
     }
@@ -123,7 +129,22 @@ PointToPointChannel::TransmitStart (
   //   }
   // continue normal operations
   
-  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+  if (m_link[wire].m_dstContext == NO_CONTEXT)
+    {
+      m_link[wire].m_dstContext = m_link[wire].m_dst->GetNode ()->GetId ();
+    }
+  uint32_t context = m_link[wire].m_dstContext;
+  if (MultithreadedSimulatorImpl::IsRemote (context))
+    {
+      // The receiving device is simulated by another thread: it gets a
+      // packet which shares no reference count with the one the sending
+      // device keeps, and the objects of the receiving side, whose
+      // reference counts are not thread-safe, are not touched here.
+      Simulator::ScheduleWithContext (context, txTime + m_delay, &PointToPointNetDevice::Receive,
+                                      PeekPointer (m_link[wire].m_dst), p->DeepCopy ());
+      return true;
+    }
+  Simulator::ScheduleWithContext (context,
                                   txTime + m_delay, &PointToPointNetDevice::Receive,
                                   m_link[wire].m_dst, p);
 
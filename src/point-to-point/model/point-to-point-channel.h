@@ -142,6 +142,9 @@ private:
    * net device, receiving net device, transmission time and 
    * packet receipt time.
    *
+   * With MultithreadedSimulatorImpl, this trace is not fired when the
+   * two devices are simulated by different threads.
+   *
    * @see class CallBackTraceSource
    */
   TracedCallback<uint32_t,          // channel ID
@@ -159,7 +162,9 @@ private:
                  Time,              // Amount of time to transmit the pkt
                  Time               // Last bit receive time (relative to now)
                  > m_dropPointToPoint;
-  
+
+  static const uint32_t NO_CONTEXT = 0xffffffff;
+
   enum WireState
   {
     INITIALIZING,
@@ -171,10 +176,13 @@ private:
   class Link
   {
 public:
-    Link() : m_state (INITIALIZING), m_src (0), m_dst (0) {}
+    Link() : m_state (INITIALIZING), m_src (0), m_dst (0), m_dstContext (NO_CONTEXT) {}
     WireState                  m_state;
     Ptr<PointToPointNetDevice> m_src;
     Ptr<PointToPointNetDevice> m_dst;
+    // the id of the node of m_dst, cached so that it can be read without
+    // touching the reference count of the node.
+    uint32_t                   m_dstContext;
   };
 
   Link    m_link[N_DEVICES];
@@ -26,6 +26,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
 #include "ns3/mpi-interface.h"
+#include "ns3/segment-offload-tag.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -220,6 +221,15 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   m_phyTxBeginTrace (m_currentPkt);
 
   Time txTime = Seconds (m_bps.CalculateTxTime (p->GetSize ()));
+  SegmentOffloadTag offload;
+  if (p->PeekPacketTag (offload) && offload.GetSegments () > 1)
+    {
+      // A super-segment takes as long to transmit as its segments would,
+      // each with its own headers and followed by an interframe gap.
+      PppHeader ppp;
+      uint32_t size = p->GetSize () + offload.GetReplicatedSize (ppp.GetSerializedSize ());
+      txTime = Seconds (m_bps.CalculateTxTime (size)) + TimeStep (m_tInterframeGap.GetTimeStep () * (offload.GetSegments () - 1));
+    }
   Time txCompleteTime = txTime + m_tInterframeGap;
 
   NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << txCompleteTime.GetSeconds () << "sec");
@@ -562,6 +572,12 @@ PointToPointNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentOffload (void) const
+{
+  return true;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive (Ptr<Packet> p)
 {
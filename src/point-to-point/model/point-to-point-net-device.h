@@ -184,6 +184,7 @@ public:
 
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsSegmentOffload (void) const;
 
 protected:
   void DoMpiReceive (Ptr<Packet> p);
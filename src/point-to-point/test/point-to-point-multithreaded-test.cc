@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Packets travel a few hops around a ring of point-to-point links: the
+ * multithreaded simulator must deliver them at the same times as the
+ * default simulator, and give them the same uids in every run.
+ */
+class MultithreadedRingTest : public TestCase
+{
+public:
+  MultithreadedRingTest ();
+
+  virtual void DoRun (void);
+
+private:
+  typedef std::vector<std::pair<uint64_t, uint32_t> > Receptions;
+
+  void RunRing (std::string simulatorType);
+  void Send (uint32_t node);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  void CountReceptions (void);
+
+  static const uint32_t N_NODES = 8;
+
+  NetDeviceContainer m_right;
+  std::vector<Receptions> m_receptions;
+  std::vector<std::vector<uint64_t> > m_uids;
+  uint32_t m_countedReceptions;
+  uint64_t m_stopTime;
+  uint32_t m_partitions;
+  Time m_lookAhead;
+  uint64_t m_remoteEvents;
+};
+
+MultithreadedRingTest::MultithreadedRingTest ()
+  : TestCase ("Check that the multithreaded simulator runs a ring of point-to-point links like the default simulator")
+{
+}
+
+void
+MultithreadedRingTest::Send (uint32_t node)
+{
+  // packets originated by different nodes can't arrive at the same time.
+  uint8_t payload[N_NODES - 1] = { 0 };
+  Ptr<Packet> packet = Create<Packet> (payload, N_NODES - 1);
+  m_right.Get (node)->Send (packet, m_right.Get (node)->GetBroadcast (), 0x800);
+}
+
+bool
+MultithreadedRingTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  uint32_t node = device->GetNode ()->GetId ();
+  m_receptions[node].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), packet->GetSize ()));
+  m_uids[node].push_back (packet->GetUid ());
+  if (packet->GetSize () > 1)
+    {
+      Ptr<Packet> next = packet->CreateFragment (0, packet->GetSize () - 1);
+      m_right.Get (node)->Send (next, m_right.Get (node)->GetBroadcast (), 0x800);
+    }
+  return true;
+}
+
+void
+MultithreadedRingTest::CountReceptions (void)
+{
+  // events without context see the nodes of all the partitions.
+  m_countedReceptions = 0;
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      m_countedReceptions += m_receptions[i].size ();
+    }
+}
+
+void
+MultithreadedRingTest::RunRing (std::string simulatorType)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  m_receptions.clear ();
+  m_receptions.resize (N_NODES);
+  m_uids.clear ();
+  m_uids.resize (N_NODES);
+  m_right = NetDeviceContainer ();
+
+  NodeContainer nodes;
+  nodes.Create (N_NODES);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      NetDeviceContainer link = p2p.Install (nodes.Get (i), nodes.Get ((i + 1) % N_NODES));
+      m_right.Add (link.Get (0));
+      link.Get (1)->SetReceiveCallback (MakeCallback (&MultithreadedRingTest::Receive, this));
+    }
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      for (uint32_t k = 0; k < 50; k++)
+        {
+          Simulator::ScheduleWithContext (i, MicroSeconds (50 * k) + NanoSeconds (i + 1),
+                                          &MultithreadedRingTest::Send, this, i);
+        }
+    }
+  Simulator::Schedule (MilliSeconds (2), &MultithreadedRingTest::CountReceptions, this);
+  Simulator::Stop (MilliSeconds (20));
+  Simulator::Run ();
+  m_stopTime = Simulator::Now ().GetTimeStep ();
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      m_partitions = impl->GetPartitionCount ();
+      m_lookAhead = impl->GetLookAhead ();
+      m_remoteEvents = impl->GetRemoteEventCount ();
+    }
+  Simulator::Destroy ();
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+MultithreadedRingTest::DoRun (void)
+{
+  RunRing ("ns3::DefaultSimulatorImpl");
+  std::vector<Receptions> expected = m_receptions;
+  uint32_t expectedCount = m_countedReceptions;
+  uint64_t expectedStopTime = m_stopTime;
+  NS_TEST_ASSERT_MSG_EQ (expected[0].size (), 50 * (N_NODES - 1), "unexpected number of receptions");
+
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (4));
+  RunRing ("ns3::MultithreadedSimulatorImpl");
+  NS_TEST_ASSERT_MSG_EQ (m_partitions, 4, "the ring should be split in MaxThreads partitions");
+  NS_TEST_ASSERT_MSG_EQ (m_lookAhead, MilliSeconds (1), "the lookahead is the delay of the links");
+  NS_TEST_ASSERT_MSG_GT (m_remoteEvents, 0, "packets should cross partitions");
+  NS_TEST_ASSERT_MSG_EQ (m_countedReceptions, expectedCount, "the global event should see all partitions at the same time");
+  NS_TEST_ASSERT_MSG_EQ (m_stopTime, expectedStopTime, "the simulation should stop at the same time");
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_receptions[i].size (), expected[i].size (), "unexpected number of receptions on node " << i);
+      NS_TEST_ASSERT_MSG_EQ ((m_receptions[i] == expected[i]), true, "unexpected receptions on node " << i);
+    }
+
+  std::vector<std::vector<uint64_t> > uids = m_uids;
+  RunRing ("ns3::MultithreadedSimulatorImpl");
+  for (uint32_t i = 0; i < N_NODES; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((m_uids[i] == uids[i]), true, "packet uids differ between runs on node " << i);
+    }
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue (0));
+}
+
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ();
+};
+
+MultithreadedSimulatorTestSuite::MultithreadedSimulatorTestSuite ()
+  : TestSuite ("multithreaded-simulator", UNIT)
+{
+  AddTestCase (new MultithreadedRingTest);
+}
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite;
@@ -20,6 +20,8 @@
 
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 
 NS_LOG_COMPONENT_DEFINE ("Jakes");
@@ -47,6 +49,20 @@ JakesPropagationLossModel::GetTypeId ()
   static TypeId tid = TypeId ("ns3::JakesPropagationLossModel")
     .SetParent<PropagationLossModel> ()
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("CacheSize",
+                   "The maximum number of propagation paths whose Jakes process is kept; "
+                   "the least recently used one is discarded beyond that. 0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::SetCacheSize,
+                                         &JakesPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("InvalidateOnCourseChange",
+                   "If true, a new Jakes process is started for the paths of a node "
+                   "whenever its mobility model notifies a course change.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&JakesPropagationLossModel::SetInvalidateOnCourseChange,
+                                        &JakesPropagationLossModel::GetInvalidateOnCourseChange),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -72,6 +88,30 @@ JakesPropagationLossModel::GetUniformRandomVariable () const
   return m_uniformVariable;
 }
 
+void
+JakesPropagationLossModel::SetCacheSize (uint32_t size)
+{
+  m_propagationCache.SetMaxSize (size);
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheSize (void) const
+{
+  return m_propagationCache.GetMaxSize ();
+}
+
+void
+JakesPropagationLossModel::SetInvalidateOnCourseChange (bool invalidate)
+{
+  m_propagationCache.SetInvalidateOnCourseChange (invalidate);
+}
+
+bool
+JakesPropagationLossModel::GetInvalidateOnCourseChange (void) const
+{
+  return m_propagationCache.GetInvalidateOnCourseChange ();
+}
+
 int64_t
 JakesPropagationLossModel::DoAssignStreams (int64_t stream)
 {
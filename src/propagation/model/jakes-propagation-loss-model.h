@@ -49,6 +49,10 @@ private:
                         Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   Ptr<UniformRandomVariable> GetUniformRandomVariable () const;
+  void SetCacheSize (uint32_t size);
+  uint32_t GetCacheSize (void) const;
+  void SetInvalidateOnCourseChange (bool invalidate);
+  bool GetInvalidateOnCourseChange (void) const;
 
   Ptr<UniformRandomVariable> m_uniformVariable;
 private:
@@ -21,7 +21,11 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
-#include <map>
+#include "ns3/callback.h"
+#include "ns3/assert.h"
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
 
 namespace ns3
 {
@@ -29,61 +33,360 @@ namespace ns3
  * \ingroup propagation
  * \brief Constructs a cache of objects, where each obect is responsible for a single propagation path loss calculations.
  * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
- * a couple of MobilityModels and a spectrum model UID
+ * a couple of MobilityModels and a model UID (for example, a SpectrumModelUid_t
+ * for the spectrum propagation loss models).
+ *
+ * The paths are stored in an open-addressing hash table. The cache is
+ * unbounded by default; when a maximum size is set, the least recently
+ * used path is evicted to make room for a new one. Optionally, the
+ * paths of a MobilityModel are invalidated whenever it notifies a
+ * course change.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
-  ~PropagationCache () {};
+  PropagationCache ()
+    : m_size (0),
+      m_deleted (0),
+      m_maxSize (0),
+      m_lruHead (NONE),
+      m_lruTail (NONE),
+      m_invalidateOnCourseChange (false),
+      m_mobilitySize (0)
+  {};
+  ~PropagationCache ()
+  {
+    Clear ();
+  };
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    typename PathCache::iterator it = m_pathCache.find (key);
-    if (it == m_pathCache.end ())
+    uint32_t i = Find (a, b, modelUid);
+    if (i == NONE)
       {
         return 0;
       }
-    return it->second;
+    Slot &slot = m_slots[i];
+    if (m_invalidateOnCourseChange
+        && (slot.m_firstGeneration != GetGeneration (slot.m_first)
+            || slot.m_secondGeneration != GetGeneration (slot.m_second)))
+      {
+        Erase (i);
+        return 0;
+      }
+    LruUnlink (i);
+    LruPushFront (i);
+    return slot.m_data;
   };
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    NS_ASSERT (Find (a, b, modelUid) == NONE);
+    if (m_maxSize != 0 && m_size >= m_maxSize)
+      {
+        Erase (m_lruTail);
+      }
+    if ((m_size + m_deleted + 1) * 2 > m_slots.size ())
+      {
+        Rehash ();
+      }
+    const MobilityModel *first = std::min (PeekPointer (a), PeekPointer (b));
+    const MobilityModel *second = std::max (PeekPointer (a), PeekPointer (b));
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t i = Hash (first, second, modelUid) & mask;
+    while (m_slots[i].m_state == FULL)
+      {
+        i = (i + 1) & mask;
+      }
+    if (m_slots[i].m_state == DELETED)
+      {
+        m_deleted--;
+      }
+    Slot &slot = m_slots[i];
+    slot.m_state = FULL;
+    slot.m_first = first;
+    slot.m_second = second;
+    slot.m_modelUid = modelUid;
+    slot.m_data = data;
+    if (m_invalidateOnCourseChange)
+      {
+        slot.m_firstGeneration = Track (slot.m_first);
+        slot.m_secondGeneration = Track (slot.m_second);
+      }
+    m_size++;
+    LruPushFront (i);
+  };
+  /**
+   * \param maxSize the maximum number of paths kept in the cache, 0 for no limit.
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    m_maxSize = maxSize;
+    while (m_maxSize != 0 && m_size > m_maxSize)
+      {
+        Erase (m_lruTail);
+      }
+  };
+  uint32_t GetMaxSize (void) const
+  {
+    return m_maxSize;
+  };
+  /**
+   * \param invalidate whether the paths of a MobilityModel are
+   * discarded when it notifies a course change. Changing this
+   * setting clears the cache.
+   */
+  void SetInvalidateOnCourseChange (bool invalidate)
+  {
+    if (invalidate != m_invalidateOnCourseChange)
+      {
+        Clear ();
+        m_invalidateOnCourseChange = invalidate;
+      }
+  };
+  bool GetInvalidateOnCourseChange (void) const
+  {
+    return m_invalidateOnCourseChange;
+  };
+  /**
+   * \returns the number of paths currently in the cache.
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_size;
+  };
+  void Clear (void)
+  {
+    for (typename std::vector<MobilitySlot>::iterator i = m_mobilities.begin (); i != m_mobilities.end (); ++i)
+      {
+        if (i->m_mobility != 0)
+          {
+            ConstCast<MobilityModel> (i->m_mobility)->TraceDisconnectWithoutContext (
+              "CourseChange", MakeCallback (&PropagationCache<T>::NotifyCourseChange, this));
+          }
+      }
+    m_mobilities.clear ();
+    m_mobilitySize = 0;
+    m_slots.clear ();
+    m_size = 0;
+    m_deleted = 0;
+    m_lruHead = NONE;
+    m_lruTail = NONE;
   };
 private:
-  /// Each path is identified by
-  struct PropagationPathIdentifier
-  {
-    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
-      m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
-    {};
-    Ptr<const MobilityModel> m_srcMobility;
-    Ptr<const MobilityModel> m_dstMobility;
-    uint32_t m_spectrumModelUid;
-    bool operator < (const PropagationPathIdentifier & other) const
-    {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
-    }
-  };
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
-private:
-  PathCache m_pathCache;
+  PropagationCache (const PropagationCache &);
+  PropagationCache &operator = (const PropagationCache &);
+
+  static const uint32_t NONE = 0xffffffff;
+  enum SlotState
+  {
+    EMPTY = 0,
+    FULL,
+    DELETED
+  };
+  /// Each path is identified by its two MobilityModels, in address order, and a model uid
+  struct Slot
+  {
+    Slot () : m_modelUid (0), m_firstGeneration (0), m_secondGeneration (0),
+              m_lruPrev (NONE), m_lruNext (NONE), m_state (EMPTY) {};
+    Ptr<const MobilityModel> m_first;
+    Ptr<const MobilityModel> m_second;
+    uint32_t m_modelUid;
+    Ptr<T> m_data;
+    uint32_t m_firstGeneration;
+    uint32_t m_secondGeneration;
+    uint32_t m_lruPrev;
+    uint32_t m_lruNext;
+    uint8_t m_state;
+  };
+  /// The course change count of a MobilityModel, used for invalidation
+  struct MobilitySlot
+  {
+    MobilitySlot () : m_generation (0) {};
+    Ptr<const MobilityModel> m_mobility;
+    uint32_t m_generation;
+  };
+
+  static uint64_t HashPointer (uint64_t h, const void *p)
+  {
+    h ^= reinterpret_cast<uintptr_t> (p);
+    h *= 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 29);
+  };
+  static uint32_t Hash (const MobilityModel *first, const MobilityModel *second, uint32_t modelUid)
+  {
+    uint64_t h = HashPointer (HashPointer (modelUid, first), second);
+    return h >> 32;
+  };
+  uint32_t Find (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) const
+  {
+    if (m_size == 0)
+      {
+        return NONE;
+      }
+    const MobilityModel *first = std::min (PeekPointer (a), PeekPointer (b));
+    const MobilityModel *second = std::max (PeekPointer (a), PeekPointer (b));
+    uint32_t mask = m_slots.size () - 1;
+    uint32_t i = Hash (first, second, modelUid) & mask;
+    while (m_slots[i].m_state != EMPTY)
+      {
+        const Slot &slot = m_slots[i];
+        if (slot.m_state == FULL && slot.m_modelUid == modelUid
+            && PeekPointer (slot.m_first) == first && PeekPointer (slot.m_second) == second)
+          {
+            return i;
+          }
+        i = (i + 1) & mask;
+      }
+    return NONE;
+  };
+  void Erase (uint32_t i)
+  {
+    LruUnlink (i);
+    Slot &slot = m_slots[i];
+    slot.m_state = DELETED;
+    slot.m_first = 0;
+    slot.m_second = 0;
+    slot.m_data = 0;
+    m_size--;
+    m_deleted++;
+  };
+  void Rehash (void)
+  {
+    uint32_t capacity = 16;
+    while (capacity < (m_size + 1) * 4)
+      {
+        capacity *= 2;
+      }
+    // reinsert from the least to the most recently used path to keep the LRU order
+    std::vector<Slot> slots;
+    slots.swap (m_slots);
+    m_slots.resize (capacity);
+    uint32_t i = m_lruTail;
+    m_size = 0;
+    m_deleted = 0;
+    m_lruHead = NONE;
+    m_lruTail = NONE;
+    uint32_t mask = capacity - 1;
+    while (i != NONE)
+      {
+        const Slot &old = slots[i];
+        uint32_t j = Hash (PeekPointer (old.m_first), PeekPointer (old.m_second), old.m_modelUid) & mask;
+        while (m_slots[j].m_state == FULL)
+          {
+            j = (j + 1) & mask;
+          }
+        m_slots[j] = old;
+        m_size++;
+        LruPushFront (j);
+        i = old.m_lruPrev;
+      }
+  };
+  void LruUnlink (uint32_t i)
+  {
+    Slot &slot = m_slots[i];
+    if (slot.m_lruPrev != NONE)
+      {
+        m_slots[slot.m_lruPrev].m_lruNext = slot.m_lruNext;
+      }
+    else
+      {
+        m_lruHead = slot.m_lruNext;
+      }
+    if (slot.m_lruNext != NONE)
+      {
+        m_slots[slot.m_lruNext].m_lruPrev = slot.m_lruPrev;
+      }
+    else
+      {
+        m_lruTail = slot.m_lruPrev;
+      }
+    slot.m_lruPrev = NONE;
+    slot.m_lruNext = NONE;
+  };
+  void LruPushFront (uint32_t i)
+  {
+    Slot &slot = m_slots[i];
+    slot.m_lruPrev = NONE;
+    slot.m_lruNext = m_lruHead;
+    if (m_lruHead != NONE)
+      {
+        m_slots[m_lruHead].m_lruPrev = i;
+      }
+    m_lruHead = i;
+    if (m_lruTail == NONE)
+      {
+        m_lruTail = i;
+      }
+  };
+  uint32_t FindMobility (const MobilityModel *mobility) const
+  {
+    if (m_mobilities.empty ())
+      {
+        return NONE;
+      }
+    uint32_t mask = m_mobilities.size () - 1;
+    uint32_t i = (HashPointer (0, mobility) >> 32) & mask;
+    while (m_mobilities[i].m_mobility != 0)
+      {
+        if (PeekPointer (m_mobilities[i].m_mobility) == mobility)
+          {
+            return i;
+          }
+        i = (i + 1) & mask;
+      }
+    return i;
+  };
+  uint32_t GetGeneration (Ptr<const MobilityModel> mobility) const
+  {
+    uint32_t i = FindMobility (PeekPointer (mobility));
+    if (i == NONE || m_mobilities[i].m_mobility == 0)
+      {
+        return 0;
+      }
+    return m_mobilities[i].m_generation;
+  };
+  /// start tracking the course changes of a MobilityModel, if not done yet, and return its generation
+  uint32_t Track (Ptr<const MobilityModel> mobility)
+  {
+    if ((m_mobilitySize + 1) * 2 > m_mobilities.size ())
+      {
+        std::vector<MobilitySlot> mobilities;
+        mobilities.swap (m_mobilities);
+        m_mobilities.resize (std::max<uint32_t> (16, mobilities.size () * 2));
+        for (typename std::vector<MobilitySlot>::const_iterator j = mobilities.begin (); j != mobilities.end (); ++j)
+          {
+            if (j->m_mobility != 0)
+              {
+                m_mobilities[FindMobility (PeekPointer (j->m_mobility))] = *j;
+              }
+          }
+      }
+    uint32_t i = FindMobility (PeekPointer (mobility));
+    if (m_mobilities[i].m_mobility == 0)
+      {
+        m_mobilities[i].m_mobility = mobility;
+        m_mobilitySize++;
+        ConstCast<MobilityModel> (mobility)->TraceConnectWithoutContext (
+          "CourseChange", MakeCallback (&PropagationCache<T>::NotifyCourseChange, this));
+      }
+    return m_mobilities[i].m_generation;
+  };
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility)
+  {
+    uint32_t i = FindMobility (PeekPointer (mobility));
+    NS_ASSERT (i != NONE && m_mobilities[i].m_mobility != 0);
+    m_mobilities[i].m_generation++;
+  };
+
+  std::vector<Slot> m_slots;
+  uint32_t m_size;
+  uint32_t m_deleted;
+  uint32_t m_maxSize;
+  uint32_t m_lruHead;
+  uint32_t m_lruTail;
+  bool m_invalidateOnCourseChange;
+  std::vector<MobilitySlot> m_mobilities;
+  uint32_t m_mobilitySize;
 };
 } // namespace ns3
 
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/constant-position-mobility-model.h"
+
+using namespace ns3;
+
+class PathData : public SimpleRefCount<PathData>
+{
+public:
+  PathData (uint32_t id) : m_id (id) {}
+  uint32_t m_id;
+};
+
+class PropagationCacheTestCase : public TestCase
+{
+public:
+  PropagationCacheTestCase ();
+  virtual ~PropagationCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationCacheTestCase::PropagationCacheTestCase ()
+  : TestCase ("Check lookup, eviction and invalidation of the PropagationCache")
+{
+}
+
+PropagationCacheTestCase::~PropagationCacheTestCase ()
+{
+}
+
+void
+PropagationCacheTestCase::DoRun (void)
+{
+  std::vector<Ptr<ConstantPositionMobilityModel> > nodes;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      nodes.push_back (CreateObject<ConstantPositionMobilityModel> ());
+    }
+
+  // lookups are symmetrical and distinguish model uids, across rehashes
+  PropagationCache<PathData> cache;
+  for (uint32_t i = 0; i < nodes.size (); i++)
+    {
+      for (uint32_t j = i + 1; j < nodes.size (); j++)
+        {
+          cache.AddPathData (Create<PathData> (i * 100 + j), nodes[i], nodes[j], 1);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (cache.GetSize (), 40 * 39 / 2, "unexpected cache size");
+  for (uint32_t i = 0; i < nodes.size (); i++)
+    {
+      for (uint32_t j = i + 1; j < nodes.size (); j++)
+        {
+          Ptr<PathData> data = cache.GetPathData (nodes[j], nodes[i], 1);
+          NS_TEST_ASSERT_MSG_NE (data, 0, "path " << i << "-" << j << " not found");
+          NS_TEST_ASSERT_MSG_EQ (data->m_id, i * 100 + j, "wrong data for path " << i << "-" << j);
+          NS_TEST_ASSERT_MSG_EQ (cache.GetPathData (nodes[i], nodes[j], 2), 0, "model uid ignored");
+        }
+    }
+
+  // the least recently used path is evicted first
+  PropagationCache<PathData> bounded;
+  bounded.SetMaxSize (3);
+  bounded.AddPathData (Create<PathData> (1), nodes[0], nodes[1], 0);
+  bounded.AddPathData (Create<PathData> (2), nodes[0], nodes[2], 0);
+  bounded.AddPathData (Create<PathData> (3), nodes[0], nodes[3], 0);
+  NS_TEST_ASSERT_MSG_NE (bounded.GetPathData (nodes[1], nodes[0], 0), 0, "path 0-1 not found");
+  bounded.AddPathData (Create<PathData> (4), nodes[0], nodes[4], 0);
+  NS_TEST_ASSERT_MSG_EQ (bounded.GetSize (), 3, "cache size not bounded");
+  NS_TEST_ASSERT_MSG_EQ (bounded.GetPathData (nodes[0], nodes[2], 0), 0, "path 0-2 should have been evicted");
+  NS_TEST_ASSERT_MSG_NE (bounded.GetPathData (nodes[0], nodes[1], 0), 0, "path 0-1 evicted");
+  NS_TEST_ASSERT_MSG_NE (bounded.GetPathData (nodes[0], nodes[3], 0), 0, "path 0-3 evicted");
+  NS_TEST_ASSERT_MSG_NE (bounded.GetPathData (nodes[0], nodes[4], 0), 0, "path 0-4 evicted");
+
+  // a course change invalidates all the paths of a node
+  PropagationCache<PathData> invalidating;
+  invalidating.SetInvalidateOnCourseChange (true);
+  invalidating.AddPathData (Create<PathData> (1), nodes[0], nodes[1], 0);
+  invalidating.AddPathData (Create<PathData> (2), nodes[1], nodes[2], 0);
+  invalidating.AddPathData (Create<PathData> (3), nodes[2], nodes[3], 0);
+  nodes[1]->SetPosition (Vector (1.0, 0.0, 0.0));
+  NS_TEST_ASSERT_MSG_EQ (invalidating.GetPathData (nodes[0], nodes[1], 0), 0, "path 0-1 not invalidated");
+  NS_TEST_ASSERT_MSG_EQ (invalidating.GetPathData (nodes[1], nodes[2], 0), 0, "path 1-2 not invalidated");
+  NS_TEST_ASSERT_MSG_NE (invalidating.GetPathData (nodes[2], nodes[3], 0), 0, "path 2-3 invalidated");
+  NS_TEST_ASSERT_MSG_EQ (invalidating.GetSize (), 1, "invalidated paths not removed");
+  invalidating.AddPathData (Create<PathData> (4), nodes[0], nodes[1], 0);
+  NS_TEST_ASSERT_MSG_NE (invalidating.GetPathData (nodes[0], nodes[1], 0), 0, "path 0-1 not re-added");
+}
+
+class PropagationCacheTestSuite : public TestSuite
+{
+public:
+  PropagationCacheTestSuite ();
+};
+
+PropagationCacheTestSuite::PropagationCacheTestSuite ()
+  : TestSuite ("propagation-cache", UNIT)
+{
+  AddTestCase (new PropagationCacheTestCase);
+}
+
+static PropagationCacheTestSuite propagationCacheTestSuite;
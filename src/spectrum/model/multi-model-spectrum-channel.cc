@@ -34,6 +34,7 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include "multi-model-spectrum-channel.h"
@@ -78,6 +79,7 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_maxRange (0.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -112,6 +114,17 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "If positive, the distance in meters beyond which receivers are not even "
+                   "considered for reception: their path loss is not evaluated and the "
+                   "transmitted signal is not converted for them. Receivers are indexed "
+                   "spatially so that the ones beyond this distance are never visited. "
+                   "This value should be set to a distance beyond which the path loss is known "
+                   "to always exceed MaxLossDb, in which case the results are unchanged. "
+                   "The default value disables this optimization.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired "
                      "whenever a new path loss value is calculated. The first and second parameters "
@@ -153,6 +166,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       if (phyIt !=  rxInfoIterator->second.m_rxPhySet.end ())
         {
           rxInfoIterator->second.m_rxPhySet.erase (phyIt);
+          rxInfoIterator->second.m_rxPhyIndex = 0;
           --m_numDevices;
           break; // there should be at most one entry
         }       
@@ -190,6 +204,7 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       // spectrum model is already known, just add the device to the corresponding list
       std::pair<std::set<Ptr<SpectrumPhy> >::iterator, bool> ret2 = rxInfoIterator->second.m_rxPhySet.insert (phy);
       NS_ASSERT (ret2.second);
+      rxInfoIterator->second.m_rxPhyIndex = 0;
     }
 
 }
@@ -260,30 +275,21 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
-  for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
+  std::vector<Ptr<SpectrumPhy> > rxPhys;
+  for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
     {
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
+      // the conversion is done only once a receiver of this
+      // SpectrumModel survives the path loss checks
       Ptr <SpectrumValue> convertedTxPowerSpectrum;
-      if (txSpectrumModelUid == rxSpectrumModelUid)
-        {
-          NS_LOG_LOGIC ("no spectrum conversion needed");
-          convertedTxPowerSpectrum = txParams->psd;
-        }
-      else
-        {
-          NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
-          SpectrumConverterMap_t::const_iterator rxConverterIterator = txInfoIteratorerator->second.m_spectrumConverterMap.find (rxSpectrumModelUid);
-          NS_ASSERT (rxConverterIterator != txInfoIteratorerator->second.m_spectrumConverterMap.end ());
-          convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
-        }
-
 
-      for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
-           rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
+      GetRxPhyCandidates (rxInfoIterator->second, txMobility, rxPhys);
+      for (std::vector<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxPhys.begin ();
+           rxPhyIterator != rxPhys.end ();
            ++rxPhyIterator)
         {
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
@@ -291,20 +297,21 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+              double pathGainLinear = 1.0;
 
               if (txMobility && receiverMobility)
                 {
+                  if (m_maxRange > 0 && txMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+                    {
+                      // beyond range
+                      continue;
+                    }
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  if (txParams->txAntenna != 0)
                     {
                       Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
@@ -329,7 +336,32 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                       // beyond range
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                  pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                }
+
+              if (convertedTxPowerSpectrum == 0)
+                {
+                  if (txSpectrumModelUid == rxSpectrumModelUid)
+                    {
+                      NS_LOG_LOGIC ("no spectrum conversion needed");
+                      convertedTxPowerSpectrum = txParams->psd;
+                    }
+                  else
+                    {
+                      NS_LOG_LOGIC (" converting txPowerSpectrum SpectrumModelUids" << txSpectrumModelUid << " --> " << rxSpectrumModelUid);
+                      SpectrumConverterMap_t::const_iterator rxConverterIterator = txInfoIteratorerator->second.m_spectrumConverterMap.find (rxSpectrumModelUid);
+                      NS_ASSERT (rxConverterIterator != txInfoIteratorerator->second.m_spectrumConverterMap.end ());
+                      convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
+                    }
+                }
+
+              NS_LOG_LOGIC (" copying signal parameters " << txParams);
+              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+              Time delay = MicroSeconds (0);
+
+              if (txMobility && receiverMobility)
+                {
                   *(rxParams->psd) *= pathGainLinear;              
 
                   if (m_spectrumPropagationLoss)
@@ -364,6 +396,69 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 }
 
+void
+MultiModelSpectrumChannel::GetRxPhyCandidates (RxSpectrumModelInfo &rxInfo, Ptr<MobilityModel> txMobility,
+                                               std::vector<Ptr<SpectrumPhy> > &rxPhys)
+{
+  NS_LOG_FUNCTION (this << txMobility);
+  rxPhys.clear ();
+  if (m_maxRange <= 0 || txMobility == 0)
+    {
+      rxPhys.insert (rxPhys.end (), rxInfo.m_rxPhySet.begin (), rxInfo.m_rxPhySet.end ());
+      return;
+    }
+
+  if (rxInfo.m_rxPhyIndex == 0 || rxInfo.m_rxPhyIndex->GetCellSize () != m_maxRange)
+    {
+      NS_LOG_LOGIC ("indexing " << rxInfo.m_rxPhySet.size () << " phys");
+      rxInfo.m_rxPhyIndex = Create<MobilityGridIndex> ();
+      rxInfo.m_rxPhyIndex->SetCellSize (m_maxRange);
+      rxInfo.m_indexedRxPhys.clear ();
+      rxInfo.m_indexedMobilities.clear ();
+      rxInfo.m_unindexedRxPhys.clear ();
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator it = rxInfo.m_rxPhySet.begin ();
+           it != rxInfo.m_rxPhySet.end ();
+           ++it)
+        {
+          Ptr<MobilityModel> mobility = (*it)->GetMobility ();
+          if (mobility)
+            {
+              rxInfo.m_rxPhyIndex->Add (mobility);
+              rxInfo.m_indexedRxPhys.push_back (*it);
+              rxInfo.m_indexedMobilities.push_back (mobility);
+            }
+          else
+            {
+              rxInfo.m_unindexedRxPhys.push_back (*it);
+            }
+        }
+    }
+
+#ifdef NS3_ASSERT_ENABLE
+  for (uint32_t i = 0; i < rxInfo.m_indexedRxPhys.size (); ++i)
+    {
+      NS_ASSERT_MSG (rxInfo.m_indexedRxPhys[i]->GetMobility () == rxInfo.m_indexedMobilities[i],
+                     "the MobilityModel of a phy changed after AddRx, call AddRx again");
+    }
+  for (uint32_t i = 0; i < rxInfo.m_unindexedRxPhys.size (); ++i)
+    {
+      NS_ASSERT_MSG (rxInfo.m_unindexedRxPhys[i]->GetMobility () == 0,
+                     "the MobilityModel of a phy changed after AddRx, call AddRx again");
+    }
+#endif
+
+  std::vector<uint32_t> candidates;
+  rxInfo.m_rxPhyIndex->GetCandidates (txMobility->GetPosition (), m_maxRange, candidates);
+  rxPhys.reserve (candidates.size () + rxInfo.m_unindexedRxPhys.size ());
+  for (std::vector<uint32_t>::const_iterator it = candidates.begin (); it != candidates.end (); ++it)
+    {
+      rxPhys.push_back (rxInfo.m_indexedRxPhys[*it]);
+    }
+  rxPhys.insert (rxPhys.end (), rxInfo.m_unindexedRxPhys.begin (), rxInfo.m_unindexedRxPhys.end ());
+  // preserve the order in which the receivers are visited without the index
+  std::sort (rxPhys.begin (), rxPhys.end ());
+}
+
 void
 MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
@@ -27,8 +27,10 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/mobility-grid-index.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -63,6 +65,21 @@ public:
 
   Ptr<const SpectrumModel> m_rxSpectrumModel;
   std::set<Ptr<SpectrumPhy> > m_rxPhySet;
+
+  /**
+   * spatial index of the phys of m_rxPhySet which have a
+   * MobilityModel, used when the MaxRange attribute of the channel is
+   * set. It is rebuilt lazily whenever m_rxPhySet changes, and follows
+   * the moves of the indexed MobilityModels, but a phy whose
+   * MobilityModel is replaced must be added again with AddRx.
+   */
+  Ptr<MobilityGridIndex> m_rxPhyIndex;
+  /// the phys indexed by m_rxPhyIndex, by index identifier
+  std::vector<Ptr<SpectrumPhy> > m_indexedRxPhys;
+  /// the MobilityModels of m_indexedRxPhys when they were indexed
+  std::vector<Ptr<MobilityModel> > m_indexedMobilities;
+  /// the phys of m_rxPhySet without a MobilityModel
+  std::vector<Ptr<SpectrumPhy> > m_unindexedRxPhys;
 };
 
 typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap_t;
@@ -81,7 +98,9 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * different SpectrumModel during the simulation. The requirement
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
- * called again passing the pointer to that SpectrumPhy.
+ * called again passing the pointer to that SpectrumPhy. When the
+ * MaxRange attribute is set, the same applies to a SpectrumPhy which
+ * is given a different MobilityModel.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -132,6 +151,18 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * find the receivers of a given RX SpectrumModel which may be
+   * within MaxRange of the transmitter.
+   *
+   * @param rxInfo the RX SpectrumModel being considered
+   * @param txMobility the mobility of the transmitter, possibly 0
+   * @param rxPhys filled with the candidate receivers, in the same
+   * order as in rxInfo.m_rxPhySet
+   */
+  void GetRxPhyCandidates (RxSpectrumModelInfo &rxInfo, Ptr<MobilityModel> txMobility,
+                           std::vector<Ptr<SpectrumPhy> > &rxPhys);
+
 
 
   /**
@@ -173,6 +204,8 @@ private:
 
   double m_maxLossDb;
 
+  double m_maxRange;
+
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
 };
 
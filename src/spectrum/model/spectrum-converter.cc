@@ -30,6 +30,7 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumConverter");
 namespace ns3 {
 
 SpectrumConverter::SpectrumConverter ()
+  : m_rowStart (1, 0)
 {
 }
 
@@ -39,10 +40,10 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
   m_fromSpectrumModel = fromSpectrumModel;
   m_toSpectrumModel = toSpectrumModel;
 
+  m_rowStart.push_back (0);
   for (Bands::const_iterator toit = toSpectrumModel->Begin (); toit != toSpectrumModel->End (); ++toit)
     {
-      std::vector<double> coeffs;
-
+      size_t column = 0;
       for (Bands::const_iterator fromit = fromSpectrumModel->Begin (); fromit != fromSpectrumModel->End (); ++fromit)
         {
           double c = GetCoefficient (*fromit, *toit);
@@ -50,10 +51,14 @@ SpectrumConverter::SpectrumConverter (Ptr<const SpectrumModel> fromSpectrumModel
                             << " --> " <<
                         "(" << toit->fl << "," << toit->fh << ")"
                             << " = " << c);
-          coeffs.push_back (c);
+          if (c != 0)
+            {
+              m_columns.push_back (column);
+              m_coefficients.push_back (c);
+            }
+          column++;
         }
-
-      m_conversionMatrix.push_back (coeffs);
+      m_rowStart.push_back (m_columns.size ());
     }
 
 }
@@ -77,27 +82,39 @@ SpectrumConverter::Convert (Ptr<const SpectrumValue> fvvf) const
 
   Ptr<SpectrumValue> tvvf = Create<SpectrumValue> (m_toSpectrumModel);
 
-  Values::iterator tvit = tvvf->ValuesBegin ();
-
-
-  for (std::vector<std::vector<double> >::const_iterator toit = m_conversionMatrix.begin ();
-       toit != m_conversionMatrix.end ();
-       ++toit)
+  // the bands out of [first, last) carry no signal, the rows whose
+  // coefficients all apply to them are left to zero
+  Values::const_iterator fvit = fvvf->ConstValuesBegin ();
+  size_t n = fvvf->ConstValuesEnd () - fvit;
+  size_t last = n;
+  size_t first = 0;
+  while (first < last && fvit[first] == 0)
+    {
+      first++;
+    }
+  while (last > first && fvit[last - 1] == 0)
     {
-      NS_ASSERT (tvit != tvvf->ValuesEnd ());
-      Values::const_iterator fvit = fvvf->ConstValuesBegin ();
+      last--;
+    }
 
+  Values::iterator tvit = tvvf->ValuesBegin ();
+  size_t rows = m_rowStart.size () - 1;
+  NS_ASSERT (rows == (size_t)(tvvf->ValuesEnd () - tvit));
+  for (size_t i = 0; i < rows; i++)
+    {
+      size_t j = m_rowStart[i];
+      size_t end = m_rowStart[i + 1];
+      if (j == end || m_columns[j] >= last || m_columns[end - 1] < first)
+        {
+          continue;
+        }
       double sum = 0;
-      for (std::vector<double>::const_iterator fromit = toit->begin ();
-           fromit != toit->end ();
-           ++fromit)
+      for (; j < end; j++)
         {
-          NS_ASSERT (fvit != fvvf->ConstValuesEnd ());
-          sum += (*fvit) * (*fromit);
-          ++fvit;
+          NS_ASSERT (m_columns[j] < n);
+          sum += fvit[m_columns[j]] * m_coefficients[j];
         }
-      *tvit = sum;
-      ++tvit;
+      tvit[i] = sum;
     }
 
   return tvvf;
@@ -22,6 +22,7 @@
 #define SPECTRUM_CONVERTER_H
 
 #include <ns3/spectrum-value.h>
+#include <vector>
 
 
 namespace ns3 {
@@ -59,6 +60,9 @@ public:
   /**
    * Convert a particular ValueVsFreq instance to
    *
+   * Only the coefficients of the bands where the provided ValueVsFreq
+   * is not zero are applied.
+   *
    * @param vvf the ValueVsFreq instance to be converted
    *
    * @return the converted version of the provided ValueVsFreq
@@ -78,7 +82,17 @@ private:
    */
   double GetCoefficient (const BandInfo& from, const BandInfo& to) const;
 
-  std::vector<std::vector<double> > m_conversionMatrix; // /< matrix of conversion coefficients
+  /*
+   * The matrix of conversion coefficients, stored in compressed sparse
+   * row form since a band of the "to" SpectrumModel usually overlaps few
+   * bands of the "from" SpectrumModel: the non-zero coefficients of
+   * row i, and the indices of the "from" bands they apply to, are at
+   * positions m_rowStart[i] to m_rowStart[i + 1] - 1 of m_coefficients
+   * and m_columns, in increasing order of band.
+   */
+  std::vector<size_t> m_rowStart;
+  std::vector<size_t> m_columns;
+  std::vector<double> m_coefficients;
   Ptr<const SpectrumModel> m_fromSpectrumModel;  // /<  the SpectrumModel this SpectrumConverter instance can convert from
   Ptr<const SpectrumModel> m_toSpectrumModel;    // /<  the SpectrumModel this SpectrumConverter instance can convert to
 
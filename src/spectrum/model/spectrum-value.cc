@@ -22,6 +22,8 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/math.h>
 #include <ns3/log.h>
+#include <string.h>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
 
@@ -29,6 +31,98 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumValue");
 namespace ns3 {
 
 
+Values::Values ()
+  : m_data (m_small),
+    m_size (0),
+    m_capacity (SMALL_SIZE)
+{
+}
+
+Values::Values (size_t size)
+  : m_data (m_small),
+    m_size (0),
+    m_capacity (SMALL_SIZE)
+{
+  Allocate (size);
+  memset (m_data, 0, size * sizeof (double));
+}
+
+Values::Values (const Values &o)
+  : m_data (m_small),
+    m_size (0),
+    m_capacity (SMALL_SIZE)
+{
+  Allocate (o.m_size);
+  memcpy (m_data, o.m_data, o.m_size * sizeof (double));
+}
+
+Values &
+Values::operator= (const Values &o)
+{
+  if (this != &o)
+    {
+      Allocate (o.m_size);
+      memcpy (m_data, o.m_data, o.m_size * sizeof (double));
+    }
+  return *this;
+}
+
+Values::~Values ()
+{
+  if (m_data != m_small)
+    {
+      delete [] m_data;
+    }
+}
+
+void
+Values::Allocate (size_t size)
+{
+  if (size > m_capacity || (size <= SMALL_SIZE && m_data != m_small))
+    {
+      if (m_data != m_small)
+        {
+          delete [] m_data;
+        }
+      m_data = size > SMALL_SIZE ? new double[size] : m_small;
+      m_capacity = size > SMALL_SIZE ? size : SMALL_SIZE;
+    }
+  m_size = size;
+}
+
+void
+Values::reserve (size_t capacity)
+{
+  if (capacity <= m_capacity)
+    {
+      return;
+    }
+  double *data = new double[capacity];
+  memcpy (data, m_data, m_size * sizeof (double));
+  if (m_data != m_small)
+    {
+      delete [] m_data;
+    }
+  m_data = data;
+  m_capacity = capacity;
+}
+
+void
+Values::resize (size_t size, double value)
+{
+  reserve (size);
+  std::fill (m_data + std::min (m_size, size), m_data + size, value);
+  m_size = size;
+}
+
+void
+Values::assign (size_t size, double value)
+{
+  Allocate (size);
+  std::fill (m_data, m_data + size, value);
+}
+
+
 SpectrumValue::SpectrumValue ()
 {
 }
@@ -99,20 +193,20 @@ SpectrumValue::ConstBandsEnd () const
 }
 
 
+// The loops over the values below index plain arrays of doubles, so that
+// the compiler can vectorize them.
+
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.begin ();
+  const double *w = x.m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      v[i] += w[i];
     }
 }
 
@@ -120,12 +214,11 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 += s;
-      ++it1;
+      v[i] += s;
     }
 }
 
@@ -134,17 +227,14 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.begin ();
+  const double *w = x.m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      v[i] -= w[i];
     }
 }
 
@@ -160,17 +250,14 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.begin ();
+  const double *w = x.m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      v[i] *= w[i];
     }
 }
 
@@ -178,12 +265,11 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 *= s;
-      ++it1;
+      v[i] *= s;
     }
 }
 
@@ -193,17 +279,14 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
-
-  while (it1 != m_values.end ())
+  NS_ASSERT (m_values.size () == x.m_values.size ());
+  double *v = m_values.begin ();
+  const double *w = x.m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      v[i] /= w[i];
     }
 }
 
@@ -212,12 +295,11 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 /= s;
-      ++it1;
+      v[i] /= s;
     }
 }
 
@@ -227,12 +309,11 @@ SpectrumValue::Divide (double s)
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = -(*it1);
-      ++it1;
+      v[i] = -v[i];
     }
 }
 
@@ -593,6 +674,25 @@ Log (const SpectrumValue& arg)
   return res;
 }
 
+SpectrumValue
+Sinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise)
+{
+  NS_ASSERT (signal.m_spectrumModel == allSignals.m_spectrumModel);
+  NS_ASSERT (signal.m_spectrumModel == noise.m_spectrumModel);
+  NS_ASSERT (signal.m_values.size () == allSignals.m_values.size ());
+  NS_ASSERT (signal.m_values.size () == noise.m_values.size ());
+  SpectrumValue res = signal;
+  double *v = res.m_values.begin ();
+  const double *a = allSignals.m_values.begin ();
+  const double *w = noise.m_values.begin ();
+  size_t n = res.m_values.size ();
+  for (size_t i = 0; i < n; i++)
+    {
+      v[i] = v[i] / ((a[i] - v[i]) + w[i]);
+    }
+  return res;
+}
+
 SpectrumValue&
 SpectrumValue:: operator+= (const SpectrumValue& rhs)
 {
@@ -654,12 +754,11 @@ SpectrumValue:: operator/= (double rhs)
 SpectrumValue&
 SpectrumValue:: operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.begin ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = rhs;
-      ++it1;
+      v[i] = rhs;
     }
   return *this;
 }
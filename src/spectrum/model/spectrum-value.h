@@ -25,12 +25,94 @@
 #include <ns3/simple-ref-count.h>
 #include <ns3/spectrum-model.h>
 #include <ostream>
-#include <vector>
+#include <cstddef>
+#include <stdexcept>
 
 namespace ns3 {
 
 
-typedef std::vector<double> Values;
+/**
+ * \ingroup spectrum
+ *
+ * \brief contiguous storage of the values of a SpectrumValue
+ *
+ * The values of up to SMALL_SIZE bands are stored in the object itself,
+ * which covers the Wi-Fi models and the LTE models of up to 25 resource
+ * blocks, the default bandwidth of LteEnbNetDevice: copying such a
+ * SpectrumValue, as all the arithmetic operators do, then allocates no
+ * memory. Larger models are stored on the heap, so that every
+ * SpectrumValue does not carry the storage of the largest model: with
+ * SMALL_SIZE = 25, sizeof (SpectrumValue) is 240 bytes instead of 840
+ * with room for 100 bands, but the LTE models of 50 and 100 resource
+ * blocks allocate again, 400 and 800 bytes per copy, as measured by
+ * utils/bench-spectrum-value.  Change SMALL_SIZE if most of the
+ * SpectrumValues of a simulation are larger.
+ *
+ * The iterators are plain pointers, so that the loops over the values
+ * can be vectorized by the compiler.
+ */
+class Values
+{
+public:
+  typedef double value_type;
+  typedef size_t size_type;
+  typedef double &reference;
+  typedef const double &const_reference;
+  typedef double *iterator;
+  typedef const double *const_iterator;
+
+  Values ();
+  /**
+   * \param size the number of values, all initialized to zero
+   */
+  explicit Values (size_t size);
+  Values (const Values &o);
+  Values &operator= (const Values &o);
+  ~Values ();
+
+  size_t size () const;
+  bool empty () const;
+  size_t capacity () const;
+  iterator begin ();
+  iterator end ();
+  const_iterator begin () const;
+  const_iterator end () const;
+  double &operator[] (size_t index);
+  const double &operator[] (size_t index) const;
+  /**
+   * \param index the index of a value
+   * \returns the value, after checking the index
+   *
+   * Throws std::out_of_range for an invalid index, as std::vector does.
+   */
+  double &at (size_t index);
+  const double &at (size_t index) const;
+
+  /**
+   * The members below behave as those of std::vector<double>, which
+   * stored the values before this class.
+   */
+  void clear ();
+  void reserve (size_t capacity);
+  void resize (size_t size, double value = 0.0);
+  void assign (size_t size, double value);
+  void push_back (double value);
+
+private:
+  /**
+   * Set the size, without keeping the values
+   */
+  void Allocate (size_t size);
+
+  enum
+  {
+    SMALL_SIZE = 25
+  };
+  double *m_data;
+  size_t m_size;
+  size_t m_capacity;
+  double m_small[SMALL_SIZE];
+};
 
 /**
  * \ingroup spectrum
@@ -489,6 +571,19 @@ public:
    */
   friend double Integral (const SpectrumValue&  arg);
 
+  /**
+   * Compute the signal to interference plus noise ratio of a signal,
+   * component by component, in a single pass and without temporaries.
+   *
+   * @param signal the power spectral density of the signal
+   * @param allSignals the sum of the power spectral densities of all
+   * the signals, including the one of interest
+   * @param noise the power spectral density of the noise
+   *
+   * @return the value of signal / (allSignals - signal + noise)
+   */
+  friend SpectrumValue Sinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise);
+
   /**
    *
    * @return a Ptr to a copy of this instance
@@ -541,6 +636,98 @@ SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
 double Integral (const SpectrumValue& arg);
+SpectrumValue Sinr (const SpectrumValue& signal, const SpectrumValue& allSignals, const SpectrumValue& noise);
+
+
+inline size_t
+Values::size () const
+{
+  return m_size;
+}
+
+inline bool
+Values::empty () const
+{
+  return m_size == 0;
+}
+
+inline size_t
+Values::capacity () const
+{
+  return m_capacity;
+}
+
+inline void
+Values::clear ()
+{
+  m_size = 0;
+}
+
+inline void
+Values::push_back (double value)
+{
+  if (m_size == m_capacity)
+    {
+      reserve (2 * m_capacity);
+    }
+  m_data[m_size++] = value;
+}
+
+inline Values::iterator
+Values::begin ()
+{
+  return m_data;
+}
+
+inline Values::iterator
+Values::end ()
+{
+  return m_data + m_size;
+}
+
+inline Values::const_iterator
+Values::begin () const
+{
+  return m_data;
+}
+
+inline Values::const_iterator
+Values::end () const
+{
+  return m_data + m_size;
+}
+
+inline double &
+Values::operator[] (size_t index)
+{
+  return m_data[index];
+}
+
+inline const double &
+Values::operator[] (size_t index) const
+{
+  return m_data[index];
+}
+
+inline double &
+Values::at (size_t index)
+{
+  if (index >= m_size)
+    {
+      throw std::out_of_range ("Values::at");
+    }
+  return m_data[index];
+}
+
+inline const double &
+Values::at (size_t index) const
+{
+  if (index >= m_size)
+    {
+      throw std::out_of_range ("Values::at");
+    }
+  return m_data[index];
+}
 
 
 } // namespace ns3
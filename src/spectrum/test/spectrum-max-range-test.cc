@@ -0,0 +1,273 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-model-ism2400MHz-res1MHz.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumMaxRangeTest");
+
+namespace ns3 {
+
+/**
+ * A SpectrumPhy which records the signals it receives.
+ */
+class MaxRangeTestPhy : public SpectrumPhy
+{
+public:
+  struct Reception
+  {
+    Time time;
+    Ptr<const SpectrumValue> psd;
+  };
+
+  MaxRangeTestPhy (Ptr<const SpectrumModel> rxSpectrumModel);
+
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice ();
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  std::vector<Reception> m_receptions;
+
+private:
+  virtual void DoDispose (void);
+
+  Ptr<const SpectrumModel> m_rxSpectrumModel;
+  Ptr<MobilityModel> m_mobility;
+};
+
+MaxRangeTestPhy::MaxRangeTestPhy (Ptr<const SpectrumModel> rxSpectrumModel)
+  : m_rxSpectrumModel (rxSpectrumModel)
+{
+}
+
+void
+MaxRangeTestPhy::DoDispose (void)
+{
+  m_mobility = 0;
+  SpectrumPhy::DoDispose ();
+}
+
+void
+MaxRangeTestPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+MaxRangeTestPhy::GetDevice ()
+{
+  return 0;
+}
+
+void
+MaxRangeTestPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+MaxRangeTestPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+MaxRangeTestPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+MaxRangeTestPhy::GetRxSpectrumModel () const
+{
+  return m_rxSpectrumModel;
+}
+
+Ptr<AntennaModel>
+MaxRangeTestPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+MaxRangeTestPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  Reception reception;
+  reception.time = Simulator::Now ();
+  reception.psd = params->psd;
+  m_receptions.push_back (reception);
+}
+
+
+/**
+ * Check that, with the MaxRange attribute of MultiModelSpectrumChannel,
+ * the receivers beyond range receive nothing, the receivers within range
+ * receive the same PSD at the same time as without MaxRange, and the
+ * receivers are found again after they move.
+ *
+ * The receivers use two RX SpectrumModels, so that the conversion of
+ * the transmitted PSD and the index of each SpectrumModel are exercised.
+ */
+class SpectrumMaxRangeTestCase : public TestCase
+{
+public:
+  SpectrumMaxRangeTestCase ();
+  virtual ~SpectrumMaxRangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Transmit twice from the origin, with the last receiver moved to
+   * 20 meters in between.
+   *
+   * \param maxRange the MaxRange attribute of the channel
+   * \return the receivers
+   */
+  std::vector<Ptr<MaxRangeTestPhy> > RunOne (double maxRange);
+  void Transmit (Ptr<MultiModelSpectrumChannel> channel, Ptr<MaxRangeTestPhy> txPhy);
+
+  Ptr<SpectrumModel> m_otherSpectrumModel;
+};
+
+SpectrumMaxRangeTestCase::SpectrumMaxRangeTestCase ()
+  : TestCase ("MultiModelSpectrumChannel MaxRange")
+{
+}
+
+SpectrumMaxRangeTestCase::~SpectrumMaxRangeTestCase ()
+{
+}
+
+void
+SpectrumMaxRangeTestCase::Transmit (Ptr<MultiModelSpectrumChannel> channel, Ptr<MaxRangeTestPhy> txPhy)
+{
+  Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters> ();
+  txParams->psd = Create<SpectrumValue> (SpectrumModelIsm2400MhzRes1Mhz);
+  (*txParams->psd) = 1.0e-9;
+  txParams->duration = MilliSeconds (1);
+  txParams->txPhy = txPhy;
+  channel->StartTx (txParams);
+}
+
+std::vector<Ptr<MaxRangeTestPhy> >
+SpectrumMaxRangeTestCase::RunOne (double maxRange)
+{
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+
+  Ptr<MaxRangeTestPhy> txPhy = CreateObject<MaxRangeTestPhy> (SpectrumModelIsm2400MhzRes1Mhz);
+  Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  txPhy->SetMobility (txMobility);
+
+  double distances[] = { 10.0, 250.0, 50.0, 400.0 };
+  std::vector<Ptr<MaxRangeTestPhy> > rxPhys;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<MaxRangeTestPhy> rxPhy = CreateObject<MaxRangeTestPhy> (i < 2 ? SpectrumModelIsm2400MhzRes1Mhz
+                                                                  : m_otherSpectrumModel);
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (0.0, distances[i], 0.0));
+      rxPhy->SetMobility (mobility);
+      channel->AddRx (rxPhy);
+      rxPhys.push_back (rxPhy);
+    }
+
+  Simulator::Schedule (Seconds (1.0), &SpectrumMaxRangeTestCase::Transmit, this, channel, txPhy);
+  Simulator::Schedule (Seconds (2.0), &MobilityModel::SetPosition, rxPhys[3]->GetMobility (),
+                       Vector (20.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &SpectrumMaxRangeTestCase::Transmit, this, channel, txPhy);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return rxPhys;
+}
+
+void
+SpectrumMaxRangeTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      freqs.push_back (2.4385e9 + i * 2.5e6);
+    }
+  m_otherSpectrumModel = Create<SpectrumModel> (freqs);
+
+  std::vector<Ptr<MaxRangeTestPhy> > all = RunOne (0.0);
+  std::vector<Ptr<MaxRangeTestPhy> > culled = RunOne (100.0);
+
+  // receivers 0 and 2 are in range, receiver 1 is not, receiver 3 moves
+  // in range before the second transmission
+  uint32_t expected[] = { 2, 0, 2, 1 };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (all[i]->m_receptions.size (), 2, "receiver " << i << " missed a signal without MaxRange");
+      NS_TEST_ASSERT_MSG_EQ (culled[i]->m_receptions.size (), expected[i], "wrong number of signals at receiver " << i);
+      // receiver 3 only receives the second transmission
+      uint32_t skipped = all[i]->m_receptions.size () - culled[i]->m_receptions.size ();
+      for (uint32_t j = 0; j < culled[i]->m_receptions.size (); j++)
+        {
+          const MaxRangeTestPhy::Reception &ref = all[i]->m_receptions[j + skipped];
+          const MaxRangeTestPhy::Reception &rx = culled[i]->m_receptions[j];
+          NS_TEST_ASSERT_MSG_EQ (rx.time, ref.time, "wrong reception time at receiver " << i);
+          NS_TEST_ASSERT_MSG_EQ (rx.psd->GetSpectrumModel (), ref.psd->GetSpectrumModel (),
+                                 "wrong SpectrumModel at receiver " << i);
+          Values::const_iterator rxIt = rx.psd->ConstValuesBegin ();
+          Values::const_iterator refIt = ref.psd->ConstValuesBegin ();
+          for (; refIt != ref.psd->ConstValuesEnd (); ++rxIt, ++refIt)
+            {
+              NS_TEST_ASSERT_MSG_EQ (rxIt != rx.psd->ConstValuesEnd (), true, "short PSD at receiver " << i);
+              NS_TEST_ASSERT_MSG_EQ_TOL (*rxIt, *refIt, 1e-30, "wrong PSD at receiver " << i);
+            }
+          NS_TEST_ASSERT_MSG_EQ (rxIt == rx.psd->ConstValuesEnd (), true, "long PSD at receiver " << i);
+        }
+    }
+  m_otherSpectrumModel = 0;
+}
+
+
+class SpectrumMaxRangeTestSuite : public TestSuite
+{
+public:
+  SpectrumMaxRangeTestSuite ();
+};
+
+SpectrumMaxRangeTestSuite::SpectrumMaxRangeTestSuite ()
+  : TestSuite ("spectrum-max-range", UNIT)
+{
+  AddTestCase (new SpectrumMaxRangeTestCase);
+}
+
+static SpectrumMaxRangeTestSuite g_spectrumMaxRangeTestSuite;
+
+} // namespace ns3
@@ -77,6 +77,48 @@ SpectrumValueTestCase::DoRun (void)
 }
 
 
+// The members of Values which behave as those of std::vector<double>
+class ValuesTestCase : public TestCase
+{
+public:
+  ValuesTestCase ();
+  virtual void DoRun (void);
+};
+
+ValuesTestCase::ValuesTestCase ()
+  : TestCase ("Values behaves as std::vector<double>")
+{
+}
+
+void
+ValuesTestCase::DoRun (void)
+{
+  Values v;
+  NS_TEST_ASSERT_MSG_EQ (v.empty (), true, "a new Values should be empty");
+  // grow past the inline storage, keeping the values
+  for (int i = 0; i < 100; i++)
+    {
+      v.push_back (i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (v.size (), 100, "wrong size after push_back");
+  for (int i = 0; i < 100; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (v[i], i, "wrong value after push_back");
+    }
+  v.resize (10);
+  v.resize (20, 7.0);
+  NS_TEST_ASSERT_MSG_EQ (v.size (), 20, "wrong size after resize");
+  NS_TEST_ASSERT_MSG_EQ (v[9], 9.0, "resize lost a value");
+  NS_TEST_ASSERT_MSG_EQ (v[19], 7.0, "resize did not set the new values");
+  v.assign (30, 2.0);
+  NS_TEST_ASSERT_MSG_EQ (v.size (), 30, "wrong size after assign");
+  NS_TEST_ASSERT_MSG_EQ (v[0], 2.0, "assign did not set the values");
+  NS_TEST_ASSERT_MSG_EQ (v[29], 2.0, "assign did not set the values");
+  v.clear ();
+  NS_TEST_ASSERT_MSG_EQ (v.empty (), true, "clear should empty the Values");
+}
+
+
 
 
 
@@ -243,6 +285,44 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
   AddTestCase (new SpectrumValueTestCase (tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"));
 
 
+  SpectrumValue signal = v2 * v2;
+  SpectrumValue allSignals = signal + v1 * v1;
+  SpectrumValue noise (f);
+  noise = 0.01;
+  SpectrumValue sinr = Sinr (signal, allSignals, noise);
+  AddTestCase (new SpectrumValueTestCase (sinr, signal / (allSignals - signal + noise),
+                                          "sinr = Sinr (signal, allSignals, noise)"));
+
+
+  // the values of this model do not fit in the storage of SpectrumValue
+  // itself
+  std::vector<double> manyFreqs;
+  for (int i = 1; i <= 150; i++)
+    {
+      manyFreqs.push_back (i);
+    }
+  Ptr<SpectrumModel> g = Create<SpectrumModel> (manyFreqs);
+  SpectrumValue w1 (g), w2 (g);
+  for (int i = 0; i < 150; i++)
+    {
+      w1[i] = i;
+      w2[i] = 2 * i;
+    }
+  SpectrumValue tw2;
+  tw2 = w1;
+  tw2 += w1;
+  AddTestCase (new SpectrumValueTestCase (tw2, w2, "tw2 = w1 + w1"));
+  SpectrumValue tw1 = v1;
+  tw1 = w1;
+  tw1 = w2 - tw1;
+  AddTestCase (new SpectrumValueTestCase (tw1, w1, "tw1 = w2 - w1"));
+  tv3 = tw1;
+  tv3 = v1 + v2;
+  AddTestCase (new SpectrumValueTestCase (tv3, v3, "tv3 = v1 + v2 after tv3 = w1"));
+
+  AddTestCase (new ValuesTestCase ());
+
+
 }
 
 
@@ -330,6 +410,44 @@ SpectrumConverterTestSuite::SpectrumConverterTestSuite ()
   AddTestCase (new SpectrumValueTestCase (t21b, *res, ""));
 
 
+  // each band of sof4 covers exactly five bands of sof3
+  std::vector<double> f3;
+  for (f = 0; f < 20; f += 1)
+    {
+      f3.push_back (f);
+    }
+  Ptr<SpectrumModel> sof3 = Create<SpectrumModel> (f3);
+  std::vector<double> f4;
+  for (f = 2; f < 20; f += 5)
+    {
+      f4.push_back (f);
+    }
+  Ptr<SpectrumModel> sof4 = Create<SpectrumModel> (f4);
+  SpectrumConverter c34 (sof3, sof4);
+
+  // a signal in a few bands only
+  Ptr<SpectrumValue> v3a = Create<SpectrumValue> (sof3);
+  (*v3a)[6] = 1;
+  (*v3a)[7] = 2;
+  (*v3a)[8] = 3;
+  res = c34.Convert (v3a);
+  SpectrumValue t34a (sof4);
+  t34a[1] = (1 + 2 + 3) * 0.2;
+  AddTestCase (new SpectrumValueTestCase (t34a, *res, "band-limited signal"));
+
+  Ptr<SpectrumValue> v3b = Create<SpectrumValue> (sof3);
+  (*v3b)[4] = 5;
+  (*v3b)[15] = 10;
+  res = c34.Convert (v3b);
+  SpectrumValue t34b (sof4);
+  t34b[0] = 1;
+  t34b[3] = 2;
+  AddTestCase (new SpectrumValueTestCase (t34b, *res, "signal at the edges of the bands"));
+
+  Ptr<SpectrumValue> v3c = Create<SpectrumValue> (sof3);
+  res = c34.Convert (v3c);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (sof4), *res, "no signal"));
+
 }
 
 
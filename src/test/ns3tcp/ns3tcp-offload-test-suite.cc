@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/csma-helper.h"
+#include "ns3/csma-net-device.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpOffloadTest");
+
+// ===========================================================================
+// Tests of the segmentation offload mode of TcpSocketBase
+// ===========================================================================
+//
+// A bulk transfer runs with and without segmentation offload: all the data
+// must arrive and, when the device supports segmentation offload, in far
+// fewer frames and, over a point-to-point link, in about the same time.
+//
+class Ns3TcpOffloadTestCase : public TestCase
+{
+public:
+  enum Link
+  {
+    POINT_TO_POINT,
+    CSMA,
+    CSMA_LLC // does not support segmentation offload
+  };
+  Ns3TcpOffloadTestCase (enum Link link);
+  virtual ~Ns3TcpOffloadTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  void Transfer (uint16_t offloadSegments);
+  void PhyTxEnd (Ptr<const Packet> p);
+  void SinkRx (Ptr<const Packet> p, const Address &address);
+
+  enum Link m_link;
+  uint32_t m_frames;
+  Time m_lastRx;
+};
+
+Ns3TcpOffloadTestCase::Ns3TcpOffloadTestCase (enum Link link)
+  : TestCase ("Check the segmentation offload mode of ns-3 TCP over a "
+              + std::string (link == POINT_TO_POINT ? "point-to-point" : link == CSMA ? "CSMA" : "LLC CSMA")
+              + " link"),
+    m_link (link)
+{
+}
+
+void
+Ns3TcpOffloadTestCase::PhyTxEnd (Ptr<const Packet> p)
+{
+  m_frames++;
+}
+
+void
+Ns3TcpOffloadTestCase::SinkRx (Ptr<const Packet> p, const Address &address)
+{
+  m_lastRx = Simulator::Now ();
+}
+
+void
+Ns3TcpOffloadTestCase::Transfer (uint16_t offloadSegments)
+{
+  const uint32_t totalBytes = 1000000;
+  m_frames = 0;
+  m_lastRx = Seconds (0);
+  Config::SetDefault ("ns3::TcpSocketBase::OffloadSegments", UintegerValue (offloadSegments));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  NetDeviceContainer devices;
+  if (m_link == POINT_TO_POINT)
+    {
+      PointToPointHelper pointToPoint;
+      pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+      pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+      devices = pointToPoint.Install (nodes);
+    }
+  else
+    {
+      CsmaHelper csma;
+      csma.SetChannelAttribute ("DataRate", StringValue ("100Mbps"));
+      csma.SetChannelAttribute ("Delay", StringValue ("1ms"));
+      csma.SetDeviceAttribute ("EncapsulationMode",
+                               EnumValue (m_link == CSMA ? CsmaNetDevice::DIX : CsmaNetDevice::LLC));
+      devices = csma.Install (nodes);
+    }
+  devices.Get (0)->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&Ns3TcpOffloadTestCase::PhyTxEnd, this));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 50000;
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory",
+                               InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sinkHelper.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkApps.Get (0));
+  sink->TraceConnectWithoutContext ("Rx", MakeCallback (&Ns3TcpOffloadTestCase::SinkRx, this));
+
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (totalBytes));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.1));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (sink->GetTotalRx (), totalBytes, "Not all the data was received with "
+                         << offloadSegments << " offload segments");
+  Simulator::Destroy ();
+}
+
+void
+Ns3TcpOffloadTestCase::DoRun (void)
+{
+  Transfer (1);
+  uint32_t frames = m_frames;
+  Time duration = m_lastRx;
+  Transfer (16);
+  if (m_link == CSMA_LLC)
+    { // TcpL4Protocol splits the super-segments for the device
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_frames, frames, frames / 10, "The super-segments should be split");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_LT (m_frames * 4, frames, "Segmentation offload should send fewer frames");
+    }
+  if (m_link == POINT_TO_POINT)
+    { // Over CSMA, the collisions of the data and the ACKs dominate the duration
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_lastRx.GetSeconds (), duration.GetSeconds (), duration.GetSeconds () / 10,
+                                 "Segmentation offload should not change the duration of the transfer much");
+    }
+  Config::SetDefault ("ns3::TcpSocketBase::OffloadSegments", UintegerValue (1));
+}
+
+class Ns3TcpOffloadTestSuite : public TestSuite
+{
+public:
+  Ns3TcpOffloadTestSuite ();
+};
+
+Ns3TcpOffloadTestSuite::Ns3TcpOffloadTestSuite ()
+  : TestSuite ("ns3-tcp-offload", SYSTEM)
+{
+  AddTestCase (new Ns3TcpOffloadTestCase (Ns3TcpOffloadTestCase::POINT_TO_POINT));
+  AddTestCase (new Ns3TcpOffloadTestCase (Ns3TcpOffloadTestCase::CSMA));
+  AddTestCase (new Ns3TcpOffloadTestCase (Ns3TcpOffloadTestCase::CSMA_LLC));
+}
+
+static Ns3TcpOffloadTestSuite ns3TcpOffloadTestSuite;
@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/type-id.h"
+#include "ns3/error-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Ns3TcpSackTest");
+
+// ===========================================================================
+// Tests of the SACK option and of the SACK-based loss recovery of ns-3 TCP
+// ===========================================================================
+//
+// A bulk transfer over a point-to-point link loses four segments of the
+// same window. With SACK on both ends, TcpSack must repair the losses in
+// about one round trip, so the transfer must end sooner than with
+// TcpNewReno, which repairs one loss per round trip. If only the sender
+// offers SACK, it is not negotiated and TcpSack must behave exactly as
+// TcpNewReno.
+//
+class Ns3TcpSackTestCase : public TestCase
+{
+public:
+  enum Mode
+  {
+    SACK,        // TcpSack with SACK on both ends
+    SENDER_ONLY  // TcpSack offering SACK to a receiver which does not
+  };
+  Ns3TcpSackTestCase (enum Mode mode);
+  virtual ~Ns3TcpSackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  void Transfer (std::string socketType, bool senderSack, bool receiverSack);
+  void PhyTxEnd (Ptr<const Packet> p);
+  void SinkRx (Ptr<const Packet> p, const Address &address);
+  static void EnableSack (bool enable);
+
+  enum Mode m_mode;
+  uint32_t m_frames;
+  Time m_lastRx;
+};
+
+Ns3TcpSackTestCase::Ns3TcpSackTestCase (enum Mode mode)
+  : TestCase (mode == SACK ? "Check that SACK repairs several losses of a window faster than NewReno"
+              : "Check that TcpSack falls back to NewReno when SACK is not negotiated"),
+    m_mode (mode)
+{
+}
+
+void
+Ns3TcpSackTestCase::PhyTxEnd (Ptr<const Packet> p)
+{
+  m_frames++;
+}
+
+void
+Ns3TcpSackTestCase::SinkRx (Ptr<const Packet> p, const Address &address)
+{
+  m_lastRx = Simulator::Now ();
+}
+
+void
+Ns3TcpSackTestCase::EnableSack (bool enable)
+{
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (enable));
+}
+
+void
+Ns3TcpSackTestCase::Transfer (std::string socketType, bool senderSack, bool receiverSack)
+{
+  const uint32_t totalBytes = 200000;
+  m_frames = 0;
+  m_lastRx = Seconds (0);
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TypeId::LookupByName (socketType)));
+  // The sockets are created when the applications start
+  EnableSack (receiverSack);
+  Simulator::Schedule (Seconds (0.05), &Ns3TcpSackTestCase::EnableSack, senderSack);
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+  devices.Get (0)->TraceConnectWithoutContext ("PhyTxEnd", MakeCallback (&Ns3TcpSackTestCase::PhyTxEnd, this));
+
+  // Lose four segments of the same window
+  std::list<uint32_t> losses;
+  losses.push_back (40);
+  losses.push_back (43);
+  losses.push_back (46);
+  losses.push_back (49);
+  Ptr<ReceiveListErrorModel> errorModel = CreateObject<ReceiveListErrorModel> ();
+  errorModel->SetList (losses);
+  devices.Get (1)->SetAttribute ("ReceiveErrorModel", PointerValue (errorModel));
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 50000;
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory",
+                               InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sinkHelper.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0));
+  Ptr<PacketSink> sink = DynamicCast<PacketSink> (sinkApps.Get (0));
+  sink->TraceConnectWithoutContext ("Rx", MakeCallback (&Ns3TcpSackTestCase::SinkRx, this));
+
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (interfaces.GetAddress (1), port));
+  source.SetAttribute ("MaxBytes", UintegerValue (totalBytes));
+  ApplicationContainer sourceApps = source.Install (nodes.Get (0));
+  sourceApps.Start (Seconds (0.1));
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (sink->GetTotalRx (), totalBytes, "Not all the data was received with " << socketType);
+  Simulator::Destroy ();
+}
+
+void
+Ns3TcpSackTestCase::DoRun (void)
+{
+  Transfer ("ns3::TcpNewReno", false, false);
+  uint32_t frames = m_frames;
+  Time duration = m_lastRx;
+  if (m_mode == SACK)
+    {
+      Transfer ("ns3::TcpSack", true, true);
+      NS_LOG_INFO ("NewReno: " << frames << " frames in " << duration.GetSeconds () << "s, SACK: "
+                   << m_frames << " frames in " << m_lastRx.GetSeconds () << "s");
+      NS_TEST_EXPECT_MSG_LT (m_lastRx, duration, "SACK should repair the losses faster");
+      NS_TEST_EXPECT_MSG_LT (m_frames, frames + 1, "SACK should not retransmit more");
+    }
+  else
+    {
+      Transfer ("ns3::TcpSack", true, false);
+      // The SYN carries the SACK-permitted option, 4 bytes longer
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_lastRx.GetSeconds (), duration.GetSeconds (), 1e-5, "TcpSack should behave as TcpNewReno");
+      NS_TEST_EXPECT_MSG_EQ (m_frames, frames, "TcpSack should behave as TcpNewReno");
+    }
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TypeId::LookupByName ("ns3::TcpNewReno")));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (false));
+}
+
+class Ns3TcpSackTestSuite : public TestSuite
+{
+public:
+  Ns3TcpSackTestSuite ();
+};
+
+Ns3TcpSackTestSuite::Ns3TcpSackTestSuite ()
+  : TestSuite ("ns3-tcp-sack", SYSTEM)
+{
+  AddTestCase (new Ns3TcpSackTestCase (Ns3TcpSackTestCase::SACK));
+  AddTestCase (new Ns3TcpSackTestCase (Ns3TcpSackTestCase::SENDER_ONLY));
+}
+
+static Ns3TcpSackTestSuite ns3TcpSackTestSuite;
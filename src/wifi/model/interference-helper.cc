@@ -22,6 +22,7 @@
 #include "error-rate-model.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/free-list-pool.h"
 #include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("InterferenceHelper");
@@ -32,6 +33,21 @@ namespace ns3 {
  *       Phy event class
  ****************************************************************/
 
+// each thread keeps at most 1024 free events
+static FreeListPool g_interferenceEventPool (sizeof (InterferenceHelper::Event), 1, 1024);
+
+void *
+InterferenceHelper::Event::operator new (size_t size)
+{
+  return g_interferenceEventPool.Allocate (size);
+}
+
+void
+InterferenceHelper::Event::operator delete (void *buffer, size_t size)
+{
+  g_interferenceEventPool.Deallocate (buffer, size);
+}
+
 InterferenceHelper::Event::Event (uint32_t size, WifiMode payloadMode,
                                   enum WifiPreamble preamble,
                                   Time duration, double rxPower)
@@ -201,7 +217,7 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
           m_firstPower += i->GetDelta ();
         }
       m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      m_niChanges.push_front (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
     }
   else
     {
@@ -226,24 +242,6 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
   return snr;
 }
 
-double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
-{
-  double noiseInterference = m_firstPower;
-  NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
-    {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
-    }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
-  return noiseInterference;
-}
-
 double
 InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode) const
 {
@@ -258,23 +256,37 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
 }
 
 double
-InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, double noiseInterferenceW) const
 {
+  NS_ASSERT (m_rxing);
   double psr = 1.0; /* Packet Success Rate */
-  NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  Time previous = event->GetStartTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
   WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (payloadMode, preamble);
-  Time plcpHeaderStart = (*j).GetTime () + MicroSeconds (WifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble));
+  Time plcpHeaderStart = previous + MicroSeconds (WifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble));
   Time plcpPayloadStart = plcpHeaderStart + MicroSeconds (WifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble));
-  double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
 
-  j++;
-  while (ni->end () != j)
+  /* The first change is the start of the event: the changes which follow
+   * it, up to the end of the event, split the event in chunks of constant
+   * noise and interference.
+   */
+  NiChanges::const_iterator j = m_niChanges.begin () + 1;
+  bool last = false;
+  while (!last)
     {
-      Time current = (*j).GetTime ();
+      Time current;
+      if (j == m_niChanges.end ()
+          || (j->GetTime () == event->GetEndTime () && j->GetDelta () == -powerW))
+        {
+          current = event->GetEndTime ();
+          last = true;
+        }
+      else
+        {
+          current = j->GetTime ();
+        }
       NS_ASSERT (current >= previous);
 
       if (previous >= plcpPayloadStart)
@@ -335,9 +347,12 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
             }
         }
 
-      noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
-      j++;
+      if (!last)
+        {
+          noiseInterferenceW += j->GetDelta ();
+          previous = current;
+          j++;
+        }
     }
 
   double per = 1 - psr;
@@ -348,16 +363,13 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculateSnrPer (Ptr<InterferenceHelper::Event> event)
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  double noiseInterferenceW = m_firstPower;
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetPayloadMode ());
 
-  /* calculate the SNIR at the start of the packet and accumulate
-   * all SNIR changes in the snir vector.
-   */
-  double per = CalculatePer (event, &ni);
+  /* calculate the SNIR over each chunk of the packet */
+  double per = CalculatePer (event, noiseInterferenceW);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
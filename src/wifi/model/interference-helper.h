@@ -21,8 +21,8 @@
 #define INTERFERENCE_HELPER_H
 
 #include <stdint.h>
-#include <vector>
-#include <list>
+#include <cstddef>
+#include <deque>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -55,6 +55,21 @@ public:
     uint32_t GetSize (void) const;
     WifiMode GetPayloadMode (void) const;
     enum WifiPreamble GetPreambleType (void) const;
+
+    /**
+     * \param size the size of the event object.
+     * \returns the storage of a new event object.
+     *
+     * A Wi-Fi phy creates an event for every frame it senses, so the
+     * storage of the released events is kept in a bounded per-thread
+     * free list and reused rather than returned to the allocator.
+     */
+    static void *operator new (size_t size);
+    /**
+     * \param buffer the storage of the event object to release.
+     * \param size the size of the event object.
+     */
+    static void operator delete (void *buffer, size_t size);
 private:
     uint32_t m_size;
     WifiMode m_payloadMode;
@@ -108,16 +123,28 @@ private:
     Time m_time;
     double m_delta;
   };
-  typedef std::vector <NiChange> NiChanges;
-  typedef std::list<Ptr<Event> > Events;
+  /**
+   * The power changes ordered by time. The changes older than the start
+   * of the current reception are folded into m_firstPower when an event
+   * is added outside of a reception, so the first element is always the
+   * start of the reception and only the overlapping signals are kept.
+   */
+  typedef std::deque<NiChange> NiChanges;
 
   InterferenceHelper (const InterferenceHelper &o);
   InterferenceHelper &operator = (const InterferenceHelper &o);
   void AppendEvent (Ptr<Event> event);
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
   double CalculateSnr (double signal, double noiseInterference, WifiMode mode) const;
   double CalculateChunkSuccessRate (double snir, Time delay, WifiMode mode) const;
-  double CalculatePer (Ptr<const Event> event, NiChanges *ni) const;
+  /**
+   * \param event the event being received
+   * \param noiseInterferenceW the noise and interference power at the start of the event
+   * \returns the packet error rate of the event
+   *
+   * Walks the power changes from the start of the event to its end in
+   * place, without copying them.
+   */
+  double CalculatePer (Ptr<const Event> event, double noiseInterferenceW) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
@@ -0,0 +1,316 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <string>
+#include "tabulated-error-rate-model.h"
+#include "nist-error-rate-model.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+
+#ifdef HAVE_PTHREAD_H
+#define NS3_TABULATED_ERROR_RATE_MUTEX 1
+#include "ns3/system-mutex.h"
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("TabulatedErrorRateModel");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedErrorRateModel);
+
+// The bounds of ln (-ln s) in the tables, for the success rates of exactly
+// one and zero
+static const double LOG_Q_MIN = -700.0;
+static const double LOG_Q_MAX = 700.0;
+// ln (-ln 0.5): below this success rate, the success rate itself is
+// interpolated, since ln (-ln s) bends sharply as s drops to zero
+static const double LOG_Q_HALF = -0.36651292058166435;
+
+namespace {
+
+struct TableKey
+{
+  std::string model;
+  uint32_t mode;
+  double minSnrDb;
+  double maxSnrDb;
+  double resolutionDb;
+
+  bool operator < (const TableKey &o) const
+  {
+    if (model != o.model)
+      {
+        return model < o.model;
+      }
+    if (mode != o.mode)
+      {
+        return mode < o.mode;
+      }
+    if (minSnrDb != o.minSnrDb)
+      {
+        return minSnrDb < o.minSnrDb;
+      }
+    if (maxSnrDb != o.maxSnrDb)
+      {
+        return maxSnrDb < o.maxSnrDb;
+      }
+    return resolutionDb < o.resolutionDb;
+  }
+};
+
+// The type of the model and the values of its attributes, so that the
+// models configured differently do not share their tables
+std::string
+GetModelKey (Ptr<const ErrorRateModel> model)
+{
+  TypeId tid = model->GetInstanceTypeId ();
+  std::ostringstream oss;
+  oss << tid.GetName ();
+  do
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ())
+            {
+              continue;
+            }
+          Ptr<AttributeValue> value = info.checker->Create ();
+          if (info.accessor->Get (PeekPointer (model), *value))
+            {
+              oss << '|' << info.name << '=' << value->SerializeToString (info.checker);
+            }
+        }
+      tid = tid.GetParent ();
+    } while (tid != ObjectBase::GetTypeId ());
+  return oss.str ();
+}
+
+} // anonymous namespace
+
+// The tables of all the instances, which may run in the threads of the
+// multithreaded simulator
+static std::map<TableKey, std::vector<double> > g_tables;
+#ifdef NS3_TABULATED_ERROR_RATE_MUTEX
+static SystemMutex g_tablesMutex;
+#endif
+
+TypeId
+TabulatedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .AddConstructor<TabulatedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model to tabulate, a NistErrorRateModel if none is set.",
+                   PointerValue (),
+                   MakePointerAccessor (&TabulatedErrorRateModel::SetErrorRateModel,
+                                        &TabulatedErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("MinSnr",
+                   "The lowest SNR of the tables, in dB.",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::SetMinSnr,
+                                       &TabulatedErrorRateModel::GetMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxSnr",
+                   "The highest SNR of the tables, in dB.",
+                   DoubleValue (50.0),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::SetMaxSnr,
+                                       &TabulatedErrorRateModel::GetMaxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Resolution",
+                   "The step of the SNR in the tables, in dB.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&TabulatedErrorRateModel::SetResolution,
+                                       &TabulatedErrorRateModel::GetResolution),
+                   MakeDoubleChecker<double> (1e-4))
+    .AddAttribute ("Interpolation",
+                   "How the error rate is found between two SNRs of the tables.",
+                   EnumValue (TabulatedErrorRateModel::LINEAR),
+                   MakeEnumAccessor (&TabulatedErrorRateModel::m_interpolation),
+                   MakeEnumChecker (TabulatedErrorRateModel::LINEAR, "Linear",
+                                    TabulatedErrorRateModel::NEAREST, "Nearest"))
+  ;
+  return tid;
+}
+
+TabulatedErrorRateModel::TabulatedErrorRateModel ()
+{
+}
+
+void
+TabulatedErrorRateModel::SetErrorRateModel (Ptr<ErrorRateModel> model)
+{
+  m_model = model;
+  m_tables.clear ();
+}
+
+Ptr<ErrorRateModel>
+TabulatedErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_model;
+}
+
+void
+TabulatedErrorRateModel::SetMinSnr (double snrDb)
+{
+  m_minSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+TabulatedErrorRateModel::GetMinSnr (void) const
+{
+  return m_minSnrDb;
+}
+
+void
+TabulatedErrorRateModel::SetMaxSnr (double snrDb)
+{
+  m_maxSnrDb = snrDb;
+  m_tables.clear ();
+}
+
+double
+TabulatedErrorRateModel::GetMaxSnr (void) const
+{
+  return m_maxSnrDb;
+}
+
+void
+TabulatedErrorRateModel::SetResolution (double resolutionDb)
+{
+  m_resolutionDb = resolutionDb;
+  m_tables.clear ();
+}
+
+double
+TabulatedErrorRateModel::GetResolution (void) const
+{
+  return m_resolutionDb;
+}
+
+const TabulatedErrorRateModel::Table *
+TabulatedErrorRateModel::GetTable (WifiMode mode) const
+{
+  uint32_t uid = mode.GetUid ();
+  if (uid < m_tables.size () && m_tables[uid] != 0)
+    {
+      return m_tables[uid];
+    }
+  if (m_model == 0)
+    {
+      const_cast<TabulatedErrorRateModel *> (this)->m_model = CreateObject<NistErrorRateModel> ();
+    }
+  TableKey key;
+  key.model = GetModelKey (m_model);
+  key.mode = uid;
+  key.minSnrDb = m_minSnrDb;
+  key.maxSnrDb = m_maxSnrDb;
+  key.resolutionDb = m_resolutionDb;
+#ifdef NS3_TABULATED_ERROR_RATE_MUTEX
+  CriticalSection cs (g_tablesMutex);
+#endif
+  std::map<TableKey, Table>::iterator i = g_tables.find (key);
+  if (i == g_tables.end ())
+    {
+      NS_LOG_DEBUG ("Tabulating " << key.model << " for " << mode);
+      i = g_tables.insert (std::make_pair (key, Table ())).first;
+      Table &table = i->second;
+      uint32_t size = static_cast<uint32_t> ((m_maxSnrDb - m_minSnrDb) / m_resolutionDb) + 1;
+      table.resize (size);
+      for (uint32_t j = 0; j < size; j++)
+        {
+          double snr = std::pow (10.0, (m_minSnrDb + j * m_resolutionDb) / 10.0);
+          double s = m_model->GetChunkSuccessRate (mode, snr, 1);
+          if (s >= 1.0)
+            {
+              table[j] = LOG_Q_MIN;
+            }
+          else if (s <= 0.0)
+            {
+              table[j] = LOG_Q_MAX;
+            }
+          else
+            {
+              table[j] = std::max (LOG_Q_MIN, std::min (LOG_Q_MAX, std::log (-std::log (s))));
+            }
+        }
+    }
+  if (uid >= m_tables.size ())
+    {
+      m_tables.resize (uid + 1, 0);
+    }
+  m_tables[uid] = &i->second;
+  return m_tables[uid];
+}
+
+double
+TabulatedErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  const Table *table = GetTable (mode);
+  if (snr <= 0.0)
+    {
+      return m_model->GetChunkSuccessRate (mode, snr, nbits);
+    }
+  double position = (10.0 * std::log10 (snr) - m_minSnrDb) / m_resolutionDb;
+  if (position < 0.0 || position > table->size () - 1)
+    {
+      return m_model->GetChunkSuccessRate (mode, snr, nbits);
+    }
+  if (nbits == 0)
+    {
+      return 1.0;
+    }
+  uint32_t j = static_cast<uint32_t> (position);
+  uint32_t k = std::min<uint32_t> (j + 1, table->size () - 1);
+  if ((*table)[j] == LOG_Q_MAX && (*table)[k] == LOG_Q_MAX)
+    {
+      return 0.0;
+    }
+  if ((*table)[j] == LOG_Q_MAX || (*table)[k] == LOG_Q_MAX)
+    {
+      // The success rate of the models drops to zero without a limit of
+      // ln (-ln s), so this interval is not interpolated
+      return m_model->GetChunkSuccessRate (mode, snr, nbits);
+    }
+  double logQ;
+  if (m_interpolation == NEAREST)
+    {
+      logQ = (*table)[position - j < 0.5 ? j : k];
+    }
+  else if ((*table)[j] > LOG_Q_HALF || (*table)[k] > LOG_Q_HALF)
+    {
+      double sj = std::exp (-std::exp ((*table)[j]));
+      double sk = std::exp (-std::exp ((*table)[k]));
+      double s = sj + (position - j) * (sk - sj);
+      return std::exp (nbits * std::log (s));
+    }
+  else
+    {
+      logQ = (*table)[j] + (position - j) * ((*table)[k] - (*table)[j]);
+    }
+  // exp (-nbits * q) is s^nbits
+  return std::exp (-(nbits * std::exp (logQ)));
+}
+
+} // namespace ns3
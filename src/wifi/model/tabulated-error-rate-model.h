@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TABULATED_ERROR_RATE_MODEL_H
+#define TABULATED_ERROR_RATE_MODEL_H
+
+#include <stdint.h>
+#include <vector>
+#include "wifi-mode.h"
+#include "error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief an error rate model which looks up the results of another one
+ *
+ * The chunk success rates of the error rate models of this module are all
+ * of the form s(snr)^nbits, where s is the success rate of a single bit.
+ * This model samples -ln s(snr) of the model it wraps on a grid of SNR in
+ * dB, the first time each WifiMode is used, and then computes the success
+ * rate of a chunk as exp (-nbits * q), where q is looked up in the table.
+ * The logarithm of q is interpolated linearly, which follows the
+ * exponential decrease of the error rate with the SNR.
+ *
+ * The SNRs out of the grid are given to the wrapped model.  The tables are
+ * shared by the instances which wrap a model of the same type, with the same
+ * values of its attributes, on the same grid; they are guarded by a mutex
+ * when threads are available.  The key is computed the first time each
+ * WifiMode is used, so a wrapped model must not be reconfigured after that,
+ * nor depend on a state which its attributes do not show.
+ */
+class TabulatedErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  enum Interpolation
+  {
+    LINEAR,
+    NEAREST
+  };
+
+  TabulatedErrorRateModel ();
+
+  /**
+   * \param model the model to tabulate, a NistErrorRateModel by default
+   */
+  void SetErrorRateModel (Ptr<ErrorRateModel> model);
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * The tables of the modes used so far are looked up again when the grid
+   * changes.
+   *
+   * \param snrDb the lowest SNR of the tables, in dB
+   */
+  void SetMinSnr (double snrDb);
+  double GetMinSnr (void) const;
+  /**
+   * \param snrDb the highest SNR of the tables, in dB
+   */
+  void SetMaxSnr (double snrDb);
+  double GetMaxSnr (void) const;
+  /**
+   * \param resolutionDb the step of the SNR in the tables, in dB
+   */
+  void SetResolution (double resolutionDb);
+  double GetResolution (void) const;
+
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+private:
+  typedef std::vector<double> Table;
+
+  const Table *GetTable (WifiMode mode) const;
+
+  Ptr<ErrorRateModel> m_model;
+  double m_minSnrDb;
+  double m_maxSnrDb;
+  double m_resolutionDb;
+  enum Interpolation m_interpolation;
+  // The tables of the modes, indexed by their uid
+  mutable std::vector<const Table *> m_tables;
+};
+
+} // namespace ns3
+
+#endif /* TABULATED_ERROR_RATE_MODEL_H */
@@ -25,6 +25,7 @@
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/object-factory.h"
+#include "ns3/double.h"
 #include "yans-wifi-channel.h"
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
@@ -50,16 +51,35 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The maximum distance (m) between a sender and the PHYs which receive its frames. "
+                   "PHYs further away are never considered, without computing their propagation loss. "
+                   "Zero disables this cutoff.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&YansWifiChannel::SetMaxRange,
+                                       &YansWifiChannel::GetMaxRange),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MinRxPower",
+                   "The received power (dBm) below which a frame is not delivered to a PHY: "
+                   "the PHY only accounts for its energy in the interference and CCA. "
+                   "Results are unchanged if this power plus the RxGain of the PHYs is not above "
+                   "their EnergyDetectionThreshold. The default value delivers every frame.",
+                   DoubleValue (-1000.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_minRxPowerDbm),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0.0),
+    m_minRxPowerDbm (-1000.0)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  m_index.Clear ();
   m_phyList.clear ();
 }
 
@@ -74,30 +94,75 @@ YansWifiChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
   m_delay = delay;
 }
 
+void
+YansWifiChannel::SetMaxRange (double maxRange)
+{
+  m_maxRange = maxRange;
+  if (m_maxRange > 0)
+    {
+      m_index.SetCellSize (m_maxRange);
+    }
+}
+double
+YansWifiChannel::GetMaxRange (void) const
+{
+  return m_maxRange;
+}
+
+void
+YansWifiChannel::UpdateIndex (void) const
+{
+  // the mobility models are usually aggregated to the nodes after the
+  // phys are added to the channel so, they are indexed lazily.
+  for (uint32_t i = m_index.GetN (); i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT (mobility != 0);
+      m_index.Add (mobility);
+    }
+}
+
 void
 YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
                        WifiMode wifiMode, WifiPreamble preamble) const
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  if (m_maxRange > 0)
+    {
+      UpdateIndex ();
+      m_index.GetCandidates (senderMobility->GetPosition (), m_maxRange, m_candidates);
+    }
+  else
     {
-      if (sender != (*i))
+      m_candidates.resize (m_phyList.size ());
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
+        {
+          m_candidates[j] = j;
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
+    {
+      uint32_t j = *i;
+      Ptr<YansWifiPhy> receiver = m_phyList[j];
+      if (sender != receiver)
         {
           // For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+          if (m_maxRange > 0 && senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+            {
+              continue;
+            }
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
+          Ptr<Object> dstNetDevice = receiver->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
             {
@@ -107,6 +172,17 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
             {
               dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
             }
+          if (rxPowerDbm < m_minRxPowerDbm)
+            {
+              // the receiver only accounts for the energy of the frame, in
+              // the event which would have delivered it
+              NS_LOG_DEBUG ("energy only: rxPower below " << m_minRxPowerDbm << "dbm");
+              Simulator::ScheduleWithContext (dstNode,
+                                              delay, &YansWifiChannel::ReceiveEnergy, this,
+                                              j, packet->GetSize (), rxPowerDbm, wifiMode, preamble);
+              continue;
+            }
+          Ptr<Packet> copy = packet->Copy ();
           Simulator::ScheduleWithContext (dstNode,
                                           delay, &YansWifiChannel::Receive, this,
                                           j, copy, rxPowerDbm, wifiMode, preamble);
@@ -121,6 +197,13 @@ YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
   m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txMode, preamble);
 }
 
+void
+YansWifiChannel::ReceiveEnergy (uint32_t i, uint32_t size, double rxPowerDbm,
+                                WifiMode txMode, WifiPreamble preamble) const
+{
+  m_phyList[i]->StartReceiveEnergy (size, rxPowerDbm, txMode, preamble);
+}
+
 uint32_t
 YansWifiChannel::GetNDevices (void) const
 {
@@ -26,6 +26,7 @@
 #include "wifi-channel.h"
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
+#include "ns3/mobility-grid-index.h"
 
 namespace ns3 {
 
@@ -45,6 +46,25 @@ class YansWifiPhy;
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * Frames weaker than the MinRxPower attribute are not delivered to the
+ * PHYs, which only add their energy to the interference and CCA with
+ * YansWifiPhy::StartReceiveEnergy. As long as MinRxPower plus the RxGain
+ * of the PHYs is not above their EnergyDetectionThreshold, the PHYs
+ * could not have synchronized on these frames and results are
+ * unchanged, except that the PhyRxDrop trace source does not fire for
+ * them.
+ *
+ * When the MaxRange attribute is set, the PHYs are indexed with a
+ * ns3::MobilityGridIndex and Send does not consider the PHYs further
+ * than that from the sender at all. This is an approximation: these
+ * PHYs do not see the energy of the frame, and the propagation loss
+ * model is not called for them, so that a loss model which draws random
+ * variables draws fewer of them. Results are only unchanged when the
+ * PHYs beyond MaxRange never transmit nor receive any frame whose
+ * outcome depends on that energy, and the loss model is deterministic.
+ * With the default values of both attributes, every PHY of the channel
+ * receives every frame.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -101,11 +121,20 @@ private:
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
   void Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
                 WifiMode txMode, WifiPreamble preamble) const;
+  void ReceiveEnergy (uint32_t i, uint32_t size, double rxPowerDbm,
+                      WifiMode txMode, WifiPreamble preamble) const;
+  void SetMaxRange (double maxRange);
+  double GetMaxRange (void) const;
+  void UpdateIndex (void) const;
 
 
   PhyList m_phyList;
   Ptr<PropagationLossModel> m_loss;
   Ptr<PropagationDelayModel> m_delay;
+  double m_maxRange;
+  double m_minRxPowerDbm;
+  mutable MobilityGridIndex m_index;
+  mutable std::vector<uint32_t> m_candidates;
 };
 
 } // namespace ns3
@@ -494,6 +494,30 @@ maybeCcaBusy:
     }
 }
 
+void
+YansWifiPhy::StartReceiveEnergy (uint32_t size,
+                                 double rxPowerDbm,
+                                 WifiMode txMode,
+                                 enum WifiPreamble preamble)
+{
+  NS_LOG_FUNCTION (this << size << rxPowerDbm << txMode << preamble);
+  rxPowerDbm += m_rxGainDb;
+  double rxPowerW = DbmToW (rxPowerDbm);
+  Time rxDuration = CalculateTxDuration (size, txMode, preamble);
+  m_interference.Add (size, txMode, preamble, rxDuration, rxPowerW);
+
+  // Same as StartReceivePacket for a frame which cannot be received
+  if (m_state->IsStateIdle () || m_state->IsStateCcaBusy ()
+      || rxDuration > m_state->GetDelayUntilIdle ())
+    {
+      Time delayUntilCcaEnd = m_interference.GetEnergyDuration (m_ccaMode1ThresholdW);
+      if (!delayUntilCcaEnd.IsZero ())
+        {
+          m_state->SwitchMaybeToCcaBusy (delayUntilCcaEnd);
+        }
+    }
+}
+
 void
 YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiMode txMode, WifiPreamble preamble, uint8_t txPower)
 {
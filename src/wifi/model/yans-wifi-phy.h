@@ -93,6 +93,22 @@ public:
                            double rxPowerDbm,
                            WifiMode mode,
                            WifiPreamble preamble);
+  /**
+   * Account for a frame which YansWifiChannel does not deliver because it
+   * is weaker than its MinRxPower attribute: its energy is added to the
+   * interference and may make CCA busy, as for a frame received with
+   * StartReceivePacket which is too weak to sync to, but PhyRxDrop is not
+   * notified.
+   *
+   * \param size the size of the frame in bytes
+   * \param rxPowerDbm the received power of the frame, before the RX gain
+   * \param mode the tx mode of the frame
+   * \param preamble the preamble of the frame
+   */
+  void StartReceiveEnergy (uint32_t size,
+                           double rxPowerDbm,
+                           WifiMode mode,
+                           WifiPreamble preamble);
 
   void SetRxNoiseFigure (double noiseFigureDb);
   void SetTxPowerStart (double start);
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/pointer.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/tabulated-error-rate-model.h"
+
+namespace ns3 {
+
+class TabulatedErrorRateModelTest : public TestCase
+{
+public:
+  TabulatedErrorRateModelTest (Ptr<ErrorRateModel> model, enum TabulatedErrorRateModel::Interpolation interpolation,
+                               double resolution, double tolerance);
+  virtual void DoRun (void);
+
+private:
+  Ptr<ErrorRateModel> m_model;
+  enum TabulatedErrorRateModel::Interpolation m_interpolation;
+  double m_resolution;
+  double m_tolerance;
+};
+
+TabulatedErrorRateModelTest::TabulatedErrorRateModelTest (Ptr<ErrorRateModel> model,
+                                                          enum TabulatedErrorRateModel::Interpolation interpolation,
+                                                          double resolution, double tolerance)
+  : TestCase (std::string ("Check that the tables of ") + model->GetInstanceTypeId ().GetName ()
+              + (interpolation == TabulatedErrorRateModel::LINEAR ? " with" : " without")
+              + " interpolation are close to the model"),
+    m_model (model),
+    m_interpolation (interpolation),
+    m_resolution (resolution),
+    m_tolerance (tolerance)
+{
+}
+
+void
+TabulatedErrorRateModelTest::DoRun (void)
+{
+  Ptr<TabulatedErrorRateModel> tabulated = CreateObject<TabulatedErrorRateModel> ();
+  tabulated->SetAttribute ("ErrorRateModel", PointerValue (m_model));
+  tabulated->SetAttribute ("Interpolation", EnumValue (m_interpolation));
+  tabulated->SetAttribute ("Resolution", DoubleValue (m_resolution));
+
+  std::vector<WifiMode> modes;
+  modes.push_back (WifiPhy::GetDsssRate1Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate2Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate5_5Mbps ());
+  modes.push_back (WifiPhy::GetDsssRate11Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate6Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate9Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate12Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate18Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate24Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate36Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate48Mbps ());
+  modes.push_back (WifiPhy::GetOfdmRate54Mbps ());
+  modes.push_back (WifiPhy::GetErpOfdmRate54Mbps ());
+
+  // The SNRs fall between the points of the tables, and cover the SNRs
+  // out of the tables
+  const uint32_t nbits[] = { 1, 200, 12000 };
+  for (std::vector<WifiMode>::const_iterator mode = modes.begin (); mode != modes.end (); mode++)
+    {
+      double maxError = 0;
+      double maxErrorSnrDb = 0;
+      for (double snrDb = -15.0; snrDb < 55.0; snrDb += 0.0137)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (uint32_t i = 0; i < sizeof (nbits) / sizeof (nbits[0]); i++)
+            {
+              double expected = m_model->GetChunkSuccessRate (*mode, snr, nbits[i]);
+              double error = std::fabs (tabulated->GetChunkSuccessRate (*mode, snr, nbits[i]) - expected);
+              if (error > maxError)
+                {
+                  maxError = error;
+                  maxErrorSnrDb = snrDb;
+                }
+            }
+        }
+      NS_TEST_EXPECT_MSG_LT (maxError, m_tolerance, "too large an error for " << *mode << " at " << maxErrorSnrDb << " dB");
+    }
+  NS_TEST_EXPECT_MSG_EQ (tabulated->GetChunkSuccessRate (WifiPhy::GetOfdmRate54Mbps (), 1e6, 12000), 1.0,
+                         "no error expected at a very high SNR");
+  NS_TEST_EXPECT_MSG_EQ (tabulated->GetChunkSuccessRate (WifiPhy::GetOfdmRate54Mbps (), 0.1, 0), 1.0,
+                         "an empty chunk cannot fail");
+
+  // The tables already built are not used on another grid
+  tabulated->SetAttribute ("MinSnr", DoubleValue (0.0));
+  tabulated->SetAttribute ("MaxSnr", DoubleValue (10.0));
+  tabulated->SetAttribute ("Resolution", DoubleValue (1.0));
+  double snr = std::pow (10.0, 0.5);
+  NS_TEST_EXPECT_MSG_EQ_TOL (tabulated->GetChunkSuccessRate (WifiPhy::GetOfdmRate6Mbps (), snr, 200),
+                             m_model->GetChunkSuccessRate (WifiPhy::GetOfdmRate6Mbps (), snr, 200), 1e-6,
+                             "the table of the previous grid was used");
+}
+
+// A model with a parameter, s(snr) = exp (-scale / snr)
+class ScaledErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+private:
+  double m_scale;
+};
+
+TypeId
+ScaledErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ScaledErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .AddConstructor<ScaledErrorRateModel> ()
+    .AddAttribute ("Scale", "The SNR at which the bit success rate is 1/e.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&ScaledErrorRateModel::m_scale),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+double
+ScaledErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  return std::exp (-(m_scale / snr) * nbits);
+}
+
+class TabulatedErrorRateModelSharingTest : public TestCase
+{
+public:
+  TabulatedErrorRateModelSharingTest ();
+  virtual void DoRun (void);
+};
+
+TabulatedErrorRateModelSharingTest::TabulatedErrorRateModelSharingTest ()
+  : TestCase ("Check that the models with different attributes do not share their tables")
+{
+}
+
+void
+TabulatedErrorRateModelSharingTest::DoRun (void)
+{
+  WifiMode mode = WifiPhy::GetOfdmRate6Mbps ();
+  double snr = std::pow (10.0, 0.5);
+  for (double scale = 1.0; scale <= 3.0; scale += 1.0)
+    {
+      Ptr<ErrorRateModel> model = CreateObject<ScaledErrorRateModel> ();
+      model->SetAttribute ("Scale", DoubleValue (scale));
+      Ptr<TabulatedErrorRateModel> tabulated = CreateObject<TabulatedErrorRateModel> ();
+      tabulated->SetAttribute ("ErrorRateModel", PointerValue (model));
+      NS_TEST_EXPECT_MSG_EQ_TOL (tabulated->GetChunkSuccessRate (mode, snr, 10),
+                                 model->GetChunkSuccessRate (mode, snr, 10), 1e-3,
+                                 "the table of another Scale was used for Scale " << scale);
+    }
+}
+
+class TabulatedErrorRateModelTestSuite : public TestSuite
+{
+public:
+  TabulatedErrorRateModelTestSuite ();
+};
+
+TabulatedErrorRateModelTestSuite::TabulatedErrorRateModelTestSuite ()
+  : TestSuite ("wifi-tabulated-error-rate-model", UNIT)
+{
+  AddTestCase (new TabulatedErrorRateModelTest (CreateObject<NistErrorRateModel> (),
+                                                TabulatedErrorRateModel::LINEAR, 0.01, 5e-4));
+  AddTestCase (new TabulatedErrorRateModelTest (CreateObject<YansErrorRateModel> (),
+                                                TabulatedErrorRateModel::LINEAR, 0.01, 5e-4));
+  AddTestCase (new TabulatedErrorRateModelTest (CreateObject<NistErrorRateModel> (),
+                                                TabulatedErrorRateModel::NEAREST, 0.001, 5e-3));
+  AddTestCase (new TabulatedErrorRateModelSharingTest ());
+}
+
+static TabulatedErrorRateModelTestSuite tabulatedErrorRateModelTestSuite;
+
+} // namespace ns3
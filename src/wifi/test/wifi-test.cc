@@ -38,6 +38,15 @@
 #include "ns3/mac-rx-middle.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/interference-helper.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/nqos-wifi-mac-helper.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include <cmath>
+#include <vector>
+#include <sstream>
 
 namespace ns3 {
 
@@ -285,6 +294,145 @@ InterferenceHelperSequenceTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * An error rate model which records the chunks it is asked about and
+ * succeeds with the same probability for each non-empty chunk.
+ */
+class ChunkRecorderErrorRateModel : public ErrorRateModel
+{
+public:
+  struct Chunk
+  {
+    WifiMode mode;
+    double snr;
+    uint32_t nbits;
+  };
+
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+  {
+    Chunk chunk;
+    chunk.mode = mode;
+    chunk.snr = snr;
+    chunk.nbits = nbits;
+    m_chunks.push_back (chunk);
+    return 0.9;
+  }
+
+  mutable std::vector<Chunk> m_chunks;
+};
+
+/**
+ * Check the chunks of constant interference which the InterferenceHelper
+ * finds in a frame overlapped by an interferer started before it, by
+ * interferers which end during its preamble, its payload or after it, and
+ * that the changes of a past reception are folded in the next one.
+ */
+class InterferenceHelperSnrPerTest : public TestCase
+{
+public:
+  InterferenceHelperSnrPerTest ();
+
+  virtual void DoRun (void);
+private:
+  void AddInterferer (uint32_t durationUs, double powerW);
+  void StartRx (uint32_t durationUs, double powerW);
+  void EndRx (void);
+
+  InterferenceHelper m_interference;
+  Ptr<ChunkRecorderErrorRateModel> m_error;
+  Ptr<InterferenceHelper::Event> m_event;
+  std::vector<struct InterferenceHelper::SnrPer> m_snrPers;
+  std::vector<std::vector<ChunkRecorderErrorRateModel::Chunk> > m_chunks;
+};
+
+InterferenceHelperSnrPerTest::InterferenceHelperSnrPerTest ()
+  : TestCase ("InterferenceHelperSnrPer")
+{
+}
+
+void
+InterferenceHelperSnrPerTest::AddInterferer (uint32_t durationUs, double powerW)
+{
+  m_interference.Add (1000, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG, MicroSeconds (durationUs), powerW);
+}
+
+void
+InterferenceHelperSnrPerTest::StartRx (uint32_t durationUs, double powerW)
+{
+  m_event = m_interference.Add (1000, WifiPhy::GetOfdmRate6Mbps (), WIFI_PREAMBLE_LONG, MicroSeconds (durationUs), powerW);
+  m_interference.NotifyRxStart ();
+}
+
+void
+InterferenceHelperSnrPerTest::EndRx (void)
+{
+  m_error->m_chunks.clear ();
+  m_snrPers.push_back (m_interference.CalculateSnrPer (m_event));
+  m_chunks.push_back (m_error->m_chunks);
+  m_interference.NotifyRxEnd ();
+  m_event = 0;
+}
+
+void
+InterferenceHelperSnrPerTest::DoRun (void)
+{
+  m_error = CreateObject<ChunkRecorderErrorRateModel> ();
+  m_interference.SetErrorRateModel (m_error);
+  // no thermal noise: the SNRs are the ratios of the powers
+  m_interference.SetNoiseFigure (0.0);
+
+  // The frame is received from 10us to 1010us, its header starts at 26us
+  // and its payload at 30us.
+  Simulator::Schedule (MicroSeconds (0), &InterferenceHelperSnrPerTest::AddInterferer, this, 400, 5e-11);
+  Simulator::Schedule (MicroSeconds (10), &InterferenceHelperSnrPerTest::StartRx, this, 1000, 1e-9);
+  Simulator::Schedule (MicroSeconds (20), &InterferenceHelperSnrPerTest::AddInterferer, this, 100, 1e-10);
+  Simulator::Schedule (MicroSeconds (200), &InterferenceHelperSnrPerTest::AddInterferer, this, 2000, 2e-10);
+  Simulator::Schedule (MicroSeconds (600), &InterferenceHelperSnrPerTest::AddInterferer, this, 100, 1e-10);
+  Simulator::Schedule (MicroSeconds (1010), &InterferenceHelperSnrPerTest::EndRx, this);
+  // Only the interferer started at 200us is left when the next frame starts
+  Simulator::Schedule (MicroSeconds (2000), &InterferenceHelperSnrPerTest::StartRx, this, 100, 1e-9);
+  Simulator::Schedule (MicroSeconds (2100), &InterferenceHelperSnrPerTest::EndRx, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_snrPers.size (), 2, "two frames received");
+
+  struct
+  {
+    double snr;
+    uint32_t durationUs;
+  } expected[] = {
+    { 1e-9 / 1.5e-10, 4 },
+    { 1e-9 / 1.5e-10, 90 },
+    { 1e-9 / 5e-11, 80 },
+    { 1e-9 / 2.5e-10, 200 },
+    { 1e-9 / 2e-10, 200 },
+    { 1e-9 / 3e-10, 100 },
+    { 1e-9 / 2e-10, 310 },
+  };
+  uint32_t rate = WifiPhy::GetOfdmRate6Mbps ().GetPhyRate ();
+  uint32_t nExpected = sizeof (expected) / sizeof (expected[0]);
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPers[0].snr, 20.0, 1e-9, "SNR at the start of the first frame");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPers[0].per, 1 - std::pow (0.9, (double)nExpected), 1e-9,
+                             "PER of the first frame");
+  NS_TEST_ASSERT_MSG_EQ (m_chunks[0].size (), nExpected, "chunks of the first frame");
+  for (uint32_t i = 0; i < nExpected; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_chunks[0][i].mode, WifiPhy::GetOfdmRate6Mbps (), "mode of chunk " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_chunks[0][i].snr, expected[i].snr, 1e-9, "SNR of chunk " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_chunks[0][i].nbits, (uint32_t)(rate * MicroSeconds (expected[i].durationUs).GetSeconds ()),
+                             "bits of chunk " << i);
+    }
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_snrPers[1].snr, 5.0, 1e-9, "SNR at the start of the second frame");
+  NS_TEST_ASSERT_MSG_EQ (m_chunks[1].size (), 2, "chunks of the second frame");
+  NS_TEST_EXPECT_MSG_EQ (m_chunks[1][0].nbits, (uint32_t)(rate * MicroSeconds (4).GetSeconds ()),
+                         "header of the second frame");
+  NS_TEST_EXPECT_MSG_EQ (m_chunks[1][1].nbits, (uint32_t)(rate * MicroSeconds (80).GetSeconds ()),
+                         "payload of the second frame");
+}
+
 //-----------------------------------------------------------------------------
 /**
  * Make sure that when multiple broadcast packets are queued on the same
@@ -427,6 +575,161 @@ Bug555TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_secondTransmissionTime, expectedSecondTransmissionTime, "The second transmission time not correct!");
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the frames which YansWifiChannel does not deliver because
+ * they are below its MinRxPower attribute still interfere with the frames
+ * which are received and still make CCA busy: with MinRxPower plus the
+ * RxGain below the EnergyDetectionThreshold of the PHYs, the states, the
+ * SNRs and the transmission times are the same as without any cutoff.
+ *
+ * Node B receives the frames of node A, while the frames of node C, and
+ * those of node A at node C, are received at -98 dBm, between the
+ * CcaMode1Threshold and the EnergyDetectionThreshold of the PHYs.
+ */
+class YansWifiChannelMinRxPowerTest : public TestCase
+{
+public:
+  YansWifiChannelMinRxPowerTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param minRxPowerDbm the MinRxPower of the channel
+   * \return the log of the states, receptions and transmissions
+   */
+  std::string RunOne (double minRxPowerDbm);
+  void SendOnePacket (Ptr<NetDevice> dev);
+  void NotifyState (std::string context, Time start, Time duration, WifiPhy::State state);
+  void NotifyRxOk (std::string context, Ptr<const Packet> p, double snr, WifiMode mode, WifiPreamble preamble);
+  void NotifyTxBegin (std::string context, Ptr<const Packet> p);
+  void NotifyRxDrop (Ptr<const Packet> p);
+
+  std::ostringstream m_log;
+  uint32_t m_rxDrops;
+};
+
+YansWifiChannelMinRxPowerTest::YansWifiChannelMinRxPowerTest ()
+  : TestCase ("YansWifiChannel MinRxPower below the energy detection threshold")
+{
+}
+
+void
+YansWifiChannelMinRxPowerTest::SendOnePacket (Ptr<NetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelMinRxPowerTest::NotifyState (std::string context, Time start, Time duration, WifiPhy::State state)
+{
+  m_log << context << " state " << start << " " << duration << " " << state << std::endl;
+}
+
+void
+YansWifiChannelMinRxPowerTest::NotifyRxOk (std::string context, Ptr<const Packet> p, double snr, WifiMode mode, WifiPreamble preamble)
+{
+  m_log << context << " rx " << Simulator::Now () << " " << snr << std::endl;
+}
+
+void
+YansWifiChannelMinRxPowerTest::NotifyTxBegin (std::string context, Ptr<const Packet> p)
+{
+  m_log << context << " tx " << Simulator::Now () << std::endl;
+}
+
+void
+YansWifiChannelMinRxPowerTest::NotifyRxDrop (Ptr<const Packet> p)
+{
+  m_rxDrops++;
+}
+
+std::string
+YansWifiChannelMinRxPowerTest::RunOne (double minRxPowerDbm)
+{
+  m_log.str ("");
+  m_rxDrops = 0;
+
+  NodeContainer nodes;
+  nodes.Create (3);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nodes.Get (i)->AggregateObject (CreateObject<ConstantPositionMobilityModel> ());
+    }
+  Ptr<MobilityModel> a = nodes.Get (0)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> b = nodes.Get (1)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> c = nodes.Get (2)->GetObject<MobilityModel> ();
+  Ptr<MatrixPropagationLossModel> propLoss = CreateObject<MatrixPropagationLossModel> ();
+  propLoss->SetLoss (a, b, 60);
+  // 16.0206 dBm + 1 dB of tx gain - 116 dB + 1 dB of rx gain = -98 dBm
+  propLoss->SetLoss (c, b, 116);
+  propLoss->SetLoss (a, c, 116);
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (propLoss);
+  channel->SetAttribute ("MinRxPower", DoubleValue (minRxPowerDbm));
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::AdhocWifiMac");
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"));
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 1);
+
+  const char *names[] = { "A", "B", "C" };
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<WifiPhy> wifiPhy = DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy ();
+      PointerValue state;
+      wifiPhy->GetAttribute ("State", state);
+      state.Get<Object> ()->TraceConnect ("State", names[i],
+                                          MakeCallback (&YansWifiChannelMinRxPowerTest::NotifyState, this));
+      state.Get<Object> ()->TraceConnect ("RxOk", names[i],
+                                          MakeCallback (&YansWifiChannelMinRxPowerTest::NotifyRxOk, this));
+      wifiPhy->TraceConnect ("PhyTxBegin", names[i],
+                             MakeCallback (&YansWifiChannelMinRxPowerTest::NotifyTxBegin, this));
+      wifiPhy->TraceConnectWithoutContext ("PhyRxDrop",
+                                           MakeCallback (&YansWifiChannelMinRxPowerTest::NotifyRxDrop, this));
+    }
+
+  // the frames of A and C overlap at B, and B transmits while C does
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Time start = Seconds (1.0) + MilliSeconds (10 * i);
+      Simulator::Schedule (start, &YansWifiChannelMinRxPowerTest::SendOnePacket, this, devices.Get (0));
+      Simulator::Schedule (start + MicroSeconds (100 + 7 * i),
+                           &YansWifiChannelMinRxPowerTest::SendOnePacket, this, devices.Get (2));
+      Simulator::Schedule (start + MicroSeconds (2000 + 11 * i),
+                           &YansWifiChannelMinRxPowerTest::SendOnePacket, this, devices.Get (2));
+      Simulator::Schedule (start + MicroSeconds (2100 + 13 * i),
+                           &YansWifiChannelMinRxPowerTest::SendOnePacket, this, devices.Get (1));
+    }
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_log.str ();
+}
+
+void
+YansWifiChannelMinRxPowerTest::DoRun (void)
+{
+  std::string full = RunOne (-1000.0);
+  uint32_t fullRxDrops = m_rxDrops;
+  // -97 dBm + 1 dB of rx gain is the default EnergyDetectionThreshold
+  std::string culled = RunOne (-97.0);
+
+  NS_TEST_ASSERT_MSG_EQ (culled, full, "MinRxPower changed the simulation");
+  NS_TEST_ASSERT_MSG_LT (m_rxDrops, fullRxDrops, "no frame was culled");
+}
+
 //-----------------------------------------------------------------------------
 
 class WifiTestSuite : public TestSuite
@@ -441,7 +744,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new WifiTest);
   AddTestCase (new QosUtilsIsOldPacketTest);
   AddTestCase (new InterferenceHelperSequenceTest); // Bug 991
+  AddTestCase (new InterferenceHelperSnrPerTest);
   AddTestCase (new Bug555TestCase); // Bug 555
+  AddTestCase (new YansWifiChannelMinRxPowerTest);
 }
 
 static WifiTestSuite g_wifiTestSuite;
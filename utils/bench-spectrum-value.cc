@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compare the SINR computation of the interference models written with
+// the SpectrumValue operators and with the fused Sinr kernel, and the
+// in-place update of the sum of the signals, for spectrum models of the
+// sizes of the LTE bandwidths and for a model too large to be stored in
+// a SpectrumValue itself.  The memory used by each operation is reported
+// too: the size of a SpectrumValue and the bytes allocated on the heap,
+// which the global operator new of this program counts.
+
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/spectrum-value.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <new>
+#include <string.h>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static double g_sink = 0;
+static uint64_t g_heapBytes = 0;
+
+void *
+operator new (size_t size) throw (std::bad_alloc)
+{
+  g_heapBytes += size;
+  void *p = malloc (size ? size : 1);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void *
+operator new[] (size_t size) throw (std::bad_alloc)
+{
+  return operator new (size);
+}
+
+void
+operator delete (void *p) throw ()
+{
+  free (p);
+}
+
+void
+operator delete[] (void *p) throw ()
+{
+  free (p);
+}
+
+static Ptr<SpectrumModel>
+MakeModel (uint32_t nBands)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < nBands; i++)
+    {
+      freqs.push_back (2.0e9 + i * 180.0e3);
+    }
+  return Create<SpectrumModel> (freqs);
+}
+
+static void
+benchOperators (uint32_t n, const SpectrumValue &signal, const SpectrumValue &allSignals, const SpectrumValue &noise)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SpectrumValue sinr = signal / (allSignals - signal + noise);
+      g_sink += *sinr.ConstValuesBegin ();
+    }
+}
+
+static void
+benchFused (uint32_t n, const SpectrumValue &signal, const SpectrumValue &allSignals, const SpectrumValue &noise)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SpectrumValue sinr = Sinr (signal, allSignals, noise);
+      g_sink += *sinr.ConstValuesBegin ();
+    }
+}
+
+static void
+benchInPlace (uint32_t n, const SpectrumValue &signal, const SpectrumValue &allSignals, const SpectrumValue &noise)
+{
+  SpectrumValue sum = allSignals;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sum += signal;
+      sum -= signal;
+    }
+  g_sink += *sum.ConstValuesBegin ();
+}
+
+static void
+runBench (void (*bench) (uint32_t, const SpectrumValue &, const SpectrumValue &, const SpectrumValue &),
+          uint32_t n, uint32_t nBands, char const *name)
+{
+  Ptr<SpectrumModel> model = MakeModel (nBands);
+  SpectrumValue signal (model), allSignals (model), noise (model);
+  for (uint32_t i = 0; i < nBands; i++)
+    {
+      signal[i] = 1e-16 * (i + 1);
+      allSignals[i] = 3e-16 * (i + 1);
+      noise[i] = 4e-21;
+    }
+  SystemWallClockMs time;
+  uint64_t heapBytes = g_heapBytes;
+  time.Start ();
+  (*bench) (n, signal, allSignals, noise);
+  uint64_t deltaMs = time.End ();
+  heapBytes = g_heapBytes - heapBytes;
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs ? deltaMs : 1;
+  std::cout << name << " bands=" << nBands << "=" << ps << " operations/s, "
+            << static_cast<double> (heapBytes) / n << " heap bytes/operation" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  while (argc > 0) {
+      if (strncmp ("--n=", argv[0],strlen ("--n=")) == 0)
+        {
+          char const *nAscii = argv[0] + strlen ("--n=");
+          std::istringstream iss;
+          iss.str (nAscii);
+          iss >> n;
+        }
+      argc--;
+      argv++;
+  }
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of operations must be specified " <<
+        "by command-line argument --n=(number of operations)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-spectrum-value with n=" << n << std::endl;
+  std::cout << "sizeof (SpectrumValue)=" << sizeof (SpectrumValue) << " bytes" << std::endl;
+
+  const uint32_t bands[] = { 6, 25, 50, 100, 300 };
+  for (uint32_t i = 0; i < sizeof (bands) / sizeof (bands[0]); i++)
+    {
+      runBench (&benchOperators, n, bands[i], "operators");
+      runBench (&benchFused, n, bands[i], "fused");
+      runBench (&benchInPlace, n, bands[i], "in-place");
+    }
+  if (g_sink == 0)
+    {
+      std::cout << std::endl;
+    }
+
+  return 0;
+}
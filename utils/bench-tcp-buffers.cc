@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Compare the packet storage and the ring storage of TcpTxBuffer and
+// TcpRxBuffer, with dummy data and with real data.
+
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-rx-buffer.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string.h>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+static const uint32_t g_segmentSize = 1460;
+static const uint32_t g_window = 65536;
+static uint32_t g_writeSize = 100;
+
+static Ptr<Packet>
+MakeData (uint32_t size, bool real)
+{
+  if (!real)
+    {
+      return Create<Packet> (size);
+    }
+  std::vector<uint8_t> bytes (size, 0x5a);
+  return Create<Packet> (&bytes[0], size);
+}
+
+// The application writes small chunks, a window of segments is sent and
+// acknowledged one segment at a time.
+static void
+benchTx (uint32_t n, bool ring, bool real)
+{
+  TcpTxBuffer buffer (0);
+  buffer.SetRingStorage (ring);
+  buffer.SetMaxBufferSize (2 * g_window);
+  SequenceNumber32 next (0);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      while (buffer.Available () >= g_writeSize)
+        {
+          buffer.Add (MakeData (g_writeSize, real));
+        }
+      while (static_cast<uint32_t> (next - buffer.HeadSequence ()) < g_window)
+        {
+          Ptr<Packet> p = buffer.CopyFromSequence (g_segmentSize, next);
+          next += p->GetSize ();
+        }
+      buffer.DiscardUpTo (buffer.HeadSequence () + SequenceNumber32 (g_segmentSize));
+    }
+}
+
+// The segments arrive with one loss in every 32 segments, repaired 8
+// segments later, and the application reads all it can after each one.
+static void
+benchRx (uint32_t n, bool ring, bool real)
+{
+  TcpRxBuffer buffer (0);
+  buffer.SetRingStorage (ring);
+  buffer.SetMaxBufferSize (2 * g_window);
+  Ptr<Packet> segment = MakeData (g_segmentSize, real);
+  TcpHeader header;
+  SequenceNumber32 lost (0);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      SequenceNumber32 seq (i * g_segmentSize);
+      if (i % 32 == 0)
+        {
+          lost = seq;
+        }
+      else
+        {
+          header.SetSequenceNumber (seq);
+          buffer.Add (segment->Copy (), header);
+        }
+      if (i % 32 == 8)
+        {
+          header.SetSequenceNumber (lost);
+          buffer.Add (segment->Copy (), header);
+        }
+      buffer.Extract (buffer.Available ());
+    }
+}
+
+static void
+runBench (void (*bench) (uint32_t, bool, bool), uint32_t n, bool ring, bool real, char const *name)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  (*bench) (n, ring, real);
+  uint64_t deltaMs = time.End ();
+  double ps = n;
+  ps *= 1000;
+  ps /= deltaMs ? deltaMs : 1;
+  std::cout << name << (ring ? " ring" : " list") << (real ? " real" : " dummy")
+            << "=" << ps << " segments/s" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  while (argc > 0) {
+      if (strncmp ("--n=", argv[0],strlen ("--n=")) == 0)
+        {
+          char const *nAscii = argv[0] + strlen ("--n=");
+          std::istringstream iss;
+          iss.str (nAscii);
+          iss >> n;
+        }
+      if (strncmp ("--write-size=", argv[0],strlen ("--write-size=")) == 0)
+        {
+          char const *sizeAscii = argv[0] + strlen ("--write-size=");
+          std::istringstream iss;
+          iss.str (sizeAscii);
+          iss >> g_writeSize;
+        }
+      argc--;
+      argv++;
+  }
+  if (n == 0 || g_writeSize == 0)
+    {
+      std::cerr << "Error-- number of segments must be specified " <<
+        "by command-line argument --n=(number of segments)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-tcp-buffers with n=" << n << " write-size=" << g_writeSize << std::endl;
+
+  for (int real = 0; real < 2; real++)
+    {
+      runBench (&benchTx, n, false, real, "tx");
+      runBench (&benchTx, n, true, real, "tx");
+      runBench (&benchRx, n, false, real, "rx");
+      runBench (&benchRx, n, true, real, "rx");
+    }
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Convert a fading trace written by fading-trace-generator.m to the
+// binary format loaded by TraceFadingLossModel, e.g.
+//
+//   ./waf --run "lte-fading-trace-converter
+//     --input=src/lte/model/fading-traces/fading_trace_EPA_3kmph.fad
+//     --output=fading_trace_EPA_3kmph.bin"
+
+#include "ns3/command-line.h"
+#include "ns3/nstime.h"
+#include "ns3/trace-fading-loss-model.h"
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  uint32_t rbNum = 100;
+  uint32_t samplesNum = 10000;
+  double traceLength = 10.0;
+  double windowSize = 0.5;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "Name of the fading trace in the text format", input);
+  cmd.AddValue ("output", "Name of the fading trace to write in the binary format", output);
+  cmd.AddValue ("rbNum", "Number of RBs of the trace", rbNum);
+  cmd.AddValue ("samplesNum", "Number of samples of each RB", samplesNum);
+  cmd.AddValue ("traceLength", "Length of the trace in seconds", traceLength);
+  cmd.AddValue ("windowSize", "Size of the fading window in seconds", windowSize);
+  cmd.Parse (argc, argv);
+
+  if (input.empty () || output.empty ())
+    {
+      std::cerr << "Error-- the traces must be specified by the command-line "
+                << "arguments --input=(text trace) and --output=(binary trace)" << std::endl;
+      exit (1);
+    }
+
+  TraceFadingLossModel::ConvertTrace (input, output, rbNum, samplesNum,
+                                      Seconds (traceLength), Seconds (windowSize));
+  std::cout << "Converted " << input << " to " << output << std::endl;
+  return 0;
+}